@@ -32,6 +32,7 @@ SOFTWARE.
 #include "mpi.h"
 #include <math.h>
 #include <stdlib.h>
+#include <stdio.h>
 #include <occa.hpp>
 
 #include "types.h"
@@ -337,6 +338,11 @@ typedef struct {
   // dfloat *probeX, *probeY, *probeZ;  
   dlong *probeElementIds, *probeIds;  
   dfloat *probeI; 
+  int probeNfields, probeNslots, probeSlot, probeNpending;
+  dfloat *probeTimes, *probePendingTimes;
+  dfloat *probeRing;   // pinned host copy of the device sample ring
+  FILE *probeFile;
+  occa::streamTag probeTag;
 
   // occa stuff
   occa::device device;
@@ -404,6 +410,9 @@ typedef struct {
 
   // Bernstein-Bezier occa arrays
   occa::memory o_BBMM;
+
+  occa::memory o_probeElementIds, o_probeI, o_probeRing, h_probeRing;
+  occa::kernel probeKernel;
   occa::memory o_D0ids, o_D1ids, o_D2ids, o_D3ids, o_Dvals; // Bernstein deriv matrix indices
   occa::memory o_packedDids; // char4 packed increments (D1ids-D0ids)
 
@@ -436,6 +445,7 @@ typedef struct {
   occa::kernel updateKernel;
   occa::kernel traceUpdateKernel;
   occa::kernel haloExtractKernel;
+  occa::kernel haloExtractEnsembleKernel; // fixed block, strides over Nensemble*Np*Nfields
   occa::kernel partialSurfaceKernel;
   occa::kernel haloGetKernel;
   occa::kernel haloPutKernel;
@@ -586,6 +596,22 @@ void readIntArray   (FILE *fp, const char *label, int **A   , int *Nrows, int* N
 
 void meshApplyElementMatrix(mesh_t *mesh, dfloat *A, dfloat *q, dfloat *Aq);
 
+// per-element minimum length scale from the surface geometric factors
+dfloat *meshElementHmin(mesh_t *mesh, int elementType);
+
+// probes: grid-indexed point location, device interpolation into a ring
+// of samples, asynchronous flush to a per-rank time-series file
+void meshProbeSetup(mesh_t *mesh, int elementType, dlong NprobeTotal,
+                    dfloat *pX, dfloat *pY, dfloat *pZ);
+void meshProbeSetupFile(mesh_t *mesh, int elementType, const char *fileName);
+void meshProbeDeviceSetup(mesh_t *mesh, int Nfields, int Nslots,
+                          const char *fileBase, occa::properties &kernelInfo);
+void meshProbeSample(mesh_t *mesh, int fieldStart, int Nfields,
+                     dlong elementStride, dlong fieldStride, occa::memory &o_q);
+void meshProbeAdvance(mesh_t *mesh, dfloat time);
+void meshProbeFlush(mesh_t *mesh);
+void meshProbeClose(mesh_t *mesh);
+
 void matrixInverse(int N, dfloat *A);
 dfloat matrixConditionNumber(int N, dfloat *A);
 
@@ -142,13 +142,6 @@ void meshMRABWeightedPartition2D(mesh2D *mesh, dfloat *weights,
                                       int numLevels, int *levels);
 
 
-// Setup probe information
-// Probe Setup : AK
-void meshProbeSetup2D(mesh2D *mesh, dfloat *pX, dfloat *pY);
-void meshVandermonde2D(int N, int sizeR, dfloat *r, dfloat *s, dfloat *V);
-dfloat meshSimplex2D(dfloat a, dfloat b, int i, int j);
-dfloat meshJacobiP(dfloat a, dfloat alpha, dfloat beta, int N);
-dfloat meshFactorial(int n);
 
 
 #define norm2(a,b) ( sqrt((a)*(a)+(b)*(b)) )
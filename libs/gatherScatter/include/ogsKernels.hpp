@@ -29,16 +29,40 @@ SOFTWARE.
 
 #include "ogs.hpp"
 
+// type and op indices for the resolved kernel tables
+typedef enum {ogsFloatId=0, ogsDoubleId=1, ogsIntId=2, ogsLongId=3, ogsNtypes=4} ogsTypeId_t;
+typedef enum {ogsAddId=0, ogsMulId=1, ogsMinId=2, ogsMaxId=3, ogsNops=4} ogsOpId_t;
+
 namespace ogs {
 
   extern int Nrefs;
 
+  extern const size_t typeSize[ogsNtypes];
+
+  ogsTypeId_t typeId(const char *type);
+  ogsOpId_t   opId  (const char *op);
+
+  extern occa::kernel gatherScatterKernels[ogsNtypes][ogsNops];
+  extern occa::kernel gatherKernels[ogsNtypes][ogsNops];
+  extern occa::kernel scatterKernels[ogsNtypes];
+
+  // add kernels for gather nodes of fixed degree 2, 4 and 8 (float and double only)
+  extern const int gatherScatterDegrees[3];
+
+  // add kernels over up to gatherScatterMaxFields arrays in one launch (float and double only)
+  extern const int gatherScatterMaxFields;
+  extern occa::kernel gatherScatterFieldsKernels[ogsNtypes];
+  extern occa::kernel gatherScatterDegreeKernels[ogsNtypes][3];
+
   extern void* hostBuf;
   extern size_t hostBufSize;
 
   extern void* haloBuf;
   extern occa::memory o_haloBuf;
 
+  extern void* haloSendBuf;
+  extern occa::memory o_haloSendBuf;
+
   extern occa::kernel gatherScatterKernel_floatAdd;
   extern occa::kernel gatherScatterKernel_floatMul;
   extern occa::kernel gatherScatterKernel_floatMin;
@@ -193,6 +217,29 @@ namespace ogs {
   void freeKernels();
 }
 
+void ogsLocalGatherScatter(occa::memory o_v, occa::kernel &gatherScatterKernel,
+                           occa::kernel *degreeKernels, ogs_t *ogs);
+
+ogsGsh_t *ogsGshSetup(MPI_Comm comm, dlong N, hlong *ids);
+void *ogsGsh(ogsGsh_t *gsh);
+void ogsGshFree(ogsGsh_t *gsh);
+
+void ogsExchangeSetup(ogs_t *ogs, hlong *symIds);
+void ogsExchangeFree(ogs_t *ogs);
+
+void ogsExchangeStart (occa::memory o_v, occa::kernel &gatherKernel, occa::kernel &packKernel,
+                       const size_t Nbytes, ogs_t *ogs);
+void ogsExchangeFinish(occa::memory o_v, occa::kernel &gatherKernel, occa::kernel &scatterKernel,
+                       const size_t Nbytes, ogs_t *ogs);
+
+void ogsExchangeGatheredStart (occa::memory o_gv, occa::kernel &packKernel,
+                               const size_t Nbytes, ogs_t *ogs);
+void ogsExchangeGatheredFinish(occa::memory o_gv, occa::kernel &gatherKernel,
+                               const size_t Nbytes, ogs_t *ogs);
+
+void ogsExchangeFieldsStart (const int Nfields, ogsField_t *fields, ogs_t *ogs);
+void ogsExchangeFieldsFinish(const int Nfields, ogsField_t *fields, ogs_t *ogs);
+
 void occaGatherScatter(const  dlong Ngather,
                 occa::memory o_gatherStarts,
                 occa::memory o_gatherIds,
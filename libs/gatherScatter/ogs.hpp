@@ -107,6 +107,26 @@ SOFTWARE.
     
   except that all communication is done together.
 
+  When the same type and op are used repeatedly, they can be resolved once,
+
+    ogsHandle_t *h = ogsHandleSetup(ogsDfloat, ogsAdd, ogs);
+    ogsGatherScatter(o_v, h);
+    ...
+    ogsHandleFree(h);
+
+  Fields of different types and ops can share the halo exchange,
+
+    ogsField_t fields[2] = {{o_u, ogsDfloat, ogsAdd}, {o_flag, ogsInt, ogsMax}};
+    ogsGatherScatterFields(2, fields, ogs);
+
+  which sends one message per neighbouring rank for all of them. When every
+  field is float or double with the add op, the local gather-scatter runs
+  in one launch for up to four fields.
+
+  The gslib handles used by the host and Vec/Many paths are only built the
+  first time they are needed, and ogs objects set up with the same ids on
+  every rank share them.
+
 */  
 
 #ifndef OGS_HPP
@@ -132,6 +152,9 @@ SOFTWARE.
 #define ogsMax "max"
 #define ogsMin "min"
 
+// lazily built gslib handle
+typedef struct ogsGsh_t ogsGsh_t;
+
 // OCCA+gslib gather scatter
 typedef struct {
   
@@ -146,6 +169,10 @@ typedef struct {
   dlong         NhaloGather;    //  number of gathered nodes on halo
   dlong         NownedHalo;     //  number of owned halo nodes
 
+  // local gather nodes are ordered in groups of degree 2, 4, 8, other, and
+  //  finally degree 1, which the local gather-scatter skips
+  dlong         localGroupStarts[6];
+
   dlong         *localGatherOffsets;
   dlong         *localGatherIds;
   occa::memory o_localGatherOffsets;  
@@ -156,9 +183,21 @@ typedef struct {
   occa::memory o_haloGatherOffsets;
   occa::memory o_haloGatherIds;    
 
-  void         *hostGsh;          // gslib gather 
-  void         *haloGshSym;       // gslib gather 
-  void         *haloGshNonSym;    // gslib gather 
+  ogsGsh_t     *hostGsh;          // gslib gather (built on first use, shared)
+  ogsGsh_t     *haloGshSym;       // gslib gather (built on first use, shared)
+  ogsGsh_t     *haloGshNonSym;    // gslib gather (built on first use, shared)
+
+  //native halo exchange, pairwise between ranks sharing halo gather nodes
+  int           NhaloNeighbors;      //  number of neighbouring ranks
+  dlong         NhaloExchange;       //  number of exchanged entries
+  int          *haloNeighbors;
+  dlong        *haloNeighborOffsets;
+  dlong        *haloExchangeIds;     //  halo gather node of each exchanged entry
+  occa::memory o_haloExchangeOffsets;
+  occa::memory o_haloExchangeIds;
+  occa::memory o_haloCombineOffsets;
+  occa::memory o_haloCombineIds;
+  MPI_Request  *haloRequests;
   
   //degree vectors
   dfloat *invDegree, *gatherInvDegree;
@@ -167,6 +206,30 @@ typedef struct {
 
 }ogs_t;
 
+// gather-scatter with a fixed (type, op). The kernels are resolved once
+//  here, so repeated calls skip the per-call type and op dispatch
+typedef struct {
+
+  ogs_t *ogs;
+  size_t Nbytes;
+
+  occa::kernel gatherScatterKernel;  // local nodes
+  occa::kernel *degreeKernels;       // local nodes of degree 2, 4, 8 (NULL if unavailable)
+  occa::kernel gatherKernel;         // halo gather and exchange reduction
+  occa::kernel packKernel;
+  occa::kernel scatterKernel;
+
+}ogsHandle_t;
+
+// one field of a batched gather-scatter, fields may differ in type and op
+typedef struct {
+
+  occa::memory o_v;
+  const char *type;
+  const char *op;
+
+}ogsField_t;
+
 
 ogs_t *ogsSetup(dlong N, hlong *ids, MPI_Comm &comm, 
                 int verbose, occa::device device);
@@ -222,5 +285,21 @@ void ogsScatterVecFinish (occa::memory  o_Sv, occa::memory  o_v, const int k, co
 void ogsScatterManyStart (occa::memory  o_Sv, occa::memory  o_v, const int k, const dlong sstride, const dlong stride, const char *type, const char *op, ogs_t *ogs);
 void ogsScatterManyFinish(occa::memory  o_Sv, occa::memory  o_v, const int k, const dlong sstride, const dlong stride, const char *type, const char *op, ogs_t *ogs);
 
+// Resolved handle versions
+ogsHandle_t *ogsHandleSetup(const char *type, const char *op, ogs_t *ogs);
+void ogsHandleFree(ogsHandle_t *h);
+
+void ogsGatherScatter      (occa::memory  o_v, ogsHandle_t *h);
+void ogsGatherScatterStart (occa::memory  o_v, ogsHandle_t *h);
+void ogsGatherScatterFinish(occa::memory  o_v, ogsHandle_t *h);
+
+// reduce already gathered halo values (NhaloGather entries) across ranks in place
+void ogsHaloExchangeStart (occa::memory  o_gv, ogsHandle_t *h);
+void ogsHaloExchangeFinish(occa::memory  o_gv, ogsHandle_t *h);
+
+// Batched versions, the halo values of all fields share one message per neighbour
+void ogsGatherScatterFields      (const int Nfields, ogsField_t *fields, ogs_t *ogs);
+void ogsGatherScatterFieldsStart (const int Nfields, ogsField_t *fields, ogs_t *ogs);
+void ogsGatherScatterFieldsFinish(const int Nfields, ogsField_t *fields, ogs_t *ogs);
 
 #endif
\ No newline at end of file
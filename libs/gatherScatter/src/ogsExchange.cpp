@@ -0,0 +1,520 @@
+/*
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Tim Warburton, Noel Chalmers, Jesse Chan, Ali Karakus
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "ogs.hpp"
+#include "ogsKernels.hpp"
+#include "ogsInterface.h"
+
+// Native halo exchange
+//  Every halo gather node is shared with at least one other rank. The exchange
+//  plan lists, for each neighbouring rank, the halo gather nodes shared with it
+//  ordered by global id, so that both sides of a pair agree on the message
+//  layout and the send and recv lists are identical. Each rank sends its
+//  partially gathered value to every rank sharing the node, and then reduces
+//  its own value with the received ones, giving the symmetric gather-scatter
+//  without going through gslib.
+
+typedef struct{
+
+  hlong id;     // global id of the halo gather node
+  int rank;     // rank holding the node (neighbour rank on the return trip)
+  dlong index;  // halo gather node index on the holding rank
+
+}exchangeNode_t;
+
+// compare on id then rank
+static int compareExchangeId(const void *a, const void *b){
+
+  exchangeNode_t *fa = (exchangeNode_t*) a;
+  exchangeNode_t *fb = (exchangeNode_t*) b;
+
+  if(fa->id < fb->id) return -1;
+  if(fa->id > fb->id) return +1;
+
+  if(fa->rank < fb->rank) return -1;
+  if(fa->rank > fb->rank) return +1;
+
+  return 0;
+}
+
+// compare on rank then id
+static int compareExchangeRank(const void *a, const void *b){
+
+  exchangeNode_t *fa = (exchangeNode_t*) a;
+  exchangeNode_t *fb = (exchangeNode_t*) b;
+
+  if(fa->rank < fb->rank) return -1;
+  if(fa->rank > fb->rank) return +1;
+
+  if(fa->id < fb->id) return -1;
+  if(fa->id > fb->id) return +1;
+
+  return 0;
+}
+
+void ogsExchangeSetup(ogs_t *ogs, hlong *symIds){
+
+  int rank, size;
+  MPI_Comm_rank(ogs->comm, &rank);
+  MPI_Comm_size(ogs->comm, &size);
+
+  // Make the MPI_EXCHANGE_NODE_T data type
+  exchangeNode_t node;
+  MPI_Datatype MPI_EXCHANGE_NODE_T;
+  MPI_Datatype dtype[3] = {MPI_HLONG, MPI_INT, MPI_DLONG};
+  int blength[3] = {1, 1, 1};
+  MPI_Aint addr[3], displ[3];
+  MPI_Get_address ( &(node.id   ), addr+0);
+  MPI_Get_address ( &(node.rank ), addr+1);
+  MPI_Get_address ( &(node.index), addr+2);
+  displ[0] = 0;
+  displ[1] = addr[1] - addr[0];
+  displ[2] = addr[2] - addr[0];
+  MPI_Type_create_struct (3, blength, displ, dtype, &MPI_EXCHANGE_NODE_T);
+  MPI_Type_commit (&MPI_EXCHANGE_NODE_T);
+
+  int *sendCounts  = (int*) calloc(size, sizeof(int));
+  int *recvCounts  = (int*) calloc(size, sizeof(int));
+  int *sendOffsets = (int*) calloc(size+1, sizeof(int));
+  int *recvOffsets = (int*) calloc(size+1, sizeof(int));
+
+  // send each halo gather node to a rendezvous rank chosen by its id
+  for (dlong c=0;c<ogs->NhaloGather;c++)
+    sendCounts[symIds[c]%size]++;
+
+  MPI_Alltoall(sendCounts, 1, MPI_INT,
+               recvCounts, 1, MPI_INT, ogs->comm);
+
+  for (int r=0;r<size;r++) {
+    sendOffsets[r+1] = sendOffsets[r]+sendCounts[r];
+    recvOffsets[r+1] = recvOffsets[r]+recvCounts[r];
+    sendCounts[r] = 0;
+  }
+
+  exchangeNode_t *sendNodes = (exchangeNode_t*) calloc(ogs->NhaloGather+1, sizeof(exchangeNode_t));
+  for (dlong c=0;c<ogs->NhaloGather;c++) {
+    int r = symIds[c]%size;
+    dlong n = sendOffsets[r] + sendCounts[r]++;
+    sendNodes[n].id    = symIds[c];
+    sendNodes[n].rank  = rank;
+    sendNodes[n].index = c;
+  }
+
+  dlong Nrecv = recvOffsets[size];
+  exchangeNode_t *recvNodes = (exchangeNode_t*) calloc(Nrecv+1, sizeof(exchangeNode_t));
+
+  MPI_Alltoallv(sendNodes, sendCounts, sendOffsets, MPI_EXCHANGE_NODE_T,
+                recvNodes, recvCounts, recvOffsets, MPI_EXCHANGE_NODE_T,
+                ogs->comm);
+
+  // group the nodes by id and tell every member which other ranks share it
+  qsort(recvNodes, Nrecv, sizeof(exchangeNode_t), compareExchangeId);
+
+  for (int r=0;r<size;r++) sendCounts[r] = 0;
+
+  for (dlong s=0;s<Nrecv;) {
+    dlong e = s;
+    while ((e<Nrecv)&&(recvNodes[e].id==recvNodes[s].id)) e++;
+
+    for (dlong n=s;n<e;n++)
+      sendCounts[recvNodes[n].rank] += e-s-1;
+
+    s = e;
+  }
+
+  for (int r=0;r<size;r++) {
+    sendOffsets[r+1] = sendOffsets[r]+sendCounts[r];
+    sendCounts[r] = 0;
+  }
+
+  dlong Nreply = sendOffsets[size];
+  exchangeNode_t *replyNodes = (exchangeNode_t*) calloc(Nreply+1, sizeof(exchangeNode_t));
+
+  for (dlong s=0;s<Nrecv;) {
+    dlong e = s;
+    while ((e<Nrecv)&&(recvNodes[e].id==recvNodes[s].id)) e++;
+
+    for (dlong n=s;n<e;n++) {
+      int r = recvNodes[n].rank;
+      for (dlong m=s;m<e;m++) {
+        if (m==n) continue;
+        dlong cnt = sendOffsets[r] + sendCounts[r]++;
+        replyNodes[cnt].id    = recvNodes[n].id;
+        replyNodes[cnt].rank  = recvNodes[m].rank;
+        replyNodes[cnt].index = recvNodes[n].index;
+      }
+    }
+    s = e;
+  }
+  free(recvNodes);
+
+  MPI_Alltoall(sendCounts, 1, MPI_INT,
+               recvCounts, 1, MPI_INT, ogs->comm);
+
+  for (int r=0;r<size;r++)
+    recvOffsets[r+1] = recvOffsets[r]+recvCounts[r];
+
+  ogs->NhaloExchange = recvOffsets[size];
+  exchangeNode_t *exchangeNodes = (exchangeNode_t*) calloc(ogs->NhaloExchange+1, sizeof(exchangeNode_t));
+
+  MPI_Alltoallv(replyNodes,    sendCounts, sendOffsets, MPI_EXCHANGE_NODE_T,
+                exchangeNodes, recvCounts, recvOffsets, MPI_EXCHANGE_NODE_T,
+                ogs->comm);
+
+  MPI_Barrier(ogs->comm);
+  MPI_Type_free(&MPI_EXCHANGE_NODE_T);
+  free(sendNodes); free(replyNodes);
+  free(sendCounts); free(recvCounts);
+  free(sendOffsets); free(recvOffsets);
+
+  // order the exchange by neighbour, then by global id
+  qsort(exchangeNodes, ogs->NhaloExchange, sizeof(exchangeNode_t), compareExchangeRank);
+
+  ogs->NhaloNeighbors = 0;
+  for (dlong n=0;n<ogs->NhaloExchange;n++)
+    if ((n==0)||(exchangeNodes[n].rank!=exchangeNodes[n-1].rank))
+      ogs->NhaloNeighbors++;
+
+  ogs->haloNeighbors       = (int*)   calloc(ogs->NhaloNeighbors+1, sizeof(int));
+  ogs->haloNeighborOffsets = (dlong*) calloc(ogs->NhaloNeighbors+1, sizeof(dlong));
+  ogs->haloExchangeIds     = (dlong*) calloc(ogs->NhaloExchange+1, sizeof(dlong));
+  ogs->haloRequests = (MPI_Request*) calloc(2*ogs->NhaloNeighbors+1, sizeof(MPI_Request));
+
+  int cnt = 0;
+  for (dlong n=0;n<ogs->NhaloExchange;n++) {
+    if ((n==0)||(exchangeNodes[n].rank!=exchangeNodes[n-1].rank)) {
+      ogs->haloNeighbors[cnt] = exchangeNodes[n].rank;
+      ogs->haloNeighborOffsets[cnt] = n;
+      cnt++;
+    }
+    ogs->haloExchangeIds[n] = exchangeNodes[n].index;
+  }
+  ogs->haloNeighborOffsets[ogs->NhaloNeighbors] = ogs->NhaloExchange;
+  free(exchangeNodes);
+
+  // the pack is a gather with one entry per exchanged node
+  dlong *haloExchangeOffsets = (dlong*) calloc(ogs->NhaloExchange+1, sizeof(dlong));
+  for (dlong n=0;n<ogs->NhaloExchange+1;n++) haloExchangeOffsets[n] = n;
+
+  // the unpack reduces each halo gather node with everything received for it.
+  //  Received values sit after the NhaloGather local partial values in the buffer
+  dlong *haloCombineOffsets = (dlong*) calloc(ogs->NhaloGather+1, sizeof(dlong));
+  dlong *haloCombineIds     = (dlong*) calloc(ogs->NhaloGather+ogs->NhaloExchange+1, sizeof(dlong));
+
+  for (dlong n=0;n<ogs->NhaloExchange;n++)
+    haloCombineOffsets[ogs->haloExchangeIds[n]+1]++;
+
+  for (dlong c=0;c<ogs->NhaloGather;c++)
+    haloCombineOffsets[c+1] += haloCombineOffsets[c] + 1;
+
+  for (dlong c=0;c<ogs->NhaloGather;c++)
+    haloCombineIds[haloCombineOffsets[c]] = c;
+
+  dlong *combineCounts = (dlong*) calloc(ogs->NhaloGather+1, sizeof(dlong));
+  for (dlong n=0;n<ogs->NhaloExchange;n++) {
+    dlong c = ogs->haloExchangeIds[n];
+    haloCombineIds[haloCombineOffsets[c] + 1 + combineCounts[c]++] = ogs->NhaloGather + n;
+  }
+  free(combineCounts);
+
+  if (ogs->NhaloExchange) {
+    ogs->o_haloExchangeOffsets = ogs->device.malloc((ogs->NhaloExchange+1)*sizeof(dlong), haloExchangeOffsets);
+    ogs->o_haloExchangeIds     = ogs->device.malloc((ogs->NhaloExchange)*sizeof(dlong), ogs->haloExchangeIds);
+    ogs->o_haloCombineOffsets  = ogs->device.malloc((ogs->NhaloGather+1)*sizeof(dlong), haloCombineOffsets);
+    ogs->o_haloCombineIds      = ogs->device.malloc((ogs->NhaloGather+ogs->NhaloExchange)*sizeof(dlong), haloCombineIds);
+  }
+
+  free(haloExchangeOffsets);
+  free(haloCombineOffsets);
+  free(haloCombineIds);
+}
+
+void ogsExchangeFree(ogs_t *ogs){
+
+  free(ogs->haloNeighbors);
+  free(ogs->haloNeighborOffsets);
+  free(ogs->haloExchangeIds);
+  free(ogs->haloRequests);
+
+  if (ogs->NhaloExchange) {
+    ogs->o_haloExchangeOffsets.free();
+    ogs->o_haloExchangeIds.free();
+    ogs->o_haloCombineOffsets.free();
+    ogs->o_haloCombineIds.free();
+  }
+}
+
+static void ogsExchangeReserve(const size_t Nbytes, ogs_t *ogs){
+
+  // received values are appended after the local partial values
+  const size_t haloBytes = (ogs->NhaloGather+ogs->NhaloExchange)*Nbytes;
+  if (ogs::o_haloBuf.size() < haloBytes) {
+    if (ogs::o_haloBuf.size()) ogs::o_haloBuf.free();
+    ogs::o_haloBuf = ogs->device.mappedAlloc(haloBytes);
+    ogs::haloBuf = ogs::o_haloBuf.getMappedPointer();
+  }
+  if (ogs::o_haloSendBuf.size() < ogs->NhaloExchange*Nbytes) {
+    if (ogs::o_haloSendBuf.size()) ogs::o_haloSendBuf.free();
+    ogs::o_haloSendBuf = ogs->device.mappedAlloc(ogs->NhaloExchange*Nbytes);
+    ogs::haloSendBuf = ogs::o_haloSendBuf.getMappedPointer();
+  }
+}
+
+// start copying the packed send buffer to the host
+static void ogsExchangeSendToHost(const size_t Nbytes,
+                                  ogs_t *ogs){
+#ifndef OGS_GPU_AWARE_MPI
+  ogs->device.finish();
+  ogs->device.setStream(ogs::dataStream);
+  ogs::o_haloSendBuf.copyTo(ogs::haloSendBuf, ogs->NhaloExchange*Nbytes, 0, "async: true");
+  ogs->device.setStream(ogs::defaultStream);
+#endif
+}
+
+// pack the gathered halo values in o_haloBuf and start copying them to the host
+static void ogsExchangePack(occa::kernel &packKernel,
+                            const size_t Nbytes,
+                            ogs_t *ogs){
+
+  packKernel(ogs->NhaloExchange, ogs->o_haloExchangeOffsets, ogs->o_haloExchangeIds, ogs::o_haloBuf, ogs::o_haloSendBuf);
+
+  ogsExchangeSendToHost(Nbytes, ogs);
+}
+
+// exchange with the neighbours, received values land after the gathered halo in o_haloBuf.
+//  Several fields are laid out one after the other in o_haloBuf and o_haloSendBuf, and
+//  each message carries the entries of every field for that neighbour
+static void ogsExchangeMessages(const int Nfields,
+                                const size_t *Nbytes,
+                                ogs_t *ogs){
+
+#ifdef OGS_GPU_AWARE_MPI
+  ogs->device.finish();
+  char *sendBuf = (char*) ogs::o_haloSendBuf.ptr();
+  char *haloBuf = (char*) ogs::o_haloBuf.ptr();
+#else
+  ogs->device.setStream(ogs::dataStream);
+  ogs->device.finish();
+  char *sendBuf = (char*) ogs::haloSendBuf;
+  char *haloBuf = (char*) ogs::haloBuf;
+#endif
+
+  // start of each field in the halo and send buffers
+  size_t *haloStarts = (size_t*) calloc(Nfields+1, sizeof(size_t));
+  size_t *sendStarts = (size_t*) calloc(Nfields+1, sizeof(size_t));
+  for (int f=0;f<Nfields;f++) {
+    haloStarts[f+1] = haloStarts[f] + (ogs->NhaloGather+ogs->NhaloExchange)*Nbytes[f];
+    sendStarts[f+1] = sendStarts[f] + ogs->NhaloExchange*Nbytes[f];
+  }
+
+  MPI_Datatype *types = NULL;
+  int      *blockLengths = NULL;
+  MPI_Aint *blockDispls  = NULL;
+  if (Nfields>1) {
+    types = (MPI_Datatype*) calloc(2*ogs->NhaloNeighbors, sizeof(MPI_Datatype));
+    blockLengths = (int*) calloc(Nfields, sizeof(int));
+    blockDispls  = (MPI_Aint*) calloc(Nfields, sizeof(MPI_Aint));
+  }
+
+  const int tag = 999;
+  for (int r=0;r<ogs->NhaloNeighbors;r++) {
+    const dlong offset = ogs->haloNeighborOffsets[r];
+    const dlong count  = ogs->haloNeighborOffsets[r+1]-offset;
+    char *recvBuf = haloBuf + (ogs->NhaloGather+offset)*Nbytes[0];
+    if (Nfields==1) {
+      MPI_Irecv(recvBuf, count*Nbytes[0], MPI_CHAR, ogs->haloNeighbors[r], tag, ogs->comm, ogs->haloRequests+r);
+    } else {
+      for (int f=0;f<Nfields;f++) {
+        blockLengths[f] = count*Nbytes[f];
+        blockDispls[f]  = haloStarts[f] + (ogs->NhaloGather+offset)*Nbytes[f];
+      }
+      MPI_Type_create_hindexed(Nfields, blockLengths, blockDispls, MPI_CHAR, types+r);
+      MPI_Type_commit(types+r);
+      MPI_Irecv(haloBuf, 1, types[r], ogs->haloNeighbors[r], tag, ogs->comm, ogs->haloRequests+r);
+    }
+  }
+  for (int r=0;r<ogs->NhaloNeighbors;r++) {
+    const dlong offset = ogs->haloNeighborOffsets[r];
+    const dlong count  = ogs->haloNeighborOffsets[r+1]-offset;
+    const int   s      = ogs->NhaloNeighbors+r;
+    if (Nfields==1) {
+      MPI_Isend(sendBuf+offset*Nbytes[0], count*Nbytes[0], MPI_CHAR, ogs->haloNeighbors[r], tag, ogs->comm, ogs->haloRequests+s);
+    } else {
+      for (int f=0;f<Nfields;f++) {
+        blockLengths[f] = count*Nbytes[f];
+        blockDispls[f]  = sendStarts[f] + offset*Nbytes[f];
+      }
+      MPI_Type_create_hindexed(Nfields, blockLengths, blockDispls, MPI_CHAR, types+s);
+      MPI_Type_commit(types+s);
+      MPI_Isend(sendBuf, 1, types[s], ogs->haloNeighbors[r], tag, ogs->comm, ogs->haloRequests+s);
+    }
+  }
+  MPI_Waitall(2*ogs->NhaloNeighbors, ogs->haloRequests, MPI_STATUSES_IGNORE);
+
+  if (Nfields>1) {
+    for (int r=0;r<2*ogs->NhaloNeighbors;r++) MPI_Type_free(types+r);
+    free(types); free(blockLengths); free(blockDispls);
+  }
+
+#ifndef OGS_GPU_AWARE_MPI
+  for (int f=0;f<Nfields;f++) {
+    const size_t recvStart = haloStarts[f] + ogs->NhaloGather*Nbytes[f];
+    ogs::o_haloBuf.copyFrom(haloBuf+recvStart, ogs->NhaloExchange*Nbytes[f], recvStart, "async: true");
+  }
+  ogs->device.finish();
+  ogs->device.setStream(ogs::defaultStream);
+#endif
+
+  free(haloStarts); free(sendStarts);
+}
+
+// gather the halo nodes, pack the exchange buffer and start copying it to the host
+void ogsExchangeStart(occa::memory o_v,
+                      occa::kernel &gatherKernel,
+                      occa::kernel &packKernel,
+                      const size_t Nbytes,
+                      ogs_t *ogs){
+
+  if (!ogs->NhaloGather) return;
+
+  ogsExchangeReserve(Nbytes, ogs);
+
+  gatherKernel(ogs->NhaloGather, ogs->o_haloGatherOffsets, ogs->o_haloGatherIds, o_v, ogs::o_haloBuf);
+
+  ogsExchangePack(packKernel, Nbytes, ogs);
+}
+
+// exchange with the neighbours, reduce and scatter back to the halo nodes of o_v
+void ogsExchangeFinish(occa::memory o_v,
+                       occa::kernel &gatherKernel,
+                       occa::kernel &scatterKernel,
+                       const size_t Nbytes,
+                       ogs_t *ogs){
+
+  if (!ogs->NhaloGather) return;
+
+  ogsExchangeMessages(1, &Nbytes, ogs);
+
+  // unpack with reduction. The send buffer is free again and, as every halo
+  //  gather node has at least one neighbour, large enough to hold the result
+  gatherKernel(ogs->NhaloGather, ogs->o_haloCombineOffsets, ogs->o_haloCombineIds, ogs::o_haloBuf, ogs::o_haloSendBuf);
+
+  // do scatter back to local nodes
+  scatterKernel(ogs->NhaloGather, ogs->o_haloGatherOffsets, ogs->o_haloGatherIds, ogs::o_haloSendBuf, o_v);
+}
+
+// start exchanging halo values that are already gathered (NhaloGather entries in o_gv)
+void ogsExchangeGatheredStart(occa::memory o_gv,
+                              occa::kernel &packKernel,
+                              const size_t Nbytes,
+                              ogs_t *ogs){
+
+  if (!ogs->NhaloGather) return;
+
+  ogsExchangeReserve(Nbytes, ogs);
+
+  ogs::o_haloBuf.copyFrom(o_gv, ogs->NhaloGather*Nbytes, 0, 0);
+
+  ogsExchangePack(packKernel, Nbytes, ogs);
+}
+
+// finish the exchange and reduce the gathered halo values of o_gv in place
+void ogsExchangeGatheredFinish(occa::memory o_gv,
+                               occa::kernel &gatherKernel,
+                               const size_t Nbytes,
+                               ogs_t *ogs){
+
+  if (!ogs->NhaloGather) return;
+
+  ogsExchangeMessages(1, &Nbytes, ogs);
+
+  gatherKernel(ogs->NhaloGather, ogs->o_haloCombineOffsets, ogs->o_haloCombineIds, ogs::o_haloBuf, o_gv);
+}
+
+// gather the halo nodes of several fields, pack them field after field and start
+//  copying the send buffer to the host
+void ogsExchangeFieldsStart(const int Nfields,
+                            ogsField_t *fields,
+                            ogs_t *ogs){
+
+  if (!ogs->NhaloGather) return;
+
+  size_t NbytesTotal = 0;
+  for (int f=0;f<Nfields;f++)
+    NbytesTotal += ogs::typeSize[ogs::typeId(fields[f].type)];
+
+  ogsExchangeReserve(NbytesTotal, ogs);
+
+  size_t haloStart = 0, sendStart = 0;
+  for (int f=0;f<Nfields;f++) {
+    const ogsTypeId_t t = ogs::typeId(fields[f].type);
+    const ogsOpId_t   o = ogs::opId(fields[f].op);
+    const size_t Nbytes = ogs::typeSize[t];
+
+    occa::memory o_haloBuf = ogs::o_haloBuf + haloStart;
+    occa::memory o_sendBuf = ogs::o_haloSendBuf + sendStart;
+
+    ogs::gatherKernels[t][o](ogs->NhaloGather, ogs->o_haloGatherOffsets, ogs->o_haloGatherIds, fields[f].o_v, o_haloBuf);
+    ogs::gatherKernels[t][ogsAddId](ogs->NhaloExchange, ogs->o_haloExchangeOffsets, ogs->o_haloExchangeIds, o_haloBuf, o_sendBuf);
+
+    haloStart += (ogs->NhaloGather+ogs->NhaloExchange)*Nbytes;
+    sendStart += ogs->NhaloExchange*Nbytes;
+  }
+
+  ogsExchangeSendToHost(NbytesTotal, ogs);
+}
+
+// exchange all fields with one message per neighbour, reduce and scatter back
+void ogsExchangeFieldsFinish(const int Nfields,
+                             ogsField_t *fields,
+                             ogs_t *ogs){
+
+  if (!ogs->NhaloGather) return;
+
+  size_t *Nbytes = (size_t*) calloc(Nfields, sizeof(size_t));
+  for (int f=0;f<Nfields;f++)
+    Nbytes[f] = ogs::typeSize[ogs::typeId(fields[f].type)];
+
+  ogsExchangeMessages(Nfields, Nbytes, ogs);
+
+  size_t haloStart = 0, sendStart = 0;
+  for (int f=0;f<Nfields;f++) {
+    const ogsTypeId_t t = ogs::typeId(fields[f].type);
+    const ogsOpId_t   o = ogs::opId(fields[f].op);
+
+    occa::memory o_haloBuf = ogs::o_haloBuf + haloStart;
+    occa::memory o_sendBuf = ogs::o_haloSendBuf + sendStart;
+
+    // the field's slice of the send buffer holds its reduced halo values
+    ogs::gatherKernels[t][o](ogs->NhaloGather, ogs->o_haloCombineOffsets, ogs->o_haloCombineIds, o_haloBuf, o_sendBuf);
+    ogs::scatterKernels[t](ogs->NhaloGather, ogs->o_haloGatherOffsets, ogs->o_haloGatherIds, o_sendBuf, fields[f].o_v);
+
+    haloStart += (ogs->NhaloGather+ogs->NhaloExchange)*Nbytes[f];
+    sendStart += ogs->NhaloExchange*Nbytes[f];
+  }
+
+  free(Nbytes);
+}
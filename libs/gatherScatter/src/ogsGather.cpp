@@ -103,7 +103,7 @@ void ogsGatherFinish(occa::memory o_gv,
     ogs->device.finish();
 
     // MPI based gather using libgs
-    ogsHostGather(ogs::haloBuf, type, op, ogs->haloGshNonSym);
+    ogsHostGather(ogs::haloBuf, type, op, ogsGsh(ogs->haloGshNonSym));
 
     // copy totally gather halo data back from HOST to DEVICE
     if (ogs->NownedHalo)
@@ -164,7 +164,7 @@ void ogsGather_add(void *gv, void *v, const size_t Nbytes, const char *type, ogs
 
   if (ogs->NhaloGather) {
     // MPI based scatter using gslib
-    ogsHostGather(ogs::hostBuf, type, ogsAdd, ogs->haloGshNonSym);
+    ogsHostGather(ogs::hostBuf, type, ogsAdd, ogsGsh(ogs->haloGshNonSym));
     
     if (ogs->NownedHalo)
       memcpy((char*)gv+ogs->NlocalGather*Nbytes, ogs::hostBuf, ogs->NownedHalo*Nbytes);
@@ -201,7 +201,7 @@ void ogsGather_mul(void *gv, void *v, const size_t Nbytes, const char *type, ogs
 
   if (ogs->NhaloGather) {
     // MPI based scatter using gslib
-    ogsHostGather(ogs::hostBuf, type, ogsMul, ogs->haloGshNonSym);
+    ogsHostGather(ogs::hostBuf, type, ogsMul, ogsGsh(ogs->haloGshNonSym));
     
     if (ogs->NownedHalo)
       memcpy((char*)gv+ogs->NlocalGather*Nbytes, ogs::hostBuf, ogs->NownedHalo*Nbytes);
@@ -238,7 +238,7 @@ void ogsGather_min(void *gv, void *v, const size_t Nbytes, const char *type, ogs
 
   if (ogs->NhaloGather) {
     // MPI based scatter using gslib
-    ogsHostGather(ogs::hostBuf, type, ogsMin, ogs->haloGshNonSym);
+    ogsHostGather(ogs::hostBuf, type, ogsMin, ogsGsh(ogs->haloGshNonSym));
     
     if (ogs->NownedHalo)
       memcpy((char*)gv+ogs->NlocalGather*Nbytes, ogs::hostBuf, ogs->NownedHalo*Nbytes);
@@ -275,7 +275,7 @@ void ogsGather_max(void *gv, void *v, const size_t Nbytes, const char *type, ogs
 
   if (ogs->NhaloGather) {
     // MPI based scatter using gslib
-    ogsHostGather(ogs::hostBuf, type, ogsMax, ogs->haloGshNonSym);
+    ogsHostGather(ogs::hostBuf, type, ogsMax, ogsGsh(ogs->haloGshNonSym));
     
     if (ogs->NownedHalo)
       memcpy((char*)gv+ogs->NlocalGather*Nbytes, ogs::hostBuf, ogs->NownedHalo*Nbytes);
@@ -302,37 +302,5 @@ void occaGather(const  dlong Ngather,
                 const char* op,
                 occa::memory  o_v,
                 occa::memory  o_gv) {
-  
-  if      ((!strcmp(type, "float"))&&(!strcmp(op, "add"))) 
-    ogs::gatherKernel_floatAdd(Ngather, o_gatherStarts, o_gatherIds, o_v, o_gv);
-  else if ((!strcmp(type, "float"))&&(!strcmp(op, "mul"))) 
-    ogs::gatherKernel_floatMul(Ngather, o_gatherStarts, o_gatherIds, o_v, o_gv);
-  else if ((!strcmp(type, "float"))&&(!strcmp(op, "min"))) 
-    ogs::gatherKernel_floatMin(Ngather, o_gatherStarts, o_gatherIds, o_v, o_gv);
-  else if ((!strcmp(type, "float"))&&(!strcmp(op, "max"))) 
-    ogs::gatherKernel_floatMax(Ngather, o_gatherStarts, o_gatherIds, o_v, o_gv);
-  else if ((!strcmp(type, "double"))&&(!strcmp(op, "add"))) 
-    ogs::gatherKernel_doubleAdd(Ngather, o_gatherStarts, o_gatherIds, o_v, o_gv);
-  else if ((!strcmp(type, "double"))&&(!strcmp(op, "mul"))) 
-    ogs::gatherKernel_doubleMul(Ngather, o_gatherStarts, o_gatherIds, o_v, o_gv);
-  else if ((!strcmp(type, "double"))&&(!strcmp(op, "min"))) 
-    ogs::gatherKernel_doubleMin(Ngather, o_gatherStarts, o_gatherIds, o_v, o_gv);
-  else if ((!strcmp(type, "double"))&&(!strcmp(op, "max"))) 
-    ogs::gatherKernel_doubleMax(Ngather, o_gatherStarts, o_gatherIds, o_v, o_gv);
-  else if ((!strcmp(type, "int"))&&(!strcmp(op, "add"))) 
-    ogs::gatherKernel_intAdd(Ngather, o_gatherStarts, o_gatherIds, o_v, o_gv);
-  else if ((!strcmp(type, "int"))&&(!strcmp(op, "mul"))) 
-    ogs::gatherKernel_intMul(Ngather, o_gatherStarts, o_gatherIds, o_v, o_gv);
-  else if ((!strcmp(type, "int"))&&(!strcmp(op, "min"))) 
-    ogs::gatherKernel_intMin(Ngather, o_gatherStarts, o_gatherIds, o_v, o_gv);
-  else if ((!strcmp(type, "int"))&&(!strcmp(op, "max"))) 
-    ogs::gatherKernel_intMax(Ngather, o_gatherStarts, o_gatherIds, o_v, o_gv);
-  else if ((!strcmp(type, "long long int"))&&(!strcmp(op, "add"))) 
-    ogs::gatherKernel_longAdd(Ngather, o_gatherStarts, o_gatherIds, o_v, o_gv);
-  else if ((!strcmp(type, "long long int"))&&(!strcmp(op, "mul"))) 
-    ogs::gatherKernel_longMul(Ngather, o_gatherStarts, o_gatherIds, o_v, o_gv);
-  else if ((!strcmp(type, "long long int"))&&(!strcmp(op, "min"))) 
-    ogs::gatherKernel_longMin(Ngather, o_gatherStarts, o_gatherIds, o_v, o_gv);
-  else if ((!strcmp(type, "long long int"))&&(!strcmp(op, "max"))) 
-    ogs::gatherKernel_longMax(Ngather, o_gatherStarts, o_gatherIds, o_v, o_gv);
+  ogs::gatherKernels[ogs::typeId(type)][ogs::opId(op)](Ngather, o_gatherStarts, o_gatherIds, o_v, o_gv);
 }
\ No newline at end of file
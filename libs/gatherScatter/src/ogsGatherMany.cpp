@@ -115,7 +115,7 @@ void ogsGatherManyFinish(occa::memory o_gv,
     for (int i=0;i<k;i++) H[i] = (char*)ogs::haloBuf + i*ogs->NhaloGather*Nbytes;
 
     // MPI based gather using libgs
-    ogsHostGatherMany(H, k, type, op, ogs->haloGshNonSym);
+    ogsHostGatherMany(H, k, type, op, ogsGsh(ogs->haloGshNonSym));
 
     // copy totally gather halo data back from HOST to DEVICE
     if (ogs->NownedHalo)
@@ -187,7 +187,7 @@ void ogsGatherMany_add(void *gv, void *v, const int k, const dlong gstride, cons
     void* H[k];
     for (int i=0;i<k;i++) H[i] = (char*)ogs::hostBuf + i*ogs->NhaloGather*Nbytes;
 
-    ogsHostGatherMany(H, k, type, ogsAdd, ogs->haloGshNonSym);
+    ogsHostGatherMany(H, k, type, ogsAdd, ogsGsh(ogs->haloGshNonSym));
     
     if (ogs->NownedHalo)
       for (int i=0;i<k;i++)
@@ -237,7 +237,7 @@ void ogsGatherMany_mul(void *gv, void *v, const int k, const dlong gstride, cons
     void* H[k];
     for (int i=0;i<k;i++) H[i] = (char*)ogs::hostBuf + i*ogs->NhaloGather*Nbytes;
 
-    ogsHostGatherMany(H, k, type, ogsAdd, ogs->haloGshNonSym);
+    ogsHostGatherMany(H, k, type, ogsAdd, ogsGsh(ogs->haloGshNonSym));
     
     if (ogs->NownedHalo)
       for (int i=0;i<k;i++)
@@ -287,7 +287,7 @@ void ogsGatherMany_min(void *gv, void *v, const int k, const dlong gstride, cons
     void* H[k];
     for (int i=0;i<k;i++) H[i] = (char*)ogs::hostBuf + i*ogs->NhaloGather*Nbytes;
 
-    ogsHostGatherMany(H, k, type, ogsAdd, ogs->haloGshNonSym);
+    ogsHostGatherMany(H, k, type, ogsAdd, ogsGsh(ogs->haloGshNonSym));
     
     if (ogs->NownedHalo)
       for (int i=0;i<k;i++)
@@ -337,7 +337,7 @@ void ogsGatherMany_max(void *gv, void *v, const int k, const dlong gstride, cons
     void* H[k];
     for (int i=0;i<k;i++) H[i] = (char*)ogs::hostBuf + i*ogs->NhaloGather*Nbytes;
 
-    ogsHostGatherMany(H, k, type, ogsAdd, ogs->haloGshNonSym);
+    ogsHostGatherMany(H, k, type, ogsAdd, ogsGsh(ogs->haloGshNonSym));
     
     if (ogs->NownedHalo)
       for (int i=0;i<k;i++)
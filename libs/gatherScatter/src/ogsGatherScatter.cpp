@@ -32,7 +32,7 @@ void ogsGatherScatter(void *v,
                       const char *type, 
                       const char *op, 
                       ogs_t *ogs){
-  ogsHostGatherScatter(v, type, op, ogs->hostGsh);
+  ogsHostGatherScatter(v, type, op, ogsGsh(ogs->hostGsh));
 }
 
 void ogsGatherScatter(occa::memory o_v, 
@@ -47,33 +47,11 @@ void ogsGatherScatterStart(occa::memory o_v,
                           const char *type, 
                           const char *op, 
                           ogs_t *ogs){
-  size_t Nbytes;
-  if (!strcmp(type, "float")) 
-    Nbytes = sizeof(float);
-  else if (!strcmp(type, "double")) 
-    Nbytes = sizeof(double);
-  else if (!strcmp(type, "int")) 
-    Nbytes = sizeof(int);
-  else if (!strcmp(type, "long long int")) 
-    Nbytes = sizeof(long long int);
-
-  if (ogs->NhaloGather) {
-    if (ogs::o_haloBuf.size() < ogs->NhaloGather*Nbytes) {
-      if (ogs::o_haloBuf.size()) ogs::o_haloBuf.free();
-      ogs::o_haloBuf = ogs->device.mappedAlloc(ogs->NhaloGather*Nbytes);
-      ogs::haloBuf = ogs::o_haloBuf.getMappedPointer();
-    }
-  }
+  const ogsTypeId_t t = ogs::typeId(type);
+  const ogsOpId_t   o = ogs::opId(op);
 
-  // gather halo nodes on device
-  if (ogs->NhaloGather) {
-    occaGather(ogs->NhaloGather, ogs->o_haloGatherOffsets, ogs->o_haloGatherIds, type, op, o_v, ogs::o_haloBuf);
-    
-    ogs->device.finish();
-    ogs->device.setStream(ogs::dataStream);
-    ogs::o_haloBuf.copyTo(ogs::haloBuf, ogs->NhaloGather*Nbytes, 0, "async: true");
-    ogs->device.setStream(ogs::defaultStream);
-  }
+  // gather halo nodes on device and start the exchange
+  ogsExchangeStart(o_v, ogs::gatherKernels[t][o], ogs::gatherKernels[t][ogsAddId], ogs::typeSize[t], ogs);
 }
 
 
@@ -81,74 +59,151 @@ void ogsGatherScatterFinish(occa::memory o_v,
                           const char *type, 
                           const char *op, 
                           ogs_t *ogs){
-  size_t Nbytes;
-  if (!strcmp(type, "float")) 
-    Nbytes = sizeof(float);
-  else if (!strcmp(type, "double")) 
-    Nbytes = sizeof(double);
-  else if (!strcmp(type, "int")) 
-    Nbytes = sizeof(int);
-  else if (!strcmp(type, "long long int")) 
-    Nbytes = sizeof(long long int);
+  const ogsTypeId_t t = ogs::typeId(type);
+  const ogsOpId_t   o = ogs::opId(op);
 
   if(ogs->NlocalGather) {
-    occaGatherScatter(ogs->NlocalGather, ogs->o_localGatherOffsets, ogs->o_localGatherIds, type, op, o_v);
+    occa::kernel *degreeKernels = (o==ogsAddId) ? ogs::gatherScatterDegreeKernels[t] : NULL;
+    ogsLocalGatherScatter(o_v, ogs::gatherScatterKernels[t][o], degreeKernels, ogs);
   }
 
-  if (ogs->NhaloGather) {
-    ogs->device.setStream(ogs::dataStream);
-    ogs->device.finish();
+  // native halo exchange, reduction and scatter back to local nodes
+  ogsExchangeFinish(o_v, ogs::gatherKernels[t][o], ogs::scatterKernels[t], ogs::typeSize[t], ogs);
+}
+
+// local gather-scatter over the degree groups. Degree 1 nodes are skipped
+void ogsLocalGatherScatter(occa::memory o_v,
+                           occa::kernel &gatherScatterKernel,
+                           occa::kernel *degreeKernels,
+                           ogs_t *ogs){
+
+  const dlong *starts = ogs->localGroupStarts;
 
-    // MPI based gather scatter using libgs
-    ogsHostGatherScatter(ogs::haloBuf, type, op, ogs->haloGshSym);
+  if (degreeKernels && degreeKernels[0].isInitialized()) {
+    for (int d=0;d<3;d++) {
+      const dlong Ngroup = starts[d+1]-starts[d];
+      if (!Ngroup) continue;
 
-    // copy totally gather halo data back from HOST to DEVICE
-    ogs::o_haloBuf.copyFrom(ogs::haloBuf, ogs->NhaloGather*Nbytes, 0, "async: true");
+      const dlong offset = ogs->localGatherOffsets[starts[d]];
+      degreeKernels[d](Ngroup, ogs->o_localGatherIds + offset*sizeof(dlong), o_v);
+    }
 
-    // do scatter back to local nodes
-    occaScatter(ogs->NhaloGather, ogs->o_haloGatherOffsets, ogs->o_haloGatherIds, type, op, ogs::o_haloBuf, o_v);
-    ogs->device.finish();
-    ogs->device.setStream(ogs::defaultStream);
+    const dlong Nother = starts[4]-starts[3];
+    if (Nother)
+      gatherScatterKernel(Nother, ogs->o_localGatherOffsets + starts[3]*sizeof(dlong), ogs->o_localGatherIds, o_v);
+  } else {
+    if (starts[4])
+      gatherScatterKernel(starts[4], ogs->o_localGatherOffsets, ogs->o_localGatherIds, o_v);
   }
 }
 
+ogsHandle_t *ogsHandleSetup(const char *type, 
+                            const char *op, 
+                            ogs_t *ogs){
+
+  ogsHandle_t *h = new ogsHandle_t();
+
+  const ogsTypeId_t t = ogs::typeId(type);
+  const ogsOpId_t   o = ogs::opId(op);
+
+  h->ogs = ogs;
+  h->Nbytes = ogs::typeSize[t];
+
+  h->gatherScatterKernel = ogs::gatherScatterKernels[t][o];
+  h->degreeKernels       = (o==ogsAddId) ? ogs::gatherScatterDegreeKernels[t] : NULL;
+  h->gatherKernel        = ogs::gatherKernels[t][o];
+  h->packKernel          = ogs::gatherKernels[t][ogsAddId];
+  h->scatterKernel       = ogs::scatterKernels[t];
+
+  return h;
+}
+
+void ogsHandleFree(ogsHandle_t *h){
+  delete h;
+}
+
+void ogsGatherScatter(occa::memory o_v, ogsHandle_t *h){
+  ogsGatherScatterStart (o_v, h);
+  ogsGatherScatterFinish(o_v, h);
+}
+
+void ogsGatherScatterStart(occa::memory o_v, ogsHandle_t *h){
+  ogsExchangeStart(o_v, h->gatherKernel, h->packKernel, h->Nbytes, h->ogs);
+}
+
+void ogsGatherScatterFinish(occa::memory o_v, ogsHandle_t *h){
+  ogs_t *ogs = h->ogs;
+
+  if(ogs->NlocalGather) {
+    ogsLocalGatherScatter(o_v, h->gatherScatterKernel, h->degreeKernels, ogs);
+  }
+
+  ogsExchangeFinish(o_v, h->gatherKernel, h->scatterKernel, h->Nbytes, ogs);
+}
+
+void ogsHaloExchangeStart(occa::memory o_gv, ogsHandle_t *h){
+  ogsExchangeGatheredStart(o_gv, h->packKernel, h->Nbytes, h->ogs);
+}
+
+void ogsHaloExchangeFinish(occa::memory o_gv, ogsHandle_t *h){
+  ogsExchangeGatheredFinish(o_gv, h->gatherKernel, h->Nbytes, h->ogs);
+}
+
+void ogsGatherScatterFields(const int Nfields, ogsField_t *fields, ogs_t *ogs){
+  ogsGatherScatterFieldsStart (Nfields, fields, ogs);
+  ogsGatherScatterFieldsFinish(Nfields, fields, ogs);
+}
+
+void ogsGatherScatterFieldsStart(const int Nfields, ogsField_t *fields, ogs_t *ogs){
+  ogsExchangeFieldsStart(Nfields, fields, ogs);
+}
+
+// true when every field shares one type and the add op, and that type has a
+// multi-field kernel
+static int ogsFieldsShareAdd(const int Nfields, ogsField_t *fields){
+  const ogsTypeId_t t = ogs::typeId(fields[0].type);
+  if (!ogs::gatherScatterFieldsKernels[t].isInitialized()) return 0;
+
+  for (int f=0;f<Nfields;f++)
+    if (ogs::typeId(fields[f].type)!=t || ogs::opId(fields[f].op)!=ogsAddId) return 0;
+
+  return 1;
+}
+
+void ogsGatherScatterFieldsFinish(const int Nfields, ogsField_t *fields, ogs_t *ogs){
+
+  if(ogs->NlocalGather && ogs->localGroupStarts[4] && ogsFieldsShareAdd(Nfields, fields)) {
+    // one launch per gatherScatterMaxFields fields, unused slots repeat the first field
+    const ogsTypeId_t t = ogs::typeId(fields[0].type);
+    const int Nmax = ogs::gatherScatterMaxFields;
+
+    for (int f0=0;f0<Nfields;f0+=Nmax) {
+      const int Nchunk = (Nfields-f0<Nmax) ? Nfields-f0 : Nmax;
+      occa::memory o_q[4];
+      for (int f=0;f<Nmax;f++)
+        o_q[f] = fields[f0 + ((f<Nchunk) ? f : 0)].o_v;
+
+      ogs::gatherScatterFieldsKernels[t](ogs->localGroupStarts[4], Nchunk,
+                                         ogs->o_localGatherOffsets, ogs->o_localGatherIds,
+                                         o_q[0], o_q[1], o_q[2], o_q[3]);
+    }
+  } else if(ogs->NlocalGather) {
+    for (int f=0;f<Nfields;f++) {
+      const ogsTypeId_t t = ogs::typeId(fields[f].type);
+      const ogsOpId_t   o = ogs::opId(fields[f].op);
+      occa::kernel *degreeKernels = (o==ogsAddId) ? ogs::gatherScatterDegreeKernels[t] : NULL;
+      ogsLocalGatherScatter(fields[f].o_v, ogs::gatherScatterKernels[t][o], degreeKernels, ogs);
+    }
+  }
+
+  ogsExchangeFieldsFinish(Nfields, fields, ogs);
+}
+
 void occaGatherScatter(const  dlong Ngather,
                 occa::memory o_gatherStarts,
                 occa::memory o_gatherIds,
                 const char* type,
                 const char* op,
                 occa::memory  o_v) {
-  
-  if      ((!strcmp(type, "float"))&&(!strcmp(op, "add"))) 
-    ogs::gatherScatterKernel_floatAdd(Ngather, o_gatherStarts, o_gatherIds, o_v);
-  else if ((!strcmp(type, "float"))&&(!strcmp(op, "mul"))) 
-    ogs::gatherScatterKernel_floatMul(Ngather, o_gatherStarts, o_gatherIds, o_v);
-  else if ((!strcmp(type, "float"))&&(!strcmp(op, "min"))) 
-    ogs::gatherScatterKernel_floatMin(Ngather, o_gatherStarts, o_gatherIds, o_v);
-  else if ((!strcmp(type, "float"))&&(!strcmp(op, "max"))) 
-    ogs::gatherScatterKernel_floatMax(Ngather, o_gatherStarts, o_gatherIds, o_v);
-  else if ((!strcmp(type, "double"))&&(!strcmp(op, "add"))) 
-    ogs::gatherScatterKernel_doubleAdd(Ngather, o_gatherStarts, o_gatherIds, o_v);
-  else if ((!strcmp(type, "double"))&&(!strcmp(op, "mul"))) 
-    ogs::gatherScatterKernel_doubleMul(Ngather, o_gatherStarts, o_gatherIds, o_v);
-  else if ((!strcmp(type, "double"))&&(!strcmp(op, "min"))) 
-    ogs::gatherScatterKernel_doubleMin(Ngather, o_gatherStarts, o_gatherIds, o_v);
-  else if ((!strcmp(type, "double"))&&(!strcmp(op, "max"))) 
-    ogs::gatherScatterKernel_doubleMax(Ngather, o_gatherStarts, o_gatherIds, o_v);
-  else if ((!strcmp(type, "int"))&&(!strcmp(op, "add"))) 
-    ogs::gatherScatterKernel_intAdd(Ngather, o_gatherStarts, o_gatherIds, o_v);
-  else if ((!strcmp(type, "int"))&&(!strcmp(op, "mul"))) 
-    ogs::gatherScatterKernel_intMul(Ngather, o_gatherStarts, o_gatherIds, o_v);
-  else if ((!strcmp(type, "int"))&&(!strcmp(op, "min"))) 
-    ogs::gatherScatterKernel_intMin(Ngather, o_gatherStarts, o_gatherIds, o_v);
-  else if ((!strcmp(type, "int"))&&(!strcmp(op, "max"))) 
-    ogs::gatherScatterKernel_intMax(Ngather, o_gatherStarts, o_gatherIds, o_v);
-  else if ((!strcmp(type, "long long int"))&&(!strcmp(op, "add"))) 
-    ogs::gatherScatterKernel_longAdd(Ngather, o_gatherStarts, o_gatherIds, o_v);
-  else if ((!strcmp(type, "long long int"))&&(!strcmp(op, "mul"))) 
-    ogs::gatherScatterKernel_longMul(Ngather, o_gatherStarts, o_gatherIds, o_v);
-  else if ((!strcmp(type, "long long int"))&&(!strcmp(op, "min"))) 
-    ogs::gatherScatterKernel_longMin(Ngather, o_gatherStarts, o_gatherIds, o_v);
-  else if ((!strcmp(type, "long long int"))&&(!strcmp(op, "max"))) 
-    ogs::gatherScatterKernel_longMax(Ngather, o_gatherStarts, o_gatherIds, o_v);
+  ogs::gatherScatterKernels[ogs::typeId(type)][ogs::opId(op)](Ngather, o_gatherStarts, o_gatherIds, o_v);
 }
\ No newline at end of file
@@ -48,7 +48,7 @@ void ogsGatherScatterMany(void *v,
   void* V[k];
   for (int i=0;i<k;i++) V[i] = (char*)v + i*stride*Nbytes;
 
-  ogsHostGatherScatterMany(V, k, type, op, ogs->hostGsh);
+  ogsHostGatherScatterMany(V, k, type, op, ogsGsh(ogs->hostGsh));
 }
 
 void ogsGatherScatterMany(occa::memory o_v, 
@@ -126,7 +126,7 @@ void ogsGatherScatterManyFinish(occa::memory o_v,
     for (int i=0;i<k;i++) H[i] = (char*)ogs::haloBuf + i*ogs->NhaloGather*Nbytes;
 
     // MPI based gather scatter using libgs
-    ogsHostGatherScatterMany(H, k, type, op, ogs->haloGshSym);
+    ogsHostGatherScatterMany(H, k, type, op, ogsGsh(ogs->haloGshSym));
 
     // copy totally gather halo data back from HOST to DEVICE
     ogs::o_haloBuf.copyFrom(ogs::haloBuf, ogs->NhaloGather*Nbytes*k, 0, "async: true");
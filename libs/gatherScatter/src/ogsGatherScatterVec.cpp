@@ -33,7 +33,7 @@ void ogsGatherScatterVec(void *v,
                       const char *type, 
                       const char *op, 
                       ogs_t *ogs){
-  ogsHostGatherScatterVec(v, k, type, op, ogs->hostGsh);
+  ogsHostGatherScatterVec(v, k, type, op, ogsGsh(ogs->hostGsh));
 }
 
 void ogsGatherScatterVec(occa::memory o_v, 
@@ -105,7 +105,7 @@ void ogsGatherScatterVecFinish(occa::memory o_v,
     ogs->device.finish();
 
     // MPI based gather scatter using libgs
-    ogsHostGatherScatterVec(ogs::haloBuf, k, type, op, ogs->haloGshSym);
+    ogsHostGatherScatterVec(ogs::haloBuf, k, type, op, ogsGsh(ogs->haloGshSym));
 
     // copy totally gather halo data back from HOST to DEVICE
     ogs::o_haloBuf.copyFrom(ogs::haloBuf, ogs->NhaloGather*Nbytes*k, 0, "async: true");
@@ -106,7 +106,7 @@ void ogsGatherVecFinish(occa::memory o_gv,
     ogs->device.finish();
 
     // MPI based gather using libgs
-    ogsHostGatherVec(ogs::haloBuf, k, type, op, ogs->haloGshNonSym);
+    ogsHostGatherVec(ogs::haloBuf, k, type, op, ogsGsh(ogs->haloGshNonSym));
 
     // copy totally gather halo data back from HOST to DEVICE
     if (ogs->NownedHalo)
@@ -167,7 +167,7 @@ void ogsGatherVec_add(void *gv, void *v, const int k, const size_t Nbytes, const
                       ogs->haloGatherIds, (long long int*)v, (long long int*)ogs::hostBuf);
 
   if (ogs->NhaloGather) {
-    ogsHostGatherVec(ogs::hostBuf, k, type, ogsAdd, ogs->haloGshNonSym);
+    ogsHostGatherVec(ogs::hostBuf, k, type, ogsAdd, ogsGsh(ogs->haloGshNonSym));
     
     if (ogs->NownedHalo)
       memcpy((char*)gv+ogs->NlocalGather*Nbytes*k, ogs::hostBuf, ogs->NownedHalo*Nbytes*k);
@@ -203,7 +203,7 @@ void ogsGatherVec_mul(void *gv, void *v, const int k, const size_t Nbytes, const
                       ogs->haloGatherIds, (long long int*)v, (long long int*)ogs::hostBuf);
 
   if (ogs->NhaloGather) {
-    ogsHostGatherVec(ogs::hostBuf, k, type, ogsMul, ogs->haloGshNonSym);
+    ogsHostGatherVec(ogs::hostBuf, k, type, ogsMul, ogsGsh(ogs->haloGshNonSym));
     
     if (ogs->NownedHalo)
       memcpy((char*)gv+ogs->NlocalGather*Nbytes*k, ogs::hostBuf, ogs->NownedHalo*Nbytes*k);
@@ -239,7 +239,7 @@ void ogsGatherVec_min(void *gv, void *v, const int k, const size_t Nbytes, const
                       ogs->haloGatherIds, (long long int*)v, (long long int*)ogs::hostBuf);
 
   if (ogs->NhaloGather) {
-    ogsHostGatherVec(ogs::hostBuf, k, type, ogsMin, ogs->haloGshNonSym);
+    ogsHostGatherVec(ogs::hostBuf, k, type, ogsMin, ogsGsh(ogs->haloGshNonSym));
     
     if (ogs->NownedHalo)
       memcpy((char*)gv+ogs->NlocalGather*Nbytes*k, ogs::hostBuf, ogs->NownedHalo*Nbytes*k);
@@ -275,7 +275,7 @@ void ogsGatherVec_max(void *gv, void *v, const int k, const size_t Nbytes, const
                       ogs->haloGatherIds, (long long int*)v, (long long int*)ogs::hostBuf);
 
   if (ogs->NhaloGather) {
-    ogsHostGatherVec(ogs::hostBuf, k, type, ogsMax, ogs->haloGshNonSym);
+    ogsHostGatherVec(ogs::hostBuf, k, type, ogsMax, ogsGsh(ogs->haloGshNonSym));
     
     if (ogs->NownedHalo)
       memcpy((char*)gv+ogs->NlocalGather*Nbytes*k, ogs::hostBuf, ogs->NownedHalo*Nbytes*k);
@@ -0,0 +1,127 @@
+/*
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Tim Warburton, Noel Chalmers, Jesse Chan, Ali Karakus
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "ogs.hpp"
+#include "ogsKernels.hpp"
+#include "ogsInterface.h"
+
+// Lazily built gslib handles
+//  gs_setup runs a crystal-router discovery, so the gslib handles are only built
+//  the first time they are used, and ogs objects with identical id sets on every
+//  rank share a single handle.
+
+struct ogsGsh_t {
+
+  MPI_Comm comm;
+  dlong N;
+  hlong *ids;
+  unsigned long long hash;
+
+  int serial;  // registration number, identical on all ranks
+  int Nrefs;
+
+  void *gsh;   // gslib handle, NULL until first use
+
+  ogsGsh_t *next;
+};
+
+namespace ogs {
+  static ogsGsh_t *gshList = NULL;
+  static int gshSerial = 0;
+}
+
+static unsigned long long ogsHashIds(dlong N, hlong *ids){
+  // FNV-1a
+  unsigned long long h = 14695981039346656037ULL;
+  const unsigned char *c = (const unsigned char*) ids;
+  for (size_t n=0;n<N*sizeof(hlong);n++) {
+    h ^= c[n];
+    h *= 1099511628211ULL;
+  }
+  return h;
+}
+
+// collective: all ranks must register the same sequence of id sets
+ogsGsh_t *ogsGshSetup(MPI_Comm comm, dlong N, hlong *ids){
+
+  unsigned long long hash = ogsHashIds(N, ids);
+
+  //look for a handle with the same ids on this rank
+  ogsGsh_t *match = NULL;
+  for (ogsGsh_t *g=ogs::gshList;g;g=g->next) {
+    if (g->comm!=comm || g->N!=N || g->hash!=hash) continue;
+    if (N && memcmp(g->ids, ids, N*sizeof(hlong))) continue;
+    match = g;
+    break;
+  }
+
+  //only share if every rank matched the same handle
+  int serial = match ? match->serial : -1;
+  int minSerial, maxSerial;
+  MPI_Allreduce(&serial, &minSerial, 1, MPI_INT, MPI_MIN, comm);
+  MPI_Allreduce(&serial, &maxSerial, 1, MPI_INT, MPI_MAX, comm);
+
+  if (match && minSerial==maxSerial) {
+    match->Nrefs++;
+    return match;
+  }
+
+  ogsGsh_t *g = new ogsGsh_t();
+  g->comm = comm;
+  g->N = N;
+  g->ids = (hlong*) malloc((N+1)*sizeof(hlong));
+  if (N) memcpy(g->ids, ids, N*sizeof(hlong));
+  g->hash = hash;
+  g->serial = ogs::gshSerial++;
+  g->Nrefs = 1;
+  g->gsh = NULL;
+
+  g->next = ogs::gshList;
+  ogs::gshList = g;
+
+  return g;
+}
+
+// the gslib handle, built on first use
+void *ogsGsh(ogsGsh_t *g){
+  if (!g->gsh)
+    g->gsh = ogsHostSetup(g->comm, g->N, g->ids, 0, 0);
+  return g->gsh;
+}
+
+void ogsGshFree(ogsGsh_t *g){
+
+  if (--g->Nrefs) return;
+
+  if (g->gsh) ogsHostFree(g->gsh);
+  free(g->ids);
+
+  ogsGsh_t **prev = &ogs::gshList;
+  while (*prev!=g) prev = &((*prev)->next);
+  *prev = g->next;
+
+  delete g;
+}
@@ -37,9 +37,24 @@ namespace ogs {
   void* haloBuf;
   occa::memory o_haloBuf;
 
+  void* haloSendBuf;
+  occa::memory o_haloSendBuf;
+
   occa::stream defaultStream;
   occa::stream dataStream;
 
+  const size_t typeSize[ogsNtypes] = {sizeof(float), sizeof(double), sizeof(int), sizeof(long long int)};
+
+  occa::kernel gatherScatterKernels[ogsNtypes][ogsNops];
+  occa::kernel gatherKernels[ogsNtypes][ogsNops];
+  occa::kernel scatterKernels[ogsNtypes];
+
+  const int gatherScatterDegrees[3] = {2, 4, 8};
+  occa::kernel gatherScatterDegreeKernels[ogsNtypes][3];
+
+  const int gatherScatterMaxFields = 4;
+  occa::kernel gatherScatterFieldsKernels[ogsNtypes];
+
   occa::kernel gatherScatterKernel_floatAdd;
   occa::kernel gatherScatterKernel_floatMul;
   occa::kernel gatherScatterKernel_floatMin;
@@ -153,6 +168,28 @@ namespace ogs {
 }
 
 
+ogsTypeId_t ogs::typeId(const char *type) {
+  if      (!strcmp(type, "float"))  return ogsFloatId;
+  else if (!strcmp(type, "double")) return ogsDoubleId;
+  else if (!strcmp(type, "int"))    return ogsIntId;
+  else if (!strcmp(type, "long long int")) return ogsLongId;
+
+  printf("ERROR: unknown ogs type %s\n", type);
+  exit(-1);
+  return ogsNtypes;
+}
+
+ogsOpId_t ogs::opId(const char *op) {
+  if      (!strcmp(op, "add")) return ogsAddId;
+  else if (!strcmp(op, "mul")) return ogsMulId;
+  else if (!strcmp(op, "min")) return ogsMinId;
+  else if (!strcmp(op, "max")) return ogsMaxId;
+
+  printf("ERROR: unknown ogs op %s\n", op);
+  exit(-1);
+  return ogsNops;
+}
+
 void ogs::initKernels(MPI_Comm comm, occa::device device) {
 
   int rank, size;
@@ -221,6 +258,18 @@ void ogs::initKernels(MPI_Comm comm, occa::device device) {
       ogs::gatherScatterKernel_longMin = device.buildKernel(DOGS "/okl/gatherScatter.okl", "gatherScatter_longMin", kernelInfo);
       ogs::gatherScatterKernel_longMax = device.buildKernel(DOGS "/okl/gatherScatter.okl", "gatherScatter_longMax", kernelInfo);
 
+      for (int d=0;d<3;d++) {
+        occa::properties degreeInfo = kernelInfo;
+        degreeInfo["defines/" "p_gsDegree"] = ogs::gatherScatterDegrees[d];
+        ogs::gatherScatterDegreeKernels[ogsFloatId][d]  = device.buildKernel(DOGS "/okl/gatherScatterDegree.okl", "gatherScatterDegree_floatAdd", degreeInfo);
+        ogs::gatherScatterDegreeKernels[ogsDoubleId][d] = device.buildKernel(DOGS "/okl/gatherScatterDegree.okl", "gatherScatterDegree_doubleAdd", degreeInfo);
+      }
+
+      occa::properties fieldsInfo = kernelInfo;
+      fieldsInfo["defines/" "p_gsMaxFields"] = ogs::gatherScatterMaxFields;
+      ogs::gatherScatterFieldsKernels[ogsFloatId]  = device.buildKernel(DOGS "/okl/gatherScatterFields.okl", "gatherScatterFields_floatAdd", fieldsInfo);
+      ogs::gatherScatterFieldsKernels[ogsDoubleId] = device.buildKernel(DOGS "/okl/gatherScatterFields.okl", "gatherScatterFields_doubleAdd", fieldsInfo);
+
       ogs::gatherScatterVecKernel_floatAdd = device.buildKernel(DOGS "/okl/gatherScatterVec.okl", "gatherScatterVec_floatAdd", kernelInfo);
       ogs::gatherScatterVecKernel_floatMul = device.buildKernel(DOGS "/okl/gatherScatterVec.okl", "gatherScatterVec_floatMul", kernelInfo);
       ogs::gatherScatterVecKernel_floatMin = device.buildKernel(DOGS "/okl/gatherScatterVec.okl", "gatherScatterVec_floatMin", kernelInfo);
@@ -342,6 +391,44 @@ void ogs::initKernels(MPI_Comm comm, occa::device device) {
     }
     MPI_Barrier(comm);
   }
+  //resolved kernel tables, indexed by [type][op]
+  ogs::gatherScatterKernels[ogsFloatId][ogsAddId] = ogs::gatherScatterKernel_floatAdd;
+  ogs::gatherScatterKernels[ogsFloatId][ogsMulId] = ogs::gatherScatterKernel_floatMul;
+  ogs::gatherScatterKernels[ogsFloatId][ogsMinId] = ogs::gatherScatterKernel_floatMin;
+  ogs::gatherScatterKernels[ogsFloatId][ogsMaxId] = ogs::gatherScatterKernel_floatMax;
+  ogs::gatherScatterKernels[ogsDoubleId][ogsAddId] = ogs::gatherScatterKernel_doubleAdd;
+  ogs::gatherScatterKernels[ogsDoubleId][ogsMulId] = ogs::gatherScatterKernel_doubleMul;
+  ogs::gatherScatterKernels[ogsDoubleId][ogsMinId] = ogs::gatherScatterKernel_doubleMin;
+  ogs::gatherScatterKernels[ogsDoubleId][ogsMaxId] = ogs::gatherScatterKernel_doubleMax;
+  ogs::gatherScatterKernels[ogsIntId][ogsAddId] = ogs::gatherScatterKernel_intAdd;
+  ogs::gatherScatterKernels[ogsIntId][ogsMulId] = ogs::gatherScatterKernel_intMul;
+  ogs::gatherScatterKernels[ogsIntId][ogsMinId] = ogs::gatherScatterKernel_intMin;
+  ogs::gatherScatterKernels[ogsIntId][ogsMaxId] = ogs::gatherScatterKernel_intMax;
+  ogs::gatherScatterKernels[ogsLongId][ogsAddId] = ogs::gatherScatterKernel_longAdd;
+  ogs::gatherScatterKernels[ogsLongId][ogsMulId] = ogs::gatherScatterKernel_longMul;
+  ogs::gatherScatterKernels[ogsLongId][ogsMinId] = ogs::gatherScatterKernel_longMin;
+  ogs::gatherScatterKernels[ogsLongId][ogsMaxId] = ogs::gatherScatterKernel_longMax;
+  ogs::gatherKernels[ogsFloatId][ogsAddId] = ogs::gatherKernel_floatAdd;
+  ogs::gatherKernels[ogsFloatId][ogsMulId] = ogs::gatherKernel_floatMul;
+  ogs::gatherKernels[ogsFloatId][ogsMinId] = ogs::gatherKernel_floatMin;
+  ogs::gatherKernels[ogsFloatId][ogsMaxId] = ogs::gatherKernel_floatMax;
+  ogs::gatherKernels[ogsDoubleId][ogsAddId] = ogs::gatherKernel_doubleAdd;
+  ogs::gatherKernels[ogsDoubleId][ogsMulId] = ogs::gatherKernel_doubleMul;
+  ogs::gatherKernels[ogsDoubleId][ogsMinId] = ogs::gatherKernel_doubleMin;
+  ogs::gatherKernels[ogsDoubleId][ogsMaxId] = ogs::gatherKernel_doubleMax;
+  ogs::gatherKernels[ogsIntId][ogsAddId] = ogs::gatherKernel_intAdd;
+  ogs::gatherKernels[ogsIntId][ogsMulId] = ogs::gatherKernel_intMul;
+  ogs::gatherKernels[ogsIntId][ogsMinId] = ogs::gatherKernel_intMin;
+  ogs::gatherKernels[ogsIntId][ogsMaxId] = ogs::gatherKernel_intMax;
+  ogs::gatherKernels[ogsLongId][ogsAddId] = ogs::gatherKernel_longAdd;
+  ogs::gatherKernels[ogsLongId][ogsMulId] = ogs::gatherKernel_longMul;
+  ogs::gatherKernels[ogsLongId][ogsMinId] = ogs::gatherKernel_longMin;
+  ogs::gatherKernels[ogsLongId][ogsMaxId] = ogs::gatherKernel_longMax;
+  ogs::scatterKernels[ogsFloatId] = ogs::scatterKernel_float;
+  ogs::scatterKernels[ogsDoubleId] = ogs::scatterKernel_double;
+  ogs::scatterKernels[ogsIntId] = ogs::scatterKernel_int;
+  ogs::scatterKernels[ogsLongId] = ogs::scatterKernel_long;
+
   if(rank==0) printf("done.\n");
 }
 
@@ -460,5 +547,24 @@ void ogs::freeKernels() {
 
   ogs::o_haloBuf.free();
   ogs::haloBuf = NULL;
+
+  ogs::o_haloSendBuf.free();
+  ogs::haloSendBuf = NULL;
+
+  for (int t=0;t<ogsNtypes;t++) {
+    for (int d=0;d<3;d++) {
+      if (ogs::gatherScatterDegreeKernels[t][d].isInitialized())
+        ogs::gatherScatterDegreeKernels[t][d].free();
+      ogs::gatherScatterDegreeKernels[t][d] = occa::kernel();
+    }
+    if (ogs::gatherScatterFieldsKernels[t].isInitialized())
+      ogs::gatherScatterFieldsKernels[t].free();
+    ogs::gatherScatterFieldsKernels[t] = occa::kernel();
+    for (int o=0;o<ogsNops;o++) {
+      ogs::gatherScatterKernels[t][o] = occa::kernel();
+      ogs::gatherKernels[t][o] = occa::kernel();
+    }
+    ogs::scatterKernels[t] = occa::kernel();
+  }
 }
 
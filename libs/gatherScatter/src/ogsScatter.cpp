@@ -100,7 +100,7 @@ void ogsScatterFinish(occa::memory o_sv,
     ogs->device.finish();
 
     // MPI based scatter using gslib
-    ogsHostScatter(ogs::haloBuf, type, op, ogs->haloGshNonSym);
+    ogsHostScatter(ogs::haloBuf, type, op, ogsGsh(ogs->haloGshNonSym));
 
     // copy totally scattered halo data back from HOST to DEVICE
     ogs::o_haloBuf.copyFrom(ogs::haloBuf, ogs->NhaloGather*Nbytes, 0, "async: true");
@@ -158,7 +158,7 @@ void ogsScatter_op(void *sv, void *v, const size_t Nbytes, const char *type, ogs
       memcpy(ogs::hostBuf, (char*) v+ogs->NlocalGather*Nbytes, ogs->NownedHalo*Nbytes);
 
     // MPI based scatter using gslib
-    ogsHostScatter(ogs::hostBuf, type, ogsAdd, ogs->haloGshNonSym);
+    ogsHostScatter(ogs::hostBuf, type, ogsAdd, ogsGsh(ogs->haloGshNonSym));
   }
 
   if (!strcmp(type, "float")) 
@@ -183,13 +183,5 @@ void occaScatter(const  dlong Nscatter,
                 const char* op,
                 occa::memory  o_v,
                 occa::memory  o_sv) {
-  
-  if      (!strcmp(type, "float")) 
-    ogs::scatterKernel_float(Nscatter, o_scatterStarts, o_scatterIds, o_v, o_sv);
-  else if (!strcmp(type, "double")) 
-    ogs::scatterKernel_double(Nscatter, o_scatterStarts, o_scatterIds, o_v, o_sv);
-  else if (!strcmp(type, "int")) 
-    ogs::scatterKernel_int(Nscatter, o_scatterStarts, o_scatterIds, o_v, o_sv);
-  else if (!strcmp(type, "long long int")) 
-    ogs::scatterKernel_long(Nscatter, o_scatterStarts, o_scatterIds, o_v, o_sv);
+  ogs::scatterKernels[ogs::typeId(type)](Nscatter, o_scatterStarts, o_scatterIds, o_v, o_sv);
 }
\ No newline at end of file
@@ -120,7 +120,7 @@ void ogsScatterManyFinish(occa::memory o_sv,
     for (int i=0;i<k;i++) H[i] = (char*)ogs::haloBuf + i*ogs->NhaloGather*Nbytes;
 
     // MPI based scatter using gslib
-    ogsHostScatterMany(H, k, type, op, ogs->haloGshNonSym);
+    ogsHostScatterMany(H, k, type, op, ogsGsh(ogs->haloGshNonSym));
 
     // copy totally scattered halo data back from HOST to DEVICE
     ogs::o_haloBuf.copyFrom(ogs::haloBuf, ogs->NhaloGather*Nbytes*k, 0, "async: true");
@@ -198,7 +198,7 @@ void ogsScatterMany_op(void *sv, void *v,
     for (int i=0;i<k;i++) H[i] = (char*)ogs::hostBuf + i*ogs->NhaloGather*Nbytes;
 
     // MPI based scatter using gslib
-    ogsHostScatterMany(H, k, type, ogsAdd, ogs->haloGshNonSym);
+    ogsHostScatterMany(H, k, type, ogsAdd, ogsGsh(ogs->haloGshNonSym));
   }
 
   if (!strcmp(type, "float")) 
@@ -103,7 +103,7 @@ void ogsScatterVecFinish(occa::memory o_sv,
     ogs->device.finish();
 
     // MPI based scatter using gslib
-    ogsHostScatterVec(ogs::haloBuf, k, type, op, ogs->haloGshNonSym);
+    ogsHostScatterVec(ogs::haloBuf, k, type, op, ogsGsh(ogs->haloGshNonSym));
 
     // copy totally scattered halo data back from HOST to DEVICE
     ogs::o_haloBuf.copyFrom(ogs::haloBuf, ogs->NhaloGather*Nbytes*k, 0, "async: true");
@@ -162,7 +162,7 @@ void ogsScatterVec_op(void *sv, void *v, const int k, const size_t Nbytes, const
       memcpy(ogs::hostBuf, (char*) v+ogs->NlocalGather*Nbytes*k, ogs->NownedHalo*Nbytes*k);
 
     // MPI based scatterVec using gslib
-    ogsHostScatterVec(ogs::hostBuf, k, type, ogsAdd, ogs->haloGshNonSym);
+    ogsHostScatterVec(ogs::hostBuf, k, type, ogsAdd, ogsGsh(ogs->haloGshNonSym));
   }
 
   if (!strcmp(type, "float")) 
@@ -53,6 +53,15 @@ int compareBaseId(const void *a, const void *b){
   return 0;
 }
 
+// degree group of a gather node: 2, 4, 8, other, then 1
+static int degreeGroup(dlong degree){
+  if (degree==2) return 0;
+  if (degree==4) return 1;
+  if (degree==8) return 2;
+  if (degree==1) return 4;
+  return 3;
+}
+
 // compare on haloOwned then localId
 int compareLocalId(const void *a, const void *b){
 
@@ -65,6 +74,169 @@ int compareLocalId(const void *a, const void *b){
   return 0;
 }
 
+typedef struct{
+
+  hlong id;      // global id (abs)
+  int rank;      // rank holding the id
+  int minRank;   // smallest rank holding the id
+  int maxRank;   // largest rank holding the id
+  dlong index;   // slot in the rendezvous buffer
+
+}rankNode_t;
+
+// compare on id then rank
+static int compareRankId(const void *a, const void *b){
+
+  rankNode_t *fa = (rankNode_t*) a;
+  rankNode_t *fb = (rankNode_t*) b;
+
+  if(fa->id < fb->id) return -1;
+  if(fa->id > fb->id) return +1;
+
+  if(fa->rank < fb->rank) return -1;
+  if(fa->rank > fb->rank) return +1;
+
+  return 0;
+}
+
+// compare on rendezvous slot
+static int compareRankIndex(const void *a, const void *b){
+
+  rankNode_t *fa = (rankNode_t*) a;
+  rankNode_t *fb = (rankNode_t*) b;
+
+  if(fa->index < fb->index) return -1;
+  if(fa->index > fb->index) return +1;
+
+  return 0;
+}
+
+// find the smallest and largest rank taking part in the gather of each node, and
+//  flag one unique node in each group (lowest local index on the smallest rank)
+//  by keeping its id positive while the others are turned negative. Each distinct
+//  id is sent once to a rendezvous rank chosen by its id, so no gslib handle is
+//  needed during setup.
+static void ogsRankRange(MPI_Comm comm, dlong N, hlong *ids,
+                         int *minRank, int *maxRank, hlong *flagIds){
+
+  int rank, size;
+  MPI_Comm_rank(comm, &rank);
+  MPI_Comm_size(comm, &size);
+
+  // Make the MPI_RANK_NODE_T data type
+  rankNode_t node;
+  MPI_Datatype MPI_RANK_NODE_T;
+  MPI_Datatype dtype[5] = {MPI_HLONG, MPI_INT, MPI_INT, MPI_INT, MPI_DLONG};
+  int blength[5] = {1, 1, 1, 1, 1};
+  MPI_Aint addr[5], displ[5];
+  MPI_Get_address ( &(node.id     ), addr+0);
+  MPI_Get_address ( &(node.rank   ), addr+1);
+  MPI_Get_address ( &(node.minRank), addr+2);
+  MPI_Get_address ( &(node.maxRank), addr+3);
+  MPI_Get_address ( &(node.index  ), addr+4);
+  for (int n=0;n<5;n++) displ[n] = addr[n] - addr[0];
+  MPI_Type_create_struct (5, blength, displ, dtype, &MPI_RANK_NODE_T);
+  MPI_Type_commit (&MPI_RANK_NODE_T);
+
+  // group the local nodes by id
+  dlong Nnodes = 0;
+  parallelNode_t *nodes = (parallelNode_t*) calloc(N+1,sizeof(parallelNode_t));
+  for (dlong i=0;i<N;i++) {
+    minRank[i] = rank;
+    maxRank[i] = rank;
+    flagIds[i] = ids[i];
+    if (ids[i]==0) continue;
+
+    nodes[Nnodes].localId = i;
+    nodes[Nnodes].baseId  = abs(ids[i]);
+    Nnodes++;
+  }
+  qsort(nodes, Nnodes, sizeof(parallelNode_t), compareBaseId);
+
+  int *sendCounts  = (int*) calloc(size, sizeof(int));
+  int *recvCounts  = (int*) calloc(size, sizeof(int));
+  int *sendOffsets = (int*) calloc(size+1, sizeof(int));
+  int *recvOffsets = (int*) calloc(size+1, sizeof(int));
+
+  // send each distinct id to its rendezvous rank
+  for (dlong i=0;i<Nnodes;i++)
+    if ((i==0)||(nodes[i].baseId!=nodes[i-1].baseId))
+      sendCounts[nodes[i].baseId%size]++;
+
+  MPI_Alltoall(sendCounts, 1, MPI_INT,
+               recvCounts, 1, MPI_INT, comm);
+
+  for (int r=0;r<size;r++) {
+    sendOffsets[r+1] = sendOffsets[r]+sendCounts[r];
+    recvOffsets[r+1] = recvOffsets[r]+recvCounts[r];
+    sendCounts[r] = 0;
+  }
+
+  dlong Nsend = sendOffsets[size];
+  dlong Nrecv = recvOffsets[size];
+  rankNode_t *sendNodes = (rankNode_t*) calloc(Nsend+1, sizeof(rankNode_t));
+  rankNode_t *recvNodes = (rankNode_t*) calloc(Nrecv+1, sizeof(rankNode_t));
+
+  //remember where each distinct id was sent
+  dlong *slot = (dlong*) calloc(Nnodes+1, sizeof(dlong));
+  for (dlong i=0;i<Nnodes;i++) {
+    if ((i==0)||(nodes[i].baseId!=nodes[i-1].baseId)) {
+      int r = nodes[i].baseId%size;
+      dlong n = sendOffsets[r] + sendCounts[r]++;
+      sendNodes[n].id   = nodes[i].baseId;
+      sendNodes[n].rank = rank;
+      slot[i] = n;
+    } else {
+      slot[i] = slot[i-1];
+    }
+  }
+
+  MPI_Alltoallv(sendNodes, sendCounts, sendOffsets, MPI_RANK_NODE_T,
+                recvNodes, recvCounts, recvOffsets, MPI_RANK_NODE_T,
+                comm);
+
+  // find the rank range of each id
+  for (dlong n=0;n<Nrecv;n++) recvNodes[n].index = n;
+  qsort(recvNodes, Nrecv, sizeof(rankNode_t), compareRankId);
+
+  for (dlong s=0;s<Nrecv;) {
+    dlong e = s;
+    while ((e<Nrecv)&&(recvNodes[e].id==recvNodes[s].id)) e++;
+
+    for (dlong n=s;n<e;n++) {
+      recvNodes[n].minRank = recvNodes[s].rank;
+      recvNodes[n].maxRank = recvNodes[e-1].rank;
+    }
+    s = e;
+  }
+
+  // return the answers in the order they arrived
+  qsort(recvNodes, Nrecv, sizeof(rankNode_t), compareRankIndex);
+
+  MPI_Alltoallv(recvNodes, recvCounts, recvOffsets, MPI_RANK_NODE_T,
+                sendNodes, sendCounts, sendOffsets, MPI_RANK_NODE_T,
+                comm);
+
+  for (dlong i=0;i<Nnodes;i++) {
+    dlong localId = nodes[i].localId;
+    rankNode_t *answer = sendNodes + slot[i];
+
+    minRank[localId] = answer->minRank;
+    maxRank[localId] = answer->maxRank;
+
+    int first = (i==0)||(nodes[i].baseId!=nodes[i-1].baseId);
+    flagIds[localId] = (first && answer->minRank==rank) ? nodes[i].baseId : -nodes[i].baseId;
+  }
+
+  MPI_Barrier(comm);
+  MPI_Type_free(&MPI_RANK_NODE_T);
+
+  free(nodes); free(slot);
+  free(sendNodes); free(recvNodes);
+  free(sendCounts); free(recvCounts);
+  free(sendOffsets); free(recvOffsets);
+}
+
 ogs_t *ogsSetup(dlong N, hlong *ids, MPI_Comm &comm,
                 int verbose, occa::device device){
 
@@ -82,22 +254,17 @@ ogs_t *ogsSetup(dlong N, hlong *ids, MPI_Comm &comm,
   MPI_Comm_rank(ogs->comm, &rank);
   MPI_Comm_size(ogs->comm, &size);
 
-  //make a host gs handle (calls gslib)
-  ogs->hostGsh = ogsHostSetup(comm, N, ids, 0, 0);
+  //register a host gs handle (gslib setup is deferred until first use)
+  ogs->hostGsh = ogsGshSetup(comm, N, ids);
 
-  //use the host gs to find what nodes are local to this rank
-  int *minRank = (int *) calloc(N,sizeof(int));
-  int *maxRank = (int *) calloc(N,sizeof(int));
-  hlong *flagIds   = (hlong *) calloc(N,sizeof(hlong));
-  for (dlong i=0;i<N;i++) {
-    minRank[i] = rank;
-    maxRank[i] = rank;
-    flagIds[i] = ids[i];
-  }
+  //find what nodes are local to this rank
+  int *minRank = (int *) calloc(N+1,sizeof(int));
+  int *maxRank = (int *) calloc(N+1,sizeof(int));
+  hlong *flagIds   = (hlong *) calloc(N+1,sizeof(hlong));
 
-  ogsHostGatherScatter(minRank, ogsInt, ogsMin, ogs->hostGsh); //minRank[n] contains the smallest rank taking part in the gather of node n
-  ogsHostGatherScatter(maxRank, ogsInt, ogsMax, ogs->hostGsh); //maxRank[n] contains the largest rank taking part in the gather of node n
-  ogsGsUnique(flagIds, N, comm); //one unique node in each group is 'flagged' kept positive while others are turned negative.
+  //minRank[n] and maxRank[n] contain the smallest and largest rank taking part in the gather of node n
+  //one unique node in each group is 'flagged' kept positive while others are turned negative.
+  ogsRankRange(comm, N, ids, minRank, maxRank, flagIds);
 
   //count local and halo nodes
   ogs->Nlocal=0; ogs->Nhalo=0; ogs->NownedHalo=0;
@@ -166,6 +333,33 @@ ogs_t *ogsSetup(dlong N, hlong *ids, MPI_Comm &comm,
     }
     free(localGatherMap);
 
+    //group the gather nodes by degree (2, 4, 8, other, then 1). Within a group
+    //  they stay ordered by first local id, so neighbouring threads work on
+    //  neighbouring elements
+    dlong groupCounts[5] = {0,0,0,0,0};
+    for (dlong g=0;g<ogs->NlocalGather;g++)
+      groupCounts[degreeGroup(localGatherCounts[g])]++;
+
+    ogs->localGroupStarts[0] = 0;
+    for (int k=0;k<5;k++) {
+      ogs->localGroupStarts[k+1] = ogs->localGroupStarts[k] + groupCounts[k];
+      groupCounts[k] = ogs->localGroupStarts[k];
+    }
+
+    dlong *localGatherOrder = (dlong*) calloc(ogs->NlocalGather,sizeof(dlong));
+    dlong *localGroupCounts = (dlong*) calloc(ogs->NlocalGather,sizeof(dlong));
+    for (dlong g=0;g<ogs->NlocalGather;g++) {
+      dlong newG = groupCounts[degreeGroup(localGatherCounts[g])]++;
+      localGatherOrder[g] = newG;
+      localGroupCounts[newG] = localGatherCounts[g];
+    }
+    for (dlong i=0;i<ogs->Nlocal;i++)
+      localNodes[i].newId = localGatherOrder[localNodes[i].newId];
+
+    free(localGatherCounts);
+    free(localGatherOrder);
+    localGatherCounts = localGroupCounts;
+
     ogs->localGatherOffsets = (dlong*) calloc(ogs->NlocalGather+1,sizeof(dlong));
     for (dlong i=0;i<ogs->NlocalGather;i++) {
       ogs->localGatherOffsets[i+1] = ogs->localGatherOffsets[i] + localGatherCounts[i];
@@ -191,6 +385,8 @@ ogs_t *ogsSetup(dlong N, hlong *ids, MPI_Comm &comm,
 
   //set up the halo gatherScatter
   parallelNode_t *haloNodes;
+  hlong *symIds = NULL;
+  hlong *nonSymIds = NULL;
   if (ogs->Nhalo) {
     haloNodes = (parallelNode_t*) calloc(ogs->Nhalo,sizeof(parallelNode_t));
 
@@ -239,8 +435,8 @@ ogs_t *ogsSetup(dlong N, hlong *ids, MPI_Comm &comm,
     //  map to a local ordering
     dlong *haloGatherCounts = (dlong*) calloc(ogs->NhaloGather,sizeof(dlong));
     dlong *haloGatherMap    = (dlong*) calloc(ogs->NhaloGather,sizeof(dlong));
-    hlong *symIds    = (hlong *) calloc(ogs->NhaloGather,sizeof(hlong));
-    hlong *nonSymIds = (hlong *) calloc(ogs->NhaloGather,sizeof(hlong));
+    symIds           = (hlong *) calloc(ogs->NhaloGather,sizeof(hlong));
+    nonSymIds        = (hlong *) calloc(ogs->NhaloGather,sizeof(hlong));
 
     cnt = 0;
     dlong cnt2 = ogs->NownedHalo;
@@ -284,13 +480,13 @@ ogs_t *ogsSetup(dlong N, hlong *ids, MPI_Comm &comm,
     ogs->o_haloGatherOffsets = device.malloc((ogs->NhaloGather+1)*sizeof(dlong), ogs->haloGatherOffsets);
     ogs->o_haloGatherIds     = device.malloc((ogs->Nhalo)*sizeof(dlong), ogs->haloGatherIds);
 
-    //make a host gs handle
-    ogs->haloGshSym    = ogsHostSetup(comm, ogs->NhaloGather, symIds,    0,0);
-    ogs->haloGshNonSym = ogsHostSetup(comm, ogs->NhaloGather, nonSymIds, 0,0);
-
-    free(symIds); free(nonSymIds);
     free(haloNodes);
   }
+
+  //register the halo gs handles (collective, ranks without halo nodes register empty sets)
+  ogs->haloGshSym    = ogsGshSetup(comm, ogs->NhaloGather, symIds);
+  ogs->haloGshNonSym = ogsGshSetup(comm, ogs->NhaloGather, nonSymIds);
+  if (nonSymIds) free(nonSymIds);
   free(minRank); free(maxRank); free(flagIds);
 
   //total number of owned gathered nodes
@@ -298,6 +494,10 @@ ogs_t *ogsSetup(dlong N, hlong *ids, MPI_Comm &comm,
 
   ogs->device = device;
 
+  //build the native halo exchange plan (collective)
+  ogsExchangeSetup(ogs, symIds);
+  if (symIds) free(symIds);
+
   // build degree vectors
   ogs->invDegree = (dfloat*) calloc(N, sizeof(dfloat));
   ogs->gatherInvDegree = (dfloat*) calloc(ogs->Ngather, sizeof(dfloat));
@@ -306,15 +506,17 @@ ogs_t *ogsSetup(dlong N, hlong *ids, MPI_Comm &comm,
   ogs->o_invDegree = device.malloc(N*sizeof(dfloat), ogs->invDegree);
   ogs->o_gatherInvDegree = device.malloc(ogs->Ngather*sizeof(dfloat), ogs->gatherInvDegree);
 
-  ogsGather(ogs->o_gatherInvDegree, ogs->o_invDegree, ogsDfloat, ogsAdd, ogs);
-
-  if(ogs->Ngather)
-    ogs->o_gatherInvDegree.copyTo(ogs->gatherInvDegree);
-
-  ogsScatter(ogs->o_invDegree, ogs->o_gatherInvDegree, ogsDfloat, ogsAdd, ogs);
+  //count the degree with the native symmetric gather-scatter
+  ogsGatherScatter(ogs->o_invDegree, ogsDfloat, ogsAdd, ogs);
 
   if (N) ogs->o_invDegree.copyTo(ogs->invDegree);
 
+  //read the degree of each gathered node off one of its members
+  for (dlong g=0;g<ogs->NlocalGather;g++)
+    ogs->gatherInvDegree[g] = ogs->invDegree[ogs->localGatherIds[ogs->localGatherOffsets[g]]];
+  for (dlong c=0;c<ogs->NownedHalo;c++)
+    ogs->gatherInvDegree[ogs->NlocalGather+c] = ogs->invDegree[ogs->haloGatherIds[ogs->haloGatherOffsets[c]]];
+
   for(dlong n=0;n<ogs->N;++n)
     ogs->invDegree[n] = 1./ogs->invDegree[n];
 
@@ -345,15 +547,16 @@ void ogsFree(ogs_t *ogs) {
     free(ogs->haloGatherIds);
     ogs->o_haloGatherOffsets.free();
     ogs->o_haloGatherIds.free();
-    ogsHostFree(ogs->haloGshSym);
-    ogsHostFree(ogs->haloGshNonSym);
   }
+  ogsGshFree(ogs->haloGshSym);
+  ogsGshFree(ogs->haloGshNonSym);
+  ogsExchangeFree(ogs);
 
   if (ogs->N) {
     free(ogs->invDegree);
     ogs->o_invDegree.free();
-    ogsHostFree(ogs->hostGsh);
   }
+  ogsGshFree(ogs->hostGsh);
 
   if (ogs->Ngather) {
     free(ogs->gatherInvDegree);
@@ -35,6 +35,9 @@ public:
   parCSR   *A,   *P,   *R;
   parHYB *o_A, *o_P, *o_R;
 
+  //block operator used in place of o_A when A->blockSize>1
+  parBSR *o_Ab=NULL;
+
   SmoothType stype;
   dfloat lambda, lambda1, lambda0; //smoothing params
 
@@ -64,6 +67,10 @@ public:
   void prolongate(dfloat        *x, dfloat        *Px);
   void prolongate(occa::memory o_x, occa::memory o_Px);
 
+  //y = alpha*inv(D)*x + beta*y with the (block) diagonal of A
+  void applyDinv(const dfloat alpha,        dfloat *x, const dfloat beta,        dfloat *y);
+  void applyDinv(const dfloat alpha, occa::memory o_x, const dfloat beta, occa::memory o_y);
+
   void smoothJacobi(dfloat *r, dfloat *x, const bool x_is_zero);
   void smoothDampedJacobi(dfloat *r, dfloat *x, const bool x_is_zero);
   void smoothChebyshev(dfloat *r, dfloat *x, const bool x_is_zero);
@@ -92,6 +99,14 @@ parCSR *transpose(parCSR *A);
 
 parCSR *galerkinProd(parCSR *A, parCSR *P);
 
+parCSR *assemblePTAP(parCSR *A, hlong *globalAggStarts,
+                     dlong sendNtotal, nonzero_t *sendPTAP);
+
+//device versions of strongGraph+formAggregates and galerkinProd
+void deviceFormAggregates(parCSR *A, hlong *FineToCoarse, hlong *globalAggStarts);
+
+parCSR *deviceGalerkinProd(parCSR *A, parCSR *P);
+
 
 
 void setupAgmgSmoother(agmgLevel *level, SmoothType s, int ChebIterations);
@@ -31,10 +31,17 @@ namespace parAlmond {
 
   void buildParAlmondKernels(MPI_Comm comm, occa::device device);
 
+  void buildParAlmondBlockKernels(MPI_Comm comm, occa::device device, int bs);
+
+  void buildParAlmondSetupKernels(MPI_Comm comm, occa::device device);
+
   void freeParAlmondKernels();
 
   extern int Nrefs;
 
+  extern occa::stream defaultStream;
+  extern occa::stream dataStream;
+
   extern occa::kernel haloExtractKernel;
 
   extern occa::kernel SpMVcsrKernel1;
@@ -44,6 +51,24 @@ namespace parAlmond {
   extern occa::kernel SpMVmcsrKernel1;
   extern occa::kernel SpMVmcsrKernel2;
 
+  extern int blockKernelSize;
+  extern occa::kernel SpMVbsrKernel1;
+  extern occa::kernel SpMVbsrKernel2;
+  extern occa::kernel vectorBlockDotStarKernel;
+
+  extern bool setupKernelsBuilt;
+  extern occa::kernel strongGraphCountKernel;
+  extern occa::kernel strongGraphFillKernel;
+  extern occa::kernel misColumnCountKernel;
+  extern occa::kernel misPerturbKernel;
+  extern occa::kernel misFirstNeighboursKernel;
+  extern occa::kernel misSecondNeighboursKernel;
+  extern occa::kernel misStateCountKernel;
+  extern occa::kernel misEnumerateKernel;
+  extern occa::kernel aggregateFirstNeighboursKernel;
+  extern occa::kernel aggregateSecondNeighboursKernel;
+  extern occa::kernel galerkinTriplesKernel;
+
   extern occa::kernel vectorSetKernel;
   extern occa::kernel vectorScaleKernel;
   extern occa::kernel vectorAddScalarKernel;
@@ -114,6 +114,31 @@ public:
   void SpMV(const dfloat alpha, occa::memory o_x, const dfloat beta, occa::memory o_y, occa::memory o_z);
 };
 
+class BSR: public matrix_t {
+
+public:
+  int bs;        //block size
+  dlong Nblocks; //number of block rows
+  dlong nnz;     //number of nonzero blocks
+  dlong  *rowStarts=NULL;
+  dlong  *cols=NULL;
+  dfloat *vals=NULL; //bs x bs row-major blocks
+
+  occa::memory o_rowStarts;
+  occa::memory o_cols;
+  occa::memory o_vals;
+
+  BSR(dlong N=0, dlong M=0, int bs=1);
+  ~BSR();
+
+  void syncToDevice(occa::device device);
+
+  void SpMV(const dfloat alpha,        dfloat *x, const dfloat beta, dfloat *y);
+  void SpMV(const dfloat alpha,        dfloat *x, const dfloat beta, const dfloat *y, dfloat *z);
+  void SpMV(const dfloat alpha, occa::memory o_x, const dfloat beta, const occa::memory o_y);
+  void SpMV(const dfloat alpha, occa::memory o_x, const dfloat beta, occa::memory o_y, occa::memory o_z);
+};
+
 class parCSR: public matrix_t {
 
 public:
@@ -129,6 +154,11 @@ public:
   occa::memory o_diagA;
   occa::memory o_diagInv;
 
+  //node-wise block diagonal inverse for coupled systems
+  int blockSize=1;
+  dfloat *blockDiagInv=NULL;
+  occa::memory o_blockDiagInv;
+
   bool nullSpace;
   dfloat nullSpacePenalty;
   dfloat *null=NULL;
@@ -149,6 +179,11 @@ public:
   dlong *haloIds=NULL;
   occa::memory o_haloIds;
 
+  //rows with nonlocal entries, the only rows the offd product touches
+  bool boundaryRowsSet=false;
+  dlong NboundaryRows=0;
+  dlong *boundaryRows=NULL;
+
   occa::device device;
 
 
@@ -171,6 +206,10 @@ public:
   ~parCSR();
 
   void haloSetup(hlong *colIds);
+  void blockDiagSetup(int bs);
+  void boundarySetup();
+  void boundarySpMV(const dfloat alpha, dfloat *x, dfloat *y);
+
   void haloExchangeStart (dfloat *x);
   void haloExchangeFinish(dfloat *x);
   void haloExchangeStart (occa::memory o_x);
@@ -238,6 +277,53 @@ public:
   void SpMV(const dfloat alpha, occa::memory o_x, const dfloat beta, occa::memory o_y, occa::memory o_z);
 };
 
+//node-blocked matrix: bs x bs blocks for the local part, scalar MCSR for the
+// (small) nonlocal part. Halo and diagonal data are borrowed from the parCSR.
+class parBSR: public matrix_t {
+
+public:
+  int bs;
+
+  BSR  *E;
+  MCSR *C;
+
+  dfloat *blockDiagInv=NULL;
+  occa::memory o_blockDiagInv;
+
+  bool nullSpace;
+  dfloat nullSpacePenalty;
+  dfloat *null=NULL;
+  occa::memory o_null;
+
+  //partition info
+  MPI_Comm comm;
+  ogs_t *ogsHalo=NULL;
+  dlong Nhalo;
+  dlong Nshared;
+  dlong NlocalCols;
+
+  dlong *haloIds=NULL;
+  occa::memory o_haloIds;
+
+  occa::device device;
+
+  parBSR(parCSR *A); //build from parCSR using A->blockSize
+
+  ~parBSR();
+
+  void haloExchangeStart (dfloat *x);
+  void haloExchangeFinish(dfloat *x);
+  void haloExchangeStart (occa::memory o_x);
+  void haloExchangeFinish(occa::memory o_x);
+
+  void syncToDevice();
+
+  void SpMV(const dfloat alpha,        dfloat *x, const dfloat beta, dfloat *y);
+  void SpMV(const dfloat alpha,        dfloat *x, const dfloat beta, const dfloat *y, dfloat *z);
+  void SpMV(const dfloat alpha, occa::memory o_x, const dfloat beta, const occa::memory o_y);
+  void SpMV(const dfloat alpha, occa::memory o_x, const dfloat beta, occa::memory o_y, occa::memory o_z);
+};
+
 
 } //namespace parAlmond
 
@@ -51,6 +51,9 @@ public:
 
   int ChebyshevIterations;
 
+  int blockSize; //number of coupled unknowns per node
+  int requestedBlockSize; //PARALMOND BLOCK SIZE, AMGSetup may fall back to 1
+
   solver_t(occa::device otherdevice, MPI_Comm othercomm,
                          setupAide otheroptions);
 
@@ -58,6 +61,10 @@ public:
 
   void AMGSetup(parCSR *A);
 
+  //write/read the AMG levels to/from one binary file per rank
+  void Save(const char *baseName, unsigned long long signature);
+  bool Load(const char *baseName, unsigned long long signature);
+
   void Report();
 
   void kcycle(int k);
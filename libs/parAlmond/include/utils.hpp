@@ -47,6 +47,10 @@ void allocatePinnedScratchSpace(size_t requiredBytes, occa::device device);
 void freeScratchSpace();
 void freePinnedScratchSpace();
 
+//host allocations first touched by the OpenMP threads that will work on them
+void *parallelCalloc(size_t N, size_t size);
+void *parallelRehome(void *a, size_t N, size_t size);
+
 typedef struct {
 
   dlong localId;
@@ -100,6 +104,9 @@ void eig(const int Nrows, double *A, double *WR, double *WI);
 
 void matrixInverse(int N, dfloat *A);
 
+unsigned long long hashBytes(const void *data, size_t bytes,
+                             unsigned long long hash=14695981039346656037ULL);
+
 } //namespace parAlmond
 
 #endif
\ No newline at end of file
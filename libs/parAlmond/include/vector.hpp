@@ -58,6 +58,10 @@ void vectorDotStar(const dlong m, const dfloat *a, dfloat *b);
 void vectorDotStar(const dlong m, const dfloat alpha, const dfloat *a,
                    const dfloat *b, const dfloat beta,  dfloat *c);
 
+// c = alpha*A*b + beta*c, A block diagonal with bs x bs blocks
+void blockDotStar(const dlong Nblocks, const int bs, const dfloat alpha,
+                  const dfloat *A, const dfloat *b, const dfloat beta, dfloat *c);
+
 dfloat vectorNorm(const dlong n, const dfloat *a, MPI_Comm comm);
 
 dfloat vectorInnerProd(const dlong n, const dfloat *a, const dfloat *b,
@@ -105,6 +109,10 @@ void vectorDotStar(const dlong N, occa::memory o_a, occa::memory o_b);
 void vectorDotStar(const dlong N, const dfloat alpha, occa::memory o_a,
                    occa::memory o_b, const dfloat beta, occa::memory o_c);
 
+void blockDotStar(const dlong Nblocks, const int bs, const dfloat alpha,
+                  occa::memory o_A, occa::memory o_b, const dfloat beta,
+                  occa::memory o_c);
+
 dfloat vectorNorm(const dlong n, occa::memory o_a, MPI_Comm comm);
 
 dfloat vectorInnerProd(const dlong N, occa::memory o_x, occa::memory o_y,
@@ -37,7 +37,7 @@ void CSR::SpMV(const dfloat alpha, dfloat *x,
                const dfloat beta, dfloat *y) {
   // y[i] = beta*y[i] + alpha* (sum_{ij} Aij*x[j])
   if (beta) {
-    // #pragma omp parallel for
+    #pragma omp parallel for
     for(dlong i=0; i<Nrows; i++){ //local
       dfloat result = 0.0;
       for(dlong jj=rowStarts[i]; jj<rowStarts[i+1]; jj++)
@@ -46,7 +46,7 @@ void CSR::SpMV(const dfloat alpha, dfloat *x,
       y[i] = alpha*result + beta*y[i];
     }
   } else {
-    // #pragma omp parallel for
+    #pragma omp parallel for
     for(dlong i=0; i<Nrows; i++){ //local
       dfloat result = 0.0;
       for(dlong jj=rowStarts[i]; jj<rowStarts[i+1]; jj++)
@@ -60,7 +60,7 @@ void CSR::SpMV(const dfloat alpha, dfloat *x,
 void CSR::SpMV(const dfloat alpha, dfloat *x,
                const dfloat beta, const dfloat *y, dfloat *z) {
   // z[i] = beta*y[i] + alpha* (sum_{ij} Aij*x[j])
-  // #pragma omp parallel for
+  #pragma omp parallel for
   for(dlong i=0; i<Nrows; i++){ //local
     dfloat result = 0.0;
     for(dlong jj=rowStarts[i]; jj<rowStarts[i+1]; jj++)
@@ -100,7 +100,7 @@ void ELL::SpMV(const dfloat alpha, dfloat *x,
                const dfloat beta, dfloat *y) {
   // y[i] = beta*y[i] + alpha* (sum_{ij} Aij*x[j])
   if (beta) {
-    // #pragma omp parallel for
+    #pragma omp parallel for
     for(dlong i=0; i<Nrows; i++){ //local
       dfloat result = 0.0;
       for(dlong c=0; c<nnzPerRow; c++) {
@@ -112,7 +112,7 @@ void ELL::SpMV(const dfloat alpha, dfloat *x,
       y[i] = alpha*result + beta*y[i];
     }
   } else {
-    // #pragma omp parallel for
+    #pragma omp parallel for
     for(dlong i=0; i<Nrows; i++){ //local
       dfloat result = 0.0;
       for(dlong c=0; c<nnzPerRow; c++) {
@@ -129,7 +129,7 @@ void ELL::SpMV(const dfloat alpha, dfloat *x,
 void ELL::SpMV(const dfloat alpha, dfloat *x,
                const dfloat beta, const dfloat *y, dfloat *z) {
   // z[i] = beta*y[i] + alpha* (sum_{ij} Aij*x[j])
-  // #pragma omp parallel for
+  #pragma omp parallel for
   for(dlong i=0; i<Nrows; i++){ //local
     dfloat result = 0.0;
     for(dlong c=0; c<nnzPerRow; c++) {
@@ -173,7 +173,7 @@ void MCSR::SpMV(const dfloat alpha, dfloat *x,
                 const dfloat beta, dfloat *y){
   // y[i] = beta*y[i] + alpha* (sum_{ij} Aij*x[j])
   if (beta) {
-    // #pragma omp parallel for
+    #pragma omp parallel for
     for(dlong i=0; i<actualRows; i++){ //local
       dlong row = rows[i];
       dfloat result = 0.0;
@@ -183,7 +183,7 @@ void MCSR::SpMV(const dfloat alpha, dfloat *x,
       y[row] = alpha*result + beta*y[row];
     }
   } else {
-    // #pragma omp parallel for
+    #pragma omp parallel for
     for(dlong i=0; i<actualRows; i++){ //local
       dlong row = rows[i];
       dfloat result = 0.0;
@@ -198,7 +198,7 @@ void MCSR::SpMV(const dfloat alpha, dfloat *x,
 void MCSR::SpMV(const dfloat alpha, dfloat *x,
                 const dfloat beta, const dfloat *y, dfloat *z){
   // z[i] = beta*y[i] + alpha* (sum_{ij} Aij*x[j])
-  // #pragma omp parallel for
+  #pragma omp parallel for
   for(dlong i=0; i<actualRows; i++){ //local
     dlong row = rows[i];
     dfloat result = 0.0;
@@ -232,11 +232,83 @@ void MCSR::SpMV(const dfloat alpha, occa::memory o_x, const dfloat beta,
 }
 
 
+//------------------------------------------------------------------------
+//
+//  BSR matrix
+//
+//------------------------------------------------------------------------
+void BSR::SpMV(const dfloat alpha, dfloat *x,
+               const dfloat beta, dfloat *y) {
+  // y[i] = beta*y[i] + alpha* (sum_{ij} Aij*x[j])
+  #pragma omp parallel for
+  for(dlong n=0; n<Nblocks; n++){ //local
+    for(int r=0; r<bs; r++){
+      dfloat result = 0.0;
+      for(dlong jj=rowStarts[n]; jj<rowStarts[n+1]; jj++)
+        for(int c=0; c<bs; c++)
+          result += vals[jj*bs*bs+r*bs+c]*x[cols[jj]*bs+c];
+
+      if (beta)
+        y[n*bs+r] = alpha*result + beta*y[n*bs+r];
+      else
+        y[n*bs+r] = alpha*result;
+    }
+  }
+}
+
+void BSR::SpMV(const dfloat alpha, dfloat *x,
+               const dfloat beta, const dfloat *y, dfloat *z) {
+  // z[i] = beta*y[i] + alpha* (sum_{ij} Aij*x[j])
+  #pragma omp parallel for
+  for(dlong n=0; n<Nblocks; n++){ //local
+    for(int r=0; r<bs; r++){
+      dfloat result = 0.0;
+      for(dlong jj=rowStarts[n]; jj<rowStarts[n+1]; jj++)
+        for(int c=0; c<bs; c++)
+          result += vals[jj*bs*bs+r*bs+c]*x[cols[jj]*bs+c];
+
+      z[n*bs+r] = alpha*result + beta*y[n*bs+r];
+    }
+  }
+}
+
+void BSR::SpMV(const dfloat alpha, occa::memory o_x, const dfloat beta,
+              occa::memory o_y){
+  // y[i] = beta*y[i] + alpha* (sum_{ij} Aij*x[j])
+  if (Nblocks)
+    SpMVbsrKernel1(Nblocks, alpha, beta, o_rowStarts, o_cols, o_vals,
+                          o_x, o_y);
+}
+
+void BSR::SpMV(const dfloat alpha, occa::memory o_x, const dfloat beta,
+              occa::memory o_y, occa::memory o_z){
+  // z[i] = beta*y[i] + alpha* (sum_{ij} Aij*x[j])
+  if (Nblocks)
+    SpMVbsrKernel2(Nblocks, alpha, beta, o_rowStarts, o_cols, o_vals,
+                          o_x, o_y, o_z);
+}
+
+
 //------------------------------------------------------------------------
 //
 //  parCSR matrix
 //
 //------------------------------------------------------------------------
+//y += alpha*offd*x over the rows with nonlocal entries
+void parCSR::boundarySpMV(const dfloat alpha, dfloat *x, dfloat *y) {
+  if (!boundaryRowsSet) this->boundarySetup();
+
+  #pragma omp parallel for
+  for(dlong n=0; n<NboundaryRows; n++){
+    const dlong i = boundaryRows[n];
+    dfloat result = 0.0;
+    for(dlong jj=offd->rowStarts[i]; jj<offd->rowStarts[i+1]; jj++)
+      result += offd->vals[jj]*x[offd->cols[jj]];
+
+    y[i] += alpha*result;
+  }
+}
+
 void parCSR::SpMV(const dfloat alpha, dfloat *x,
                   const dfloat beta, dfloat *y) {
 
@@ -247,7 +319,7 @@ void parCSR::SpMV(const dfloat alpha, dfloat *x,
 
   this->haloExchangeFinish(x);
 
-  offd->SpMV(alpha, x, 1.0, y);
+  boundarySpMV(alpha, x, y);
 
   //rank 1 correction if there is a nullspace
   if (nullSpace) {
@@ -266,7 +338,7 @@ void parCSR::SpMV(const dfloat alpha, dfloat *x,
 
   this->haloExchangeFinish(x);
 
-  offd->SpMV(alpha, x, 1.0, z);
+  boundarySpMV(alpha, x, z);
 
   //rank 1 correction if there is a nullspace
   if (nullSpace) {
@@ -394,5 +466,86 @@ void parHYB::SpMV(const dfloat alpha, occa::memory o_x, const dfloat beta,
   }
 }
 
+//------------------------------------------------------------------------
+//
+//  parBSR matrix
+//
+//------------------------------------------------------------------------
+void parBSR::SpMV(const dfloat alpha, dfloat *x,
+                  const dfloat beta, dfloat *y) {
+
+  this->haloExchangeStart(x);
+
+  // z[i] = beta*y[i] + alpha* (sum_{ij} Aij*x[j])
+  E->SpMV(alpha, x, beta, y);
+
+  this->haloExchangeFinish(x);
+
+  C->SpMV(alpha, x, 1.0, y);
+
+  //rank 1 correction if there is a nullspace
+  if (nullSpace) {
+    dfloat gamma = vectorInnerProd(Nrows, null, x, comm)*nullSpacePenalty;
+    vectorAdd(Nrows, alpha*gamma, null, 1.0, y);
+  }
+}
+
+void parBSR::SpMV(const dfloat alpha, dfloat *x,
+                  const dfloat beta, const dfloat *y, dfloat *z) {
+
+  this->haloExchangeStart(x);
+
+  // z[i] = beta*y[i] + alpha* (sum_{ij} Aij*x[j])
+  E->SpMV(alpha, x, beta, y, z);
+
+  this->haloExchangeFinish(x);
+
+  C->SpMV(alpha, x, 1.0, z);
+
+  //rank 1 correction if there is a nullspace
+  if (nullSpace) {
+    dfloat gamma = vectorInnerProd(Nrows, null, x, comm)*nullSpacePenalty;
+    vectorAdd(Nrows, alpha*gamma, null, 1.0, z);
+  }
+}
+
+void parBSR::SpMV(const dfloat alpha, occa::memory o_x, const dfloat beta,
+                  occa::memory o_y) {
+
+  this->haloExchangeStart(o_x);
+
+  // z[i] = beta*y[i] + alpha* (sum_{ij} Aij*x[j])
+  E->SpMV(alpha, o_x, beta, o_y);
+
+  this->haloExchangeFinish(o_x);
+
+  C->SpMV(alpha, o_x, 1.0, o_y);
+
+  //rank 1 correction if there is a nullspace
+  if (nullSpace) {
+    dfloat gamma = vectorInnerProd(Nrows, o_null, o_x, comm)*nullSpacePenalty;
+    vectorAdd(Nrows, alpha*gamma, o_null, 1.0, o_y);
+  }
+}
+
+void parBSR::SpMV(const dfloat alpha, occa::memory o_x, const dfloat beta,
+                  occa::memory o_y, occa::memory o_z) {
+
+  this->haloExchangeStart(o_x);
+
+  // z[i] = beta*y[i] + alpha* (sum_{ij} Aij*x[j])
+  E->SpMV(alpha, o_x, beta, o_y, o_z);
+
+  this->haloExchangeFinish(o_x);
+
+  C->SpMV(alpha, o_x, 1.0, o_z);
+
+  //rank 1 correction if there is a nullspace
+  if (nullSpace) {
+    dfloat gamma = vectorInnerProd(Nrows, o_null, o_x, comm)*nullSpacePenalty;
+    vectorAdd(Nrows, alpha*gamma, o_null, 1.0, o_z);
+  }
+}
+
 
 } //namespace parAlmond
\ No newline at end of file
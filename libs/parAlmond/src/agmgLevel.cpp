@@ -55,6 +55,7 @@ agmgLevel::~agmgLevel() {
 
   delete   A; delete   P; delete   R;
   delete o_A; delete o_P; delete o_R;
+  delete o_Ab;
 
 }
 
@@ -82,7 +83,10 @@ void agmgLevel::prolongate(dfloat *x, dfloat *Px){
 
 void agmgLevel::residual  (dfloat *rhs, dfloat *x, dfloat *res) { A->SpMV(-1.0, x, 1.0, rhs, res); }
 
-void agmgLevel::Ax        (occa::memory o_x, occa::memory o_Ax){ o_A->SpMV(1.0, o_x, 0.0, o_Ax); }
+void agmgLevel::Ax        (occa::memory o_x, occa::memory o_Ax){
+  if (o_Ab) o_Ab->SpMV(1.0, o_x, 0.0, o_Ax);
+  else      o_A->SpMV(1.0, o_x, 0.0, o_Ax);
+}
 
 void agmgLevel::coarsen   (occa::memory o_r, occa::memory o_Rr){
   if (gatherLevel) {
@@ -104,7 +108,10 @@ void agmgLevel::prolongate(occa::memory o_x, occa::memory o_Px){
   }
 }
 
-void agmgLevel::residual  (occa::memory o_rhs, occa::memory o_x, occa::memory o_res) { o_A->SpMV(-1.0, o_x, 1.0, o_rhs, o_res); }
+void agmgLevel::residual  (occa::memory o_rhs, occa::memory o_x, occa::memory o_res) {
+  if (o_Ab) o_Ab->SpMV(-1.0, o_x, 1.0, o_rhs, o_res);
+  else      o_A->SpMV(-1.0, o_x, 1.0, o_rhs, o_res);
+}
 
 void agmgLevel::smooth(dfloat *rhs, dfloat *x, bool x_is_zero){
   if(stype == JACOBI){
@@ -36,6 +36,30 @@ void solver_t::AMGSetup(parCSR *A){
 
   AMGstartLev = numLevels;
 
+  //block aggregation needs whole nodes on each rank
+  if (blockSize>1) {
+    int blockError = (A->Nrows%blockSize) ? 1 : 0;
+    int globalBlockError = 0;
+    MPI_Allreduce(&blockError, &globalBlockError, 1, MPI_INT, MPI_MAX, comm);
+    if (globalBlockError) {
+      if (rank==0)
+        printf("WARNING:  PARALMOND BLOCK SIZE %d does not divide the local row counts.  Using scalar AMG.\n", blockSize);
+      blockSize = 1;
+    } else {
+      buildParAlmondBlockKernels(comm, device, blockSize);
+    }
+  }
+  A->blockDiagSetup(blockSize);
+
+  if (options.compareArgs("PARALMOND SETUP", "DEVICE")) {
+    if (options.compareArgs("PARALMOND AGGREGATION STRATEGY", "LPSCN") || blockSize>1) {
+      if (rank==0)
+        printf("WARNING:  PARALMOND SETUP DEVICE supports scalar DEFAULT aggregation only.  Using host setup.\n");
+    } else {
+      buildParAlmondSetupKernels(comm, device);
+    }
+  }
+
   agmgLevel *L = new agmgLevel(A, ktype);
   levels[numLevels] = L;
 
@@ -77,6 +101,74 @@ void solver_t::AMGSetup(parCSR *A){
   coarseLevel->syncToDevice();
 }
 
+//collapse a node-interleaved matrix to its node graph. Each block is replaced
+// by its Frobenius norm, negated off the diagonal so strongGraph sees every
+// block coupling as a candidate strong connection.
+static parCSR *collapseBlocks(parCSR *A) {
+
+  int rank, size;
+  MPI_Comm_rank(A->comm, &rank);
+  MPI_Comm_size(A->comm, &size);
+
+  const int bs = A->blockSize;
+  const dlong Nnodes = A->Nrows/bs;
+  const hlong globalOffset = A->globalRowStarts[rank];
+
+  hlong *nodeStarts = (hlong *) calloc(size+1,sizeof(hlong));
+  for (int r=0;r<size+1;r++) nodeStarts[r] = A->globalRowStarts[r]/bs;
+
+  dlong nnz = A->diag->nnz + A->offd->nnz;
+  nonzero_t *nonZeros = (nonzero_t *) calloc(nnz, sizeof(nonzero_t));
+
+  dlong cnt = 0;
+  for (dlong i=0;i<A->Nrows;i++) {
+    const hlong row = (i+globalOffset)/bs;
+    for (dlong jj=A->diag->rowStarts[i];jj<A->diag->rowStarts[i+1];jj++) {
+      nonZeros[cnt].row = row;
+      nonZeros[cnt].col = (A->diag->cols[jj]+globalOffset)/bs;
+      nonZeros[cnt].val = A->diag->vals[jj]*A->diag->vals[jj];
+      cnt++;
+    }
+    for (dlong jj=A->offd->rowStarts[i];jj<A->offd->rowStarts[i+1];jj++) {
+      nonZeros[cnt].row = row;
+      nonZeros[cnt].col = A->colMap[A->offd->cols[jj]]/bs;
+      nonZeros[cnt].val = A->offd->vals[jj]*A->offd->vals[jj];
+      cnt++;
+    }
+  }
+
+  qsort(nonZeros, nnz, sizeof(nonzero_t), compareNonZeroByRow);
+
+  //compress nonzeros
+  hlong  *Ai    = (hlong *)  calloc(nnz, sizeof(hlong));
+  hlong  *Aj    = (hlong *)  calloc(nnz, sizeof(hlong));
+  dfloat *Avals = (dfloat *) calloc(nnz, sizeof(dfloat));
+
+  dlong nodeNnz = 0;
+  for (dlong n=0;n<nnz;n++) {
+    if ((nodeNnz==0) || (nonZeros[n].row!=Ai[nodeNnz-1])
+                     || (nonZeros[n].col!=Aj[nodeNnz-1])) {
+      Ai[nodeNnz] = nonZeros[n].row;
+      Aj[nodeNnz] = nonZeros[n].col;
+      nodeNnz++;
+    }
+    Avals[nodeNnz-1] += nonZeros[n].val;
+  }
+  for (dlong n=0;n<nodeNnz;n++)
+    Avals[n] = (Ai[n]==Aj[n]) ? sqrt(Avals[n]) : -sqrt(Avals[n]);
+
+  dfloat *null = (dfloat *) calloc(Nnodes, sizeof(dfloat));
+
+  parCSR *Anode = new parCSR(Nnodes, nodeStarts, nodeNnz, Ai, Aj, Avals,
+                             false, null, 0.0, A->comm, A->device);
+
+  free(nonZeros);
+  free(Ai); free(Aj); free(Avals);
+  free(null);
+
+  return Anode;
+}
+
 //create coarsened problem
 agmgLevel *coarsenAgmgLevel(agmgLevel *level, KrylovType ktype, setupAide options){
 
@@ -84,21 +176,52 @@ agmgLevel *coarsenAgmgLevel(agmgLevel *level, KrylovType ktype, setupAide option
   MPI_Comm_rank(level->comm, &rank);
   MPI_Comm_size(level->comm, &size);
 
-  parCSR *C = strongGraph(level->A);
+  const int bs = level->A->blockSize;
 
   hlong *FineToCoarse = (hlong *) malloc(level->A->Ncols*sizeof(hlong));
   hlong *globalAggStarts = (hlong *) calloc(size+1,sizeof(hlong));
 
-  formAggregates(level->A, C, FineToCoarse, globalAggStarts, options);
+  const bool deviceSetup = (bs==1) && setupKernelsBuilt
+                           && options.compareArgs("PARALMOND SETUP", "DEVICE")
+                           && !options.compareArgs("PARALMOND AGGREGATION STRATEGY", "LPSCN");
+
+  if (deviceSetup) {
+    deviceFormAggregates(level->A, FineToCoarse, globalAggStarts);
+  } else if (bs==1) {
+    parCSR *C = strongGraph(level->A);
+
+    formAggregates(level->A, C, FineToCoarse, globalAggStarts, options);
+  } else {
+    //aggregate whole nodes on the collapsed graph, then give each
+    // aggregate one coarse unknown per component
+    parCSR *Anode = collapseBlocks(level->A);
+    parCSR *C = strongGraph(Anode);
+
+    hlong *nodeFineToCoarse = (hlong *) malloc(Anode->Ncols*sizeof(hlong));
+    hlong *nodeAggStarts = (hlong *) calloc(size+1,sizeof(hlong));
+
+    formAggregates(Anode, C, nodeFineToCoarse, nodeAggStarts, options);
+
+    for (dlong i=0;i<level->A->Nrows;i++)
+      FineToCoarse[i] = nodeFineToCoarse[i/bs]*bs + i%bs;
+    for (int r=0;r<size+1;r++)
+      globalAggStarts[r] = nodeAggStarts[r]*bs;
+
+    free(nodeFineToCoarse);
+    free(nodeAggStarts);
+    delete Anode;
+  }
 
   // adjustPartition(FineToCoarse, options);
 
   dfloat *nullCoarseA;
   parCSR *P = constructProlongation(level->A, FineToCoarse, globalAggStarts, &nullCoarseA);
   parCSR *R = transpose(P);
-  parCSR *A = galerkinProd(level->A, P);
+  parCSR *A = deviceSetup ? deviceGalerkinProd(level->A, P)
+                         : galerkinProd(level->A, P);
 
   A->null = nullCoarseA;
+  A->blockDiagSetup(bs);
 
   agmgLevel *coarseLevel = new agmgLevel(A,P,R, ktype);
 
@@ -126,29 +249,53 @@ void setupAgmgSmoother(agmgLevel *level, SmoothType s, int ChebIterations){
   }
 }
 
+static void rehomeCSR(CSR *A) {
+  A->rowStarts = (dlong *)  parallelRehome(A->rowStarts, A->Nrows+1, sizeof(dlong));
+  if (A->nnz) {
+    A->cols = (dlong *)  parallelRehome(A->cols, A->nnz, sizeof(dlong));
+    A->vals = (dfloat *) parallelRehome(A->vals, A->nnz, sizeof(dfloat));
+  }
+}
+
 void allocateAgmgVectors(agmgLevel *level, int k, int AMGstartLev, CycleType ctype) {
 
-  if (k) level->x    = (dfloat *) calloc(level->Ncols,sizeof(dfloat));
-  if (k) level->rhs  = (dfloat *) calloc(level->Nrows,sizeof(dfloat));
+  if (k) level->x    = (dfloat *) parallelCalloc(level->Ncols,sizeof(dfloat));
+  if (k) level->rhs  = (dfloat *) parallelCalloc(level->Nrows,sizeof(dfloat));
 
-  level->res  = (dfloat *) calloc(level->Ncols,sizeof(dfloat));
+  level->res  = (dfloat *) parallelCalloc(level->Ncols,sizeof(dfloat));
 
   //kcycle vectors
   if (ctype==KCYCLE) {
     if ((k>0) && (k<NUMKCYCLES+1)) {
-      level->ck = (dfloat *) calloc(level->Ncols,sizeof(dfloat));
-      level->vk = (dfloat *) calloc(level->Nrows,sizeof(dfloat));
-      level->wk = (dfloat *) calloc(level->Nrows,sizeof(dfloat));
+      level->ck = (dfloat *) parallelCalloc(level->Ncols,sizeof(dfloat));
+      level->vk = (dfloat *) parallelCalloc(level->Nrows,sizeof(dfloat));
+      level->wk = (dfloat *) parallelCalloc(level->Nrows,sizeof(dfloat));
     }
   }
+
+  //move the host operators onto the NUMA nodes of the threads applying them
+  rehomeCSR(level->A->diag);
+  rehomeCSR(level->A->offd);
+  if (k>AMGstartLev) {
+    rehomeCSR(level->P->diag);
+    rehomeCSR(level->P->offd);
+    rehomeCSR(level->R->diag);
+    rehomeCSR(level->R->offd);
+  }
 }
 
 void syncAgmgToDevice(agmgLevel *level, int k, int AMGstartLev, CycleType ctype) {
 
   occa::device device = level->A->device;
 
-  level->o_A = new parHYB(level->A);
-  level->o_A->syncToDevice();
+  if (level->A->blockSize>1) {
+    level->o_A  = NULL;
+    level->o_Ab = new parBSR(level->A);
+    level->o_Ab->syncToDevice();
+  } else {
+    level->o_A = new parHYB(level->A);
+    level->o_A->syncToDevice();
+  }
   if (k>AMGstartLev) {
     level->o_R = new parHYB(level->R);
     level->o_P = new parHYB(level->P);
@@ -0,0 +1,351 @@
+/*
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Tim Warburton, Noel Chalmers, Jesse Chan, Ali Karakus, Rajesh Gandham
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "parAlmond.hpp"
+
+namespace parAlmond {
+
+/*****************************************************************************/
+// Device AMG setup (PARALMOND SETUP = DEVICE)
+//
+// strongGraph, the MIS-2 aggregation of formAggregatesDefault and the fine
+// PTAP products of galerkinProd run as OCCA kernels, with halos shared by
+// the device gather-scatter. Prefix sums over per-row/per-block counts, the
+// prolongator (one nonzero per row) and the sort/exchange/compress of the
+// coarse nonzeros stay on the host.
+//
+/*****************************************************************************/
+
+//device copy of the level operator, uploaded once and shared by the
+// aggregation and the Galerkin product of the same level
+typedef struct {
+  parCSR *A;
+
+  occa::memory o_diagRowStarts, o_diagCols, o_diagVals;
+  occa::memory o_offdRowStarts, o_offdCols, o_offdVals;
+  occa::memory o_diagA;
+  occa::memory o_colMap;
+} setupCSR_t;
+
+static setupCSR_t setupA = {NULL};
+
+//zero-length arrays are still passed as kernel arguments
+static occa::memory setupMalloc(occa::device device, size_t bytes, void *src=NULL) {
+  if (bytes==0) return device.malloc(sizeof(dfloat));
+  if (src) return device.malloc(bytes, src);
+
+  void *zeros = calloc(bytes, 1);
+  occa::memory o_mem = device.malloc(bytes, zeros);
+  free(zeros);
+  return o_mem;
+}
+
+static void freeSetupCSR() {
+  if (setupA.A==NULL) return;
+
+  setupA.o_diagRowStarts.free(); setupA.o_diagCols.free(); setupA.o_diagVals.free();
+  setupA.o_offdRowStarts.free(); setupA.o_offdCols.free(); setupA.o_offdVals.free();
+  setupA.o_diagA.free();
+  setupA.o_colMap.free();
+  setupA.A = NULL;
+}
+
+static setupCSR_t &uploadSetupCSR(parCSR *A) {
+
+  if (setupA.A==A) return setupA;
+  freeSetupCSR();
+
+  occa::device device = A->device;
+  const dlong N = A->Nrows;
+  const dlong M = A->Ncols;
+
+  setupA.o_diagRowStarts = setupMalloc(device, (N+1)*sizeof(dlong), A->diag->rowStarts);
+  setupA.o_diagCols      = setupMalloc(device, A->diag->nnz*sizeof(dlong),  A->diag->cols);
+  setupA.o_diagVals      = setupMalloc(device, A->diag->nnz*sizeof(dfloat), A->diag->vals);
+  setupA.o_offdRowStarts = setupMalloc(device, (N+1)*sizeof(dlong), A->offd->rowStarts);
+  setupA.o_offdCols      = setupMalloc(device, A->offd->nnz*sizeof(dlong),  A->offd->cols);
+  setupA.o_offdVals      = setupMalloc(device, A->offd->nnz*sizeof(dfloat), A->offd->vals);
+  setupA.o_diagA         = setupMalloc(device, M*sizeof(dfloat), A->diagA);
+  setupA.o_colMap        = setupMalloc(device, M*sizeof(hlong),  A->colMap);
+  setupA.A = A;
+
+  return setupA;
+}
+
+//in-place exclusive scan of the N+1 row counts in o_rowStarts
+static dlong scanRowStarts(dlong N, occa::memory o_rowStarts) {
+  dlong *rowStarts = (dlong *) calloc(N+1, sizeof(dlong));
+  o_rowStarts.copyTo(rowStarts, (N+1)*sizeof(dlong), 0);
+  rowStarts[0] = 0;
+  for (dlong i=0;i<N;i++) rowStarts[i+1] += rowStarts[i];
+  o_rowStarts.copyFrom(rowStarts, (N+1)*sizeof(dlong), 0);
+
+  dlong nnz = rowStarts[N];
+  free(rowStarts);
+  return nnz;
+}
+
+void deviceFormAggregates(parCSR *A, hlong *FineToCoarse, hlong *globalAggStarts) {
+
+  int rank, size;
+  MPI_Comm_rank(A->comm, &rank);
+  MPI_Comm_size(A->comm, &size);
+
+  occa::device device = A->device;
+  setupCSR_t &dA = uploadSetupCSR(A);
+
+  const dlong N = A->Nrows;
+  const dlong M = A->Ncols;
+  const hlong globalOffset = A->globalRowStarts[rank];
+
+  //strong graph
+  occa::memory o_maxOD          = setupMalloc(device, N*sizeof(dfloat));
+  occa::memory o_CdiagRowStarts = setupMalloc(device, (N+1)*sizeof(dlong));
+  occa::memory o_CoffdRowStarts = setupMalloc(device, (N+1)*sizeof(dlong));
+
+  if (N)
+    strongGraphCountKernel(N, dA.o_diagRowStarts, dA.o_diagCols, dA.o_diagVals,
+                              dA.o_offdRowStarts, dA.o_offdCols, dA.o_offdVals,
+                              dA.o_diagA, o_maxOD, o_CdiagRowStarts, o_CoffdRowStarts);
+
+  const dlong CdiagNnz = scanRowStarts(N, o_CdiagRowStarts);
+  const dlong CoffdNnz = scanRowStarts(N, o_CoffdRowStarts);
+
+  occa::memory o_CdiagCols = setupMalloc(device, CdiagNnz*sizeof(dlong));
+  occa::memory o_CoffdCols = setupMalloc(device, CoffdNnz*sizeof(dlong));
+
+  if (N)
+    strongGraphFillKernel(N, dA.o_diagRowStarts, dA.o_diagCols, dA.o_diagVals,
+                             dA.o_offdRowStarts, dA.o_offdCols, dA.o_offdVals,
+                             dA.o_diagA, o_maxOD,
+                             o_CdiagRowStarts, o_CdiagCols,
+                             o_CoffdRowStarts, o_CoffdCols);
+  o_maxOD.free();
+
+  //MIS-2 aggregation
+  dfloat *rands = (dfloat *) calloc(M, sizeof(dfloat));
+  for(dlong i=0; i<N; i++)
+    rands[i] = (dfloat) drand48();
+
+  occa::memory o_rands  = setupMalloc(device, M*sizeof(dfloat), rands);
+  occa::memory o_colCnt = setupMalloc(device, M*sizeof(int));
+  occa::memory o_states = setupMalloc(device, M*sizeof(int));
+  occa::memory o_Ts     = setupMalloc(device, M*sizeof(int));
+  occa::memory o_Tr     = setupMalloc(device, M*sizeof(dfloat));
+  occa::memory o_Ti     = setupMalloc(device, M*sizeof(hlong));
+  occa::memory o_Tc     = setupMalloc(device, M*sizeof(hlong));
+  occa::memory o_FineToCoarse    = setupMalloc(device, M*sizeof(hlong));
+  occa::memory o_newFineToCoarse = setupMalloc(device, M*sizeof(hlong));
+  free(rands);
+
+  //per-block counts, one block per p_BLOCKSIZE nodes
+  const dlong Nblocks = (M+BLOCKSIZE-1)/BLOCKSIZE;
+  dlong *blockCounts = (dlong *) calloc(Nblocks+1, sizeof(dlong));
+  hlong *blockStarts = (hlong *) calloc(Nblocks+1, sizeof(hlong));
+  occa::memory o_blockCounts = setupMalloc(device, Nblocks*sizeof(dlong));
+  occa::memory o_blockStarts = setupMalloc(device, Nblocks*sizeof(hlong));
+
+  // add the number of non-zeros in each column and a random pertubation
+  if (N) misColumnCountKernel(N, o_CdiagRowStarts, o_CdiagCols,
+                                 o_CoffdRowStarts, o_CoffdCols, o_colCnt);
+  ogsGatherScatter(o_colCnt, ogsInt, ogsAdd, A->ogs);
+
+  if (N) misPerturbKernel(N, o_colCnt, o_rands);
+  ogsGatherScatter(o_rands, ogsDfloat, ogsAdd, A->ogs);
+
+  hlong done = 0;
+  while(!done){
+    if (M) misFirstNeighboursKernel(N, M, globalOffset,
+                                    o_CdiagRowStarts, o_CdiagCols,
+                                    o_CoffdRowStarts, o_CoffdCols,
+                                    dA.o_colMap, o_states, o_rands,
+                                    o_Ts, o_Tr, o_Ti);
+
+    ogsGatherScatter(o_Tr, ogsDfloat, ogsAdd, A->ogs);
+    ogsGatherScatter(o_Ts, ogsInt,    ogsAdd, A->ogs);
+    ogsGatherScatter(o_Ti, ogsHlong,  ogsAdd, A->ogs);
+
+    if (M) misSecondNeighboursKernel(N, M, globalOffset,
+                                     o_CdiagRowStarts, o_CdiagCols,
+                                     o_CoffdRowStarts, o_CoffdCols,
+                                     o_Ts, o_Tr, o_Ti, o_states);
+
+    ogsGatherScatter(o_states, ogsInt, ogsAdd, A->ogs);
+
+    // if number of undecided nodes = 0, algorithm terminates
+    hlong cnt = 0;
+    if (Nblocks) {
+      misStateCountKernel(Nblocks, N, 0, o_states, o_blockCounts);
+      o_blockCounts.copyTo(blockCounts, Nblocks*sizeof(dlong), 0);
+      for (dlong b=0;b<Nblocks;b++) cnt += blockCounts[b];
+    }
+    MPI_Allreduce(&cnt,&done,1,MPI_HLONG, MPI_SUM,A->comm);
+    done = (done == 0) ? 1 : 0;
+  }
+
+  // count the coarse nodes/aggregates
+  dlong numAggs = 0;
+  if (Nblocks) {
+    misStateCountKernel(Nblocks, N, 1, o_states, o_blockCounts);
+    o_blockCounts.copyTo(blockCounts, Nblocks*sizeof(dlong), 0);
+    for (dlong b=0;b<Nblocks;b++) numAggs += blockCounts[b];
+  }
+
+  dlong *gNumAggs = (dlong *) calloc(size,sizeof(dlong));
+  MPI_Allgather(&numAggs,1,MPI_DLONG,gNumAggs,1,MPI_DLONG,A->comm);
+
+  globalAggStarts[0] = 0;
+  for (int r=0;r<size;r++)
+    globalAggStarts[r+1] = globalAggStarts[r] + gNumAggs[r];
+  free(gNumAggs);
+
+  // enumerate the coarse nodes/aggregates
+  if (Nblocks) {
+    blockStarts[0] = globalAggStarts[rank];
+    for (dlong b=0;b<Nblocks;b++) blockStarts[b+1] = blockStarts[b] + blockCounts[b];
+    o_blockStarts.copyFrom(blockStarts, Nblocks*sizeof(hlong), 0);
+
+    misEnumerateKernel(Nblocks, N, M, o_blockStarts, o_states, o_FineToCoarse);
+  }
+
+  //share the initial aggregate flags
+  ogsGatherScatter(o_FineToCoarse, ogsHlong, ogsAdd, A->ogs);
+
+  // form the aggregates
+  if (M) aggregateFirstNeighboursKernel(N, M, globalOffset,
+                                        o_CdiagRowStarts, o_CdiagCols,
+                                        o_CoffdRowStarts, o_CoffdCols,
+                                        dA.o_colMap, o_states, o_rands, o_FineToCoarse,
+                                        o_Ts, o_Tr, o_Ti, o_Tc, o_newFineToCoarse);
+
+  ogsGatherScatter(o_newFineToCoarse, ogsHlong,  ogsAdd, A->ogs);
+  ogsGatherScatter(o_Tr,              ogsDfloat, ogsAdd, A->ogs);
+  ogsGatherScatter(o_Ts,              ogsInt,    ogsAdd, A->ogs);
+  ogsGatherScatter(o_Ti,              ogsHlong,  ogsAdd, A->ogs);
+  ogsGatherScatter(o_Tc,              ogsHlong,  ogsAdd, A->ogs);
+
+  // second neighbours
+  if (M) aggregateSecondNeighboursKernel(N, M,
+                                         o_CdiagRowStarts, o_CdiagCols,
+                                         o_CoffdRowStarts, o_CoffdCols,
+                                         o_states, o_Ts, o_Tr, o_Ti, o_Tc,
+                                         o_newFineToCoarse);
+
+  ogsGatherScatter(o_newFineToCoarse, ogsHlong, ogsAdd, A->ogs);
+
+  if (M) o_newFineToCoarse.copyTo(FineToCoarse, M*sizeof(hlong), 0);
+
+  free(blockCounts);
+  free(blockStarts);
+
+  o_CdiagRowStarts.free(); o_CdiagCols.free();
+  o_CoffdRowStarts.free(); o_CoffdCols.free();
+  o_rands.free(); o_colCnt.free(); o_states.free();
+  o_Ts.free(); o_Tr.free(); o_Ti.free(); o_Tc.free();
+  o_FineToCoarse.free(); o_newFineToCoarse.free();
+  o_blockCounts.free(); o_blockStarts.free();
+}
+
+parCSR *deviceGalerkinProd(parCSR *A, parCSR *P) {
+
+  int rank, size;
+  MPI_Comm_rank(A->comm, &rank);
+  MPI_Comm_size(A->comm, &size);
+
+  occa::device device = A->device;
+  setupCSR_t &dA = uploadSetupCSR(A);
+
+  hlong *globalAggStarts = P->globalColStarts;
+  hlong globalAggOffset = globalAggStarts[rank];
+
+  const dlong N = A->Nrows;
+  const dlong M = A->Ncols;
+
+  //record the entries of P that this rank has
+  hlong  *Pcols = (hlong  *) calloc(M,sizeof(hlong));
+  dfloat *Pvals = (dfloat *) calloc(M,sizeof(dfloat));
+
+  dlong cnt =0;
+  for (dlong i=0;i<N;i++) {
+    for (dlong j=P->diag->rowStarts[i];j<P->diag->rowStarts[i+1];j++) {
+      Pcols[cnt] = P->diag->cols[j] + globalAggOffset; //global ID
+      Pvals[cnt] = P->diag->vals[j];
+      cnt++;
+    }
+    for (dlong j=P->offd->rowStarts[i];j<P->offd->rowStarts[i+1];j++) {
+      Pcols[cnt] = P->colMap[P->offd->cols[j]]; //global ID
+      Pvals[cnt] = P->offd->vals[j];
+      cnt++;
+    }
+  }
+
+  occa::memory o_Pcols = setupMalloc(device, M*sizeof(hlong),  Pcols);
+  occa::memory o_Pvals = setupMalloc(device, M*sizeof(dfloat), Pvals);
+  free(Pcols);
+  free(Pvals);
+
+  //fill the halo region
+  ogsGatherScatter(o_Pcols, ogsHlong,  ogsAdd, A->ogs);
+  ogsGatherScatter(o_Pvals, ogsDfloat, ogsAdd, A->ogs);
+
+  //form the fine PTAP products
+  const dlong sendNtotal = A->diag->nnz+A->offd->nnz;
+
+  occa::memory o_PTAProws = setupMalloc(device, sendNtotal*sizeof(hlong));
+  occa::memory o_PTAPcols = setupMalloc(device, sendNtotal*sizeof(hlong));
+  occa::memory o_PTAPvals = setupMalloc(device, sendNtotal*sizeof(dfloat));
+
+  if (N) galerkinTriplesKernel(N, dA.o_diagRowStarts, dA.o_diagCols, dA.o_diagVals,
+                                  dA.o_offdRowStarts, dA.o_offdCols, dA.o_offdVals,
+                                  o_Pcols, o_Pvals, o_PTAProws, o_PTAPcols, o_PTAPvals);
+
+  hlong  *PTAProws = (hlong *)  malloc(sendNtotal*sizeof(hlong));
+  hlong  *PTAPcols = (hlong *)  malloc(sendNtotal*sizeof(hlong));
+  dfloat *PTAPvals = (dfloat *) malloc(sendNtotal*sizeof(dfloat));
+  if (sendNtotal) {
+    o_PTAProws.copyTo(PTAProws, sendNtotal*sizeof(hlong),  0);
+    o_PTAPcols.copyTo(PTAPcols, sendNtotal*sizeof(hlong),  0);
+    o_PTAPvals.copyTo(PTAPvals, sendNtotal*sizeof(dfloat), 0);
+  }
+
+  nonzero_t *sendPTAP = (nonzero_t *) calloc(sendNtotal,sizeof(nonzero_t));
+  for (dlong n=0;n<sendNtotal;n++) {
+    sendPTAP[n].row = PTAProws[n];
+    sendPTAP[n].col = PTAPcols[n];
+    sendPTAP[n].val = PTAPvals[n];
+  }
+
+  free(PTAProws); free(PTAPcols); free(PTAPvals);
+  o_PTAProws.free(); o_PTAPcols.free(); o_PTAPvals.free();
+  o_Pcols.free(); o_Pvals.free();
+
+  //the level operator is not needed on the device past this point
+  freeSetupCSR();
+
+  return assemblePTAP(A, globalAggStarts, sendNtotal, sendPTAP);
+}
+
+} //namespace parAlmond
@@ -75,21 +75,6 @@ parCSR *galerkinProd(parCSR *A, parCSR *P){
   dlong sendNtotal = A->diag->nnz+A->offd->nnz;
   nonzero_t *sendPTAP = (nonzero_t *) calloc(sendNtotal,sizeof(nonzero_t));
 
-  // Make the MPI_NONZERO_T data type
-  nonzero_t NZ;
-  MPI_Datatype MPI_NONZERO_T;
-  MPI_Datatype dtype[3] = {MPI_HLONG, MPI_HLONG, MPI_DFLOAT};
-  int blength[3] = {1, 1, 1};
-  MPI_Aint addr[3], displ[3];
-  MPI_Get_address ( &(NZ.row), addr+0);
-  MPI_Get_address ( &(NZ.col), addr+1);
-  MPI_Get_address ( &(NZ.val), addr+2);
-  displ[0] = 0;
-  displ[1] = addr[1] - addr[0];
-  displ[2] = addr[2] - addr[0];
-  MPI_Type_create_struct (3, blength, displ, dtype, &MPI_NONZERO_T);
-  MPI_Type_commit (&MPI_NONZERO_T);
-
   //form the fine PTAP products
   cnt =0;
   for (dlong i=0;i<N;i++) {
@@ -120,6 +105,36 @@ parCSR *galerkinProd(parCSR *A, parCSR *P){
   free(Pcols);
   free(Pvals);
 
+  return assemblePTAP(A, globalAggStarts, sendNtotal, sendPTAP);
+}
+
+//send the fine PTAP products to the ranks owning their coarse rows, sum
+// the duplicates, and build the coarse parCSR. Frees sendPTAP.
+parCSR *assemblePTAP(parCSR *A, hlong *globalAggStarts,
+                     dlong sendNtotal, nonzero_t *sendPTAP){
+
+  // MPI info
+  int rank, size;
+  MPI_Comm_rank(A->comm, &rank);
+  MPI_Comm_size(A->comm, &size);
+
+  hlong globalAggOffset = globalAggStarts[rank];
+
+  // Make the MPI_NONZERO_T data type
+  nonzero_t NZ;
+  MPI_Datatype MPI_NONZERO_T;
+  MPI_Datatype dtype[3] = {MPI_HLONG, MPI_HLONG, MPI_DFLOAT};
+  int blength[3] = {1, 1, 1};
+  MPI_Aint addr[3], displ[3];
+  MPI_Get_address ( &(NZ.row), addr+0);
+  MPI_Get_address ( &(NZ.col), addr+1);
+  MPI_Get_address ( &(NZ.val), addr+2);
+  displ[0] = 0;
+  displ[1] = addr[1] - addr[0];
+  displ[2] = addr[2] - addr[0];
+  MPI_Type_create_struct (3, blength, displ, dtype, &MPI_NONZERO_T);
+  MPI_Type_commit (&MPI_NONZERO_T);
+
   //sort entries by the coarse row and col
   qsort(sendPTAP, sendNtotal, sizeof(nonzero_t), compareNonZeroByRow);
 
@@ -217,7 +232,7 @@ parCSR *galerkinProd(parCSR *A, parCSR *P){
 
   // Halo setup
   hlong *colIds = (hlong *) malloc(Ac->offd->nnz*sizeof(hlong));
-  cnt=0;
+  dlong cnt=0;
   for (dlong n=0;n<nnz;n++) {
     if ((PTAP[n].col <= (globalAggStarts[rank]-1))||
         (PTAP[n].col >= globalAggStarts[rank+1])) {
@@ -28,19 +28,35 @@ SOFTWARE.
 
 namespace parAlmond {
 
+void agmgLevel::applyDinv(const dfloat alpha, dfloat *x,
+                          const dfloat beta, dfloat *y) {
+  if (A->blockSize>1)
+    blockDotStar(Nrows/A->blockSize, A->blockSize, alpha, A->blockDiagInv, x, beta, y);
+  else
+    vectorDotStar(Nrows, alpha, A->diagInv, x, beta, y);
+}
+
+void agmgLevel::applyDinv(const dfloat alpha, occa::memory o_x,
+                          const dfloat beta, occa::memory o_y) {
+  if (o_Ab)
+    blockDotStar(Nrows/o_Ab->bs, o_Ab->bs, alpha, o_Ab->o_blockDiagInv, o_x, beta, o_y);
+  else
+    vectorDotStar(Nrows, alpha, o_A->o_diagInv, o_x, beta, o_y);
+}
+
 void agmgLevel::smoothJacobi(dfloat *r, dfloat *x,
                              const bool x_is_zero) {
 
   // x = x + inv(D)*(b-A*x)
   if(x_is_zero){
-    vectorDotStar(Nrows,1.0,A->diagInv,r,0.0,x);
+    this->applyDinv(1.0, r, 0.0, x);
     return;
   }
 
   static dfloat *res = (dfloat *) scratch;
 
-  A->SpMV(-1.0, x, 1.0, r, res);
-  vectorDotStar(Nrows, 1.0, A->diagInv, res, 1.0, x);
+  this->residual(r, x, res);
+  this->applyDinv(1.0, res, 1.0, x);
 }
 
 
@@ -49,14 +65,14 @@ void agmgLevel::smoothDampedJacobi(dfloat *r, dfloat *x,
 
   // x = x + alpha*inv(D)*(b-A*x)
   if(x_is_zero){
-    vectorDotStar(Nrows,lambda,A->diagInv,r,0.0,x);
+    this->applyDinv(lambda, r, 0.0, x);
     return;
   }
 
   static dfloat *res = (dfloat *) scratch;
 
-  A->SpMV(-1.0, x, 1.0, r, res);
-  vectorDotStar(Nrows, lambda, A->diagInv, res, 1.0, x);
+  this->residual(r, x, res);
+  this->applyDinv(lambda, res, 1.0, x);
 }
 
 void agmgLevel::smoothChebyshev(dfloat *r, dfloat *x,
@@ -75,14 +91,14 @@ void agmgLevel::smoothChebyshev(dfloat *r, dfloat *x,
 
   if(x_is_zero){ //skip the Ax if x is zero
     //res = D^{-1}r
-    vectorDotStar(Nrows, 1.0, A->diagInv, r, 0.0, res);
+    this->applyDinv(1.0, r, 0.0, res);
     vectorSet(Nrows, 0.0, x);
     //d = invTheta*res
     vectorAdd(Nrows, invTheta, res, 0.0, d);
   } else {
     //res = D^{-1}(r-Ax)
-    A->SpMV(-1.0, x, 1.0, r, res);
-    vectorDotStar(Nrows, A->diagInv, res);
+    this->residual(r, x, Ad);
+    this->applyDinv(1.0, Ad, 0.0, res);
 
     //d = invTheta*res
     vectorAdd(Nrows, invTheta, res, 0.0, d);
@@ -93,8 +109,8 @@ void agmgLevel::smoothChebyshev(dfloat *r, dfloat *x,
     vectorAdd(Nrows, 1.0, d, 1.0, x);
 
     //r_k+1 = r_k - D^{-1}Ad_k
-    A->SpMV(1.0, d, 0.0, Ad);
-    vectorDotStar(Nrows, -1.0, A->diagInv, Ad, 1.0, res);
+    this->Ax(d, Ad);
+    this->applyDinv(-1.0, Ad, 1.0, res);
 
     rho_np1 = 1.0/(2.*sigma-rho_n);
 
@@ -111,7 +127,7 @@ void agmgLevel::smoothJacobi(occa::memory o_r, occa::memory o_x,
 
   // occaTimerTic(parAlmond->device,"device smoothJacobi");
   if(x_is_zero){
-    vectorDotStar(Nrows, 1.0, o_A->o_diagInv, o_r, 0.0, o_x);
+    this->applyDinv(1.0, o_r, 0.0, o_x);
     // occaTimerToc(parAlmond->device,"device smoothJacobi");
     return;
   }
@@ -119,10 +135,10 @@ void agmgLevel::smoothJacobi(occa::memory o_r, occa::memory o_x,
   static occa::memory o_res = o_scratch;
 
   // res = r-A*x
-  o_A->SpMV(-1.0, o_x, 1.0, o_r, o_res);
+  this->residual(o_r, o_x, o_res);
 
   // x = x + alpha*inv(D)*res
-  vectorDotStar(Nrows, 1.0, o_A->o_diagInv, o_res, 1.0, o_x);
+  this->applyDinv(1.0, o_res, 1.0, o_x);
   // occaTimerToc(parAlmond->device,"hyb smoothJacobi");
 }
 
@@ -131,7 +147,7 @@ void agmgLevel::smoothDampedJacobi(occa::memory o_r, occa::memory o_x,
 
   // occaTimerTic(parAlmond->device,"device smoothDampedJacobi");
   if(x_is_zero){
-    vectorDotStar(Nrows, lambda, o_A->o_diagInv, o_r, 0.0, o_x);
+    this->applyDinv(lambda, o_r, 0.0, o_x);
     // occaTimerToc(parAlmond->device,"device smoothDampedJacobi");
     return;
   }
@@ -139,10 +155,10 @@ void agmgLevel::smoothDampedJacobi(occa::memory o_r, occa::memory o_x,
   static occa::memory o_res = o_scratch;
 
   // res = r-A*x
-  o_A->SpMV(-1.0, o_x, 1.0, o_r, o_res);
+  this->residual(o_r, o_x, o_res);
 
   // x = x + alpha*inv(D)*res
-  vectorDotStar(Nrows, lambda, o_A->o_diagInv, o_res, 1.0, o_x);
+  this->applyDinv(lambda, o_res, 1.0, o_x);
   // occaTimerToc(parAlmond->device,"device smoothDampedJacobi");
 }
 
@@ -164,14 +180,14 @@ void agmgLevel::smoothChebyshev(occa::memory o_r, occa::memory o_x,
 
   if(x_is_zero){ //skip the Ax if x is zero
     //res = D^{-1}r
-    vectorDotStar(Nrows, 1.0, o_A->o_diagInv, o_r, 0.0, o_res);
+    this->applyDinv(1.0, o_r, 0.0, o_res);
     vectorSet(Nrows, 0.0, o_x);
     //d = invTheta*res
     vectorAdd(Nrows, invTheta, o_res, 0.0, o_d);
   } else {
     //res = D^{-1}(r-Ax)
-    o_A->SpMV(-1.0, o_x, 1.0, o_r, o_res);
-    vectorDotStar(Nrows, o_A->o_diagInv, o_res);
+    this->residual(o_r, o_x, o_Ad);
+    this->applyDinv(1.0, o_Ad, 0.0, o_res);
 
     //d = invTheta*res
     vectorAdd(Nrows, invTheta, o_res, 0.0, o_d);
@@ -182,8 +198,8 @@ void agmgLevel::smoothChebyshev(occa::memory o_r, occa::memory o_x,
     vectorAdd(Nrows, 1.0, o_d, 1.0, o_x);
 
     //r_k+1 = r_k - D^{-1}Ad_k
-    o_A->SpMV(1.0, o_d, 0.0, o_Ad);
-    vectorDotStar(Nrows, -1.0, o_A->o_diagInv, o_Ad, 1.0, o_res);
+    this->Ax(o_d, o_Ad);
+    this->applyDinv(-1.0, o_Ad, 1.0, o_res);
 
     rho_np1 = 1.0/(2.*sigma-rho_n);
 
@@ -188,7 +188,7 @@ void coarseSolver::solve(dfloat *rhs, dfloat *x) {
                    rhsCoarse, coarseCounts, coarseOffsets, MPI_DFLOAT, comm);
 
     //multiply by local part of the exact matrix inverse
-    // #pragma omp parallel for
+    #pragma omp parallel for
     for (int n=0;n<N;n++) {
       xLocal[n] = 0.;
       for (int m=0;m<coarseTotal;m++) {
@@ -203,7 +203,7 @@ void coarseSolver::solve(dfloat *rhs, dfloat *x) {
                    rhsCoarse, coarseCounts, coarseOffsets, MPI_DFLOAT, comm);
 
     //multiply by local part of the exact matrix inverse
-    // #pragma omp parallel for
+    #pragma omp parallel for
     for (int n=0;n<N;n++) {
       x[n] = 0.;
       for (int m=0;m<coarseTotal;m++) {
@@ -229,7 +229,7 @@ void coarseSolver::solve(occa::memory o_rhs, occa::memory o_x) {
                  rhsCoarse, coarseCounts, coarseOffsets, MPI_DFLOAT, comm);
 
   //multiply by local part of the exact matrix inverse
-  // #pragma omp parallel for
+  #pragma omp parallel for
   for (int n=0;n<N;n++) {
     xLocal[n] = 0.;
     for (int m=0;m<coarseTotal;m++) {
@@ -0,0 +1,337 @@
+/*
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Tim Warburton, Noel Chalmers, Jesse Chan, Ali Karakus, Rajesh Gandham
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "parAlmond.hpp"
+
+namespace parAlmond {
+
+/*****************************************************************************/
+// AMG hierarchy files
+//
+// Each rank writes the AMG levels it owns (A, P, R and the smoother
+// parameters) to its own binary file. Halo plans are rebuilt from the saved
+// column maps on load, which is cheap next to aggregation and the Galerkin
+// products.
+//
+/*****************************************************************************/
+
+#define HIERARCHY_MAGIC   0x504c4d41 // "AMLP"
+#define HIERARCHY_VERSION 2
+
+typedef struct {
+  int magic;
+  int version;
+  int size;
+  int rank;
+  int dlongSize;
+  int hlongSize;
+  int dfloatSize;
+  int Nlevels;
+  int requestedBlockSize;
+  int blockSize;
+  int stype;
+  int ChebyshevIterations;
+  unsigned long long signature;
+} hierarchyHeader_t;
+
+static void hierarchyFileName(char *fileName, const char *baseName, int rank) {
+  sprintf(fileName, "%s_%05d.bin", baseName, rank);
+}
+
+//FNV-1a hash of a block of bytes, used to check a file against the operator
+unsigned long long hashBytes(const void *data, size_t bytes, unsigned long long hash) {
+  const unsigned char *c = (const unsigned char *) data;
+  for (size_t n=0;n<bytes;n++) {
+    hash ^= (unsigned long long) c[n];
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+
+static void writeCSR(FILE *fp, CSR *A) {
+  fwrite(&(A->nnz), sizeof(dlong), 1, fp);
+  fwrite(A->rowStarts, sizeof(dlong), A->Nrows+1, fp);
+  fwrite(A->cols, sizeof(dlong),  A->nnz, fp);
+  fwrite(A->vals, sizeof(dfloat), A->nnz, fp);
+}
+
+static void writeParCSR(FILE *fp, parCSR *A, int size) {
+
+  fwrite(&(A->Nrows),      sizeof(dlong), 1, fp);
+  fwrite(&(A->NlocalCols), sizeof(dlong), 1, fp);
+  fwrite(&(A->Ncols),      sizeof(dlong), 1, fp);
+
+  fwrite(A->globalRowStarts, sizeof(hlong), size+1, fp);
+  fwrite(A->globalColStarts, sizeof(hlong), size+1, fp);
+
+  writeCSR(fp, A->diag);
+  writeCSR(fp, A->offd);
+
+  fwrite(A->colMap,  sizeof(hlong),  A->Ncols, fp);
+  fwrite(A->diagA,   sizeof(dfloat), A->Nrows, fp);
+  fwrite(A->diagInv, sizeof(dfloat), A->Nrows, fp);
+
+  int nullSpace = A->nullSpace ? 1 : 0;
+  fwrite(&nullSpace, sizeof(int), 1, fp);
+  fwrite(&(A->nullSpacePenalty), sizeof(dfloat), 1, fp);
+
+  int hasNull = A->null ? 1 : 0;
+  fwrite(&hasNull, sizeof(int), 1, fp);
+  if (hasNull) fwrite(A->null, sizeof(dfloat), A->Nrows, fp);
+
+  fwrite(&(A->blockSize), sizeof(int), 1, fp);
+}
+
+//copy the next N entries of the file buffer into a
+static void unpack(char **buf, void *a, size_t size, size_t N) {
+  memcpy(a, *buf, size*N);
+  *buf += size*N;
+}
+
+static void readCSR(char **buf, CSR *A) {
+  unpack(buf, &(A->nnz), sizeof(dlong), 1);
+
+  A->rowStarts = (dlong *)  calloc(A->Nrows+1, sizeof(dlong));
+  A->cols      = (dlong *)  calloc(A->nnz, sizeof(dlong));
+  A->vals      = (dfloat *) calloc(A->nnz, sizeof(dfloat));
+
+  unpack(buf, A->rowStarts, sizeof(dlong), A->Nrows+1);
+  unpack(buf, A->cols, sizeof(dlong),  A->nnz);
+  unpack(buf, A->vals, sizeof(dfloat), A->nnz);
+}
+
+static parCSR *readParCSR(char **buf, int size, MPI_Comm comm, occa::device device) {
+
+  dlong Nrows, NlocalCols, Ncols;
+  unpack(buf, &Nrows,      sizeof(dlong), 1);
+  unpack(buf, &NlocalCols, sizeof(dlong), 1);
+  unpack(buf, &Ncols,      sizeof(dlong), 1);
+
+  parCSR *A = new parCSR(Nrows, NlocalCols, comm, device);
+
+  A->globalRowStarts = (hlong *) calloc(size+1, sizeof(hlong));
+  A->globalColStarts = (hlong *) calloc(size+1, sizeof(hlong));
+  unpack(buf, A->globalRowStarts, sizeof(hlong), size+1);
+  unpack(buf, A->globalColStarts, sizeof(hlong), size+1);
+
+  readCSR(buf, A->diag);
+  readCSR(buf, A->offd);
+
+  //rebuild the halo plans from the global ids of the offd columns
+  hlong *colMap = (hlong *) calloc(Ncols, sizeof(hlong));
+  unpack(buf, colMap, sizeof(hlong), Ncols);
+
+  hlong *colIds = (hlong *) malloc(A->offd->nnz*sizeof(hlong));
+  for (dlong n=0;n<A->offd->nnz;n++)
+    colIds[n] = colMap[A->offd->cols[n]];
+
+  A->haloSetup(colIds);
+
+  for (dlong n=0;n<A->offd->nnz;n++)
+    A->offd->cols[n] = (dlong) colIds[n];
+
+  free(colIds);
+  free(colMap);
+
+  A->diagA   = (dfloat *) calloc(A->Ncols, sizeof(dfloat));
+  A->diagInv = (dfloat *) calloc(A->Ncols, sizeof(dfloat));
+  unpack(buf, A->diagA,   sizeof(dfloat), Nrows);
+  unpack(buf, A->diagInv, sizeof(dfloat), Nrows);
+
+  //fill the halo region
+  ogsGatherScatter(A->diagA, ogsDfloat, ogsAdd, A->ogs);
+
+  int nullSpace;
+  unpack(buf, &nullSpace, sizeof(int), 1);
+  unpack(buf, &(A->nullSpacePenalty), sizeof(dfloat), 1);
+  A->nullSpace = (nullSpace==1);
+
+  int hasNull;
+  unpack(buf, &hasNull, sizeof(int), 1);
+  if (hasNull) {
+    A->null = (dfloat *) calloc(A->Ncols, sizeof(dfloat));
+    unpack(buf, A->null, sizeof(dfloat), Nrows);
+  }
+
+  int bs;
+  unpack(buf, &bs, sizeof(int), 1);
+  A->blockDiagSetup(bs);
+
+  return A;
+}
+
+void solver_t::Save(const char *baseName, unsigned long long signature) {
+
+  char fileName[BUFSIZ];
+  hierarchyFileName(fileName, baseName, rank);
+
+  FILE *fp = fopen(fileName, "wb");
+  if (fp==NULL) {
+    printf("WARNING:  Unable to open AMG hierarchy file %s for writing.\n", fileName);
+    return;
+  }
+
+  hierarchyHeader_t header;
+  header.magic = HIERARCHY_MAGIC;
+  header.version = HIERARCHY_VERSION;
+  header.size = size;
+  header.rank = rank;
+  header.dlongSize = sizeof(dlong);
+  header.hlongSize = sizeof(hlong);
+  header.dfloatSize = sizeof(dfloat);
+  header.Nlevels = numLevels-AMGstartLev;
+  header.requestedBlockSize = requestedBlockSize;
+  header.blockSize = blockSize;
+  header.stype = (int) stype;
+  header.ChebyshevIterations = ChebyshevIterations;
+  header.signature = signature;
+
+  fwrite(&header, sizeof(hierarchyHeader_t), 1, fp);
+
+  for (int n=AMGstartLev;n<numLevels;n++) {
+    agmgLevel *level = (agmgLevel *) levels[n];
+
+    fwrite(&(level->lambda),  sizeof(dfloat), 1, fp);
+    fwrite(&(level->lambda1), sizeof(dfloat), 1, fp);
+    fwrite(&(level->lambda0), sizeof(dfloat), 1, fp);
+
+    writeParCSR(fp, level->A, size);
+    if (n>AMGstartLev) {
+      writeParCSR(fp, level->P, size);
+      writeParCSR(fp, level->R, size);
+    }
+  }
+
+  fclose(fp);
+}
+
+//rebuild the AMG levels from a hierarchy file. Returns false on every rank,
+// leaving the solver untouched, if any rank's file is missing or was written
+// for a different operator, partition or setup.
+bool solver_t::Load(const char *baseName, unsigned long long signature) {
+
+  char fileName[BUFSIZ];
+  hierarchyFileName(fileName, baseName, rank);
+
+  hierarchyHeader_t header;
+  char *data = NULL;
+  size_t dataBytes = 0;
+
+  int ok = 1;
+  FILE *fp = fopen(fileName, "rb");
+  if (fp==NULL) ok = 0;
+
+  if (ok && fread(&header, sizeof(hierarchyHeader_t), 1, fp)!=1) ok = 0;
+
+  if (ok) {
+    ok = (header.magic==HIERARCHY_MAGIC)
+      && (header.version==HIERARCHY_VERSION)
+      && (header.size==size)
+      && (header.rank==rank)
+      && (header.dlongSize==sizeof(dlong))
+      && (header.hlongSize==sizeof(hlong))
+      && (header.dfloatSize==sizeof(dfloat))
+      && (header.requestedBlockSize==requestedBlockSize)
+      && (header.stype==(int) stype)
+      && (header.ChebyshevIterations==ChebyshevIterations)
+      && (header.signature==signature)
+      && (header.Nlevels>0) && (numLevels+header.Nlevels<=MAX_LEVELS);
+  }
+
+  //read the rest of the file before any collective setup starts
+  if (ok) {
+    long start = ftell(fp);
+    fseek(fp, 0, SEEK_END);
+    dataBytes = (size_t) (ftell(fp) - start);
+    fseek(fp, start, SEEK_SET);
+
+    data = (char *) malloc(dataBytes);
+    if (fread(data, 1, dataBytes, fp)!=dataBytes) ok = 0;
+  }
+  if (fp) fclose(fp);
+
+  int allOk = 0;
+  MPI_Allreduce(&ok, &allOk, 1, MPI_INT, MPI_MIN, comm);
+  if (!allOk) {
+    free(data);
+    return false;
+  }
+
+  //the block size the saved hierarchy was actually built with
+  blockSize = header.blockSize;
+  if (blockSize>1) buildParAlmondBlockKernels(comm, device, blockSize);
+
+  AMGstartLev = numLevels;
+
+  char *buf = data;
+  for (int n=0;n<header.Nlevels;n++) {
+    dfloat lambda, lambda1, lambda0;
+    unpack(&buf, &lambda,  sizeof(dfloat), 1);
+    unpack(&buf, &lambda1, sizeof(dfloat), 1);
+    unpack(&buf, &lambda0, sizeof(dfloat), 1);
+
+    agmgLevel *level;
+    parCSR *A = readParCSR(&buf, size, comm, device);
+    if (n==0) {
+      level = new agmgLevel(A, ktype);
+    } else {
+      parCSR *P = readParCSR(&buf, size, comm, device);
+      parCSR *R = readParCSR(&buf, size, comm, device);
+      level = new agmgLevel(A, P, R, ktype);
+
+      //update the number of columns required for the finer level (from R)
+      multigridLevel *fineLevel = levels[numLevels-1];
+      fineLevel->Ncols = (fineLevel->Ncols > R->Ncols) ? fineLevel->Ncols : R->Ncols;
+    }
+
+    level->stype = stype;
+    level->ChebyshevIterations = ChebyshevIterations;
+    level->lambda  = lambda;
+    level->lambda1 = lambda1;
+    level->lambda0 = lambda0;
+
+    levels[numLevels++] = level;
+  }
+  free(data);
+
+  baseLevel = numLevels-1;
+
+  coarseLevel = new coarseSolver(options);
+  coarseLevel->setup(((agmgLevel*)levels[baseLevel])->A);
+
+  size_t requiredBytes = 3*levels[AMGstartLev]->Ncols*sizeof(dfloat);
+  allocateScratchSpace(requiredBytes, device);
+
+  for (int n=AMGstartLev;n<numLevels;n++) {
+    allocateAgmgVectors((agmgLevel*)(levels[n]), n, AMGstartLev, ctype);
+    syncAgmgToDevice((agmgLevel*)(levels[n]), n, AMGstartLev, ctype);
+  }
+  coarseLevel->syncToDevice();
+
+  return true;
+}
+
+} //namespace parAlmond
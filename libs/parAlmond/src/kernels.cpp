@@ -30,6 +30,9 @@ namespace parAlmond {
 
 int Nrefs = 0;
 
+occa::stream defaultStream;
+occa::stream dataStream;
+
 occa::kernel haloExtractKernel;
 
 occa::kernel SpMVcsrKernel1;
@@ -39,6 +42,24 @@ occa::kernel SpMVellKernel2;
 occa::kernel SpMVmcsrKernel1;
 occa::kernel SpMVmcsrKernel2;
 
+int blockKernelSize = 0;
+occa::kernel SpMVbsrKernel1;
+occa::kernel SpMVbsrKernel2;
+occa::kernel vectorBlockDotStarKernel;
+
+bool setupKernelsBuilt = false;
+occa::kernel strongGraphCountKernel;
+occa::kernel strongGraphFillKernel;
+occa::kernel misColumnCountKernel;
+occa::kernel misPerturbKernel;
+occa::kernel misFirstNeighboursKernel;
+occa::kernel misSecondNeighboursKernel;
+occa::kernel misStateCountKernel;
+occa::kernel misEnumerateKernel;
+occa::kernel aggregateFirstNeighboursKernel;
+occa::kernel aggregateSecondNeighboursKernel;
+occa::kernel galerkinTriplesKernel;
+
 occa::kernel vectorSetKernel;
 occa::kernel vectorScaleKernel;
 occa::kernel vectorAddScalarKernel;
@@ -54,14 +75,7 @@ occa::kernel kcycleWeightedCombinedOp2Kernel;
 occa::kernel vectorAddInnerProdKernel;
 occa::kernel vectorAddWeightedInnerProdKernel;
 
-void buildParAlmondKernels(MPI_Comm comm, occa::device device){
-
-  int rank, size;
-  MPI_Comm_rank(comm, &rank);
-  MPI_Comm_size(comm, &size);
-
-  double seed = (double) rank;
-  srand48(seed);
+static occa::properties parAlmondKernelInfo(occa::device device){
 
   occa::properties kernelInfo;
   kernelInfo["defines"].asObject();
@@ -99,6 +113,24 @@ void buildParAlmondKernels(MPI_Comm comm, occa::device device){
     kernelInfo["compiler_flags"] += "--fmad=true"; // compiler option for cuda
   }
 
+  return kernelInfo;
+}
+
+void buildParAlmondKernels(MPI_Comm comm, occa::device device){
+
+  int rank, size;
+  MPI_Comm_rank(comm, &rank);
+  MPI_Comm_size(comm, &size);
+
+  double seed = (double) rank;
+  srand48(seed);
+
+  occa::properties kernelInfo = parAlmondKernelInfo(device);
+
+  //halo exchanges copy on their own stream
+  defaultStream = device.getStream();
+  dataStream    = device.createStream();
+
   if (rank==0) printf("Compiling parALMOND Kernels...");fflush(stdout);
 
   for (int r=0;r<size;r++) {
@@ -134,6 +166,74 @@ void buildParAlmondKernels(MPI_Comm comm, occa::device device){
   if(rank==0) printf("done.\n");
 }
 
+//block kernels are compiled for a fixed block size, so only one block size
+// can be live at a time
+void buildParAlmondBlockKernels(MPI_Comm comm, occa::device device, int bs){
+
+  if (blockKernelSize==bs) return;
+
+  int rank, size;
+  MPI_Comm_rank(comm, &rank);
+  MPI_Comm_size(comm, &size);
+
+  occa::properties kernelInfo = parAlmondKernelInfo(device);
+  kernelInfo["defines/" "p_bs"]= bs;
+
+  if (rank==0) printf("Compiling parALMOND block kernels...");fflush(stdout);
+
+  for (int r=0;r<size;r++) {
+    if (r==rank) {
+      SpMVbsrKernel1 = device.buildKernel(DPARALMOND"/okl/SpMVbsr.okl", "SpMVbsr1", kernelInfo);
+      SpMVbsrKernel2 = device.buildKernel(DPARALMOND"/okl/SpMVbsr.okl", "SpMVbsr2", kernelInfo);
+      vectorBlockDotStarKernel = device.buildKernel(DPARALMOND"/okl/vectorBlockDotStar.okl", "vectorBlockDotStar", kernelInfo);
+    }
+    MPI_Barrier(comm);
+  }
+  if(rank==0) printf("done.\n");
+
+  blockKernelSize = bs;
+}
+
+//kernels for running strongGraph, aggregation and the Galerkin products on
+// the device (PARALMOND SETUP = DEVICE)
+void buildParAlmondSetupKernels(MPI_Comm comm, occa::device device){
+
+  if (setupKernelsBuilt) return;
+
+  int rank, size;
+  MPI_Comm_rank(comm, &rank);
+  MPI_Comm_size(comm, &size);
+
+  occa::properties kernelInfo = parAlmondKernelInfo(device);
+  kernelInfo["defines/" "hlong"]= hlongString;
+  kernelInfo["defines/" "p_COARSENTHREASHOLD"]= (dfloat) COARSENTHREASHOLD;
+
+  if (rank==0) printf("Compiling parALMOND setup kernels...");fflush(stdout);
+
+  for (int r=0;r<size;r++) {
+    if (r==rank) {
+      strongGraphCountKernel = device.buildKernel(DPARALMOND"/okl/agmgSetup.okl", "strongGraphCount", kernelInfo);
+      strongGraphFillKernel  = device.buildKernel(DPARALMOND"/okl/agmgSetup.okl", "strongGraphFill", kernelInfo);
+
+      misColumnCountKernel      = device.buildKernel(DPARALMOND"/okl/agmgSetup.okl", "misColumnCount", kernelInfo);
+      misPerturbKernel          = device.buildKernel(DPARALMOND"/okl/agmgSetup.okl", "misPerturb", kernelInfo);
+      misFirstNeighboursKernel  = device.buildKernel(DPARALMOND"/okl/agmgSetup.okl", "misFirstNeighbours", kernelInfo);
+      misSecondNeighboursKernel = device.buildKernel(DPARALMOND"/okl/agmgSetup.okl", "misSecondNeighbours", kernelInfo);
+      misStateCountKernel       = device.buildKernel(DPARALMOND"/okl/agmgSetup.okl", "misStateCount", kernelInfo);
+      misEnumerateKernel        = device.buildKernel(DPARALMOND"/okl/agmgSetup.okl", "misEnumerate", kernelInfo);
+
+      aggregateFirstNeighboursKernel  = device.buildKernel(DPARALMOND"/okl/agmgSetup.okl", "aggregateFirstNeighbours", kernelInfo);
+      aggregateSecondNeighboursKernel = device.buildKernel(DPARALMOND"/okl/agmgSetup.okl", "aggregateSecondNeighbours", kernelInfo);
+
+      galerkinTriplesKernel = device.buildKernel(DPARALMOND"/okl/agmgSetup.okl", "galerkinTriples", kernelInfo);
+    }
+    MPI_Barrier(comm);
+  }
+  if(rank==0) printf("done.\n");
+
+  setupKernelsBuilt = true;
+}
+
 void freeParAlmondKernels() {
 
   haloExtractKernel.free();
@@ -145,6 +245,28 @@ void freeParAlmondKernels() {
   SpMVmcsrKernel1.free();
   SpMVmcsrKernel2.free();
 
+  if (blockKernelSize) {
+    SpMVbsrKernel1.free();
+    SpMVbsrKernel2.free();
+    vectorBlockDotStarKernel.free();
+    blockKernelSize = 0;
+  }
+
+  if (setupKernelsBuilt) {
+    strongGraphCountKernel.free();
+    strongGraphFillKernel.free();
+    misColumnCountKernel.free();
+    misPerturbKernel.free();
+    misFirstNeighboursKernel.free();
+    misSecondNeighboursKernel.free();
+    misStateCountKernel.free();
+    misEnumerateKernel.free();
+    aggregateFirstNeighboursKernel.free();
+    aggregateSecondNeighboursKernel.free();
+    galerkinTriplesKernel.free();
+    setupKernelsBuilt = false;
+  }
+
   vectorSetKernel.free();
   vectorScaleKernel.free();
   vectorAddScalarKernel.free();
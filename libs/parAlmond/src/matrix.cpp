@@ -114,6 +114,35 @@ void MCSR::syncToDevice(occa::device device) {
   }
 }
 
+//------------------------------------------------------------------------
+//
+//  BSR matrix
+//
+//------------------------------------------------------------------------
+BSR::BSR(dlong N, dlong M, int bs_): matrix_t(N,M), bs(bs_) {
+  Nblocks = N/bs;
+  nnz = 0;
+}
+
+BSR::~BSR() {
+  free(rowStarts);
+  free(cols);
+  free(vals);
+
+  if (o_rowStarts.size()) o_rowStarts.free();
+  if (o_cols.size()) o_cols.free();
+  if (o_vals.size()) o_vals.free();
+}
+
+void BSR::syncToDevice(occa::device device) {
+  if (Nblocks)
+    o_rowStarts = device.malloc((Nblocks+1)*sizeof(dlong), rowStarts);
+  if (nnz) {
+    o_cols = device.malloc(nnz*sizeof(dlong),          cols);
+    o_vals = device.malloc(nnz*bs*bs*sizeof(dfloat),   vals);
+  }
+}
+
 //------------------------------------------------------------------------
 //
 //  parCSR matrix
@@ -237,6 +266,22 @@ parCSR::parCSR(dlong N,         // number of rows on this rank
   for (dlong n=0;n<Nrows;n++) diagInv[n] = 1.0/diagA[n];
 }
 
+//list the rows with nonlocal entries. Called on first use since offd is
+// filled after haloSetup in some of the builders.
+void parCSR::boundarySetup() {
+
+  NboundaryRows = 0;
+  for (dlong i=0;i<Nrows;i++)
+    if (offd->rowStarts[i+1]>offd->rowStarts[i]) NboundaryRows++;
+
+  boundaryRows = (dlong *) malloc(NboundaryRows*sizeof(dlong));
+  NboundaryRows = 0;
+  for (dlong i=0;i<Nrows;i++)
+    if (offd->rowStarts[i+1]>offd->rowStarts[i]) boundaryRows[NboundaryRows++] = i;
+
+  boundaryRowsSet = true;
+}
+
 void parCSR::haloSetup(hlong *colIds) {
 
   int rank, size;
@@ -367,16 +412,53 @@ void parCSR::haloExchangeStart(occa::memory o_x) {
   // copy data from outgoing elements into temporary send buffer
   if (Nshared) {
     haloExtractKernel(Nshared, o_haloIds, o_x, o_pinnedScratch);
-    o_pinnedScratch.copyTo(pinnedScratch, Nshared*sizeof(dfloat), 0);
+
+    // send buffer is copied on the data stream so the local part of the
+    // SpMV can be queued behind it on the compute stream
+    device.finish();
+    device.setStream(dataStream);
+    o_pinnedScratch.copyTo(pinnedScratch, Nshared*sizeof(dfloat), 0, "async: true");
+    device.setStream(defaultStream);
   }
 }
 
 void parCSR::haloExchangeFinish(occa::memory o_x) {
+  device.setStream(dataStream);
+  device.finish();
+
   ogsGatherScatter(pinnedScratch, ogsDfloat, ogsAdd, ogsHalo);
-  if (Nhalo-Nshared)
+  if (Nhalo-Nshared) {
     o_x.copyFrom(((dfloat*)pinnedScratch)+Nshared,
                  (Nhalo-Nshared)*sizeof(dfloat),
-                  NlocalCols*sizeof(dfloat));
+                  NlocalCols*sizeof(dfloat), "async: true");
+    device.finish();
+  }
+  device.setStream(defaultStream);
+}
+
+//invert the bs x bs diagonal blocks of the local part (rows are node-interleaved)
+void parCSR::blockDiagSetup(int bs) {
+
+  blockSize = bs;
+  if (bs==1) return;
+
+  const dlong Nblocks = Nrows/bs;
+
+  free(blockDiagInv);
+  blockDiagInv = (dfloat *) calloc(Nblocks*bs*bs, sizeof(dfloat));
+
+  for (dlong i=0;i<Nrows;i++) {
+    const dlong n = i/bs;
+    const int   r = i%bs;
+    for (dlong jj=diag->rowStarts[i];jj<diag->rowStarts[i+1];jj++) {
+      const dlong col = diag->cols[jj];
+      if (col/bs==n)
+        blockDiagInv[n*bs*bs + r*bs + col%bs] = diag->vals[jj];
+    }
+  }
+
+  for (dlong n=0;n<Nblocks;n++)
+    matrixInverse(bs, blockDiagInv+n*bs*bs);
 }
 
 parCSR::~parCSR() {
@@ -385,6 +467,8 @@ parCSR::~parCSR() {
 
   free(diagA);
   free(diagInv);
+  free(blockDiagInv);
+  if (o_blockDiagInv.size()) o_blockDiagInv.free();
 
   if (o_diagA.size()) o_diagA.free();
   if (o_diagInv.size()) o_diagInv.free();
@@ -397,6 +481,7 @@ parCSR::~parCSR() {
 
   free(colMap);
   free(haloIds);
+  free(boundaryRows);
 
   if (ogs)       ogsFree(ogs);
   if (ogsHalo)   ogsFree(ogsHalo);
@@ -439,7 +524,12 @@ dfloat parCSR::rhoDinvA(){
 
     // v[j+1] = invD*(A*v[j])
     this->SpMV(1.0, Vx, 0., V[j+1]);
-    vectorDotStar(Nrows, diagInv, V[j+1]);
+    if (blockSize>1) {
+      blockDotStar(Nrows/blockSize, blockSize, 1.0, blockDiagInv, V[j+1], 0.0, Vx);
+      memcpy(V[j+1], Vx, Nrows*sizeof(dfloat));
+    } else {
+      vectorDotStar(Nrows, diagInv, V[j+1]);
+    }
 
     // modified Gram-Schmidth
     for(int i=0; i<=j; i++){
@@ -503,58 +593,23 @@ dfloat parCSR::rhoDinvA(){
 //build from parCSR
 parHYB::parHYB(parCSR *A): matrix_t(A->Nrows, A->Ncols) {
 
-  int *rowCounters = (int*) calloc(A->Nrows, sizeof(int));
-
-  int maxNnzPerRow = 0;
-  int minNnzPerRow = 0;
-  if (A->Nrows)
-    minNnzPerRow = (int) A->diag->rowStarts[1] - A->diag->rowStarts[0];
-
+  //Rows are split into interior rows, which only touch local columns, and
+  // boundary rows, which have nonlocal columns. Interior rows go in the ELL
+  // part and can be applied while the halo exchange is in flight. Boundary
+  // rows are stored whole (local and nonlocal entries) in the MCSR part and
+  // applied once the halo has arrived, so each row is visited once.
+  int nnzPerRow = 0;
   for(dlong i=0; i<A->Nrows; i++) {
-    int rowNnz = (int) A->diag->rowStarts[i+1] - A->diag->rowStarts[i];
-    rowCounters[i] = rowNnz;
-
-    maxNnzPerRow = (rowNnz > maxNnzPerRow) ? rowNnz : maxNnzPerRow;
-    minNnzPerRow = (rowNnz < minNnzPerRow) ? rowNnz : minNnzPerRow;
-  }
-
-  // This chooses the nnzPerRow by binning. Just pack all the local nonzeros in ELL
-  /*
-  // create bins
-  int numBins = maxNnzPerRow - minNnzPerRow + 1;
-
-  //zero row check
-  if (numBins<0) numBins =0;
+    if (A->offd->rowStarts[i+1]>A->offd->rowStarts[i]) continue; //boundary row
 
-  int *bins;
-  if (numBins)
-    bins = (int *) calloc(numBins, sizeof(int));
-
-  for(dlong i=0; i<A->Nrows; i++)
-    bins[rowCounters[i]-minNnzPerRow]++;
-
-  dfloat threshold = 2.0/3.0;
-  dlong totalNNZ = csrA->diagNNZ+csrA->offdNNZ;
-  int nnzPerRow = 0;
-  dlong nnz = 0;
-
-  //increase the nnz per row in E until it holds threshold*totalnnz nonzeros
-  for(int i=0; i<numBins; i++){
-    nnz += bins[i] * (i+minNnzPerRow);
-    if((nnz > threshold*totalNNZ)||(i==numBins-1)){
-      nnzPerRow = i+minNnzPerRow;
-      break;
-    }
-  }
-  */
-  if(Nrows) {
-    free(rowCounters);
-    // free(bins);
+    int rowNnz = (int) A->diag->rowStarts[i+1] - A->diag->rowStarts[i];
+    nnzPerRow = (rowNnz > nnzPerRow) ? rowNnz : nnzPerRow;
   }
 
-  int nnzPerRow = maxNnzPerRow;
+  //the ELL pass also applies beta to the boundary rows, so keep it non-empty
+  if (nnzPerRow==0) nnzPerRow = 1;
 
-  //build the ELL matrix from the local CSR
+  //build the ELL matrix from the interior rows of the local CSR
   E = new ELL(Nrows, Ncols);
   C = new MCSR(Nrows, Ncols);
 
@@ -571,28 +626,24 @@ parHYB::parHYB(parCSR *A): matrix_t(A->Nrows, A->Ncols) {
     dlong Jend   = A->diag->rowStarts[i+1];
     int rowNnz = (int)  (Jend - Jstart);
 
-    // store only min of nnzPerRow and rowNnz
-    int maxNnz = (nnzPerRow >= rowNnz) ? rowNnz : nnzPerRow;
+    int offdNnz = (int) (A->offd->rowStarts[i+1]-A->offd->rowStarts[i]);
 
-    for(int c=0; c<maxNnz; c++){
-      E->cols[i*nnzPerRow+c] = A->diag->cols[Jstart+c];
-      E->vals[i*nnzPerRow+c] = A->diag->vals[Jstart+c];
-    }
-
-    for(int c=maxNnz; c<nnzPerRow; c++){
-      E->cols[i*nnzPerRow+c] = -1; //ignore this column
-    }
+    if (offdNnz) {
+      //boundary row, stored in MCSR format
+      for(int c=0; c<nnzPerRow; c++)
+        E->cols[i*nnzPerRow+c] = -1; //ignore this column
 
-    // count the number of nonzeros to be stored in MCSR format
-
-    //all of offd
-    int cnt= (int) (A->offd->rowStarts[i+1]-A->offd->rowStarts[i]);
-    if (rowNnz>nnzPerRow)
-      cnt += rowNnz-nnzPerRow; //excess of diag
-
-    if (cnt) {
-      C->nnz += cnt;
+      C->nnz += rowNnz + offdNnz;
       C->actualRows++;
+    } else {
+      for(int c=0; c<rowNnz; c++){
+        E->cols[i*nnzPerRow+c] = A->diag->cols[Jstart+c];
+        E->vals[i*nnzPerRow+c] = A->diag->vals[Jstart+c];
+      }
+
+      for(int c=rowNnz; c<nnzPerRow; c++){
+        E->cols[i*nnzPerRow+c] = -1; //ignore this column
+      }
     }
   }
 
@@ -604,35 +655,24 @@ parHYB::parHYB(parCSR *A): matrix_t(A->Nrows, A->Ncols) {
   dlong row = 0;
   dlong cnt = 0;
   for(dlong i=0; i<Nrows; i++){
-    dlong Jstart = A->diag->rowStarts[i];
-    dlong Jend   = A->diag->rowStarts[i+1];
-    int rowNnz = (int)  (Jend - Jstart);
-    int rowCnt =0;
-
-    // store the remaining row in MCSR format
-    if(rowNnz > nnzPerRow){
-      rowCnt += rowNnz-nnzPerRow;
-      for(int c=nnzPerRow; c<rowNnz; c++){
-        C->cols[cnt] = A->diag->cols[Jstart+c];
-        C->vals[cnt] = A->diag->vals[Jstart+c];
-        cnt++;
-      }
+    if (A->offd->rowStarts[i+1]==A->offd->rowStarts[i]) continue; //interior row
+
+    //local non-zeros
+    for (dlong j=A->diag->rowStarts[i];j<A->diag->rowStarts[i+1];j++) {
+      C->cols[cnt] = A->diag->cols[j];
+      C->vals[cnt] = A->diag->vals[j];
+      cnt++;
     }
 
-    //add the offd non-zeros
-    Jstart = A->offd->rowStarts[i];
-    Jend   = A->offd->rowStarts[i+1];
-    rowCnt += (int) (Jend-Jstart);
-    for (dlong j=Jstart;j<Jend;j++) {
+    //nonlocal non-zeros
+    for (dlong j=A->offd->rowStarts[i];j<A->offd->rowStarts[i+1];j++) {
       C->cols[cnt] = A->offd->cols[j];
       C->vals[cnt] = A->offd->vals[j];
       cnt++;
     }
 
-    if (rowCnt) {
-      C->rows[row++] = i;
-      C->rowStarts[row] = cnt;
-    }
+    C->rows[row++] = i;
+    C->rowStarts[row] = cnt;
   }
 
   nullSpace = A->nullSpace;
@@ -724,16 +764,209 @@ void parHYB::haloExchangeStart(occa::memory o_x) {
   // copy data from outgoing elements into temporary send buffer
   if (Nshared) {
     haloExtractKernel(Nshared, o_haloIds, o_x, o_pinnedScratch);
-    o_pinnedScratch.copyTo(pinnedScratch, Nshared*sizeof(dfloat), 0);
+
+    // send buffer is copied on the data stream so the local part of the
+    // SpMV can be queued behind it on the compute stream
+    device.finish();
+    device.setStream(dataStream);
+    o_pinnedScratch.copyTo(pinnedScratch, Nshared*sizeof(dfloat), 0, "async: true");
+    device.setStream(defaultStream);
   }
 }
 
 void parHYB::haloExchangeFinish(occa::memory o_x) {
+  device.setStream(dataStream);
+  device.finish();
+
+  ogsGatherScatter(pinnedScratch, ogsDfloat, ogsAdd, ogsHalo);
+  if (Nhalo-Nshared) {
+    o_x.copyFrom(((dfloat*)pinnedScratch)+Nshared,
+                 (Nhalo-Nshared)*sizeof(dfloat),
+                  NlocalCols*sizeof(dfloat), "async: true");
+    device.finish();
+  }
+  device.setStream(defaultStream);
+}
+
+
+//------------------------------------------------------------------------
+//
+//  parBSR matrix
+//
+//------------------------------------------------------------------------
+
+//build from parCSR
+parBSR::parBSR(parCSR *A): matrix_t(A->Nrows, A->Ncols) {
+
+  bs = A->blockSize;
+
+  const dlong Nblocks = Nrows/bs;
+
+  E = new BSR(Nrows, A->NlocalCols, bs);
+  C = new MCSR(Nrows, Ncols);
+
+  //count the distinct block columns in each block row
+  dlong *blockCols = (dlong *) malloc(Nblocks*sizeof(dlong));
+  for (dlong n=0;n<Nblocks;n++) blockCols[n] = -1;
+
+  E->rowStarts = (dlong *) calloc(Nblocks+1, sizeof(dlong));
+  for (dlong n=0;n<Nblocks;n++) {
+    for (int r=0;r<bs;r++) {
+      const dlong i = n*bs+r;
+      for (dlong jj=A->diag->rowStarts[i];jj<A->diag->rowStarts[i+1];jj++) {
+        const dlong bcol = A->diag->cols[jj]/bs;
+        if (blockCols[bcol]!=n) {
+          blockCols[bcol] = n;
+          E->rowStarts[n+1]++;
+        }
+      }
+    }
+  }
+  for (dlong n=0;n<Nblocks;n++)
+    E->rowStarts[n+1] += E->rowStarts[n];
+  E->nnz = E->rowStarts[Nblocks];
+
+  E->cols = (dlong *)  calloc(E->nnz, sizeof(dlong));
+  E->vals = (dfloat *) calloc(E->nnz*bs*bs, sizeof(dfloat));
+
+  //blockCols now records the position of each block column in the current row
+  for (dlong n=0;n<Nblocks;n++) blockCols[n] = -1;
+
+  for (dlong n=0;n<Nblocks;n++) {
+    const dlong start = E->rowStarts[n];
+    dlong cnt = start;
+    for (int r=0;r<bs;r++) {
+      const dlong i = n*bs+r;
+      for (dlong jj=A->diag->rowStarts[i];jj<A->diag->rowStarts[i+1];jj++) {
+        const dlong col  = A->diag->cols[jj];
+        const dlong bcol = col/bs;
+        if (blockCols[bcol]<start) {
+          blockCols[bcol] = cnt;
+          E->cols[cnt++] = bcol;
+        }
+        E->vals[blockCols[bcol]*bs*bs + r*bs + col%bs] = A->diag->vals[jj];
+      }
+    }
+  }
+  free(blockCols);
+
+  //the nonlocal part stays scalar
+  C->nnz = 0;
+  C->actualRows = 0;
+  for (dlong i=0;i<Nrows;i++) {
+    dlong cnt = A->offd->rowStarts[i+1]-A->offd->rowStarts[i];
+    if (cnt) {
+      C->nnz += cnt;
+      C->actualRows++;
+    }
+  }
+
+  C->rowStarts = (dlong *) calloc(C->actualRows+1, sizeof(dlong));
+  C->rows = (dlong  *) calloc(C->actualRows, sizeof(dlong));
+  C->cols = (dlong  *) calloc(C->nnz, sizeof(dlong));
+  C->vals = (dfloat *) calloc(C->nnz, sizeof(dfloat));
+
+  dlong row = 0;
+  dlong cnt = 0;
+  for (dlong i=0;i<Nrows;i++) {
+    const dlong Jstart = A->offd->rowStarts[i];
+    const dlong Jend   = A->offd->rowStarts[i+1];
+    for (dlong j=Jstart;j<Jend;j++) {
+      C->cols[cnt] = A->offd->cols[j];
+      C->vals[cnt] = A->offd->vals[j];
+      cnt++;
+    }
+    if (Jend-Jstart) {
+      C->rows[row++] = i;
+      C->rowStarts[row] = cnt;
+    }
+  }
+
+  nullSpace = A->nullSpace;
+  nullSpacePenalty = A->nullSpacePenalty;
+  null = A->null;
+
+  blockDiagInv = A->blockDiagInv;
+
+  comm = A->comm;
+  ogsHalo = A->ogsHalo;
+
+  Nhalo = A->Nhalo;
+  Nshared = A->Nshared;
+  NlocalCols = A->NlocalCols;
+
+  haloIds = A->haloIds;
+
+  device = A->device;
+}
+
+parBSR::~parBSR() {
+  //everything else is owned by the parCSR
+  delete E;
+  delete C;
+
+  if (o_blockDiagInv.size()) o_blockDiagInv.free();
+  if (o_null.size()) o_null.free();
+  if (o_haloIds.size()) o_haloIds.free();
+}
+
+void parBSR::syncToDevice() {
+
+  E->syncToDevice(device);
+  C->syncToDevice(device);
+
+  if (Nrows) {
+    o_blockDiagInv = device.malloc(Nrows*bs*sizeof(dfloat), blockDiagInv);
+
+    if(nullSpace)
+      o_null = device.malloc(Nrows*sizeof(dfloat), null);
+  }
+
+  if (Nshared)
+    o_haloIds = device.malloc(Nshared*sizeof(dlong), haloIds);
+}
+
+void parBSR::haloExchangeStart(dfloat *x) {
+  // copy data from outgoing elements into temporary send buffer
+  for(int i=0;i<Nshared;++i){
+    // outgoing element
+    dlong id = haloIds[i];
+    ((dfloat*)pinnedScratch)[i] = x[id];
+  }
+}
+
+void parBSR::haloExchangeFinish(dfloat *x) {
   ogsGatherScatter(pinnedScratch, ogsDfloat, ogsAdd, ogsHalo);
-  if (Nhalo-Nshared)
+  memcpy(x+NlocalCols, ((dfloat*)pinnedScratch)+Nshared,
+          (Nhalo-Nshared)*sizeof(dfloat));
+}
+
+void parBSR::haloExchangeStart(occa::memory o_x) {
+  // copy data from outgoing elements into temporary send buffer
+  if (Nshared) {
+    haloExtractKernel(Nshared, o_haloIds, o_x, o_pinnedScratch);
+
+    // send buffer is copied on the data stream so the local part of the
+    // SpMV can be queued behind it on the compute stream
+    device.finish();
+    device.setStream(dataStream);
+    o_pinnedScratch.copyTo(pinnedScratch, Nshared*sizeof(dfloat), 0, "async: true");
+    device.setStream(defaultStream);
+  }
+}
+
+void parBSR::haloExchangeFinish(occa::memory o_x) {
+  device.setStream(dataStream);
+  device.finish();
+
+  ogsGatherScatter(pinnedScratch, ogsDfloat, ogsAdd, ogsHalo);
+  if (Nhalo-Nshared) {
     o_x.copyFrom(((dfloat*)pinnedScratch)+Nshared,
                  (Nhalo-Nshared)*sizeof(dfloat),
-                  NlocalCols*sizeof(dfloat));
+                  NlocalCols*sizeof(dfloat), "async: true");
+    device.finish();
+  }
+  device.setStream(defaultStream);
 }
 
-} //namespace parAlmond
\ No newline at end of file
+} //namespace parAlmond
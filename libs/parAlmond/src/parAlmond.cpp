@@ -38,6 +38,16 @@ solver_t *Init(occa::device device, MPI_Comm comm, setupAide options) {
   return M;
 }
 
+//fold an option's value into a hash, skipping unset keys without a warning
+static unsigned long long hashOption(setupAide &options, string key, unsigned long long hash) {
+  vector<string> &keywords = options.getKeyword();
+  vector<string> &data = options.getData();
+  for (size_t i=0;i<keywords.size();i++)
+    if (keywords[i]==key)
+      return hashBytes(data[i].c_str(), data[i].size()+1, hash);
+  return hash;
+}
+
 void AMGSetup(solver_t *MM,
                hlong* globalRowStarts,       //global partition
                dlong nnz,                    //--
@@ -56,6 +66,35 @@ void AMGSetup(solver_t *MM,
   hlong TotalRows = globalRowStarts[M->size];
   dlong numLocalRows = (dlong) (globalRowStarts[M->rank+1]-globalRowStarts[M->rank]);
 
+  //reuse a saved hierarchy if one was written for this operator
+  string hierarchyFile;
+  unsigned long long signature = 0;
+  M->options.getArgs("PARALMOND HIERARCHY FILE", hierarchyFile);
+  if (hierarchyFile.size()) {
+    int nullFlag = nullSpace ? 1 : 0;
+    signature = hashBytes(globalRowStarts, (M->size+1)*sizeof(hlong));
+    signature = hashBytes(Ai,    nnz*sizeof(hlong),  signature);
+    signature = hashBytes(Aj,    nnz*sizeof(hlong),  signature);
+    signature = hashBytes(Avals, nnz*sizeof(dfloat), signature);
+    signature = hashBytes(&nullFlag, sizeof(int), signature);
+    signature = hashBytes(&nullSpacePenalty, sizeof(dfloat), signature);
+
+    //options that change the aggregates, and so the saved levels
+    const char *setupKeys[] = {"PARALMOND AGGREGATION STRATEGY",
+                               "PARALMOND LPSCN ORDERING",
+                               "PARALMOND PARTITION",
+                               "PARALMOND SETUP"};
+    for (int k=0;k<4;k++)
+      signature = hashOption(M->options, setupKeys[k], signature);
+
+    if(rank==0) printf("Loading AMG hierarchy...");fflush(stdout);
+    if (M->Load(hierarchyFile.c_str(), signature)) {
+      if(rank==0) printf("done.\n");
+      return;
+    }
+    if(rank==0) printf("not found.\n");
+  }
+
   if(rank==0) printf("Setting up AMG...");fflush(stdout);
 
   //populate null space vector
@@ -71,6 +110,8 @@ void AMGSetup(solver_t *MM,
   M->AMGSetup(A);
 
   if(rank==0) printf("done.\n");
+
+  if (hierarchyFile.size()) M->Save(hierarchyFile.c_str(), signature);
 }
 
 void Precon(solver_t *M, occa::memory o_x, occa::memory o_rhs) {
@@ -65,6 +65,11 @@ solver_t::solver_t(occa::device device_, MPI_Comm comm_,
   } else { //default to DAMPED_JACOBI
     stype = DAMPED_JACOBI;
   }
+
+  blockSize = 1;
+  options.getArgs("PARALMOND BLOCK SIZE", blockSize);
+  if (blockSize<1) blockSize = 1;
+  requestedBlockSize = blockSize;
 }
 
 solver_t::~solver_t() {
@@ -48,8 +48,7 @@ void allocateScratchSpace(size_t requiredBytes, occa::device device) {
       free(scratch);
       o_scratch.free();
     }
-    scratch   = malloc(requiredBytes);
-    memset(scratch, 0, requiredBytes);
+    scratch   = parallelCalloc(requiredBytes/sizeof(dfloat)+1, sizeof(dfloat));
     o_scratch = device.malloc(requiredBytes, scratch);
     scratchSpaceBytes = requiredBytes;
   }
@@ -93,6 +92,34 @@ void freePinnedScratchSpace() {
   pinnedScratchSpaceBytes=0;
 }
 
+// Allocate N zeroed entries of the given size. The zeroing loop uses the same
+// static schedule as the host vector and SpMV loops so each page lands on the
+// NUMA node of the thread that will later touch it.
+void *parallelCalloc(size_t N, size_t size) {
+  char *a = (char *) malloc(N*size);
+
+  #pragma omp parallel for schedule(static)
+  for (size_t n=0;n<N;n++)
+    memset(a+n*size, 0, size);
+
+  return (void *) a;
+}
+
+// Move an existing host array onto pages first touched by the worker threads.
+// The old array is freed and the new one returned.
+void *parallelRehome(void *a, size_t N, size_t size) {
+  if (a==NULL) return NULL;
+
+  char *b = (char *) malloc(N*size);
+
+  #pragma omp parallel for schedule(static)
+  for (size_t n=0;n<N;n++)
+    memcpy(b+n*size, ((char *) a)+n*size, size);
+
+  free(a);
+  return (void *) b;
+}
+
 // compare on global indices
 int CompareGlobalId(const void *a, const void *b){
 
@@ -35,25 +35,25 @@ namespace parAlmond {
 //------------------------------------------------------------------------
 
 void vectorSet(const dlong m, const dfloat alpha, dfloat *a){
-  // #pragma omp parallel for
+  #pragma omp parallel for
   for(dlong i=0; i<m; i++)
     a[i] = alpha;
 }
 
 void vectorRandomize(const dlong m, dfloat *a){
-  // #pragma omp parallel for
+  // drand48 is not thread safe
   for(dlong i=0; i<m; i++)
     a[i] = (dfloat) drand48();
 }
 
 void vectorScale(const dlong m, const dfloat alpha, dfloat *a){
-  // #pragma omp parallel for
+  #pragma omp parallel for
   for(dlong i=0; i<m; i++)
     a[i] *= alpha;
 }
 
 void vectorAddScalar(const dlong m, const dfloat alpha, dfloat *a){
-  // #pragma omp parallel for
+  #pragma omp parallel for
   for(dlong i=0; i<m; i++)
     a[i] += alpha;
 }
@@ -62,11 +62,11 @@ void vectorAddScalar(const dlong m, const dfloat alpha, dfloat *a){
 void vectorAdd(const dlong n, const dfloat alpha, const dfloat *x,
                const dfloat beta, dfloat *y){
   if (beta) {
-    // #pragma omp parallel for
+    #pragma omp parallel for
     for(dlong i=0; i<n; i++)
       y[i] = beta*y[i] + alpha*x[i];
   } else {
-    // #pragma omp parallel for
+    #pragma omp parallel for
     for(dlong i=0; i<n; i++)
       y[i] = alpha*x[i];
   }
@@ -75,14 +75,14 @@ void vectorAdd(const dlong n, const dfloat alpha, const dfloat *x,
 // z = beta*y + alpha*x
 void vectorAdd(const dlong n, const dfloat alpha, const dfloat *x,
                const dfloat beta, const dfloat *y, dfloat *z){
-  // #pragma omp parallel for
+  #pragma omp parallel for
   for(dlong i=0; i<n; i++)
     z[i] = beta*y[i] + alpha*x[i];
 }
 
 // b = a*b
 void vectorDotStar(const dlong m, const dfloat *a, dfloat *b){
-  // #pragma omp parallel for
+  #pragma omp parallel for
   for(dlong i=0; i<m; i++)
     b[i] *= a[i];
 }
@@ -91,19 +91,37 @@ void vectorDotStar(const dlong m, const dfloat *a, dfloat *b){
 void vectorDotStar(const dlong m, const dfloat alpha, const dfloat *a,
                    const dfloat *b, const dfloat beta,  dfloat *c){
   if (beta) {
-    // #pragma omp parallel for
+    #pragma omp parallel for
     for(dlong i=0; i<m; i++)
       c[i] = beta*c[i]+ alpha*a[i]*b[i];
   } else {
-    // #pragma omp parallel for
+    #pragma omp parallel for
     for(dlong i=0; i<m; i++)
       c[i] = alpha*a[i]*b[i];
   }
 }
 
+// c = alpha*A*b + beta*c, A block diagonal with bs x bs blocks
+void blockDotStar(const dlong Nblocks, const int bs, const dfloat alpha,
+                  const dfloat *A, const dfloat *b, const dfloat beta, dfloat *c){
+  #pragma omp parallel for
+  for(dlong n=0; n<Nblocks; n++){
+    for(int r=0; r<bs; r++){
+      dfloat result = 0.;
+      for(int k=0; k<bs; k++)
+        result += A[n*bs*bs+r*bs+k]*b[n*bs+k];
+
+      if (beta)
+        c[n*bs+r] = beta*c[n*bs+r] + alpha*result;
+      else
+        c[n*bs+r] = alpha*result;
+    }
+  }
+}
+
 dfloat vectorNorm(const dlong n, const dfloat *a, MPI_Comm comm){
   dfloat result = 0., gresult = 0.;
-  // #pragma omp parallel for reduction(+:result)
+  #pragma omp parallel for reduction(+:result)
   for(dlong i=0; i<n; i++)
     result += a[i]*a[i];
 
@@ -114,7 +132,7 @@ dfloat vectorNorm(const dlong n, const dfloat *a, MPI_Comm comm){
 dfloat vectorInnerProd(const dlong n, const dfloat *a, const dfloat *b,
                        MPI_Comm comm){
   dfloat result = 0., gresult = 0.;
-  // #pragma omp parallel for reduction(+:result)
+  #pragma omp parallel for reduction(+:result)
   for(dlong i=0; i<n; i++)
     result += a[i]*b[i];
 
@@ -126,7 +144,7 @@ dfloat vectorMaxAbs(const dlong n, const dfloat *a, MPI_Comm comm){
   dfloat maxVal=0.0;
   dfloat gmaxVal=0.0;
 
-  //  #pragma omp parallel for reduction(max:maxVal)
+  #pragma omp parallel for reduction(max:maxVal)
   for(dlong i=0; i<n; i++){
     dfloat a2 = (a[i] < 0) ? -a[i] : a[i];
     if(maxVal < a2){
@@ -142,22 +160,23 @@ dfloat vectorMaxAbs(const dlong n, const dfloat *a, MPI_Comm comm){
 void kcycleCombinedOp1(const dlong n, dfloat *aDotbc, const dfloat *a,
                       const dfloat *b, const dfloat *c, const dfloat* w,
                       const bool weighted, MPI_Comm comm) {
-  dfloat result[3] = {0.,0.,0.};
+  dfloat aDotb = 0., aDotc = 0., bDotb = 0.;
   if (weighted) {
-    // #pragma omp parallel for reduction(+:aDotb) reduction(+:aDotc) reduction(+:bDotb)
+    #pragma omp parallel for reduction(+:aDotb) reduction(+:aDotc) reduction(+:bDotb)
     for(dlong i=0; i<n; i++) {
-      result[0] += w[i]*a[i]*b[i];
-      result[1] += w[i]*a[i]*c[i];
-      result[2] += w[i]*b[i]*b[i];
+      aDotb += w[i]*a[i]*b[i];
+      aDotc += w[i]*a[i]*c[i];
+      bDotb += w[i]*b[i]*b[i];
     }
   } else {
-    // #pragma omp parallel for reduction(+:aDotb) reduction(+:aDotc) reduction(+:bDotb)
+    #pragma omp parallel for reduction(+:aDotb) reduction(+:aDotc) reduction(+:bDotb)
     for(dlong i=0; i<n; i++) {
-      result[0] += a[i]*b[i];
-      result[1] += a[i]*c[i];
-      result[2] += b[i]*b[i];
+      aDotb += a[i]*b[i];
+      aDotc += a[i]*c[i];
+      bDotb += b[i]*b[i];
     }
   }
+  dfloat result[3] = {aDotb, aDotc, bDotb};
   MPI_Allreduce(result,aDotbc,3,MPI_DFLOAT,MPI_SUM,comm);
 }
 
@@ -165,22 +184,23 @@ void kcycleCombinedOp1(const dlong n, dfloat *aDotbc, const dfloat *a,
 void kcycleCombinedOp2(const dlong n, dfloat *aDotbcd, const dfloat *a,
                        const dfloat *b, const dfloat *c, const dfloat* d,
                        const dfloat *w, const bool weighted, MPI_Comm comm) {
-  dfloat result[3] = {0.,0.,0.};
+  dfloat aDotb = 0., aDotc = 0., aDotd = 0.;
   if (weighted) {
-    // #pragma omp parallel for reduction(+:aDotb) reduction(+:aDotc) reduction(+:aDotd)
+    #pragma omp parallel for reduction(+:aDotb) reduction(+:aDotc) reduction(+:aDotd)
     for(dlong i=0; i<n; i++) {
-      result[0] += w[i]*a[i]*b[i];
-      result[1] += w[i]*a[i]*c[i];
-      result[2] += w[i]*a[i]*d[i];
+      aDotb += w[i]*a[i]*b[i];
+      aDotc += w[i]*a[i]*c[i];
+      aDotd += w[i]*a[i]*d[i];
     }
   } else {
-    // #pragma omp parallel for reduction(+:aDotb) reduction(+:aDotc) reduction(+:aDotd)
+    #pragma omp parallel for reduction(+:aDotb) reduction(+:aDotc) reduction(+:aDotd)
     for(dlong i=0; i<n; i++) {
-      result[0] += a[i]*b[i];
-      result[1] += a[i]*c[i];
-      result[2] += a[i]*d[i];
+      aDotb += a[i]*b[i];
+      aDotc += a[i]*c[i];
+      aDotd += a[i]*d[i];
     }
   }
+  dfloat result[3] = {aDotb, aDotc, aDotd};
   MPI_Allreduce(result,aDotbcd,3,MPI_DFLOAT,MPI_SUM,comm);
 }
 
@@ -194,13 +214,13 @@ dfloat vectorAddInnerProd(const dlong n, const dfloat alpha, const dfloat *x,
   dfloat gresult = 0.;
   if (weighted) {
     if (beta) {
-      // #pragma omp parallel for reduction(+:result)
+      #pragma omp parallel for reduction(+:result)
       for(dlong i=0; i<n; i++) {
         y[i] = beta*y[i] + alpha*x[i];
         result += w[i]*y[i]*y[i];
       }
     } else {
-      // #pragma omp parallel for reduction(+:result)
+      #pragma omp parallel for reduction(+:result)
       for(dlong i=0; i<n; i++) {
         y[i] = alpha*x[i];
         result += w[i]*y[i]*y[i];
@@ -208,13 +228,13 @@ dfloat vectorAddInnerProd(const dlong n, const dfloat alpha, const dfloat *x,
     }
   } else {
     if (beta) {
-      // #pragma omp parallel for reduction(+:result)
+      #pragma omp parallel for reduction(+:result)
       for(dlong i=0; i<n; i++) {
         y[i] = beta*y[i] + alpha*x[i];
         result += y[i]*y[i];
       }
     } else {
-      // #pragma omp parallel for reduction(+:result)
+      #pragma omp parallel for reduction(+:result)
       for(dlong i=0; i<n; i++) {
         y[i] = alpha*x[i];
         result += y[i]*y[i];
@@ -265,6 +285,12 @@ void vectorDotStar(const dlong N, const dfloat alpha, occa::memory o_a,
   if (N) vectorDotStarKernel2(N, alpha, beta, o_a, o_b, o_c);
 }
 
+void blockDotStar(const dlong Nblocks, const int bs, const dfloat alpha,
+                  occa::memory o_A, occa::memory o_b, const dfloat beta,
+                  occa::memory o_c){
+  if (Nblocks) vectorBlockDotStarKernel(Nblocks, alpha, beta, o_A, o_b, o_c);
+}
+
 //dfloat vectorNorm(const dlong n, occa::memory o_a, MPI_Comm comm)
 
 dfloat vectorInnerProd(const dlong N, occa::memory o_x, occa::memory o_y,
@@ -44,6 +44,11 @@ typedef struct{
   
   int Nfields;
 
+  // independent members advanced together by the fused stage, stored per element
+  // as consecutive blocks of Np*Nfields (qEnsemble is the host copy)
+  int Nensemble;
+  dfloat *qEnsemble;
+
   hlong totalElements;
   dlong Nblock;
 
@@ -63,6 +68,11 @@ typedef struct{
   occa::kernel rkStageKernel;
   occa::kernel rkUpdateKernel;
   occa::kernel rkErrorEstimateKernel;
+  occa::kernel rkEmbeddedUpdateKernel;
+
+  // fused LSERK stage (volume+surface+update), ping-pongs q with qtmp
+  occa::kernel fusedStageKernel;
+  occa::memory o_qtmp;
 
   occa::memory o_q;
   occa::memory o_rhsq;
@@ -80,7 +90,7 @@ typedef struct{
   occa::memory o_recvBuffer;
   occa::memory o_haloBuffer;
 
-  // DOPRI5 RK data
+  // DOPRI5 RK data (LSERK43 uses mesh->rka/rkb/rkc with rkE as its error weights)
   int advSwitch;
   int Nrk;
   dfloat ATOL, RTOL;
@@ -89,6 +99,16 @@ typedef struct{
   dfloat exp1, facold,  dtMIN, safe, beta;
   dfloat *rkA, *rkC, *rkE;
   occa::memory o_rkA, o_rkC, o_rkE;
+
+  // MRAB data: per level AB3 weights for the full (A) and half (B) step
+  dfloat *MRAB_A, *MRAB_B;
+  dfloat *fQM;
+  occa::memory o_fQM;
+
+  occa::kernel mrVolumeKernel;
+  occa::kernel mrSurfaceKernel;
+  occa::kernel mrabUpdateKernel;
+  occa::kernel mrabTraceUpdateKernel;
   
 }acoustics_t;
 
@@ -115,6 +135,10 @@ void acousticsLserkStep(acoustics_t *acoustics, setupAide &newOoptions, const df
 
 dfloat acousticsDopriEstimate(acoustics_t *acoustics);
 
+void acousticsMRABStep(acoustics_t *acoustics, setupAide &newOptions, const int tstep);
+
+void acousticsFusedLserkStep(acoustics_t *acoustics, setupAide &newOptions, const dfloat time);
+
 #define TRIANGLES 3
 #define QUADRILATERALS 4
 #define TETRAHEDRA 6
@@ -0,0 +1,117 @@
+/*
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Tim Warburton, Noel Chalmers, Jesse Chan, Ali Karakus
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "acoustics.h"
+
+// LSERK4 step with one fused volume+surface+update kernel per stage. Stages
+// ping-pong between o_q and o_qtmp since neighbours still read the old state.
+// All Nensemble members are advanced by the same launches and halo exchange.
+void acousticsFusedLserkStep(acoustics_t *acoustics, setupAide &newOptions, const dfloat time){
+
+  mesh_t *mesh = acoustics->mesh;
+
+  // entries per element, all ensemble members
+  int Nentries = acoustics->Nensemble*mesh->Np*acoustics->Nfields;
+
+  occa::memory o_sourceq = acoustics->o_q;
+  occa::memory o_destq   = acoustics->o_qtmp;
+
+  for(int rk=0;rk<mesh->Nrk;++rk){
+
+    dfloat currentTime = time + mesh->rkc[rk]*mesh->dt;
+
+    // extract q halo on DEVICE
+    if(mesh->totalHaloPairs>0){
+      mesh->haloExtractEnsembleKernel(mesh->totalHaloPairs, Nentries, mesh->o_haloElementList, o_sourceq, acoustics->o_haloBuffer);
+
+      // copy extracted halo to HOST
+      acoustics->o_haloBuffer.copyTo(acoustics->sendBuffer);
+
+      // start halo exchange
+      meshHaloExchangeStart(mesh, Nentries*sizeof(dfloat), acoustics->sendBuffer, acoustics->recvBuffer);
+    }
+
+    // elements with no neighbour on another rank overlap the exchange
+    if(mesh->NinternalElements)
+      acoustics->fusedStageKernel(mesh->NinternalElements,
+				  mesh->o_internalElementIds,
+				  mesh->dt,
+				  mesh->rka[rk],
+				  mesh->rkb[rk],
+				  currentTime,
+				  mesh->o_vgeo,
+				  mesh->o_sgeo,
+				  mesh->o_Dmatrices,
+				  mesh->o_LIFTT,
+				  mesh->o_vmapM,
+				  mesh->o_vmapP,
+				  mesh->o_EToB,
+				  mesh->o_x,
+				  mesh->o_y,
+				  mesh->o_z,
+				  o_sourceq,
+				  acoustics->o_resq,
+				  o_destq);
+
+    // wait for q halo data to arrive
+    if(mesh->totalHaloPairs>0){
+      meshHaloExchangeFinish(mesh);
+
+      // copy halo data to DEVICE
+      size_t offset = Nentries*mesh->Nelements*sizeof(dfloat); // offset for halo data
+      o_sourceq.copyFrom(acoustics->recvBuffer, acoustics->haloBytes, offset);
+    }
+
+    if(mesh->NnotInternalElements)
+      acoustics->fusedStageKernel(mesh->NnotInternalElements,
+				  mesh->o_notInternalElementIds,
+				  mesh->dt,
+				  mesh->rka[rk],
+				  mesh->rkb[rk],
+				  currentTime,
+				  mesh->o_vgeo,
+				  mesh->o_sgeo,
+				  mesh->o_Dmatrices,
+				  mesh->o_LIFTT,
+				  mesh->o_vmapM,
+				  mesh->o_vmapP,
+				  mesh->o_EToB,
+				  mesh->o_x,
+				  mesh->o_y,
+				  mesh->o_z,
+				  o_sourceq,
+				  acoustics->o_resq,
+				  o_destq);
+
+    occa::memory o_tmp = o_sourceq;
+    o_sourceq = o_destq;
+    o_destq   = o_tmp;
+  }
+
+  // an odd number of stages leaves the solution in o_qtmp
+  acoustics->o_qtmp = o_destq;
+  acoustics->o_q    = o_sourceq;
+}
@@ -0,0 +1,143 @@
+/*
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Tim Warburton, Noel Chalmers, Jesse Chan, Ali Karakus
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "acoustics.h"
+
+// one coarse MRAB step: 2^(Nlevels-1) ticks of the finest level dt
+void acousticsMRABStep(acoustics_t *acoustics, setupAide &newOptions, const int tstep){
+
+  mesh_t *mesh = acoustics->mesh;
+
+  const dlong offset = mesh->Np*mesh->Nelements*mesh->Nfields;
+
+  // ramp up to third order over the first steps
+  const int mrab_order = (tstep<2) ? tstep : 2;
+
+  for (int Ntick=0; Ntick < pow(2,mesh->MRABNlevels-1);Ntick++) {
+
+    // intermediate stage time
+    dfloat currentTime = mesh->dt*(tstep*pow(2,mesh->MRABNlevels-1) + Ntick);
+
+    // levels 0..lev-1 need a new rhs at this tick
+    int lev;
+    for (lev=0;lev<mesh->MRABNlevels;lev++)
+      if (Ntick % (1<<lev) != 0) break;
+
+    // extract trace halo on DEVICE
+    if(mesh->totalHaloPairs>0){
+      int Nentries = mesh->Nfp*mesh->Nfaces*acoustics->Nfields;
+
+      mesh->haloExtractKernel(mesh->totalHaloPairs, Nentries, mesh->o_haloElementList, acoustics->o_fQM, acoustics->o_haloBuffer);
+
+      // copy extracted halo to HOST
+      acoustics->o_haloBuffer.copyTo(acoustics->sendBuffer);
+
+      // start halo exchange
+      meshHaloExchangeStart(mesh, Nentries*sizeof(dfloat), acoustics->sendBuffer, acoustics->recvBuffer);
+    }
+
+    for (int l=0;l<lev;l++)
+      if (mesh->MRABNelements[l])
+        acoustics->mrVolumeKernel(mesh->MRABNelements[l],
+				  mesh->o_MRABelementIds[l],
+				  offset,
+				  mesh->MRABshiftIndex[l],
+				  mesh->o_vgeo,
+				  mesh->o_Dmatrices,
+				  acoustics->o_q,
+				  acoustics->o_rhsq);
+
+    // wait for trace halo data to arrive
+    if(mesh->totalHaloPairs>0){
+      meshHaloExchangeFinish(mesh);
+
+      // copy halo data to DEVICE
+      size_t foffset = mesh->Nfp*mesh->Nfaces*acoustics->Nfields*mesh->Nelements*sizeof(dfloat); // offset for halo data
+      acoustics->o_fQM.copyFrom(acoustics->recvBuffer, acoustics->haloBytes, foffset);
+    }
+
+    for (int l=0;l<lev;l++)
+      if (mesh->MRABNelements[l])
+        acoustics->mrSurfaceKernel(mesh->MRABNelements[l],
+				   mesh->o_MRABelementIds[l],
+				   offset,
+				   mesh->MRABshiftIndex[l],
+				   mesh->o_sgeo,
+				   mesh->o_LIFTT,
+				   mesh->o_vmapM,
+				   mesh->o_mapP,
+				   mesh->o_EToB,
+				   currentTime,
+				   mesh->o_x,
+				   mesh->o_y,
+				   mesh->o_z,
+				   acoustics->o_fQM,
+				   acoustics->o_rhsq);
+
+    // levels 0..lev-1 complete a step at the end of this tick
+    for (lev=0;lev<mesh->MRABNlevels;lev++)
+      if ((Ntick+1) % (1<<lev) != 0) break;
+
+    for (int l=0;l<lev;l++) {
+      const int id = mrab_order*mesh->MRABNlevels*3 + l*3;
+
+      if (mesh->MRABNelements[l])
+        acoustics->mrabUpdateKernel(mesh->MRABNelements[l],
+				    mesh->o_MRABelementIds[l],
+				    offset,
+				    mesh->MRABshiftIndex[l],
+				    acoustics->MRAB_A[id+0],
+				    acoustics->MRAB_A[id+1],
+				    acoustics->MRAB_A[id+2],
+				    mesh->o_vmapM,
+				    acoustics->o_rhsq,
+				    acoustics->o_fQM,
+				    acoustics->o_q);
+
+      //rotate index
+      mesh->MRABshiftIndex[l] = (mesh->MRABshiftIndex[l]+1)%3;
+    }
+
+    // the first level not updated extrapolates its traces bordering level lev-1
+    // to the half step so that the finer neighbours see a consistent state
+    if (lev<mesh->MRABNlevels) {
+      const int id = mrab_order*mesh->MRABNlevels*3 + lev*3;
+
+      if (mesh->MRABNhaloElements[lev])
+        acoustics->mrabTraceUpdateKernel(mesh->MRABNhaloElements[lev],
+					 mesh->o_MRABhaloIds[lev],
+					 offset,
+					 mesh->MRABshiftIndex[lev],
+					 acoustics->MRAB_B[id+0],
+					 acoustics->MRAB_B[id+1],
+					 acoustics->MRAB_B[id+2],
+					 mesh->o_vmapM,
+					 acoustics->o_q,
+					 acoustics->o_rhsq,
+					 acoustics->o_fQM);
+    }
+  }
+}
@@ -26,10 +26,45 @@ SOFTWARE.
 
 #include "acoustics.h"
 
+// check and plot each ensemble member in turn through the single member host array
+static void acousticsEnsembleReport(acoustics_t *acoustics, dfloat time){
+
+  mesh3D *mesh = acoustics->mesh;
+
+  int Nensemble = acoustics->Nensemble;
+  dlong NpNfields = mesh->Np*acoustics->Nfields;
+
+  // copy data back to host
+  acoustics->o_q.copyTo(acoustics->qEnsemble, Nensemble*mesh->Nelements*NpNfields*sizeof(dfloat));
+
+  char fname[BUFSIZ];
+
+  for(int m=0;m<Nensemble;++m){
+    for(dlong e=0;e<mesh->Nelements;++e)
+      for(dlong n=0;n<NpNfields;++n)
+        acoustics->q[e*NpNfields+n] = acoustics->qEnsemble[(e*Nensemble+m)*NpNfields+n];
+
+    // do error stuff on host
+    if(mesh->rank==0) printf("member %d: ", m);
+    acousticsError(acoustics, time);
+
+    sprintf(fname, "foo_%04d_%04d_%04d.vtu", mesh->rank, m, acoustics->frame);
+
+    acousticsPlotVTU(acoustics, fname);
+  }
+
+  ++acoustics->frame;
+}
+
 void acousticsReport(acoustics_t *acoustics, dfloat time, setupAide &newOptions){
 
   mesh3D *mesh = acoustics->mesh;
 
+  if(acoustics->Nensemble>1){
+    acousticsEnsembleReport(acoustics, time);
+    return;
+  }
+
   // copy data back to host
   acoustics->o_q.copyTo(acoustics->q);
 
@@ -38,7 +38,11 @@ void acousticsRun(acoustics_t *acoustics, setupAide &newOptions){
 
   timer.tic("Run");
   
-  if (newOptions.compareArgs("TIME INTEGRATOR","DOPRI5")) {
+  // LSERK43 shares the adaptive controller, but keeps no copy of the state
+  // for an output mini step so its steps are clipped to the output times
+  int lserkEmbedded = newOptions.compareArgs("TIME INTEGRATOR","LSERK43");
+
+  if (newOptions.compareArgs("TIME INTEGRATOR","DOPRI5") || lserkEmbedded) {
     
     // hard code this for the moment
     dfloat outputInterval;
@@ -65,6 +69,14 @@ void acousticsRun(acoustics_t *acoustics, setupAide &newOptions){
         exit (-1);
       }
 
+      //check for an output time inside this step
+      dfloat unclippedDt = mesh->dt;
+      int outputStep = 0;
+      if (lserkEmbedded && outputInterval>0 && time+mesh->dt >= nextOutputTime){
+	mesh->dt = nextOutputTime-time;
+	outputStep = 1;
+      }
+
       //check for final timestep
       if (time+mesh->dt > mesh->finalTime){
 	mesh->dt = mesh->finalTime-time;
@@ -87,7 +99,7 @@ void acousticsRun(acoustics_t *acoustics, setupAide &newOptions){
       if (err<1.0) { //dt is accepted
 
 	// check for output during this step and do a mini-step
-	if(time<nextOutputTime && time+mesh->dt>nextOutputTime){
+	if(!lserkEmbedded && time<nextOutputTime && time+mesh->dt>nextOutputTime){
 	  dfloat savedt = mesh->dt;
 	  
 	  // save rkq
@@ -124,6 +136,16 @@ void acousticsRun(acoustics_t *acoustics, setupAide &newOptions){
 
         time += mesh->dt;
 
+	// the step was clipped to end on the output time
+	if(outputStep){
+	  acousticsReport(acoustics, time, newOptions);
+
+	  nextOutputTime += outputInterval;
+
+	  // a short step onto the output time should not shrink the next one
+	  dtnew = mymax(dtnew, unclippedDt);
+	}
+
         acoustics->facold = mymax(err,1E-4); // hard coded factor ?
 
 	printf("\r time = %g (%d), dt = %g accepted                      ", time, allStep,  mesh->dt);
@@ -147,11 +169,17 @@ void acousticsRun(acoustics_t *acoustics, setupAide &newOptions){
     
   } else if (newOptions.compareArgs("TIME INTEGRATOR","LSERK4")) {
 
+    // LSERK4+FUSED runs one volume+surface+update kernel per stage
+    int fused = newOptions.compareArgs("TIME INTEGRATOR","FUSED");
+
     for(int tstep=0;tstep<mesh->NtimeSteps;++tstep){
 
       dfloat time = tstep*mesh->dt;
 
-      acousticsLserkStep(acoustics, newOptions, time);
+      if(fused)
+        acousticsFusedLserkStep(acoustics, newOptions, time);
+      else
+        acousticsLserkStep(acoustics, newOptions, time);
 
 #if 0
       if(((tstep+1)%mesh->errorStep)==0){
@@ -160,6 +188,18 @@ void acousticsRun(acoustics_t *acoustics, setupAide &newOptions){
       }
 #endif
     }
+  } else if (newOptions.compareArgs("TIME INTEGRATOR","MRAB")) {
+
+    for(int tstep=0;tstep<mesh->NtimeSteps;++tstep){
+
+      acousticsMRABStep(acoustics, newOptions, tstep);
+    }
+
+    mesh->device.finish();
+
+    double elapsed  = timer.toc("Run");
+
+    printf("run took %lg seconds for %d MRAB steps of %d levels\n", elapsed, mesh->NtimeSteps, mesh->MRABNlevels);
   }
   
 }
@@ -38,6 +38,42 @@ acoustics_t *acousticsSetup(mesh_t *mesh, setupAide &newOptions, char* boundaryH
   
   acoustics->mesh = mesh;
 
+  newOptions.getArgs("FINAL TIME", mesh->finalTime);
+
+  // ensemble members share the mesh, geometric factors and kernels
+  acoustics->Nensemble = 1;
+  newOptions.getArgs("ENSEMBLE SIZE", acoustics->Nensemble);
+  int Nensemble = acoustics->Nensemble;
+
+  // multirate levels go first: meshMRABSetup may repartition the mesh
+  int mrab = newOptions.compareArgs("TIME INTEGRATOR","MRAB");
+  if(mrab){
+    int maxLevels = 1;
+    newOptions.getArgs("MAX MRAB LEVELS", maxLevels);
+
+    // AB3 is stable on about a fifth of the LSERK4 imaginary interval
+    dfloat cfl = 0.1;
+
+    dfloat *EToDT = (dfloat*) calloc(mesh->Nelements, sizeof(dfloat));
+    dfloat *elementHmin = meshElementHmin(mesh, acoustics->elementType);
+
+    // same estimate as the single rate dt below, per element
+    for(dlong e=0;e<mesh->Nelements;++e)
+      EToDT[e] = cfl*0.25*elementHmin[e]/((mesh->N+1.)*(mesh->N+1.));
+
+    if(acoustics->dim==3)
+      mesh->dt = meshMRABSetup3D(mesh, EToDT, maxLevels, mesh->finalTime);
+    else
+      mesh->dt = meshMRABSetup2D(mesh, EToDT, maxLevels, mesh->finalTime);
+
+    mesh->NtimeSteps = mesh->finalTime/(pow(2,mesh->MRABNlevels-1)*mesh->dt);
+
+    if (mesh->rank==0) printf("MRAB LEVELS\t:\t%d\n", mesh->MRABNlevels);
+
+    free(EToDT);
+    free(elementHmin);
+  }
+
   dlong Ntotal = mesh->Nelements*mesh->Np*mesh->Nfields;
   acoustics->Nblock = (Ntotal+blockSize-1)/blockSize;
   
@@ -50,14 +86,45 @@ acoustics_t *acousticsSetup(mesh_t *mesh, setupAide &newOptions, char* boundaryH
   // compute samples of q at interpolation nodes
   acoustics->q = (dfloat*) calloc((mesh->totalHaloPairs+mesh->Nelements)*mesh->Np*mesh->Nfields,
 				sizeof(dfloat));
-  acoustics->rhsq = (dfloat*) calloc(mesh->Nelements*mesh->Np*mesh->Nfields,
+  // MRAB keeps three levels of rhs history
+  int Nrhs = mrab ? 3 : 1;
+  acoustics->rhsq = (dfloat*) calloc(Nrhs*mesh->Nelements*mesh->Np*mesh->Nfields,
 				sizeof(dfloat));
   
-  if (newOptions.compareArgs("TIME INTEGRATOR","LSERK4")){
-    acoustics->resq = (dfloat*) calloc(mesh->Nelements*mesh->Np*mesh->Nfields,
+  // compareArgs matches substrings, so "LSERK4" also matches LSERK43
+  int lserkEmbedded = newOptions.compareArgs("TIME INTEGRATOR","LSERK43");
+
+  if (newOptions.compareArgs("TIME INTEGRATOR","LSERK4") && !lserkEmbedded){
+    acoustics->resq = (dfloat*) calloc(Nensemble*mesh->Nelements*mesh->Np*mesh->Nfields,
 		  		sizeof(dfloat));
   }
 
+  if (mrab){
+    // face traces of local and halo elements at each element's current time
+    acoustics->fQM = (dfloat*) calloc((mesh->Nelements+mesh->totalHaloPairs)*mesh->Nfp*mesh->Nfaces*mesh->Nfields,
+				sizeof(dfloat));
+
+    // AB weights of order 1,2,3 for a full (A) and half (B) step of each level
+    int Nlevels = mesh->MRABNlevels;
+    acoustics->MRAB_A = (dfloat*) calloc(3*3*Nlevels, sizeof(dfloat));
+    acoustics->MRAB_B = (dfloat*) calloc(3*3*Nlevels, sizeof(dfloat));
+
+    for(int l=0;l<Nlevels;++l){
+      dfloat h = mesh->dt*pow(2,l);
+      dfloat *A = acoustics->MRAB_A + l*3;
+      dfloat *B = acoustics->MRAB_B + l*3;
+
+      A[0] = h;
+      B[0] = h/2.;
+
+      A[3*Nlevels+0] =  3.*h/2.;  A[3*Nlevels+1] = -1.*h/2.;
+      B[3*Nlevels+0] =  5.*h/8.;  B[3*Nlevels+1] = -1.*h/8.;
+
+      A[6*Nlevels+0] = 23.*h/12.; A[6*Nlevels+1] = -16.*h/12.; A[6*Nlevels+2] = 5.*h/12.;
+      B[6*Nlevels+0] = 17.*h/24.; B[6*Nlevels+1] = - 7.*h/24.; B[6*Nlevels+2] = 2.*h/24.;
+    }
+  }
+
   if (newOptions.compareArgs("TIME INTEGRATOR","DOPRI5")){
     int NrkStages = 7;
     acoustics->rkq  = (dfloat*) calloc((mesh->totalHaloPairs+mesh->Nelements)*mesh->Np*mesh->Nfields,
@@ -89,7 +156,32 @@ acoustics_t *acousticsSetup(mesh_t *mesh, setupAide &newOptions, char* boundaryH
     memcpy(acoustics->rkC, rkC, acoustics->Nrk*sizeof(dfloat));
     memcpy(acoustics->rkE, rkE, acoustics->Nrk*sizeof(dfloat));
     memcpy(acoustics->rkA, rkA, acoustics->Nrk*acoustics->Nrk*sizeof(dfloat));
-    
+  }
+
+  if (lserkEmbedded){
+    // LSERK4 stages in 2N form plus one register for the embedded error
+    acoustics->resq  = (dfloat*) calloc(mesh->Nelements*mesh->Np*mesh->Nfields,
+          sizeof(dfloat));
+    acoustics->rkq   = (dfloat*) calloc((mesh->totalHaloPairs+mesh->Nelements)*mesh->Np*mesh->Nfields,
+          sizeof(dfloat));
+    acoustics->rkerr = (dfloat*) calloc(mesh->Nelements*mesh->Np*mesh->Nfields,
+          sizeof(dfloat));
+
+    acoustics->errtmp = (dfloat*) calloc(acoustics->Nblock, sizeof(dfloat));
+
+    // b - bhat of a third order method on the LSERK4 stages
+    dfloat rkE[5] = {-1.0551646709299256,
+                      2.2687631457869588,
+                     -1.6062517483580934,
+                      0.35966315565732393,
+                      0.032990117843736198};
+
+    acoustics->Nrk = mesh->Nrk;
+    acoustics->rkE = (dfloat*) calloc(acoustics->Nrk, sizeof(dfloat));
+    memcpy(acoustics->rkE, rkE, acoustics->Nrk*sizeof(dfloat));
+  }
+
+  if (newOptions.compareArgs("TIME INTEGRATOR","DOPRI5") || lserkEmbedded){
     acoustics->dtMIN = 1E-9; //minumum allowed timestep
     acoustics->ATOL = 1E-6;  //absolute error tolerance
     acoustics->RTOL = 1E-6;  //relative error tolerance
@@ -101,7 +193,7 @@ acoustics_t *acousticsSetup(mesh_t *mesh, setupAide &newOptions, char* boundaryH
     acoustics->factor2 = 10.0;
 
 
-    acoustics->exp1 = 0.2 - 0.75*acoustics->beta;
+    acoustics->exp1 = (lserkEmbedded ? 0.25 : 0.2) - 0.75*acoustics->beta;
     acoustics->invfactor1 = 1.0/acoustics->factor1;
     acoustics->invfactor2 = 1.0/acoustics->factor2;
     acoustics->facold = 1E-4;
@@ -129,6 +221,37 @@ acoustics_t *acousticsSetup(mesh_t *mesh, setupAide &newOptions, char* boundaryH
     }
   }
 
+  // members differ by the position of the initial pulse
+  if(Nensemble>1){
+    dfloat spacing = 0.1;
+    newOptions.getArgs("ENSEMBLE PULSE SPACING", spacing);
+
+    acoustics->qEnsemble = (dfloat*) calloc((mesh->totalHaloPairs+mesh->Nelements)*Nensemble*mesh->Np*mesh->Nfields,
+					    sizeof(dfloat));
+
+    for(dlong e=0;e<mesh->Nelements;++e){
+      for(int m=0;m<Nensemble;++m){
+	for(int n=0;n<mesh->Np;++n){
+	  dfloat t = 0;
+	  dfloat x = mesh->x[n + mesh->Np*e] - m*spacing;
+	  dfloat y = mesh->y[n + mesh->Np*e];
+	  dfloat z = mesh->z[n + mesh->Np*e];
+
+	  dlong qbase = (e*Nensemble+m)*mesh->Np*mesh->Nfields + n;
+
+	  dfloat u = 0, v = 0, w = 0, r = 0;
+
+	  acousticsGaussianPulse(x, y, z, t, &r, &u, &v, &w);
+	  acoustics->qEnsemble[qbase+0*mesh->Np] = r;
+	  acoustics->qEnsemble[qbase+1*mesh->Np] = u;
+	  acoustics->qEnsemble[qbase+2*mesh->Np] = v;
+	  if(acoustics->dim==3)
+	    acoustics->qEnsemble[qbase+3*mesh->Np] = w;
+	}
+      }
+    }
+  }
+
   // set penalty parameter
   mesh->Lambda2 = 0.5;
   
@@ -158,13 +281,12 @@ acoustics_t *acousticsSetup(mesh_t *mesh, setupAide &newOptions, char* boundaryH
   dfloat dtAdv  = hmin/((mesh->N+1.)*(mesh->N+1.));
   dfloat dt = cfl*dtAdv;
   
-  // MPI_Allreduce to get global minimum dt
-  MPI_Allreduce(&dt, &(mesh->dt), 1, MPI_DFLOAT, MPI_MIN, mesh->comm);
-  
-  //
-  newOptions.getArgs("FINAL TIME", mesh->finalTime);
+  if(!mrab){
+    // MPI_Allreduce to get global minimum dt
+    MPI_Allreduce(&dt, &(mesh->dt), 1, MPI_DFLOAT, MPI_MIN, mesh->comm);
 
-  mesh->NtimeSteps = mesh->finalTime/mesh->dt;
+    mesh->NtimeSteps = mesh->finalTime/mesh->dt;
+  }
   if (newOptions.compareArgs("TIME INTEGRATOR","LSERK4")){
     mesh->dt = mesh->finalTime/mesh->NtimeSteps;
   }
@@ -194,20 +316,54 @@ acoustics_t *acousticsSetup(mesh_t *mesh, setupAide &newOptions, char* boundaryH
   //add boundary data to kernel info
   kernelInfo["includes"] += boundaryHeaderFileName;
  
+  // fused LSERK4 stages write into a second copy of the state
+  int fused = newOptions.compareArgs("TIME INTEGRATOR","FUSED");
+  if (fused && (lserkEmbedded || !newOptions.compareArgs("TIME INTEGRATOR","LSERK4"))){
+    printf("WARNING: only LSERK4 has a fused stage kernel, running unfused\n");
+    fused = 0;
+  }
+  if (Nensemble>1 && !fused){
+    printf("ERROR: ENSEMBLE SIZE > 1 needs TIME INTEGRATOR LSERK4+FUSED\n");
+    exit(-1);
+  }
+
+  dfloat *qinit = (Nensemble>1) ? acoustics->qEnsemble : acoustics->q;
+  
   acoustics->o_q =
-    mesh->device.malloc(mesh->Np*(mesh->totalHaloPairs+mesh->Nelements)*mesh->Nfields*sizeof(dfloat), acoustics->q);
+    mesh->device.malloc(Nensemble*mesh->Np*(mesh->totalHaloPairs+mesh->Nelements)*mesh->Nfields*sizeof(dfloat), qinit);
+
+  if (fused)
+    acoustics->o_qtmp =
+      mesh->device.malloc(Nensemble*mesh->Np*(mesh->totalHaloPairs+mesh->Nelements)*mesh->Nfields*sizeof(dfloat), qinit);
 
-  acoustics->o_saveq =
-    mesh->device.malloc(mesh->Np*(mesh->totalHaloPairs+mesh->Nelements)*mesh->Nfields*sizeof(dfloat), acoustics->q);
+  if (newOptions.compareArgs("TIME INTEGRATOR","DOPRI5"))
+    acoustics->o_saveq =
+      mesh->device.malloc(mesh->Np*(mesh->totalHaloPairs+mesh->Nelements)*mesh->Nfields*sizeof(dfloat), acoustics->q);
   
   acoustics->o_rhsq =
-    mesh->device.malloc(mesh->Np*mesh->Nelements*mesh->Nfields*sizeof(dfloat), acoustics->rhsq);
+    mesh->device.malloc(Nrhs*mesh->Np*mesh->Nelements*mesh->Nfields*sizeof(dfloat), acoustics->rhsq);
 
   cout << "TIME INTEGRATOR (" << newOptions.getArgs("TIME INTEGRATOR") << ")" << endl;
   
-  if (newOptions.compareArgs("TIME INTEGRATOR","LSERK4")){
+  if (newOptions.compareArgs("TIME INTEGRATOR","LSERK4") && !lserkEmbedded){
     acoustics->o_resq =
-      mesh->device.malloc(mesh->Np*mesh->Nelements*mesh->Nfields*sizeof(dfloat), acoustics->resq);
+      mesh->device.malloc(Nensemble*mesh->Np*mesh->Nelements*mesh->Nfields*sizeof(dfloat), acoustics->resq);
+  }
+
+  if (mrab){
+    acoustics->o_fQM =
+      mesh->device.malloc((mesh->Nelements+mesh->totalHaloPairs)*mesh->Nfp*mesh->Nfaces*mesh->Nfields*sizeof(dfloat), acoustics->fQM);
+
+    mesh->o_mapP = mesh->device.malloc(mesh->Nelements*mesh->Nfp*mesh->Nfaces*sizeof(dlong), mesh->mapP);
+
+    mesh->o_MRABelementIds = new occa::memory[mesh->MRABNlevels];
+    mesh->o_MRABhaloIds    = new occa::memory[mesh->MRABNlevels];
+    for (int lev=0;lev<mesh->MRABNlevels;lev++) {
+      if (mesh->MRABNelements[lev])
+        mesh->o_MRABelementIds[lev] = mesh->device.malloc(mesh->MRABNelements[lev]*sizeof(dlong), mesh->MRABelementIds[lev]);
+      if (mesh->MRABNhaloElements[lev])
+        mesh->o_MRABhaloIds[lev]    = mesh->device.malloc(mesh->MRABNhaloElements[lev]*sizeof(dlong), mesh->MRABhaloIds[lev]);
+    }
   }
 
   if (newOptions.compareArgs("TIME INTEGRATOR","DOPRI5")){
@@ -226,14 +382,28 @@ acoustics_t *acousticsSetup(mesh_t *mesh, setupAide &newOptions, char* boundaryH
     acoustics->o_rkE = mesh->device.malloc(  acoustics->Nrk*sizeof(dfloat), acoustics->rkE);
   }
 
+  if (lserkEmbedded){
+    acoustics->o_resq =
+      mesh->device.malloc(mesh->Np*mesh->Nelements*mesh->Nfields*sizeof(dfloat), acoustics->resq);
+    acoustics->o_rkq =
+      mesh->device.malloc(mesh->Np*(mesh->totalHaloPairs+mesh->Nelements)*mesh->Nfields*sizeof(dfloat), acoustics->rkq);
+    acoustics->o_rkerr =
+      mesh->device.malloc(mesh->Np*mesh->Nelements*mesh->Nfields*sizeof(dfloat), acoustics->rkerr);
+
+    acoustics->o_errtmp = mesh->device.malloc(acoustics->Nblock*sizeof(dfloat), acoustics->errtmp);
+  }
+
   
   if(mesh->totalHaloPairs>0){
-    // temporary DEVICE buffer for halo (maximum size Nfields*Np for dfloat)
+    // MRAB exchanges face traces instead of volume nodes
+    int NhaloEntries = mrab ? mesh->Nfp*mesh->Nfaces*mesh->Nfields : Nensemble*mesh->Np*mesh->Nfields;
+
+    // temporary DEVICE buffer for halo
     mesh->o_haloBuffer =
-      mesh->device.malloc(mesh->totalHaloPairs*mesh->Np*mesh->Nfields*sizeof(dfloat));
+      mesh->device.malloc(mesh->totalHaloPairs*NhaloEntries*sizeof(dfloat));
 
     // MPI send buffer
-    acoustics->haloBytes = mesh->totalHaloPairs*mesh->Np*acoustics->Nfields*sizeof(dfloat);
+    acoustics->haloBytes = mesh->totalHaloPairs*NhaloEntries*sizeof(dfloat);
 
     acoustics->o_haloBuffer = mesh->device.malloc(acoustics->haloBytes);
 
@@ -253,6 +423,7 @@ acoustics_t *acousticsSetup(mesh_t *mesh, setupAide &newOptions, char* boundaryH
   // p_half, p_two, p_third, p_Nstresses
   
   kernelInfo["defines/" "p_Nfields"]= mesh->Nfields;
+  kernelInfo["defines/" "p_Nensemble"]= Nensemble;
   const dfloat p_one = 1.0, p_two = 2.0, p_half = 1./2., p_third = 1./3., p_zero = 0;
 
   kernelInfo["defines/" "p_two"]= p_two;
@@ -331,11 +502,60 @@ acoustics_t *acousticsSetup(mesh_t *mesh, setupAide &newOptions, char* boundaryH
 				       "acousticsErrorEstimate",
 				       kernelInfo);
 
+  acoustics->rkEmbeddedUpdateKernel =
+    mesh->device.buildKernel(DACOUSTICS "/okl/acousticsUpdate.okl",
+				       "acousticsLserkEmbeddedUpdate",
+				       kernelInfo);
+
   // fix this later
   mesh->haloExtractKernel =
     mesh->device.buildKernel(DHOLMES "/okl/meshHaloExtract3D.okl",
 				       "meshHaloExtract3D",
 				       kernelInfo);
 
+  mesh->haloExtractEnsembleKernel =
+    mesh->device.buildKernel(DHOLMES "/okl/meshHaloExtract3D.okl",
+				       "meshHaloExtractEnsemble3D",
+				       kernelInfo);
+
+  if(fused){
+    sprintf(fileName, DACOUSTICS "/okl/acousticsFused%s.okl", suffix);
+    sprintf(kernelName, "acousticsFusedLserk%s", suffix);
+    acoustics->fusedStageKernel = mesh->device.buildKernel(fileName, kernelName, kernelInfo);
+  }
+
+  if(mrab){
+    sprintf(fileName, DACOUSTICS "/okl/acousticsVolume%s.okl", suffix);
+    sprintf(kernelName, "acousticsMRVolume%s", suffix);
+    acoustics->mrVolumeKernel = mesh->device.buildKernel(fileName, kernelName, kernelInfo);
+
+    sprintf(fileName, DACOUSTICS "/okl/acousticsSurface%s.okl", suffix);
+    sprintf(kernelName, "acousticsMRSurface%s", suffix);
+    acoustics->mrSurfaceKernel = mesh->device.buildKernel(fileName, kernelName, kernelInfo);
+
+    acoustics->mrabUpdateKernel =
+      mesh->device.buildKernel(DACOUSTICS "/okl/acousticsUpdate.okl",
+				       "acousticsMRABUpdate",
+				       kernelInfo);
+    acoustics->mrabTraceUpdateKernel =
+      mesh->device.buildKernel(DACOUSTICS "/okl/acousticsUpdate.okl",
+				       "acousticsMRABTraceUpdate",
+				       kernelInfo);
+
+    // populate the face traces from the initial condition
+    dlong offset = mesh->Np*mesh->Nelements*mesh->Nfields;
+    for (int lev=0;lev<mesh->MRABNlevels;lev++)
+      if (mesh->MRABNelements[lev])
+        acoustics->mrabTraceUpdateKernel(mesh->MRABNelements[lev],
+					 mesh->o_MRABelementIds[lev],
+					 offset,
+					 mesh->MRABshiftIndex[lev],
+					 (dfloat) 0., (dfloat) 0., (dfloat) 0.,
+					 mesh->o_vmapM,
+					 acoustics->o_q,
+					 acoustics->o_rhsq,
+					 acoustics->o_fQM);
+  }
+
   return acoustics;
 }
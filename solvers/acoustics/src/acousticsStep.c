@@ -29,22 +29,29 @@ SOFTWARE.
 void acousticsDopriStep(acoustics_t *acoustics, setupAide &newOptions, const dfloat time){
 
   mesh_t *mesh = acoustics->mesh;
+
+  // LSERK43 advances rkq in place through the 2N LSERK4 stages
+  int lserkEmbedded = newOptions.compareArgs("TIME INTEGRATOR","LSERK43");
+
+  if(lserkEmbedded)
+    acoustics->o_rkq.copyFrom(acoustics->o_q, mesh->Nelements*mesh->Np*mesh->Nfields*sizeof(dfloat));
   
   //RK step
   for(int rk=0;rk<acoustics->Nrk;++rk){
     
     // t_rk = t + C_rk*dt
-    dfloat currentTime = time + acoustics->rkC[rk]*mesh->dt;
+    dfloat currentTime = time + (lserkEmbedded ? mesh->rkc[rk] : acoustics->rkC[rk])*mesh->dt;
     
     //compute RK stage 
     // rkq = q + dt sum_{i=0}^{rk-1} a_{rk,i}*rhsq_i
-    acoustics->rkStageKernel(mesh->Nelements,
-		       rk,
-		       mesh->dt,
-		       acoustics->o_rkA,
-		       acoustics->o_q,
-		       acoustics->o_rkrhsq,
-		       acoustics->o_rkq);
+    if(!lserkEmbedded)
+      acoustics->rkStageKernel(mesh->Nelements,
+			 rk,
+			 mesh->dt,
+			 acoustics->o_rkA,
+			 acoustics->o_q,
+			 acoustics->o_rkrhsq,
+			 acoustics->o_rkq);
     
     //compute RHS
     // rhsq = F(currentTIme, rkq)
@@ -89,6 +96,22 @@ void acousticsDopriStep(acoustics_t *acoustics, setupAide &newOptions, const dfl
 			     acoustics->o_rkq, 
 			     acoustics->o_rhsq);
     
+    if(lserkEmbedded){
+      // resq = rka_rk*resq + dt*rhsq, rkq += rkb_rk*resq
+      // rkerr = dt*sum_{i=0}^{rk} rkE_i*rhsq_i
+      acoustics->rkEmbeddedUpdateKernel(mesh->Nelements,
+					rk,
+					mesh->dt,
+					mesh->rka[rk],
+					mesh->rkb[rk],
+					acoustics->rkE[rk],
+					acoustics->o_rhsq,
+					acoustics->o_resq,
+					acoustics->o_rkerr,
+					acoustics->o_rkq);
+      continue;
+    }
+
     // update solution using Runge-Kutta
     // rkrhsq_rk = rhsq
     // if rk==6 
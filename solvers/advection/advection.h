@@ -44,6 +44,11 @@ typedef struct{
   
   int Nfields;
 
+  // independent members advanced together by the fused stage, stored per element
+  // as consecutive blocks of Np*Nfields (qEnsemble is the host copy)
+  int Nensemble;
+  dfloat *qEnsemble;
+
   hlong totalElements;
   dlong Nblock;
 
@@ -63,9 +68,14 @@ typedef struct{
   occa::kernel rkStageKernel;
   occa::kernel rkUpdateKernel;
   occa::kernel rkErrorEstimateKernel;
+  occa::kernel rkEmbeddedUpdateKernel;
 
   occa::kernel combinedKernel;
 
+  // fused LSERK stage (volume+surface+update), ping-pongs q with qtmp0
+  int fused;
+  occa::kernel fusedStageKernel;
+
   occa::kernel invertMassMatrixKernel;
   occa::kernel invertMassMatrixCombinedKernel;
   
@@ -101,7 +111,7 @@ typedef struct{
   occa::memory o_recvBuffer;
   occa::memory o_haloBuffer;
 
-  // DOPRI5 RK data
+  // DOPRI5 RK data (LSERK43 uses mesh->rka/rkb/rkc with rkE as its error weights)
   int advSwitch;
   int Nrk;
   dfloat ATOL, RTOL;
@@ -131,6 +141,8 @@ void advectionDopriStep(advection_t *advection, setupAide &newOptions, const dfl
 
 void advectionLserkStep(advection_t *advection, setupAide &newOoptions, const dfloat time);
 
+void advectionFusedLserkStep(advection_t *advection, setupAide &newOptions, const dfloat time);
+
 dfloat advectionDopriEstimate(advection_t *advection);
 
 #define TRIANGLES 3
@@ -0,0 +1,106 @@
+/*
+
+  The MIT License (MIT)
+
+  Copyright (c) 2017 Tim Warburton, Noel Chalmers, Jesse Chan, Ali Karakus
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+*/
+
+#include "advection.h"
+
+// LSERK4 step with one fused volume+surface+update kernel per stage. Stages
+// ping-pong between o_q and o_qtmp0 since neighbours still read the old state.
+void advectionFusedLserkStep(advection_t *advection, setupAide &newOptions, const dfloat time){
+
+  mesh_t *mesh = advection->mesh;
+
+  // the fused stage exchanges whole halo elements (all members) rather than face nodes
+  int Nentries = advection->Nensemble*mesh->Np*advection->Nfields;
+
+  occa::memory o_sourceq = advection->o_q;
+  occa::memory o_destq   = advection->o_qtmp0;
+
+  for(int rk=0;rk<mesh->Nrk;++rk){
+
+    // extract q halo on DEVICE
+    if(mesh->totalHaloPairs>0){
+      mesh->haloExtractEnsembleKernel(mesh->totalHaloPairs, Nentries, mesh->o_haloElementList, o_sourceq, advection->o_haloBuffer);
+
+      // copy extracted halo to HOST
+      advection->o_haloBuffer.copyTo(advection->sendBuffer);
+
+      // start halo exchange
+      meshHaloExchangeStart(mesh, Nentries*sizeof(dfloat), advection->sendBuffer, advection->recvBuffer);
+    }
+
+    // elements with no neighbour on another rank overlap the exchange
+    if(mesh->NinternalElements)
+      advection->fusedStageKernel(mesh->NinternalElements,
+				  mesh->o_internalElementIds,
+				  mesh->dt,
+				  mesh->rka[rk],
+				  mesh->rkb[rk],
+				  mesh->o_vgeo,
+				  mesh->o_Dmatrices,
+				  advection->o_advectionVelocityJW,
+				  mesh->o_vmapM,
+				  mesh->o_vmapP,
+				  advection->o_advectionVelocityM,
+				  advection->o_advectionVelocityP,
+				  advection->o_resq,
+				  o_sourceq,
+				  o_destq);
+
+    // wait for q halo data to arrive
+    if(mesh->totalHaloPairs>0){
+      meshHaloExchangeFinish(mesh);
+
+      // copy halo data to DEVICE
+      size_t offset = Nentries*mesh->Nelements*sizeof(dfloat); // offset for halo data
+      o_sourceq.copyFrom(advection->recvBuffer, advection->haloBytes, offset);
+    }
+
+    if(mesh->NnotInternalElements)
+      advection->fusedStageKernel(mesh->NnotInternalElements,
+				  mesh->o_notInternalElementIds,
+				  mesh->dt,
+				  mesh->rka[rk],
+				  mesh->rkb[rk],
+				  mesh->o_vgeo,
+				  mesh->o_Dmatrices,
+				  advection->o_advectionVelocityJW,
+				  mesh->o_vmapM,
+				  mesh->o_vmapP,
+				  advection->o_advectionVelocityM,
+				  advection->o_advectionVelocityP,
+				  advection->o_resq,
+				  o_sourceq,
+				  o_destq);
+
+    occa::memory o_tmp = o_sourceq;
+    o_sourceq = o_destq;
+    o_destq   = o_tmp;
+  }
+
+  // an odd number of stages leaves the solution in o_qtmp0
+  advection->o_qtmp0 = o_destq;
+  advection->o_q     = o_sourceq;
+}
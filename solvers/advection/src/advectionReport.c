@@ -26,10 +26,45 @@ SOFTWARE.
 
 #include "advection.h"
 
+// check and plot each ensemble member in turn through the single member host array
+static void advectionEnsembleReport(advection_t *advection, dfloat time){
+
+  mesh3D *mesh = advection->mesh;
+
+  int Nensemble = advection->Nensemble;
+  dlong NpNfields = mesh->Np*advection->Nfields;
+
+  // copy data back to host
+  advection->o_q.copyTo(advection->qEnsemble, Nensemble*mesh->Nelements*NpNfields*sizeof(dfloat));
+
+  char fname[BUFSIZ];
+
+  for(int m=0;m<Nensemble;++m){
+    for(dlong e=0;e<mesh->Nelements;++e)
+      for(dlong n=0;n<NpNfields;++n)
+        advection->q[e*NpNfields+n] = advection->qEnsemble[(e*Nensemble+m)*NpNfields+n];
+
+    // do error stuff on host
+    if(mesh->rank==0) printf("member %d: ", m);
+    advectionError(advection, time);
+
+    sprintf(fname, "foo_%04d_%04d_%04d.vtu", mesh->rank, m, advection->frame);
+
+    advectionPlotVTU(advection, fname);
+  }
+
+  ++advection->frame;
+}
+
 void advectionReport(advection_t *advection, dfloat time, setupAide &newOptions){
 
   mesh3D *mesh = advection->mesh;
 
+  if(advection->Nensemble>1){
+    advectionEnsembleReport(advection, time);
+    return;
+  }
+
   // copy data back to host
   advection->o_q.copyTo(advection->q);
 
@@ -46,7 +46,11 @@ void advectionRun(advection_t *advection, setupAide &newOptions){
   
   occa::streamTag start = mesh->device.tagStream();
   
-  if (newOptions.compareArgs("TIME INTEGRATOR","DOPRI5")) {
+  // LSERK43 shares the adaptive controller, but keeps no copy of the state
+  // for an output mini step so its steps are clipped to the output times
+  int lserkEmbedded = newOptions.compareArgs("TIME INTEGRATOR","LSERK43");
+
+  if (newOptions.compareArgs("TIME INTEGRATOR","DOPRI5") || lserkEmbedded) {
     
     // hard code this for the moment
     dfloat outputInterval;
@@ -72,6 +76,14 @@ void advectionRun(advection_t *advection, setupAide &newOptions){
         exit (-1);
       }
 
+      //check for an output time inside this step
+      dfloat unclippedDt = mesh->dt;
+      int outputStep = 0;
+      if (lserkEmbedded && outputInterval>0 && time+mesh->dt >= nextOutputTime){
+	mesh->dt = nextOutputTime-time;
+	outputStep = 1;
+      }
+
       //check for final timestep
       if (time+mesh->dt > mesh->finalTime){
 	mesh->dt = mesh->finalTime-time;
@@ -94,7 +106,7 @@ void advectionRun(advection_t *advection, setupAide &newOptions){
       if (err<1.0) { //dt is accepted
 
 	// check for output during this step and do a mini-step
-	if(time<nextOutputTime && time+mesh->dt>nextOutputTime){
+	if(!lserkEmbedded && time<nextOutputTime && time+mesh->dt>nextOutputTime){
 	  dfloat savedt = mesh->dt;
 	  
 	  // save rkq
@@ -131,6 +143,16 @@ void advectionRun(advection_t *advection, setupAide &newOptions){
 
         time += mesh->dt;
 
+	// the step was clipped to end on the output time
+	if(outputStep){
+	  advectionReport(advection, time, newOptions);
+
+	  nextOutputTime += outputInterval;
+
+	  // a short step onto the output time should not shrink the next one
+	  dtnew = mymax(dtnew, unclippedDt);
+	}
+
         advection->facold = mymax(err,1E-4); // hard coded factor ?
 	if(!(tstep%1000))
 	  printf("\r time = %g (%d), dt = %g accepted                      ", time, allStep,  mesh->dt);
@@ -156,11 +178,17 @@ void advectionRun(advection_t *advection, setupAide &newOptions){
     
   } else if (newOptions.compareArgs("TIME INTEGRATOR","LSERK4")) {
 
+    // LSERK4+FUSED runs one volume+surface+update kernel per stage
+    int fused = advection->fused;
+
     for(int tstep=0;tstep<mesh->NtimeSteps;++tstep){
 
       dfloat time = tstep*mesh->dt;
 
-      advectionLserkStep(advection, newOptions, time);
+      if(fused)
+        advectionFusedLserkStep(advection, newOptions, time);
+      else
+        advectionLserkStep(advection, newOptions, time);
       
       if(((tstep+1)%mesh->errorStep)==0){
 	time += mesh->dt;
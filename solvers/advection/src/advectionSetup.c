@@ -38,6 +38,10 @@ advection_t *advectionSetup(mesh_t *mesh, setupAide &newOptions, char* boundaryH
   mesh->Nfields = 1;
   advection->Nfields = mesh->Nfields;
 
+  advection->Nensemble = 1;
+  newOptions.getArgs("ENSEMBLE SIZE", advection->Nensemble);
+  int Nensemble = advection->Nensemble;
+
   advection->mesh = mesh;
 
   dlong Ntotal = mesh->Nelements*mesh->Np*mesh->Nfields;
@@ -55,8 +59,11 @@ advection_t *advectionSetup(mesh_t *mesh, setupAide &newOptions, char* boundaryH
   advection->rhsq = (dfloat*) calloc(mesh->Nelements*mesh->Np*mesh->Nfields,
 				sizeof(dfloat));
 
-  if (newOptions.compareArgs("TIME INTEGRATOR","LSERK4")){
-    advection->resq = (dfloat*) calloc(mesh->Nelements*mesh->Np*mesh->Nfields,
+  // compareArgs matches substrings, so "LSERK4" also matches LSERK43
+  int lserkEmbedded = newOptions.compareArgs("TIME INTEGRATOR","LSERK43");
+
+  if (newOptions.compareArgs("TIME INTEGRATOR","LSERK4") && !lserkEmbedded){
+    advection->resq = (dfloat*) calloc(Nensemble*mesh->Nelements*mesh->Np*mesh->Nfields,
 		  		sizeof(dfloat));
   }
 
@@ -91,7 +98,32 @@ advection_t *advectionSetup(mesh_t *mesh, setupAide &newOptions, char* boundaryH
     memcpy(advection->rkC, rkC, advection->Nrk*sizeof(dfloat));
     memcpy(advection->rkE, rkE, advection->Nrk*sizeof(dfloat));
     memcpy(advection->rkA, rkA, advection->Nrk*advection->Nrk*sizeof(dfloat));
+  }
+
+  if (lserkEmbedded){
+    // LSERK4 stages in 2N form plus one register for the embedded error
+    advection->resq  = (dfloat*) calloc(mesh->Nelements*mesh->Np*mesh->Nfields,
+          sizeof(dfloat));
+    advection->rkq   = (dfloat*) calloc((mesh->totalHaloPairs+mesh->Nelements)*mesh->Np*mesh->Nfields,
+          sizeof(dfloat));
+    advection->rkerr = (dfloat*) calloc(mesh->Nelements*mesh->Np*mesh->Nfields,
+          sizeof(dfloat));
+
+    advection->errtmp = (dfloat*) calloc(advection->Nblock, sizeof(dfloat));
+
+    // b - bhat of a third order method on the LSERK4 stages
+    dfloat rkE[5] = {-1.0551646709299256,
+                      2.2687631457869588,
+                     -1.6062517483580934,
+                      0.35966315565732393,
+                      0.032990117843736198};
 
+    advection->Nrk = mesh->Nrk;
+    advection->rkE = (dfloat*) calloc(advection->Nrk, sizeof(dfloat));
+    memcpy(advection->rkE, rkE, advection->Nrk*sizeof(dfloat));
+  }
+
+  if (newOptions.compareArgs("TIME INTEGRATOR","DOPRI5") || lserkEmbedded){
     advection->dtMIN = 1E-9; //minumum allowed timestep
     advection->ATOL = 1E-6;  //absolute error tolerance
     advection->RTOL = 1E-6;  //relative error tolerance
@@ -103,7 +135,7 @@ advection_t *advectionSetup(mesh_t *mesh, setupAide &newOptions, char* boundaryH
     advection->factor2 = 10.0;
 
 
-    advection->exp1 = 0.2 - 0.75*advection->beta;
+    advection->exp1 = (lserkEmbedded ? 0.25 : 0.2) - 0.75*advection->beta;
     advection->invfactor1 = 1.0/advection->factor1;
     advection->invfactor2 = 1.0/advection->factor2;
     advection->facold = 1E-4;
@@ -127,6 +159,33 @@ advection_t *advectionSetup(mesh_t *mesh, setupAide &newOptions, char* boundaryH
     }
   }
 
+  // members differ by the position of the initial pulse
+  if(Nensemble>1){
+    dfloat spacing = 0.1;
+    newOptions.getArgs("ENSEMBLE PULSE SPACING", spacing);
+
+    advection->qEnsemble = (dfloat*) calloc((mesh->totalHaloPairs+mesh->Nelements)*Nensemble*mesh->Np*mesh->Nfields,
+					    sizeof(dfloat));
+
+    for(dlong e=0;e<mesh->Nelements;++e){
+      for(int m=0;m<Nensemble;++m){
+	for(int n=0;n<mesh->Np;++n){
+	  dfloat t = 0;
+	  dfloat x = mesh->x[n + mesh->Np*e] - m*spacing;
+	  dfloat y = mesh->y[n + mesh->Np*e];
+	  dfloat z = mesh->z[n + mesh->Np*e];
+
+	  dlong qbase = (e*Nensemble+m)*mesh->Np*mesh->Nfields + n;
+
+	  dfloat qn = 0;
+
+	  advectionGaussianPulse(x, y, z, t, &qn);
+	  advection->qEnsemble[qbase+0*mesh->Np] = qn;
+	}
+      }
+    }
+  }
+
   // set time step
   dfloat hmin = 1e9;
 
@@ -227,11 +286,13 @@ advection_t *advectionSetup(mesh_t *mesh, setupAide &newOptions, char* boundaryH
   //add boundary data to kernel info
   kernelInfo["includes"] += boundaryHeaderFileName;
 
+  dfloat *qinit = (Nensemble>1) ? advection->qEnsemble : advection->q;
+
   advection->o_q =
-    mesh->device.malloc(mesh->Np*(mesh->totalHaloPairs+mesh->Nelements)*mesh->Nfields*sizeof(dfloat), advection->q);
+    mesh->device.malloc(Nensemble*mesh->Np*(mesh->totalHaloPairs+mesh->Nelements)*mesh->Nfields*sizeof(dfloat), qinit);
 
   advection->o_qtmp0 =
-    mesh->device.malloc(mesh->Np*(mesh->totalHaloPairs+mesh->Nelements)*mesh->Nfields*sizeof(dfloat), advection->q);
+    mesh->device.malloc(Nensemble*mesh->Np*(mesh->totalHaloPairs+mesh->Nelements)*mesh->Nfields*sizeof(dfloat), qinit);
 
   advection->o_qtmp1 =
     mesh->device.malloc(mesh->Np*(mesh->totalHaloPairs+mesh->Nelements)*mesh->Nfields*sizeof(dfloat), advection->q);
@@ -239,8 +300,9 @@ advection_t *advectionSetup(mesh_t *mesh, setupAide &newOptions, char* boundaryH
   advection->o_qtmp2 =
     mesh->device.malloc(mesh->Np*(mesh->totalHaloPairs+mesh->Nelements)*mesh->Nfields*sizeof(dfloat), advection->q);
 
-  advection->o_saveq =
-    mesh->device.malloc(mesh->Np*(mesh->totalHaloPairs+mesh->Nelements)*mesh->Nfields*sizeof(dfloat), advection->q);
+  if (newOptions.compareArgs("TIME INTEGRATOR","DOPRI5"))
+    advection->o_saveq =
+      mesh->device.malloc(mesh->Np*(mesh->totalHaloPairs+mesh->Nelements)*mesh->Nfields*sizeof(dfloat), advection->q);
 
   advection->o_rhsq =
     mesh->device.malloc(mesh->Np*(mesh->totalHaloPairs+mesh->Nelements)*mesh->Nfields*sizeof(dfloat), advection->rhsq);
@@ -421,9 +483,9 @@ advection_t *advectionSetup(mesh_t *mesh, setupAide &newOptions, char* boundaryH
 
   cout << "TIME INTEGRATOR (" << newOptions.getArgs("TIME INTEGRATOR") << ")" << endl;
 
-  if (newOptions.compareArgs("TIME INTEGRATOR","LSERK4")){
+  if (newOptions.compareArgs("TIME INTEGRATOR","LSERK4") && !lserkEmbedded){
     advection->o_resq =
-      mesh->device.malloc(mesh->Np*mesh->Nelements*mesh->Nfields*sizeof(dfloat), advection->resq);
+      mesh->device.malloc(Nensemble*mesh->Np*mesh->Nelements*mesh->Nfields*sizeof(dfloat), advection->resq);
   }
 
   if (newOptions.compareArgs("TIME INTEGRATOR","DOPRI5")){
@@ -442,12 +504,41 @@ advection_t *advectionSetup(mesh_t *mesh, setupAide &newOptions, char* boundaryH
     advection->o_rkE = mesh->device.malloc(  advection->Nrk*sizeof(dfloat), advection->rkE);
   }
 
+  if (lserkEmbedded){
+    advection->o_resq =
+      mesh->device.malloc(mesh->Np*mesh->Nelements*mesh->Nfields*sizeof(dfloat), advection->resq);
+    advection->o_rkq =
+      mesh->device.malloc(mesh->Np*(mesh->totalHaloPairs+mesh->Nelements)*mesh->Nfields*sizeof(dfloat), advection->rkq);
+    advection->o_rkerr =
+      mesh->device.malloc(mesh->Np*mesh->Nelements*mesh->Nfields*sizeof(dfloat), advection->rkerr);
+
+    advection->o_errtmp = mesh->device.malloc(advection->Nblock*sizeof(dfloat), advection->errtmp);
+  }
+
+
+  // fused LSERK4 stages ping-pong q with qtmp0
+  int fused = newOptions.compareArgs("TIME INTEGRATOR","FUSED");
+  if (fused && (lserkEmbedded || !newOptions.compareArgs("TIME INTEGRATOR","LSERK4"))){
+    printf("WARNING: only LSERK4 has a fused stage kernel, running unfused\n");
+    fused = 0;
+  }
+  if (fused && (advectionForm || advectionIntegration || advectionMassType)){
+    printf("WARNING: the fused stage is nodal weak SEMDG only, running unfused\n");
+    fused = 0;
+  }
+  advection->fused = fused;
+
+  if (Nensemble>1 && !fused){
+    printf("ERROR: ENSEMBLE SIZE > 1 needs TIME INTEGRATOR LSERK4+FUSED\n");
+    exit(-1);
+  }
 
   if(mesh->totalHaloPairs>0){
-    // NOTE USE OF NFP NODES PER HALO FACE
+    // NOTE USE OF NFP NODES PER HALO FACE (the fused stage sends whole elements)
+    int NhaloNodes = fused ? Nensemble*mesh->Np : mesh->Nfp;
 
     // MPI send buffer
-    advection->haloBytes = mesh->totalHaloPairs*mesh->Nfp*advection->Nfields*sizeof(dfloat);
+    advection->haloBytes = mesh->totalHaloPairs*NhaloNodes*advection->Nfields*sizeof(dfloat);
     
     // temporary DEVICE buffer for halo (maximum size Nfields*Np for dfloat)
     mesh->o_haloBuffer =
@@ -467,6 +558,8 @@ advection_t *advectionSetup(mesh_t *mesh, setupAide &newOptions, char* boundaryH
   // p_half, p_two, p_third, p_Nstresses
 
   kernelInfo["defines/" "p_Nfields"]= mesh->Nfields;
+  kernelInfo["defines/" "p_dim"]= advection->dim; // meshOccaSetup2D does not set it
+  kernelInfo["defines/" "p_Nensemble"]= Nensemble;
   const dfloat p_one = 1.0, p_two = 2.0, p_half = 1./2., p_third = 1./3., p_zero = 0;
 
   kernelInfo["defines/" "p_two"]= p_two;
@@ -558,6 +651,12 @@ advection_t *advectionSetup(mesh_t *mesh, setupAide &newOptions, char* boundaryH
 
   advection->surfaceKernel = mesh->device.buildKernel(fileName, kernelName, kernelInfo);
 
+  if(fused){
+    sprintf(fileName, DADVECTION "/okl/advectionFused%s.okl", suffix);
+    sprintf(kernelName, "advectionFusedLserk%s", suffix);
+    advection->fusedStageKernel = mesh->device.buildKernel(fileName, kernelName, kernelInfo);
+  }
+
   // kernels from update file
   advection->updateKernel =
     mesh->device.buildKernel(DADVECTION "/okl/advectionUpdate.okl",
@@ -578,11 +677,21 @@ advection_t *advectionSetup(mesh_t *mesh, setupAide &newOptions, char* boundaryH
 				       "advectionErrorEstimate",
 				       kernelInfo);
 
+  advection->rkEmbeddedUpdateKernel =
+    mesh->device.buildKernel(DADVECTION "/okl/advectionUpdate.okl",
+				       "advectionLserkEmbeddedUpdate",
+				       kernelInfo);
+
   // fix this later
   mesh->haloExtractKernel =
     mesh->device.buildKernel(DHOLMES "/okl/meshHaloExtract3D.okl",
 				       "meshHaloExtract3D",
 				       kernelInfo);
+
+  mesh->haloExtractEnsembleKernel =
+    mesh->device.buildKernel(DHOLMES "/okl/meshHaloExtract3D.okl",
+				       "meshHaloExtractEnsemble3D",
+				       kernelInfo);
   mesh->haloGetKernel =
     mesh->device.buildKernel(DHOLMES "/okl/meshHaloGet.okl",
 			     "meshHaloGet",
@@ -29,22 +29,29 @@
 void advectionDopriStep(advection_t *advection, setupAide &newOptions, const dfloat time){
 
   mesh_t *mesh = advection->mesh;
+
+  // LSERK43 advances rkq in place through the 2N LSERK4 stages
+  int lserkEmbedded = newOptions.compareArgs("TIME INTEGRATOR","LSERK43");
+
+  if(lserkEmbedded)
+    advection->o_rkq.copyFrom(advection->o_q, mesh->Nelements*mesh->Np*mesh->Nfields*sizeof(dfloat));
   
   //RK step
   for(int rk=0;rk<advection->Nrk;++rk){
     
     // t_rk = t + C_rk*dt
-    dfloat currentTime = time + advection->rkC[rk]*mesh->dt;
+    dfloat currentTime = time + (lserkEmbedded ? mesh->rkc[rk] : advection->rkC[rk])*mesh->dt;
     
     //compute RK stage 
     // rkq = q + dt sum_{i=0}^{rk-1} a_{rk,i}*rhsq_i
-    advection->rkStageKernel(mesh->Nelements,
-			     rk,
-			     mesh->dt,
-			     advection->o_rkA,
-			     advection->o_q,
-			     advection->o_rkrhsq,
-			     advection->o_rkq);
+    if(!lserkEmbedded)
+      advection->rkStageKernel(mesh->Nelements,
+			       rk,
+			       mesh->dt,
+			       advection->o_rkA,
+			       advection->o_q,
+			       advection->o_rkrhsq,
+			       advection->o_rkq);
     
     //compute RHS
     // rhsq = F(currentTIme, rkq)
@@ -131,6 +138,22 @@ void advectionDopriStep(advection_t *advection, setupAide &newOptions, const dfl
 			     advection->o_rkq, 
 			     advection->o_rhsq);
     
+    if(lserkEmbedded){
+      // resq = rka_rk*resq + dt*rhsq, rkq += rkb_rk*resq
+      // rkerr = dt*sum_{i=0}^{rk} rkE_i*rhsq_i
+      advection->rkEmbeddedUpdateKernel(mesh->Nelements,
+					rk,
+					mesh->dt,
+					mesh->rka[rk],
+					mesh->rkb[rk],
+					advection->rkE[rk],
+					advection->o_rhsq,
+					advection->o_resq,
+					advection->o_rkerr,
+					advection->o_rkq);
+      continue;
+    }
+
     // update solution using Runge-Kutta
     // rkrhsq_rk = rhsq
     // if rk==6 
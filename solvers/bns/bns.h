@@ -107,13 +107,21 @@ typedef struct{
   dfloat *pmlrhsqx, *pmlrhsqy, *pmlrhsqz;
   dfloat *pmlresqx, *pmlresqy, *pmlresqz;
 
-  // Some Iso-surfacing variables
-  int isoField, isoColorField, isoNfields, isoNlevels, isoMaxNtris, *isoNtris; 
-  dfloat isoMinVal, isoMaxVal, *isoLevels, *isoq; 
-  size_t isoMax; 
+  // Some Iso-surfacing variables, extracted on the welded plot mesh
+  int isoField, isoColorField, isoNlevels, isoMaxNtris, isoMaxNverts;
+  dfloat isoMinVal, isoMaxVal, *isoLevels;
+  dlong isoNelements, NplotEdges;
 
-  occa::memory o_isoLevels, o_isoq, o_isoNtris; 
-  occa::memory o_plotInterp, o_plotEToV; 
+  // staging of the frame being written to the shared VTP file
+  char *isoStage;
+  size_t isoStageBytes;
+  int isoPending;
+  MPI_File isoFile;
+  MPI_Request isoRequest;
+
+  occa::memory o_plotInterp, o_plotEToV;
+  occa::memory o_isoElementIds, o_plotNodeRep, o_plotEdges, o_plotEdgeNodes, o_isoPlotq;
+  occa::memory o_isoCounts, o_isoEdgeVert, o_isoPoints, o_isoColor, o_isoTris;
 
 
   // IMEX Coefficients
@@ -135,18 +143,6 @@ typedef struct{
 
 
 
-  int *isoGNlevels, isoGNgroups;
-  dfloat **isoGLvalues;
-
-  occa::memory *o_isoGLvalues; 
-
-
-
-
-  // NBN: add storage for compacted isosurf data for gmsh write
-  std::vector<dfloat> iso_nodes;
-  std::vector<int> iso_tris;
-
   int emethod; 
   int tstep, atstep, rtstep, tstepAccepted, rkp;
   dfloat ATOL, RTOL, time; 
@@ -209,7 +205,9 @@ typedef struct{
 
   occa::kernel vorticityKernel;
 
-  occa::kernel isoSurfaceKernel;
+  occa::kernel isoPlotKernel;
+  occa::kernel isoEdgesKernel;
+  occa::kernel isoTrisKernel;
 
   occa::kernel constrainKernel;
   
@@ -250,8 +248,11 @@ void bnsReport(bns_t *bns, dfloat time, setupAide &options);
 void bnsError(bns_t *bns, dfloat time, setupAide &options);
 void bnsForces(bns_t *bns, dfloat time, setupAide &options);
 void bnsPlotVTU(bns_t *bns, char * FileName);
-void bnsIsoPlotVTU(bns_t *bns, int isoNtris, dfloat *isoq, char *fileName);
-void bnsIsoWeldPlotVTU(bns_t *bns, char *fileName);
+
+// device isosurfaces written as binary VTP, one shared file per frame
+void bnsIsoSurfaceSetup(bns_t *bns, setupAide &options);
+void bnsIsoSurface(bns_t *bns, char *fileName);
+void bnsIsoSurfaceClose(bns_t *bns);
 
 //
 void bnsRestartWrite(bns_t *bns, setupAide &options, dfloat time); 
@@ -283,13 +284,6 @@ void bnsSARKStep(bns_t *bns, dfloat time, int haloBytes,
 void bnsRunEmbedded(bns_t *bns, int haloBytes, dfloat * sendBuffer,
 		    dfloat *recvBuffer, setupAide &options);
 
-// Welding Tris
-
-int bnsWeldTriVerts(bns_t *bns, int isoNtris, dfloat *isoq);
-
-void bnsIsoPlotGmsh(bns_t *bns, int isoNtris, char *fname, int tstep, int N_offset,     
-  					int E_offset, int plotnum, dfloat plottime,    bool bBinary, int procid);
-
 
 
 #define TRIANGLES 3
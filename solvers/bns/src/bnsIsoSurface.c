@@ -0,0 +1,404 @@
+/*
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Tim Warburton, Noel Chalmers, Jesse Chan, Ali Karakus
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include <stdint.h>
+#include "bns.h"
+
+typedef struct {
+  hlong q[3];   // quantized plot node coordinates
+  dlong id;     // flat plot node index e*plotNp+n
+} isoPlotNode_t;
+
+typedef struct {
+  dlong a, b;   // representative plot nodes, a<b
+  dlong slot;   // (e*plotNelements+t)*6+k
+} isoPlotEdge_t;
+
+static int bnsIsoComparePlotNodes(const void *a, const void *b){
+  const isoPlotNode_t *na = (const isoPlotNode_t*) a;
+  const isoPlotNode_t *nb = (const isoPlotNode_t*) b;
+
+  for(int d=0;d<3;++d){
+    if(na->q[d] < nb->q[d]) return -1;
+    if(na->q[d] > nb->q[d]) return +1;
+  }
+  return (na->id < nb->id) ? -1 : (na->id > nb->id);
+}
+
+static int bnsIsoComparePlotEdges(const void *a, const void *b){
+  const isoPlotEdge_t *ea = (const isoPlotEdge_t*) a;
+  const isoPlotEdge_t *eb = (const isoPlotEdge_t*) b;
+
+  if(ea->a < eb->a) return -1;
+  if(ea->a > eb->a) return +1;
+  if(ea->b < eb->b) return -1;
+  if(ea->b > eb->b) return +1;
+  return 0;
+}
+
+// read the ISOSURFACE options, weld the plot nodes shared between elements
+// and number the edges of the plot tets once, since the mesh does not move
+void bnsIsoSurfaceSetup(bns_t *bns, setupAide &options){
+
+  mesh_t *mesh = bns->mesh;
+
+  if(bns->dim!=3 || !options.compareArgs("OUTPUT FILE FORMAT", "ISO")) return;
+
+  if(bns->elementType==QUADRILATERALS){
+    if(mesh->rank==0) printf("WARNING: isosurfaces are not available for surface quadrilaterals\n");
+    return;
+  }
+
+  // 0 pr (1,2,3) (u,v,w) (4,5,6) vort(x,y,z) 7 mag(vort) 8 mag(u)
+  bns->isoField      = 7;
+  bns->isoColorField = 8;
+  bns->isoNlevels    = 1;
+  bns->isoMaxNtris   = 1.E7;
+  bns->isoMinVal     = 0.;
+  bns->isoMaxVal     = 0.;
+  options.getArgs("ISOSURFACE FIELD ID", bns->isoField);
+  options.getArgs("ISOSURFACE COLOR ID", bns->isoColorField);
+  options.getArgs("ISOSURFACE LEVEL NUMBER", bns->isoNlevels);
+  options.getArgs("ISOSURFACE CONTOUR MAX", bns->isoMaxVal);
+  options.getArgs("ISOSURFACE CONTOUR MIN", bns->isoMinVal);
+  options.getArgs("ISOSURFACE MAX TRIANGLES", bns->isoMaxNtris);
+  bns->isoMaxNverts = bns->isoMaxNtris;
+
+  bns->isoNlevels = mymax(bns->isoNlevels, 1);
+  bns->isoLevels  = (dfloat*) calloc(bns->isoNlevels, sizeof(dfloat));
+  for(int l=0;l<bns->isoNlevels;++l)
+    bns->isoLevels[l] = (bns->isoNlevels==1) ? bns->isoMinVal :
+      bns->isoMinVal + (bns->isoMaxVal-bns->isoMinVal)*l/(dfloat)(bns->isoNlevels-1);
+
+  // isosurfaces are not extracted in the absorbing layer
+  bns->isoNelements = 0;
+  dlong *isoElementIds = (dlong*) calloc(mesh->Nelements+1, sizeof(dlong));
+  for(dlong e=0;e<mesh->Nelements;++e){
+    const int type = mesh->elementInfo[e];
+    const int pml  = (type==100)||(type==200)||(type==300)||
+                     (type==400)||(type==500)||(type==600)||(type==700);
+    if(!mesh->pmlNelements || !pml)
+      isoElementIds[bns->isoNelements++] = e;
+  }
+
+  const int plotNp = mesh->plotNp;
+  const int plotNelements = mesh->plotNelements;
+  const dlong Nplot = mesh->Nelements*plotNp;
+
+  // Interpolation operators form Np to PlotNp (equisapaced nodes of order >N generally)
+  dfloat *plotInterp = (dfloat*) calloc(plotNp*mesh->Np, sizeof(dfloat));
+  for(int n=0;n<plotNp;++n)
+    for(int m=0;m<mesh->Np;++m)
+      plotInterp[n+m*plotNp] = mesh->plotInterp[n*mesh->Np+m];
+
+  bns->o_plotInterp = mesh->device.malloc(plotNp*mesh->Np*sizeof(dfloat), plotInterp);
+
+  // EToV for local triangulation
+  int *plotEToV = (int*) calloc(plotNelements*mesh->plotNverts, sizeof(int));
+  for(int n=0;n<plotNelements;++n)
+    for(int m=0;m<mesh->plotNverts;++m)
+      plotEToV[n+m*plotNelements] = mesh->plotEToV[n*mesh->plotNverts+m];
+
+  bns->o_plotEToV = mesh->device.malloc(plotNelements*mesh->plotNverts*sizeof(int), plotEToV);
+
+  // plot node coordinates, quantized relative to the size of the partition
+  dfloat *plotx = (dfloat*) calloc(3*(Nplot+1), sizeof(dfloat));
+  dfloat xmin[3] = {0.,0.,0.}, xmax[3] = {0.,0.,0.};
+
+  for(dlong e=0;e<mesh->Nelements;++e){
+    for(int n=0;n<plotNp;++n){
+      const dlong id = e*plotNp+n;
+      for(int m=0;m<mesh->Np;++m){
+        const dfloat Inm = mesh->plotInterp[n*mesh->Np+m];
+        plotx[3*id+0] += Inm*mesh->x[m+e*mesh->Np];
+        plotx[3*id+1] += Inm*mesh->y[m+e*mesh->Np];
+        plotx[3*id+2] += Inm*mesh->z[m+e*mesh->Np];
+      }
+      for(int d=0;d<3;++d){
+        xmin[d] = (id==0) ? plotx[3*id+d] : mymin(xmin[d], plotx[3*id+d]);
+        xmax[d] = (id==0) ? plotx[3*id+d] : mymax(xmax[d], plotx[3*id+d]);
+      }
+    }
+  }
+
+  const dfloat extent = mymax(xmax[0]-xmin[0], mymax(xmax[1]-xmin[1], xmax[2]-xmin[2]));
+  const dfloat tol    = 1.e-9*mymax(extent, (dfloat) 1.e-12);
+
+  isoPlotNode_t *nodes = (isoPlotNode_t*) calloc(Nplot+1, sizeof(isoPlotNode_t));
+  for(dlong id=0;id<Nplot;++id){
+    for(int d=0;d<3;++d)
+      nodes[id].q[d] = (hlong) llround((plotx[3*id+d]-xmin[d])/tol);
+    nodes[id].id = id;
+  }
+  qsort(nodes, Nplot, sizeof(isoPlotNode_t), bnsIsoComparePlotNodes);
+
+  // every plot node is represented by the first node at its position
+  dlong *plotNodeRep = (dlong*) calloc(Nplot+1, sizeof(dlong));
+  for(dlong i=0, rep=0;i<Nplot;++i){
+    if(i==0 || nodes[i-1].q[0]!=nodes[i].q[0] || nodes[i-1].q[1]!=nodes[i].q[1] || nodes[i-1].q[2]!=nodes[i].q[2])
+      rep = nodes[i].id;
+    plotNodeRep[nodes[i].id] = rep;
+  }
+  free(nodes);
+  free(plotx);
+
+  // number the edges of the plot tets between representatives
+  const int edgeVerts[6][2] = {{0,1},{0,2},{0,3},{1,2},{1,3},{2,3}};
+  const dlong Nslots = mesh->Nelements*plotNelements*6;
+  const dlong NisoSlots = bns->isoNelements*plotNelements*6;
+
+  isoPlotEdge_t *edges = (isoPlotEdge_t*) calloc(NisoSlots+1, sizeof(isoPlotEdge_t));
+  for(dlong i=0, cnt=0;i<bns->isoNelements;++i){
+    const dlong e = isoElementIds[i];
+    for(int t=0;t<plotNelements;++t){
+      for(int k=0;k<6;++k){
+        const dlong slot = (e*plotNelements+t)*6+k;
+        const dlong ra = plotNodeRep[e*plotNp+plotEToV[t+edgeVerts[k][0]*plotNelements]];
+        const dlong rb = plotNodeRep[e*plotNp+plotEToV[t+edgeVerts[k][1]*plotNelements]];
+        edges[cnt].a    = mymin(ra, rb);
+        edges[cnt].b    = mymax(ra, rb);
+        edges[cnt].slot = slot;
+        ++cnt;
+      }
+    }
+  }
+  qsort(edges, NisoSlots, sizeof(isoPlotEdge_t), bnsIsoComparePlotEdges);
+
+  dlong *plotEdges = (dlong*) calloc(Nslots+1, sizeof(dlong));
+  dlong *edgeNodes = (dlong*) calloc(2*(NisoSlots+1), sizeof(dlong));
+  bns->NplotEdges = 0;
+  for(dlong i=0;i<NisoSlots;++i){
+    if(i==0 || bnsIsoComparePlotEdges(edges+i-1, edges+i)){
+      edgeNodes[2*bns->NplotEdges+0] = edges[i].a;
+      edgeNodes[2*bns->NplotEdges+1] = edges[i].b;
+      ++bns->NplotEdges;
+    }
+    plotEdges[edges[i].slot] = bns->NplotEdges-1;
+  }
+  free(edges);
+
+  bns->o_isoElementIds = mesh->device.malloc((bns->isoNelements+1)*sizeof(dlong), isoElementIds);
+  bns->o_plotNodeRep   = mesh->device.malloc((Nplot+1)*sizeof(dlong), plotNodeRep);
+  bns->o_plotEdges     = mesh->device.malloc((Nslots+1)*sizeof(dlong), plotEdges);
+  bns->o_plotEdgeNodes = mesh->device.malloc(2*(bns->NplotEdges+1)*sizeof(dlong), edgeNodes);
+  bns->o_isoPlotq      = mesh->device.malloc((Nplot+1)*5*sizeof(dfloat));
+  bns->o_isoEdgeVert   = mesh->device.malloc((bns->NplotEdges+1)*sizeof(int));
+
+  bns->o_isoCounts = mesh->device.malloc(2*sizeof(int));
+  bns->o_isoPoints = mesh->device.malloc(3*(size_t)bns->isoMaxNverts*sizeof(float));
+  bns->o_isoColor  = mesh->device.malloc(  (size_t)bns->isoMaxNverts*sizeof(float));
+  bns->o_isoTris   = mesh->device.malloc(3*(size_t)bns->isoMaxNtris*sizeof(int));
+
+  bns->isoStage      = NULL;
+  bns->isoStageBytes = 0;
+  bns->isoPending    = 0;
+
+  free(isoElementIds);
+  free(plotInterp);
+  free(plotEToV);
+  free(plotNodeRep);
+  free(plotEdges);
+  free(edgeNodes);
+}
+
+// complete the write of the previous frame and release its staging
+void bnsIsoSurfaceClose(bns_t *bns){
+
+  if(!bns->isoPending) return;
+
+  MPI_Wait(&bns->isoRequest, MPI_STATUS_IGNORE);
+  MPI_File_close(&bns->isoFile);
+  bns->isoPending = 0;
+}
+
+// piece of the shared VTP file for rank r with Nv points and Nt triangles
+static int bnsIsoPieceHeader(char *buf, int Nv, int Nt, size_t offset){
+
+  const size_t pointBytes = 3*(size_t)Nv*sizeof(float);
+  const size_t colorBytes =   (size_t)Nv*sizeof(float);
+  const size_t triBytes   = 3*(size_t)Nt*sizeof(int);
+
+  size_t o0 = offset;
+  size_t o1 = o0 + sizeof(uint64_t) + pointBytes;
+  size_t o2 = o1 + sizeof(uint64_t) + colorBytes;
+  size_t o3 = o2 + sizeof(uint64_t) + triBytes;
+
+  return sprintf(buf,
+    "    <Piece NumberOfPoints=\"%d\" NumberOfPolys=\"%d\">\n"
+    "      <Points>\n"
+    "        <DataArray type=\"Float32\" NumberOfComponents=\"3\" format=\"appended\" offset=\"%zu\"/>\n"
+    "      </Points>\n"
+    "      <PointData Scalars=\"Color\">\n"
+    "        <DataArray type=\"Float32\" Name=\"Color\" format=\"appended\" offset=\"%zu\"/>\n"
+    "      </PointData>\n"
+    "      <Polys>\n"
+    "        <DataArray type=\"Int32\" Name=\"connectivity\" format=\"appended\" offset=\"%zu\"/>\n"
+    "        <DataArray type=\"Int32\" Name=\"offsets\" format=\"appended\" offset=\"%zu\"/>\n"
+    "      </Polys>\n"
+    "    </Piece>\n", Nv, Nt, o0, o1, o2, o3);
+}
+
+static size_t bnsIsoPieceBytes(int Nv, int Nt){
+  return 4*sizeof(uint64_t) + 4*(size_t)Nv*sizeof(float) + 4*(size_t)Nt*sizeof(int);
+}
+
+// extract all contour levels of the current solution on the device and start
+// a non-blocking write of one binary VTP file shared by all ranks
+void bnsIsoSurface(bns_t *bns, char *fileName){
+
+  mesh_t *mesh = bns->mesh;
+
+  bns->isoPlotKernel(mesh->Nelements,
+                     bns->isoField,
+                     bns->isoColorField,
+                     mesh->o_x,
+                     mesh->o_y,
+                     mesh->o_z,
+                     bns->o_q,
+                     bns->o_Vort,
+                     bns->o_VortMag,
+                     bns->o_plotInterp,
+                     bns->o_isoPlotq);
+
+  int zero[2] = {0, 0};
+  bns->o_isoCounts.copyFrom(zero);
+
+  // vertices and triangles of all levels are appended to the same buffers
+  for(int l=0;l<bns->isoNlevels;++l){
+    bns->isoEdgesKernel(bns->NplotEdges,
+                        bns->isoLevels[l],
+                        bns->o_plotEdgeNodes,
+                        bns->o_isoPlotq,
+                        bns->isoMaxNverts,
+                        bns->o_isoCounts,
+                        bns->o_isoEdgeVert,
+                        bns->o_isoPoints,
+                        bns->o_isoColor);
+
+    bns->isoTrisKernel(bns->isoNelements,
+                       bns->o_isoElementIds,
+                       bns->isoLevels[l],
+                       bns->o_plotNodeRep,
+                       bns->o_plotEToV,
+                       bns->o_plotEdges,
+                       bns->o_isoPlotq,
+                       bns->o_isoEdgeVert,
+                       bns->isoMaxNtris,
+                       bns->o_isoCounts,
+                       bns->o_isoTris);
+  }
+
+  int counts[2];
+  bns->o_isoCounts.copyTo(counts);
+
+  if(counts[0]>bns->isoMaxNverts || counts[1]>bns->isoMaxNtris)
+    printf("WARNING: rank %d isosurface truncated to %d triangles, increase ISOSURFACE MAX TRIANGLES\n",
+           mesh->rank, bns->isoMaxNtris);
+
+  int Nv = mymin(counts[0], bns->isoMaxNverts);
+  int Nt = mymin(counts[1], bns->isoMaxNtris);
+
+  // the staging of the previous frame is still owned by its write
+  bnsIsoSurfaceClose(bns);
+
+  const size_t pieceBytes = bnsIsoPieceBytes(Nv, Nt);
+  if(pieceBytes>bns->isoStageBytes){
+    bns->isoStage      = (char*) realloc(bns->isoStage, pieceBytes);
+    bns->isoStageBytes = pieceBytes;
+  }
+
+  // stage the piece as [bytes][points][bytes][color][bytes][connectivity][bytes][offsets]
+  char *stage = bns->isoStage;
+  uint64_t nbytes;
+
+  nbytes = 3*(size_t)Nv*sizeof(float);
+  memcpy(stage, &nbytes, sizeof(uint64_t)); stage += sizeof(uint64_t);
+  if(Nv) bns->o_isoPoints.copyTo(stage, nbytes);
+  stage += nbytes;
+
+  nbytes = (size_t)Nv*sizeof(float);
+  memcpy(stage, &nbytes, sizeof(uint64_t)); stage += sizeof(uint64_t);
+  if(Nv) bns->o_isoColor.copyTo(stage, nbytes);
+  stage += nbytes;
+
+  nbytes = 3*(size_t)Nt*sizeof(int);
+  memcpy(stage, &nbytes, sizeof(uint64_t)); stage += sizeof(uint64_t);
+  int *tris = (int*) stage;
+  if(Nt) bns->o_isoTris.copyTo(stage, nbytes);
+  stage += nbytes;
+
+  // triangles whose vertices were dropped by a truncation are collapsed
+  for(int t=0;t<Nt;++t)
+    if(tris[3*t+0]<0 || tris[3*t+1]<0 || tris[3*t+2]<0 || tris[3*t+0]>=Nv || tris[3*t+1]>=Nv || tris[3*t+2]>=Nv)
+      tris[3*t+0] = tris[3*t+1] = tris[3*t+2] = 0;
+
+  nbytes = (size_t)Nt*sizeof(int);
+  memcpy(stage, &nbytes, sizeof(uint64_t)); stage += sizeof(uint64_t);
+  int *offsets = (int*) stage;
+  for(int t=0;t<Nt;++t) offsets[t] = 3*(t+1);
+
+  // every rank builds the same header from the gathered piece sizes
+  int *allCounts = (int*) calloc(2*mesh->size, sizeof(int));
+  int myCounts[2] = {Nv, Nt};
+  MPI_Allgather(myCounts, 2, MPI_INT, allCounts, 2, MPI_INT, mesh->comm);
+
+  const char *head =
+    "<?xml version=\"1.0\"?>\n"
+    "<VTKFile type=\"PolyData\" version=\"1.0\" byte_order=\"LittleEndian\" header_type=\"UInt64\">\n"
+    "  <PolyData>\n";
+  const char *tail =
+    "  </PolyData>\n"
+    "  <AppendedData encoding=\"raw\">\n   _";
+  const char *end =
+    "\n  </AppendedData>\n</VTKFile>\n";
+
+  char *header = (char*) calloc(strlen(head)+strlen(tail)+(size_t)mesh->size*1024, sizeof(char));
+  size_t headerBytes = sprintf(header, "%s", head);
+  size_t dataOffset = 0, myOffset = 0;
+  for(int r=0;r<mesh->size;++r){
+    if(r==mesh->rank) myOffset = dataOffset;
+    headerBytes += bnsIsoPieceHeader(header+headerBytes, allCounts[2*r+0], allCounts[2*r+1], dataOffset);
+    dataOffset  += bnsIsoPieceBytes(allCounts[2*r+0], allCounts[2*r+1]);
+  }
+  headerBytes += sprintf(header+headerBytes, "%s", tail);
+
+  MPI_File_open(mesh->comm, fileName, MPI_MODE_CREATE|MPI_MODE_WRONLY, MPI_INFO_NULL, &bns->isoFile);
+  MPI_File_set_size(bns->isoFile, 0);
+
+  if(mesh->rank==0){
+    MPI_File_write_at(bns->isoFile, 0, header, headerBytes, MPI_CHAR, MPI_STATUS_IGNORE);
+    MPI_File_write_at(bns->isoFile, headerBytes+dataOffset, (void*) end, strlen(end), MPI_CHAR, MPI_STATUS_IGNORE);
+  }
+
+  // the piece is completed in the background, at the next frame or at the end of the run
+  MPI_File_iwrite_at(bns->isoFile, headerBytes+myOffset, bns->isoStage, pieceBytes, MPI_BYTE, &bns->isoRequest);
+  bns->isoPending = 1;
+
+  if(mesh->rank==0) printf("Isosurface %s: %d levels\n", fileName, bns->isoNlevels);
+
+  free(header);
+  free(allCounts);
+}
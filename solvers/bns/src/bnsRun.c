@@ -179,6 +179,17 @@ void bnsRun(bns_t *bns, setupAide &options){
 #endif
     }
 
+      if(bns->probeFlag){
+        dfloat time = 0;
+        if(options.compareArgs("TIME INTEGRATOR", "MRSAAB"))
+          time = bns->startTime + bns->dt*(tstep+1)*pow(2,(mesh->MRABNlevels-1));
+        else
+          time = bns->startTime + (tstep+1)*bns->dt;
+
+        meshProbeSample(mesh, 0, bns->Nfields, mesh->Np*bns->Nfields, mesh->Np, bns->o_q);
+        meshProbeAdvance(mesh, time);
+      }
+
       
       /*
 
@@ -214,6 +225,8 @@ void bnsRun(bns_t *bns, setupAide &options){
  
 
 
+  if(bns->probeFlag) meshProbeClose(mesh);
+
   elp_tot += (MPI_Wtime() - tic_tot);    
   occaTimerToc(mesh->device, "BOLTZMANN");
 
@@ -233,6 +246,9 @@ void bnsRun(bns_t *bns, setupAide &options){
   // For Final Time
   //bnsReport(bns, bns->NtimeSteps,options);
 
+  // finish the last isosurface write before the run returns
+  bnsIsoSurfaceClose(bns);
+
   occa::printTimer();
 }
 
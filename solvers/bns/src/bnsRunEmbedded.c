@@ -41,16 +41,11 @@ void bnsRunEmbedded(bns_t *bns, int haloBytes, dfloat * sendBuffer,
   dfloat invfactor2 = 1.0/factor2;
   dfloat facold     = 1E-4;
 
+  dfloat *elementHmin = meshElementHmin(mesh, bns->elementType);
   dfloat hmin = 1e9;
-  for(dlong e=0;e<mesh->Nelements;++e){  
-    for(int f=0;f<mesh->Nfaces;++f){
-      dlong sid = mesh->Nsgeo*(mesh->Nfaces*e + f);
-      dfloat sJ   = mesh->sgeo[sid + SJID];
-      dfloat invJ = mesh->sgeo[sid + IJID];
-      dfloat hest = .5/(sJ*invJ);
-      hmin = mymin(hmin, hest);
-      }
-  }
+  for(dlong e=0;e<mesh->Nelements;++e)
+    hmin = mymin(hmin, .25*elementHmin[e]);
+  free(elementHmin);
 
 
   // hard code this for the moment
@@ -230,6 +225,11 @@ void bnsRunEmbedded(bns_t *bns, int haloBytes, dfloat * sendBuffer,
       facold = mymax(err,1E-4);
       bns->time += bns->dt;
 
+      if(bns->probeFlag){
+        meshProbeSample(mesh, 0, bns->Nfields, mesh->Np*bns->Nfields, mesh->Np, bns->o_q);
+        meshProbeAdvance(mesh, bns->time);
+      }
+
       if(mesh->rank==0) printf("\r time = %g (%d), dt = %g accepted (ratio dt/hmin = %g)               ", bns->time, bns->atstep, bns->dt, bns->dt/hmin);
       bns->tstep++;
     }
@@ -102,6 +102,14 @@ bns_t *bnsSetup(mesh_t *mesh, setupAide &options){
     }
   }
 
+  // ensembles are acoustics/advection only: the PML and MRSAAB state has no member dimension
+  int Nensemble = 1;
+  options.getArgs("ENSEMBLE SIZE", Nensemble);
+  if(Nensemble>1){
+    printf("ERROR: ENSEMBLE SIZE > 1 is not supported by bns\n");
+    exit(-1);
+  }
+
   bns->readRestartFile = 0; 
   options.getArgs("RESTART FROM FILE", bns->readRestartFile);
   
@@ -224,23 +232,14 @@ bns_t *bnsSetup(mesh_t *mesh, setupAide &options){
   dfloat ghmin        = 1e9; 
   dfloat dt           = 1e9; 
   dfloat *EtoDT       = (dfloat *) calloc(mesh->Nelements,sizeof(dfloat));
+  dfloat *elementHmin = meshElementHmin(mesh, bns->elementType);
 
   //Set time step size
   for(dlong e=0;e<mesh->Nelements;++e){ 
-    dfloat hmin = 1e9, dtmax = 1e9;
+    dfloat hmin = elementHmin[e], dtmax = 1e9;
     
     EtoDT[e] = dtmax;
 
-    for(int f=0;f<mesh->Nfaces;++f){
-      // not good for all element types (some have varying geofacs)
-      dlong sid   = mesh->Nsgeo*(mesh->Nfaces*e + f);
-      dfloat sJ   = mesh->sgeo[sid + SJID];
-      dfloat invJ = mesh->sgeo[sid + IJID];
-     
-      dfloat htest = 2.0/(sJ*invJ);
-      hmin = mymin(hmin, htest); 
-    }
-
     ghmin = mymin(ghmin, hmin);
 
     dfloat dtex   = bns->cfl*hmin/((mesh->N+1.)*(mesh->N+1.)*sqrt(3.)*bns->sqrtRT);
@@ -257,6 +256,8 @@ bns_t *bnsSetup(mesh_t *mesh, setupAide &options){
   }
 
 
+  free(elementHmin);
+
   printf("ghmin =  %lg\n", ghmin);
 
   
@@ -426,15 +427,13 @@ bns_t *bnsSetup(mesh_t *mesh, setupAide &options){
  
   // SET PROBE DATA
   if(bns->probeFlag){
-    // mesh->probeNTotal = 3; 
-    // dfloat *pX   = (dfloat *) calloc (mesh->probeNTotal, sizeof(dfloat));
-    // dfloat *pY   = (dfloat *) calloc (mesh->probeNTotal, sizeof(dfloat));
-    // // Fill probe coordinates
-    //  pX[0] = 9.00;  pX[1] = 10.00;  pX[2] = 10.50; //pX[3] = 5;
-    //  pY[0] = 5.00;  pY[1] =  6.00;  pY[2] =  6.50; //pY[3] = 5*tan(M_PI/6.);
-    // meshProbeSetup2D(mesh, pX, pY);
-    // free(pX); free(pY);
-
+    string probeFile;
+    if(options.getArgs("PROBE FILE", probeFile))
+      meshProbeSetupFile(mesh, bns->elementType, probeFile.c_str());
+    else{
+      if(mesh->rank==0) printf("WARNING setup file does not include PROBE FILE, probes are disabled\n");
+      bns->probeFlag = 0;
+    }
   }
 
   occa::properties kernelInfo;
@@ -485,107 +484,6 @@ bns_t *bnsSetup(mesh_t *mesh, setupAide &options){
   
 
   bns->Nvort      = 3;   // hold wx, wy, wz
-  // Set Iso-surfacing stuf here
-  if(options.compareArgs("OUTPUT FILE FORMAT","ISO") && bns->dim==3){
-    
-    // Only one field is exported for iso-surface to reduce the file size
-    bns->isoNfields  = 1;   //1 + (bns->dim) + (1 + bns->dim) ; // p, u.v,w, vort_x, vort_y, vort_z, wort_mag 
-    bns->isoMaxNtris = 1.E7; 
-
-    bns->procid = gethostid();
-
-    //
-    options.getArgs("ISOSURFACE FIELD ID", bns->isoField); 
-    options.getArgs("ISOSURFACE COLOR ID", bns->isoColorField); 
-    options.getArgs("ISOSURFACE LEVEL NUMBER", bns->isoNlevels);
-    options.getArgs("ISOSURFACE CONTOUR MAX", bns->isoMaxVal); 
-    options.getArgs("ISOSURFACE CONTOUR MIN", bns->isoMinVal);
-
-
-    bns->isoMax    = (bns->dim + bns->isoNfields)*3*bns->isoMaxNtris;
-    bns->isoNtris  = (int*) calloc(1, sizeof(int));
-    bns->isoq      = (dfloat*) calloc(bns->isoMax, sizeof(dfloat)); 
-
-  
-    bns->o_isoq      = mesh->device.malloc(bns->isoMax*sizeof(dfloat), bns->isoq);
-    bns->o_isoNtris  = mesh->device.malloc(1*sizeof(int), bns->isoNtris);
-
-
-   
-
-    // meshParallelGatherScatter(mesh, ogs, o_q);
-    // Create all contour levels
-    dfloat *isoLevels = (dfloat*) calloc(bns->isoNlevels, sizeof(dfloat));
-    for(int l=0;l<bns->isoNlevels;++l)
-      isoLevels[l] = bns->isoMinVal + (bns->isoMaxVal-bns->isoMinVal)*l/(dfloat)(bns->isoNlevels-1);
-
-
-
-    // GROUP LEVELS of ISOCONTOURS
-
-    int levelsInGroup = 0; 
-    options.getArgs("ISOSURFACE GROUP NUMBER", levelsInGroup);
-
-    if(levelsInGroup==0) {printf("Number of levels in each group can not be zero!!!\n");  exit(EXIT_FAILURE);} 
-    if(levelsInGroup){
-
-      // Number of groups for isosurfaces
-      bns->isoGNgroups        = bns->isoNlevels/(levelsInGroup);  
-      if(bns->isoNlevels%(levelsInGroup))
-        bns->isoGNgroups++; 
-
-      bns->isoGNlevels        = (int *) calloc(bns->isoGNgroups,sizeof(int));
-      bns->isoGLvalues        = (dfloat **) calloc(bns->isoGNgroups,sizeof(dfloat*));
-
-      for(int gr =0; gr<bns->isoGNgroups; gr++)
-  {
-    int nlevels = (gr+1)*levelsInGroup > bns->isoNlevels ? (bns->isoNlevels%levelsInGroup) : levelsInGroup;  
-    bns->isoGNlevels[gr] = nlevels;  
-    printf("Isosurface Group %d has %d levels\n", gr, bns->isoGNlevels[gr]);
-  }
-
-      // Allocate memory for levels in each group
-      for (int gr =0;gr<bns->isoGNgroups;gr++)
-        bns->isoGLvalues[gr] = (dfloat *) calloc(bns->isoGNlevels[gr],sizeof(dfloat));
-
-      int sk = 0; 
-      for (int gr =0;gr<bns->isoGNgroups;gr++){
-        printf("Isosurface Group %d Values\n", gr);        
-        for (int l=0;l<bns->isoGNlevels[gr];l++){
-          bns->isoGLvalues[gr][l] = isoLevels[sk + l];
-          printf("%.4f\t", bns->isoGLvalues[gr][l]);
-        }
-        printf("\n");
-  sk += bns->isoGNlevels[gr]; 
-      }
-
-      // Create levels for each group
-      bns->o_isoGLvalues     = (occa::memory *) malloc(bns->isoGNgroups*sizeof(occa::memory));
-      for (int gr =0;gr<bns->isoGNgroups;gr++)
-        bns->o_isoGLvalues[gr] = mesh->device.malloc(bns->isoGNlevels[gr]*sizeof(dfloat),bns->isoGLvalues[gr]);
-    
-    }
-
-    // Interpolation operators form Np to PlotNp (equisapaced nodes of order >N generally)
-    dfloat *plotInterp = (dfloat*) calloc(mesh->plotNp*mesh->Np, sizeof(dfloat));
-    for(int n=0;n<mesh->plotNp;++n){
-      for(int m=0;m<mesh->Np;++m){
-        plotInterp[n+m*mesh->plotNp] = mesh->plotInterp[n*mesh->Np+m];
-      }
-    }
-    bns->o_plotInterp = mesh->device.malloc(mesh->plotNp*mesh->Np*sizeof(dfloat), plotInterp);
-
-    // EToV for local triangulation
-    int *plotEToV = (int*) calloc(mesh->plotNp*mesh->Np, sizeof(int));
-    for(int n=0;n<mesh->plotNelements;++n){
-      for(int m=0;m<mesh->plotNverts;++m){
-        plotEToV[n+m*mesh->plotNelements] = mesh->plotEToV[n*mesh->plotNverts+m];
-      }
-    }
-    bns->o_plotEToV = mesh->device.malloc(mesh->plotNp*mesh->Np*sizeof(int), plotEToV);
-  }
-
-
 
 
   // Compute Time Stepper Coefficcients
@@ -737,11 +635,6 @@ bns_t *bnsSetup(mesh_t *mesh, setupAide &options){
   kernelInfo["defines/" "p_Nvort"]= bns->Nvort;
 
   if(bns->dim==3){
-    kernelInfo["defines/" "p_isoNfields"]= bns->isoNfields;
-    
-    // Define Isosurface Area Tolerance
-    kernelInfo["defines/" "p_triAreaTol"]= (dfloat) 1.0E-16;
-
     kernelInfo["defines/" "p_dim"]= bns->dim;
     kernelInfo["defines/" "p_plotNp"]= mesh->plotNp;
     kernelInfo["defines/" "p_plotNelements"]= mesh->plotNelements;
@@ -923,18 +816,30 @@ bns_t *bnsSetup(mesh_t *mesh, setupAide &options){
 	
         // kernels from volume file
         if(bns->elementType!=QUADRILATERALS){
-          // sprintf(fileName, DBNS "/okl/bnsIsoSurface3D.okl");
-          // sprintf(kernelName, "bnsIsoSurface3D");
+          sprintf(fileName, DBNS "/okl/bnsIsoSurface3D.okl");
+          sprintf(kernelName, "bnsIsoSurfacePlot3D");
+          bns->isoPlotKernel = mesh->device.buildKernel(fileName, kernelName, kernelInfo);
+
+          sprintf(kernelName, "bnsIsoSurfaceEdges3D");
+          bns->isoEdgesKernel = mesh->device.buildKernel(fileName, kernelName, kernelInfo);
 
-          // bns->isoSurfaceKernel =
-          // mesh->device.buildKernel(fileName, kernelName, kernelInfo);
+          sprintf(kernelName, "bnsIsoSurfaceTris3D");
+          bns->isoTrisKernel = mesh->device.buildKernel(fileName, kernelName, kernelInfo);
         }
       }
     }
     MPI_Barrier(mesh->comm);
   }
 
+  if(bns->probeFlag){
+    int Nslots = 64;
+    options.getArgs("PROBE RING SLOTS", Nslots);
+
+    string probeName = "ProbeData";
+    options.getArgs("PROBE OUTPUT NAME", probeName);
 
+    meshProbeDeviceSetup(mesh, bns->Nfields, Nslots, probeName.c_str(), kernelInfo);
+  }
 
   // Setup GatherScatter
   if(bns->dim==3){
@@ -943,6 +848,8 @@ bns_t *bnsSetup(mesh_t *mesh, setupAide &options){
     meshParallelGatherScatterSetup(mesh, Ntotal, mesh->globalIds, mesh->comm, verbose);
   }
 
+  bnsIsoSurfaceSetup(bns, options);
+
   return bns; 
 }
 
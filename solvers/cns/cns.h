@@ -65,6 +65,13 @@ typedef struct{
   dfloat wbar;
 
   int outputForceStep;
+
+  // running statistics (TSTEPS FOR STATISTICS > 0)
+  int statSteps, statMoments;
+  int NstatFields, NstatUU;
+  dlong statCount;
+  dfloat statStartTime;
+  dfloat *statMean, *statM2, *statUU;
   
   
   mesh_t *mesh;
@@ -78,11 +85,21 @@ typedef struct{
   occa::kernel rkUpdateKernel;
   occa::kernel rkOutputKernel;
   occa::kernel rkErrorEstimateKernel;
+  occa::kernel rkEmbeddedUpdateKernel;
 
   occa::kernel stressesVolumeKernel;
   occa::kernel stressesSurfaceKernel;
+
+  occa::kernel mrVolumeKernel;
+  occa::kernel mrSurfaceKernel;
+  occa::kernel mrStressesVolumeKernel;
+  occa::kernel mrStressesSurfaceKernel;
+  occa::kernel mrabUpdateKernel;
+  occa::kernel mrabTraceUpdateKernel;
+  occa::kernel mrabStressesTraceKernel;
   
   occa::kernel vorticityKernel;
+  occa::kernel statisticsKernel;
 
   occa::kernel constrainKernel;
   
@@ -91,6 +108,7 @@ typedef struct{
   occa::memory o_resq;
   occa::memory o_Vort;
   occa::memory o_viscousStresses;
+  occa::memory o_statMean, o_statM2, o_statUU;
   occa::memory o_saveq;
   
   occa::memory o_rkq, o_rkrhsq, o_rkerr;
@@ -112,7 +130,7 @@ typedef struct{
   occa::memory o_recvStressesBuffer;
   occa::memory o_haloStressesBuffer;
 
-  // DOPRI5 RK data
+  // DOPRI5 RK data (LSERK43 uses mesh->rka/rkb/rkc with rkE as its error weights)
   int advSwitch;
   int Nrk;
   dfloat ATOL, RTOL;
@@ -121,6 +139,13 @@ typedef struct{
   dfloat exp1, facold,  dtMIN, dtMAX, safe, beta;
   dfloat *rkA, *rkC, *rkE, *rkoutB;
   occa::memory o_rkA, o_rkC, o_rkE, o_rkoutB;
+
+  // MRAB data: per level AB3 weights for the full (A) and half (B) step,
+  // face traces of the state and stresses, and the half step state of
+  // coarse elements bordering a finer level
+  dfloat *MRAB_A, *MRAB_B;
+  dfloat *fQM, *fSM;
+  occa::memory o_fQM, o_fSM, o_extq;
   
 }cns_t;
 
@@ -142,11 +167,18 @@ void cnsReport(cns_t *cns, dfloat time, setupAide &options);
 
 void cnsPlotVTU(cns_t *cns, char *fileName);
 
+void cnsStatisticsSetup(cns_t *cns, setupAide &options);
+void cnsStatistics(cns_t *cns, dfloat time);
+void cnsStatisticsCopyToHost(cns_t *cns);
+void cnsStatisticsPlotVTU(cns_t *cns, FILE *fp);
+
 void cnsDopriStep(cns_t *cns, setupAide &options, const dfloat time);
 void cnsDopriOutputStep(cns_t *cns, const dfloat time, const dfloat dt, const dfloat outTime, occa::memory o_outq);
 
 void cnsLserkStep(cns_t *cns, setupAide &newOoptions, const dfloat time);
 
+void cnsMRABStep(cns_t *cns, setupAide &options, const int tstep);
+
 dfloat cnsDopriEstimate(cns_t *cns);
 
 void cnsBodyForce(dfloat t, dfloat *fx, dfloat *fy, dfloat *fz,
@@ -0,0 +1,234 @@
+/*
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Tim Warburton, Noel Chalmers, Jesse Chan, Ali Karakus
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "cns.h"
+
+// one coarse MRAB step: 2^(Nlevels-1) ticks of the finest level dt
+void cnsMRABStep(cns_t *cns, setupAide &options, const int tstep){
+
+  mesh_t *mesh = cns->mesh;
+
+  int advSwitch = 1;
+
+  const dlong offset = mesh->Np*mesh->Nelements*mesh->Nfields;
+
+  // ramp up to third order over the first steps
+  const int mrab_order = (tstep<2) ? tstep : 2;
+
+  for (int Ntick=0; Ntick < pow(2,mesh->MRABNlevels-1);Ntick++) {
+
+    // intermediate stage time
+    dfloat currentTime = mesh->dt*(tstep*pow(2,mesh->MRABNlevels-1) + Ntick);
+
+    dfloat fx, fy, fz, intfx, intfy, intfz;
+    cnsBodyForce(currentTime , &fx, &fy, &fz, &intfx, &intfy, &intfz);
+
+    // levels 0..lev-1 need a new rhs at this tick
+    int lev;
+    for (lev=0;lev<mesh->MRABNlevels;lev++)
+      if (Ntick % (1<<lev) != 0) break;
+
+    // the first inactive level only supplies stresses on its faces bordering level lev-1
+    const dlong NhaloElements = (lev<mesh->MRABNlevels) ? mesh->MRABNhaloElements[lev] : 0;
+
+    // extract state trace halo on DEVICE
+    if(mesh->totalHaloPairs>0){
+      int Nentries = mesh->Nfp*mesh->Nfaces*cns->Nfields;
+
+      mesh->haloExtractKernel(mesh->totalHaloPairs, Nentries, mesh->o_haloElementList, cns->o_fQM, cns->o_haloBuffer);
+
+      // copy extracted halo to HOST
+      cns->o_haloBuffer.copyTo(cns->sendBuffer);
+
+      // start halo exchange
+      meshHaloExchangeStart(mesh, Nentries*sizeof(dfloat), cns->sendBuffer, cns->recvBuffer);
+    }
+
+    // viscous stresses of the active levels from the current state, and of
+    // their coarse neighbours from the half step state
+    for (int l=0;l<lev;l++)
+      if (mesh->MRABNelements[l])
+        cns->mrStressesVolumeKernel(mesh->MRABNelements[l],
+                                    mesh->o_MRABelementIds[l],
+                                    mesh->o_vgeo,
+                                    mesh->o_Dmatrices,
+                                    cns->mu,
+                                    cns->o_q,
+                                    cns->o_viscousStresses);
+
+    if (NhaloElements)
+      cns->mrStressesVolumeKernel(NhaloElements,
+                                  mesh->o_MRABhaloIds[lev],
+                                  mesh->o_vgeo,
+                                  mesh->o_Dmatrices,
+                                  cns->mu,
+                                  cns->o_extq,
+                                  cns->o_viscousStresses);
+
+    // wait for state trace halo data to arrive
+    if(mesh->totalHaloPairs>0){
+      meshHaloExchangeFinish(mesh);
+
+      // copy halo data to DEVICE
+      size_t foffset = mesh->Nfp*mesh->Nfaces*cns->Nfields*mesh->Nelements*sizeof(dfloat); // offset for halo data
+      cns->o_fQM.copyFrom(cns->recvBuffer, cns->haloBytes, foffset);
+    }
+
+    for (int l=0;l<=lev && l<mesh->MRABNlevels;l++) {
+      const dlong Nelements = (l<lev) ? mesh->MRABNelements[l] : NhaloElements;
+      occa::memory &o_elementIds = (l<lev) ? mesh->o_MRABelementIds[l] : mesh->o_MRABhaloIds[l];
+
+      if (Nelements) {
+        cns->mrStressesSurfaceKernel(Nelements,
+                                     o_elementIds,
+                                     mesh->o_sgeo,
+                                     mesh->o_LIFTT,
+                                     mesh->o_vmapM,
+                                     mesh->o_mapP,
+                                     mesh->o_EToB,
+                                     currentTime,
+                                     mesh->o_x,
+                                     mesh->o_y,
+                                     mesh->o_z,
+                                     cns->mu,
+                                     intfx, intfy, intfz,
+                                     cns->o_fQM,
+                                     cns->o_viscousStresses);
+
+        cns->mrabStressesTraceKernel(Nelements,
+                                     o_elementIds,
+                                     mesh->o_vmapM,
+                                     cns->o_viscousStresses,
+                                     cns->o_fSM);
+      }
+    }
+
+    // second trace pass: exchange the stress traces
+    if(mesh->totalHaloPairs>0){
+      int Nentries = mesh->Nfp*mesh->Nfaces*cns->Nstresses;
+
+      mesh->haloExtractKernel(mesh->totalHaloPairs, Nentries, mesh->o_haloElementList, cns->o_fSM, cns->o_haloStressesBuffer);
+
+      // copy extracted halo to HOST
+      cns->o_haloStressesBuffer.copyTo(cns->sendStressesBuffer);
+
+      // start halo exchange
+      meshHaloExchangeStart(mesh, Nentries*sizeof(dfloat), cns->sendStressesBuffer, cns->recvStressesBuffer);
+    }
+
+    for (int l=0;l<lev;l++)
+      if (mesh->MRABNelements[l])
+        cns->mrVolumeKernel(mesh->MRABNelements[l],
+                            mesh->o_MRABelementIds[l],
+                            offset,
+                            mesh->MRABshiftIndex[l],
+                            advSwitch,
+                            fx, fy, fz,
+                            mesh->o_vgeo,
+                            mesh->o_x,
+                            mesh->o_y,
+                            mesh->o_z,
+                            mesh->o_Dmatrices,
+                            cns->o_viscousStresses,
+                            cns->o_q,
+                            cns->o_rhsq);
+
+    // wait for stress trace halo data to arrive
+    if(mesh->totalHaloPairs>0){
+      meshHaloExchangeFinish(mesh);
+
+      // copy halo data to DEVICE
+      size_t foffset = mesh->Nfp*mesh->Nfaces*cns->Nstresses*mesh->Nelements*sizeof(dfloat); // offset for halo data
+      cns->o_fSM.copyFrom(cns->recvStressesBuffer, cns->haloStressesBytes, foffset);
+    }
+
+    for (int l=0;l<lev;l++)
+      if (mesh->MRABNelements[l])
+        cns->mrSurfaceKernel(mesh->MRABNelements[l],
+                             mesh->o_MRABelementIds[l],
+                             offset,
+                             mesh->MRABshiftIndex[l],
+                             advSwitch,
+                             mesh->o_sgeo,
+                             mesh->o_LIFTT,
+                             mesh->o_vmapM,
+                             mesh->o_mapP,
+                             mesh->o_EToB,
+                             currentTime,
+                             mesh->o_x,
+                             mesh->o_y,
+                             mesh->o_z,
+                             cns->mu,
+                             intfx, intfy, intfz,
+                             cns->o_fQM,
+                             cns->o_fSM,
+                             cns->o_rhsq);
+
+    // levels 0..lev-1 complete a step at the end of this tick
+    for (lev=0;lev<mesh->MRABNlevels;lev++)
+      if ((Ntick+1) % (1<<lev) != 0) break;
+
+    for (int l=0;l<lev;l++) {
+      const int id = mrab_order*mesh->MRABNlevels*3 + l*3;
+
+      if (mesh->MRABNelements[l])
+        cns->mrabUpdateKernel(mesh->MRABNelements[l],
+                              mesh->o_MRABelementIds[l],
+                              offset,
+                              mesh->MRABshiftIndex[l],
+                              cns->MRAB_A[id+0],
+                              cns->MRAB_A[id+1],
+                              cns->MRAB_A[id+2],
+                              mesh->o_vmapM,
+                              cns->o_rhsq,
+                              cns->o_fQM,
+                              cns->o_q);
+
+      //rotate index
+      mesh->MRABshiftIndex[l] = (mesh->MRABshiftIndex[l]+1)%3;
+    }
+
+    // the first level not updated extrapolates its elements bordering level lev-1
+    // to the half step so that the finer neighbours see a consistent state
+    if (lev<mesh->MRABNlevels) {
+      const int id = mrab_order*mesh->MRABNlevels*3 + lev*3;
+
+      if (mesh->MRABNhaloElements[lev])
+        cns->mrabTraceUpdateKernel(mesh->MRABNhaloElements[lev],
+                                   mesh->o_MRABhaloIds[lev],
+                                   offset,
+                                   mesh->MRABshiftIndex[lev],
+                                   cns->MRAB_B[id+0],
+                                   cns->MRAB_B[id+1],
+                                   cns->MRAB_B[id+2],
+                                   mesh->o_vmapM,
+                                   cns->o_q,
+                                   cns->o_rhsq,
+                                   cns->o_fQM,
+                                   cns->o_extq);
+    }
+  }
+}
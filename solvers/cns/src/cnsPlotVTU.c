@@ -163,6 +163,8 @@ void cnsPlotVTU(cns_t *cns, char *fileName){
     }
     fprintf(fp, "       </DataArray>\n");
   }
+
+  if(cns->statSteps) cnsStatisticsPlotVTU(cns, fp);
   
   fprintf(fp, "     </PointData>\n");
   
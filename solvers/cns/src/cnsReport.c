@@ -66,6 +66,8 @@ void cnsReport(cns_t *cns, dfloat time, setupAide &options){
     string outName;
     options.getArgs("OUTPUT FILE NAME", outName);
     sprintf(fname, "%s_%04d_%04d.vtu",(char*)outName.c_str(), mesh->rank, cns->frame++);
+
+    if(cns->statSteps) cnsStatisticsCopyToHost(cns);
     
     cnsPlotVTU(cns, fname);
   }
@@ -38,7 +38,11 @@ void cnsRun(cns_t *cns, setupAide &options){
 
   timer.tic("Run");
   
-  if (options.compareArgs("TIME INTEGRATOR","DOPRI5")) {
+  // LSERK43 shares the adaptive controller, but has no dense output so
+  // its steps are clipped to land on the output times instead
+  int lserkEmbedded = options.compareArgs("TIME INTEGRATOR","LSERK43");
+
+  if (options.compareArgs("TIME INTEGRATOR","DOPRI5") || lserkEmbedded) {
     int Nregect = 0;
 
     // hard code this for the moment
@@ -70,6 +74,14 @@ void cnsRun(cns_t *cns, setupAide &options){
         exit (-1);
       }
 
+      //check for an output time inside this step
+      dfloat unclippedDt = mesh->dt;
+      int outputStep = 0;
+      if (lserkEmbedded && timeIntervalFlag && time+mesh->dt >= nextOutputTime){
+        mesh->dt = nextOutputTime-time;
+        outputStep = 1;
+      }
+
       //check for final timestep
       if (time+mesh->dt > mesh->finalTime){
         mesh->dt = mesh->finalTime-time;
@@ -92,7 +104,7 @@ void cnsRun(cns_t *cns, setupAide &options){
       if (err<1.0) { //dt is accepted
 
         // check for time interval output during this step
-        if(timeIntervalFlag && time<nextOutputTime && time+mesh->dt>=nextOutputTime){
+        if(!lserkEmbedded && timeIntervalFlag && time<nextOutputTime && time+mesh->dt>=nextOutputTime){
           cnsDopriOutputStep(cns, time,mesh->dt,nextOutputTime, cns->o_saveq);
 
           cns->o_saveq.copyTo(cns->o_q);
@@ -110,6 +122,19 @@ void cnsRun(cns_t *cns, setupAide &options){
         time += mesh->dt;
         tstep++;
 
+        if(cns->statSteps && (tstep%cns->statSteps)==0)
+          cnsStatistics(cns, time);
+
+        // the step was clipped to end on the output time
+        if(outputStep){
+          cnsReport(cns, time, options);
+
+          nextOutputTime += outputInterval;
+
+          // a short step onto the output time should not shrink the next one
+          dtnew = mymax(dtnew, unclippedDt);
+        }
+
 	if(0){
 	  dfloat *maxStresses = (dfloat*) calloc(cns->Nstresses, sizeof(dfloat));
 	  cns->o_viscousStresses.copyTo(cns->viscousStresses);
@@ -188,12 +213,40 @@ void cnsRun(cns_t *cns, setupAide &options){
     dfloat time = tstep*mesh->dt;
 
     cnsLserkStep(cns, options, time);
+
+    if(cns->statSteps && ((tstep+1)%cns->statSteps)==0)
+      cnsStatistics(cns, time+mesh->dt);
       
     if(((tstep+1)%mesh->errorStep)==0){
       time += mesh->dt;
       cnsReport(cns, time, options);
     }
   }
+ } else if (options.compareArgs("TIME INTEGRATOR","MRAB")) {
+
+  // one MRAB step advances the coarsest level by its dt
+  dfloat dtMRAB = pow(2,mesh->MRABNlevels-1)*mesh->dt;
+
+  for(int tstep=0;tstep<mesh->NtimeSteps;++tstep){
+
+    dfloat time = tstep*dtMRAB;
+
+    cnsMRABStep(cns, options, tstep);
+
+    if(cns->statSteps && ((tstep+1)%cns->statSteps)==0)
+      cnsStatistics(cns, time+dtMRAB);
+
+    if(((tstep+1)%mesh->errorStep)==0){
+      time += dtMRAB;
+      cnsReport(cns, time, options);
+    }
+  }
+
+  mesh->device.finish();
+
+  double elapsed  = timer.toc("Run");
+
+  printf("Run took %lg seconds for %d MRAB steps of %d levels\n", elapsed, mesh->NtimeSteps, mesh->MRABNlevels);
  }
   
 }
@@ -39,12 +39,6 @@ cns_t *cnsSetup(mesh_t *mesh, setupAide &options){
   cns->Nstresses = (cns->dim==3) ? 6:3;
   cns->mesh = mesh;
 
-  dlong Ntotal = mesh->Nelements*mesh->Np*mesh->Nfields;
-  cns->Nblock = (Ntotal+blockSize-1)/blockSize;
-  
-  hlong localElements = (hlong) mesh->Nelements;
-  MPI_Allreduce(&localElements, &(cns->totalElements), 1, MPI_HLONG, MPI_SUM, mesh->comm);
-
   // mean flow
   cns->rbar = 1;
   cns->ubar = 0.2;
@@ -79,9 +73,53 @@ cns_t *cnsSetup(mesh_t *mesh, setupAide &options){
   // speed of sound (assuming isothermal unit bulk flow) = sqrt(RT)
   cns->RT = soundSpeed*soundSpeed;
 
+  // multirate levels go before any allocation: meshMRABSetup may repartition the mesh
+  int mrab = options.compareArgs("TIME INTEGRATOR","MRAB");
+  if(mrab){
+    if(cns->elementType==QUADRILATERALS && cns->dim==3){
+      printf("ERROR: MRAB is not available for Quad3D meshes\n");
+      exit(-1);
+    }
+
+    int maxLevels = 1;
+    options.getArgs("MAX MRAB LEVELS", maxLevels);
+    options.getArgs("FINAL TIME", mesh->finalTime);
+
+    // AB3 is stable on about a fifth of the LSERK4 imaginary interval
+    dfloat cfl = 0.1;
+
+    dfloat *EToDT = (dfloat*) calloc(mesh->Nelements, sizeof(dfloat));
+    dfloat *elementHmin = meshElementHmin(mesh, cns->elementType);
+
+    // same advective estimate as the single rate dt below, per element
+    for(dlong e=0;e<mesh->Nelements;++e)
+      EToDT[e] = cfl*0.25*elementHmin[e]/((mesh->N+1.)*(mesh->N+1.)*sqrt(cns->RT));
+
+    if(cns->dim==3)
+      mesh->dt = meshMRABSetup3D(mesh, EToDT, maxLevels, mesh->finalTime);
+    else
+      mesh->dt = meshMRABSetup2D(mesh, EToDT, maxLevels, mesh->finalTime);
+
+    mesh->NtimeSteps = mesh->finalTime/(pow(2,mesh->MRABNlevels-1)*mesh->dt);
+
+    if (mesh->rank==0) printf("MRAB LEVELS\t:\t%d\n", mesh->MRABNlevels);
+
+    free(EToDT);
+    free(elementHmin);
+  }
+
+  dlong Ntotal = mesh->Nelements*mesh->Np*mesh->Nfields;
+  cns->Nblock = (Ntotal+blockSize-1)/blockSize;
+  
+  hlong localElements = (hlong) mesh->Nelements;
+  MPI_Allreduce(&localElements, &(cns->totalElements), 1, MPI_HLONG, MPI_SUM, mesh->comm);
+
   cns->outputForceStep = 0;
   
   options.getArgs("TSTEPS FOR FORCE OUTPUT",   cns->outputForceStep);
+
+  cns->statSteps = 0;
+  options.getArgs("TSTEPS FOR STATISTICS", cns->statSteps);
   
   // compute samples of q at interpolation nodes
   //  mesh->q    = (dfloat*) calloc((mesh->totalHaloPairs+mesh->Nelements)*mesh->Np*mesh->Nfields,
@@ -90,10 +128,15 @@ cns_t *cnsSetup(mesh_t *mesh, setupAide &options){
   cns->q    = (dfloat*) calloc((mesh->totalHaloPairs+mesh->Nelements)*mesh->Np*mesh->Nfields,
 			       sizeof(dfloat));
   
-  cns->rhsq = (dfloat*) calloc(mesh->Nelements*mesh->Np*mesh->Nfields,
+  // MRAB keeps three levels of rhs history
+  int Nrhs = mrab ? 3 : 1;
+  cns->rhsq = (dfloat*) calloc(Nrhs*mesh->Nelements*mesh->Np*mesh->Nfields,
                                 sizeof(dfloat));
   
-  if (options.compareArgs("TIME INTEGRATOR","LSERK4")){
+  // compareArgs matches substrings, so "LSERK4" also matches LSERK43
+  int lserkEmbedded = options.compareArgs("TIME INTEGRATOR","LSERK43");
+
+  if (options.compareArgs("TIME INTEGRATOR","LSERK4") && !lserkEmbedded){
     cns->resq = (dfloat*) calloc(mesh->Nelements*mesh->Np*mesh->Nfields,
                                 sizeof(dfloat));
   }
@@ -131,7 +174,34 @@ cns_t *cnsSetup(mesh_t *mesh, setupAide &options){
     memcpy(cns->rkC, rkC, cns->Nrk*sizeof(dfloat));
     memcpy(cns->rkE, rkE, cns->Nrk*sizeof(dfloat));
     memcpy(cns->rkA, rkA, cns->Nrk*cns->Nrk*sizeof(dfloat));
+  }
+
+  if (lserkEmbedded){
+    // LSERK4 stages in 2N form plus one register for the embedded error:
+    // q, rkq, resq, rkerr and rhsq instead of the 12 states DOPRI5 keeps
+    cns->resq  = (dfloat*) calloc(mesh->Nelements*mesh->Np*mesh->Nfields,
+          sizeof(dfloat));
+    cns->rkq   = (dfloat*) calloc((mesh->totalHaloPairs+mesh->Nelements)*mesh->Np*mesh->Nfields,
+          sizeof(dfloat));
+    cns->rkerr = (dfloat*) calloc(mesh->Nelements*mesh->Np*mesh->Nfields,
+          sizeof(dfloat));
 
+    cns->errtmp = (dfloat*) calloc(cns->Nblock, sizeof(dfloat));
+
+    // b - bhat for a third order method on the LSERK4 stages: the null
+    // vector of the order <= 3 conditions, scaled so that sum_i rkE_i c_i^3 = 1/24
+    dfloat rkE[5] = {-1.0551646709299256,
+                      2.2687631457869588,
+                     -1.6062517483580934,
+                      0.35966315565732393,
+                      0.032990117843736198};
+
+    cns->Nrk = mesh->Nrk;
+    cns->rkE = (dfloat*) calloc(cns->Nrk, sizeof(dfloat));
+    memcpy(cns->rkE, rkE, cns->Nrk*sizeof(dfloat));
+  }
+
+  if (options.compareArgs("TIME INTEGRATOR","DOPRI5") || lserkEmbedded){
     cns->ATOL    = 1.0; options.getArgs("ABSOLUTE TOLERANCE",   cns->ATOL); 
     cns->RTOL    = 1.0; options.getArgs("RELATIVE TOLERANCE",   cns->RTOL);
     cns->dtMIN   = 1.0; options.getArgs("MINUMUM TIME STEP SIZE",   cns->dtMIN);
@@ -145,13 +215,42 @@ cns_t *cnsSetup(mesh_t *mesh, setupAide &options){
     cns->factor2 = 10.0;
 
 
-    cns->exp1 = 0.2 - 0.75*cns->beta;
+    // 1/(p+1) for the lower order of the pair
+    cns->exp1 = (lserkEmbedded ? 0.25 : 0.2) - 0.75*cns->beta;
     cns->invfactor1 = 1.0/cns->factor1;
     cns->invfactor2 = 1.0/cns->factor2;
     cns->facold = 1E-4;
     
   }
 
+  if (mrab){
+    // face traces of local and halo elements at each element's current time
+    cns->fQM = (dfloat*) calloc((mesh->Nelements+mesh->totalHaloPairs)*mesh->Nfp*mesh->Nfaces*mesh->Nfields,
+                                sizeof(dfloat));
+    cns->fSM = (dfloat*) calloc((mesh->Nelements+mesh->totalHaloPairs)*mesh->Nfp*mesh->Nfaces*cns->Nstresses,
+                                sizeof(dfloat));
+
+    // AB weights of order 1,2,3 for a full (A) and half (B) step of each level
+    int Nlevels = mesh->MRABNlevels;
+    cns->MRAB_A = (dfloat*) calloc(3*3*Nlevels, sizeof(dfloat));
+    cns->MRAB_B = (dfloat*) calloc(3*3*Nlevels, sizeof(dfloat));
+
+    for(int l=0;l<Nlevels;++l){
+      dfloat h = mesh->dt*pow(2,l);
+      dfloat *A = cns->MRAB_A + l*3;
+      dfloat *B = cns->MRAB_B + l*3;
+
+      A[0] = h;
+      B[0] = h/2.;
+
+      A[3*Nlevels+0] =  3.*h/2.;  A[3*Nlevels+1] = -1.*h/2.;
+      B[3*Nlevels+0] =  5.*h/8.;  B[3*Nlevels+1] = -1.*h/8.;
+
+      A[6*Nlevels+0] = 23.*h/12.; A[6*Nlevels+1] = -16.*h/12.; A[6*Nlevels+2] = 5.*h/12.;
+      B[6*Nlevels+0] = 17.*h/24.; B[6*Nlevels+1] = - 7.*h/24.; B[6*Nlevels+2] = 2.*h/24.;
+    }
+  }
+
   cns->viscousStresses = (dfloat*) calloc((mesh->totalHaloPairs+mesh->Nelements)*mesh->Np*cns->Nstresses,
                                            sizeof(dfloat));
 
@@ -198,24 +297,13 @@ cns_t *cnsSetup(mesh_t *mesh, setupAide &options){
   mesh->Lambda2 = 0.5;
   
   // set time step
+  // sJ = L/2, J = A/2,   sJ/J = L/A = L/(0.5*h*L) = 2/h
+  // h = 0.5/(sJ/J), a quarter of the element length scale
+  dfloat *elementHmin = meshElementHmin(mesh, cns->elementType);
   dfloat hmin = 1e9;
-  for(dlong e=0;e<mesh->Nelements;++e){  
-
-    for(int f=0;f<mesh->Nfaces;++f){
-      dlong sid = mesh->Nsgeo*(mesh->Nfaces*e + f);
-      dfloat sJ   = mesh->sgeo[sid + SJID];
-      dfloat invJ = mesh->sgeo[sid + IJID];
-
-      if(invJ<0) printf("invJ = %g\n", invJ);
-      
-      // sJ = L/2, J = A/2,   sJ/J = L/A = L/(0.5*h*L) = 2/h
-      // h = 0.5/(sJ/J)
-      
-      dfloat hest = .5/(sJ*invJ);
-
-      hmin = mymin(hmin, hest);
-    }
-  }
+  for(dlong e=0;e<mesh->Nelements;++e)
+    hmin = mymin(hmin, .25*elementHmin[e]);
+  free(elementHmin);
 
   // need to change cfl and defn of dt
   dfloat cfl = 0.5; // depends on the stability region size
@@ -226,15 +314,18 @@ cns_t *cnsSetup(mesh_t *mesh, setupAide &options){
   dfloat dt = cfl*mymin(dtAdv, dtVisc);
   dt = cfl*dtAdv;
   
-  // MPI_Allreduce to get global minimum dt
-  MPI_Allreduce(&dt, &(mesh->dt), 1, MPI_DFLOAT, MPI_MIN, mesh->comm);
+  // MRAB already picked the finest level dt
+  if(!mrab){
+    // MPI_Allreduce to get global minimum dt
+    MPI_Allreduce(&dt, &(mesh->dt), 1, MPI_DFLOAT, MPI_MIN, mesh->comm);
   
-  //
-  options.getArgs("FINAL TIME", mesh->finalTime);
+    //
+    options.getArgs("FINAL TIME", mesh->finalTime);
 
-  mesh->NtimeSteps = mesh->finalTime/mesh->dt;
-  if (options.compareArgs("TIME INTEGRATOR","LSERK4")){
-    mesh->dt = mesh->finalTime/mesh->NtimeSteps;
+    mesh->NtimeSteps = mesh->finalTime/mesh->dt;
+    if (options.compareArgs("TIME INTEGRATOR","LSERK4")){
+      mesh->dt = mesh->finalTime/mesh->NtimeSteps;
+    }
   }
 
   if (mesh->rank ==0) printf("dtAdv = %lg (before cfl), dtVisc = %lg (before cfl), dt = %lg\n",
@@ -275,8 +366,10 @@ cns_t *cnsSetup(mesh_t *mesh, setupAide &options){
   cns->o_q =
     mesh->device.malloc(mesh->Np*(mesh->totalHaloPairs+mesh->Nelements)*mesh->Nfields*sizeof(dfloat), cns->q);
 
-  cns->o_saveq =
-    mesh->device.malloc(mesh->Np*(mesh->totalHaloPairs+mesh->Nelements)*mesh->Nfields*sizeof(dfloat), cns->q);
+  // dense output buffer, only DOPRI5 keeps the stages it needs
+  if (options.compareArgs("TIME INTEGRATOR","DOPRI5"))
+    cns->o_saveq =
+      mesh->device.malloc(mesh->Np*(mesh->totalHaloPairs+mesh->Nelements)*mesh->Nfields*sizeof(dfloat), cns->q);
 
   
   cns->o_viscousStresses =
@@ -284,12 +377,12 @@ cns_t *cnsSetup(mesh_t *mesh, setupAide &options){
                         cns->viscousStresses);
   
   cns->o_rhsq =
-    mesh->device.malloc(mesh->Np*mesh->Nelements*mesh->Nfields*sizeof(dfloat), cns->rhsq);
+    mesh->device.malloc(Nrhs*mesh->Np*mesh->Nelements*mesh->Nfields*sizeof(dfloat), cns->rhsq);
 
   if (mesh->rank==0)
     cout << "TIME INTEGRATOR (" << options.getArgs("TIME INTEGRATOR") << ")" << endl;
   
-  if (options.compareArgs("TIME INTEGRATOR","LSERK4")){
+  if (options.compareArgs("TIME INTEGRATOR","LSERK4") && !lserkEmbedded){
     cns->o_resq =
       mesh->device.malloc(mesh->Np*mesh->Nelements*mesh->Nfields*sizeof(dfloat), cns->resq);
   }
@@ -311,21 +404,55 @@ cns_t *cnsSetup(mesh_t *mesh, setupAide &options){
     cns->o_rkoutB = mesh->device.malloc(cns->Nrk*sizeof(dfloat), cns->rkoutB);
   }
 
+  if (lserkEmbedded){
+    cns->o_resq =
+      mesh->device.malloc(mesh->Np*mesh->Nelements*mesh->Nfields*sizeof(dfloat), cns->resq);
+    cns->o_rkq =
+      mesh->device.malloc(mesh->Np*(mesh->totalHaloPairs+mesh->Nelements)*mesh->Nfields*sizeof(dfloat), cns->rkq);
+    cns->o_rkerr =
+      mesh->device.malloc(mesh->Np*mesh->Nelements*mesh->Nfields*sizeof(dfloat), cns->rkerr);
+
+    cns->o_errtmp = mesh->device.malloc(cns->Nblock*sizeof(dfloat), cns->errtmp);
+  }
+
   
   cns->o_Vort = mesh->device.malloc(3*mesh->Np*mesh->Nelements*sizeof(dfloat), cns->Vort); // 3 components
+
+  if (mrab){
+    cns->o_fQM =
+      mesh->device.malloc((mesh->Nelements+mesh->totalHaloPairs)*mesh->Nfp*mesh->Nfaces*mesh->Nfields*sizeof(dfloat), cns->fQM);
+    cns->o_fSM =
+      mesh->device.malloc((mesh->Nelements+mesh->totalHaloPairs)*mesh->Nfp*mesh->Nfaces*cns->Nstresses*sizeof(dfloat), cns->fSM);
+    cns->o_extq =
+      mesh->device.malloc(mesh->Np*mesh->Nelements*mesh->Nfields*sizeof(dfloat), cns->q);
+
+    mesh->o_mapP = mesh->device.malloc(mesh->Nelements*mesh->Nfp*mesh->Nfaces*sizeof(dlong), mesh->mapP);
+
+    mesh->o_MRABelementIds = new occa::memory[mesh->MRABNlevels];
+    mesh->o_MRABhaloIds    = new occa::memory[mesh->MRABNlevels];
+    for (int lev=0;lev<mesh->MRABNlevels;lev++) {
+      if (mesh->MRABNelements[lev])
+        mesh->o_MRABelementIds[lev] = mesh->device.malloc(mesh->MRABNelements[lev]*sizeof(dlong), mesh->MRABelementIds[lev]);
+      if (mesh->MRABNhaloElements[lev])
+        mesh->o_MRABhaloIds[lev]    = mesh->device.malloc(mesh->MRABNhaloElements[lev]*sizeof(dlong), mesh->MRABhaloIds[lev]);
+    }
+  }
   
 
   if(mesh->totalHaloPairs>0){
+    // MRAB exchanges face traces instead of volume nodes
+    int NhaloNodes = mrab ? mesh->Nfp*mesh->Nfaces : mesh->Np;
+
     // temporary DEVICE buffer for halo (maximum size Nfields*Np for dfloat)
     mesh->o_haloBuffer =
-      mesh->device.malloc(mesh->totalHaloPairs*mesh->Np*mesh->Nfields*sizeof(dfloat));
+      mesh->device.malloc(mesh->totalHaloPairs*NhaloNodes*mesh->Nfields*sizeof(dfloat));
 
     cns->o_haloStressesBuffer =
-      mesh->device.malloc(mesh->totalHaloPairs*mesh->Np*cns->Nstresses*sizeof(dfloat));
+      mesh->device.malloc(mesh->totalHaloPairs*NhaloNodes*cns->Nstresses*sizeof(dfloat));
   
     // MPI send buffer
-    cns->haloBytes = mesh->totalHaloPairs*mesh->Np*cns->Nfields*sizeof(dfloat);
-    cns->haloStressesBytes = mesh->totalHaloPairs*mesh->Np*cns->Nstresses*sizeof(dfloat);
+    cns->haloBytes = mesh->totalHaloPairs*NhaloNodes*cns->Nfields*sizeof(dfloat);
+    cns->haloStressesBytes = mesh->totalHaloPairs*NhaloNodes*cns->Nstresses*sizeof(dfloat);
     
     cns->o_haloBuffer = mesh->device.malloc(cns->haloBytes);
     cns->o_haloStressesBuffer = mesh->device.malloc(cns->haloStressesBytes);
@@ -444,6 +571,16 @@ cns_t *cnsSetup(mesh_t *mesh, setupAide &options){
       
       cns->vorticityKernel = mesh->device.buildKernel(fileName, kernelName, kernelInfo);
 
+      if(cns->statSteps){
+        // 2D vorticity has a single (z) component
+        occa::properties kernelInfoS = kernelInfo;
+        kernelInfoS["defines/" "p_NVfields"]= cns->dim;
+        kernelInfoS["defines/" "p_NVort"]= (cns->dim==2) ? 1 : 3;
+
+        cns->statisticsKernel =
+          mesh->device.buildKernel(DCNS "/okl/cnsStatistics.okl", "cnsStatistics", kernelInfoS);
+      }
+
 
       // kernels from update file
       cns->updateKernel =
@@ -470,6 +607,11 @@ cns_t *cnsSetup(mesh_t *mesh, setupAide &options){
                                            "cnsErrorEstimate",
                                            kernelInfo);
 
+      cns->rkEmbeddedUpdateKernel =
+        mesh->device.buildKernel(DCNS "/okl/cnsUpdate.okl",
+                                           "cnsLserkEmbeddedUpdate",
+                                           kernelInfo);
+
       // fix this later
       mesh->haloExtractKernel =
         mesh->device.buildKernel(DHOLMES "/okl/meshHaloExtract3D.okl",
@@ -481,11 +623,59 @@ cns_t *cnsSetup(mesh_t *mesh, setupAide &options){
 	sprintf(fileName, DCNS "/okl/cnsConstrain%s.okl", suffix);
 	cns->constrainKernel =  mesh->device.buildKernel(fileName, kernelName, kernelInfo);
       }
+
+      if(mrab){
+        sprintf(fileName, DCNS "/okl/cnsVolume%s.okl", suffix);
+        sprintf(kernelName, "cnsMRVolume%s", suffix);
+        cns->mrVolumeKernel = mesh->device.buildKernel(fileName, kernelName, kernelInfo);
+
+        sprintf(kernelName, "cnsMRStressesVolume%s", suffix);
+        cns->mrStressesVolumeKernel = mesh->device.buildKernel(fileName, kernelName, kernelInfo);
+
+        sprintf(fileName, DCNS "/okl/cnsSurface%s.okl", suffix);
+        sprintf(kernelName, "cnsMRSurface%s", suffix);
+        cns->mrSurfaceKernel = mesh->device.buildKernel(fileName, kernelName, kernelInfo);
+
+        sprintf(kernelName, "cnsMRStressesSurface%s", suffix);
+        cns->mrStressesSurfaceKernel = mesh->device.buildKernel(fileName, kernelName, kernelInfo);
+
+        cns->mrabUpdateKernel =
+          mesh->device.buildKernel(DCNS "/okl/cnsUpdate.okl",
+                                             "cnsMRABUpdate",
+                                             kernelInfo);
+        cns->mrabTraceUpdateKernel =
+          mesh->device.buildKernel(DCNS "/okl/cnsUpdate.okl",
+                                             "cnsMRABTraceUpdate",
+                                             kernelInfo);
+        cns->mrabStressesTraceKernel =
+          mesh->device.buildKernel(DCNS "/okl/cnsUpdate.okl",
+                                             "cnsMRABStressesTrace",
+                                             kernelInfo);
+      }
     }
     MPI_Barrier(mesh->comm);
   }
 
   printf("done building kernels\n");
+
+  if(mrab){
+    // populate the face traces from the initial condition
+    dlong offset = mesh->Np*mesh->Nelements*mesh->Nfields;
+    for (int lev=0;lev<mesh->MRABNlevels;lev++)
+      if (mesh->MRABNelements[lev])
+        cns->mrabTraceUpdateKernel(mesh->MRABNelements[lev],
+                                   mesh->o_MRABelementIds[lev],
+                                   offset,
+                                   mesh->MRABshiftIndex[lev],
+                                   (dfloat) 0., (dfloat) 0., (dfloat) 0.,
+                                   mesh->o_vmapM,
+                                   cns->o_q,
+                                   cns->o_rhsq,
+                                   cns->o_fQM,
+                                   cns->o_extq);
+  }
+
+  cnsStatisticsSetup(cns, options);
   
   return cns;
 }
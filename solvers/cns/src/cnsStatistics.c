@@ -0,0 +1,155 @@
+/*
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Tim Warburton, Noel Chalmers, Jesse Chan, Ali Karakus
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "cns.h"
+
+// device buffers of the running statistics, zero until the first sample. Each
+// buffer is stored per element as blocks of Np like q
+void cnsStatisticsSetup(cns_t *cns, setupAide &options){
+
+  mesh_t *mesh = cns->mesh;
+  if(!cns->statSteps) return;
+
+  cns->statMoments = 2;
+  options.getArgs("STATISTICS MOMENTS", cns->statMoments);
+
+  cns->statStartTime = 0;
+  options.getArgs("STATISTICS START TIME", cns->statStartTime);
+
+  // velocity, pressure and vorticity (one component in 2D); co-moments uv[, uw, vw]
+  const int NVort  = (cns->dim==2) ? 1 : 3;
+  cns->NstatFields = cns->dim+1+NVort;
+  cns->NstatUU     = cns->dim*(cns->dim-1)/2;
+  cns->statCount   = 0;
+
+  dlong Nstat = mesh->Nelements*mesh->Np*cns->NstatFields;
+  dlong NUU   = mesh->Nelements*mesh->Np*cns->NstatUU;
+
+  cns->statMean = (dfloat*) calloc(Nstat, sizeof(dfloat));
+  cns->o_statMean = mesh->device.malloc(Nstat*sizeof(dfloat), cns->statMean);
+  if(cns->statMoments>1){
+    cns->statM2 = (dfloat*) calloc(Nstat, sizeof(dfloat));
+    cns->statUU = (dfloat*) calloc(NUU, sizeof(dfloat));
+    cns->o_statM2 = mesh->device.malloc(Nstat*sizeof(dfloat), cns->statM2);
+    cns->o_statUU = mesh->device.malloc(NUU*sizeof(dfloat), cns->statUU);
+  }else{
+    cns->o_statM2 = cns->o_statMean;
+    cns->o_statUU = cns->o_statMean;
+  }
+
+  if(mesh->rank==0)
+    printf("Statistics: moments up to order %d every %d steps from t = %g\n",
+           cns->statMoments, cns->statSteps, cns->statStartTime);
+}
+
+// add the current velocity, pressure and vorticity to the running statistics
+void cnsStatistics(cns_t *cns, dfloat time){
+
+  mesh_t *mesh = cns->mesh;
+  if(time<cns->statStartTime) return;
+
+  cns->vorticityKernel(mesh->Nelements,
+                       mesh->o_vgeo,
+                       mesh->o_Dmatrices,
+                       cns->o_q,
+                       cns->o_Vort);
+
+  cns->statCount++;
+
+  cns->statisticsKernel(mesh->Nelements,
+                        1.0/cns->statCount,
+                        (int) (cns->statMoments>1),
+                        cns->o_q,
+                        cns->o_Vort,
+                        cns->o_statMean,
+                        cns->o_statM2,
+                        cns->o_statUU);
+}
+
+// stage the raw statistics on the host for output
+void cnsStatisticsCopyToHost(cns_t *cns){
+
+  mesh_t *mesh = cns->mesh;
+
+  cns->o_statMean.copyTo(cns->statMean, mesh->Nelements*mesh->Np*cns->NstatFields*sizeof(dfloat));
+
+  if(cns->statMoments>1){
+    cns->o_statM2.copyTo(cns->statM2, mesh->Nelements*mesh->Np*cns->NstatFields*sizeof(dfloat));
+    cns->o_statUU.copyTo(cns->statUU, mesh->Nelements*mesh->Np*cns->NstatUU*sizeof(dfloat));
+  }
+}
+
+// write Ncomp fields, starting at field offset of a buffer holding Nstride
+// fields per element, to the plot nodes. Values are scaled by scale and
+// optionally square rooted per node before interpolation
+static void cnsStatisticsPlotField(cns_t *cns, FILE *fp, const char *name, int Ncomp,
+                                   dfloat *q, int Nstride, int offset, dfloat scale, int root){
+
+  mesh_t *mesh = cns->mesh;
+
+  if(Ncomp==1)
+    fprintf(fp, "        <DataArray type=\"Float32\" Name=\"%s\" Format=\"ascii\">\n", name);
+  else
+    fprintf(fp, "        <DataArray type=\"Float32\" Name=\"%s\" NumberOfComponents=\"%d\" Format=\"ascii\">\n", name, Ncomp);
+
+  for(dlong e=0;e<mesh->Nelements;++e){
+    for(int n=0;n<mesh->plotNp;++n){
+      fprintf(fp, "       ");
+      for(int c=0;c<Ncomp;++c){
+        dfloat plotq = 0;
+        for(int m=0;m<mesh->Np;++m){
+          dfloat qm = scale*q[e*Nstride*mesh->Np+(offset+c)*mesh->Np+m];
+          if(root) qm = sqrt(mymax(qm, 0.));
+          plotq += mesh->plotInterp[n*mesh->Np+m]*qm;
+        }
+        fprintf(fp, "%g ", plotq);
+      }
+      fprintf(fp, "\n");
+    }
+  }
+  fprintf(fp, "       </DataArray>\n");
+}
+
+// append the statistics to the point data of an open VTU piece
+void cnsStatisticsPlotVTU(cns_t *cns, FILE *fp){
+
+  if(!cns->statCount) return;
+
+  const dfloat invCount = 1.0/cns->statCount;
+  const int NVort = cns->NstatFields-cns->dim-1;
+  const int Nstat = cns->NstatFields;
+
+  cnsStatisticsPlotField(cns, fp, "MeanVelocity",  cns->dim, cns->statMean, Nstat, 0,          1.0, 0);
+  cnsStatisticsPlotField(cns, fp, "MeanPressure",  1,        cns->statMean, Nstat, cns->dim,   1.0, 0);
+  cnsStatisticsPlotField(cns, fp, "MeanVorticity", NVort,    cns->statMean, Nstat, cns->dim+1, 1.0, 0);
+
+  if(cns->statMoments>1){
+    cnsStatisticsPlotField(cns, fp, "RMSVelocity",    cns->dim,     cns->statM2, Nstat,        0,          invCount, 1);
+    cnsStatisticsPlotField(cns, fp, "RMSPressure",    1,            cns->statM2, Nstat,        cns->dim,   invCount, 1);
+    cnsStatisticsPlotField(cns, fp, "RMSVorticity",   NVort,        cns->statM2, Nstat,        cns->dim+1, invCount, 1);
+    cnsStatisticsPlotField(cns, fp, "ReynoldsStress", cns->NstatUU, cns->statUU, cns->NstatUU, 0,          invCount, 0);
+  }
+}
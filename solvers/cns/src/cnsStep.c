@@ -31,6 +31,12 @@ SOFTWARE.
 void cnsDopriStep(cns_t *cns, setupAide &newOptions, const dfloat time){
 
   mesh_t *mesh = cns->mesh;
+
+  // LSERK43 advances rkq in place through the 2N LSERK4 stages
+  int lserkEmbedded = newOptions.compareArgs("TIME INTEGRATOR","LSERK43");
+
+  if(lserkEmbedded)
+    cns->o_rkq.copyFrom(cns->o_q, mesh->Nelements*mesh->Np*cns->Nfields*sizeof(dfloat));
   
   //RK step
   for(int rk=0;rk<cns->Nrk;++rk){
@@ -39,20 +45,21 @@ void cnsDopriStep(cns_t *cns, setupAide &newOptions, const dfloat time){
     mesh->device.setStream(mesh->defaultStream);
     
     // t_rk = t + C_rk*dt
-    dfloat currentTime = time + cns->rkC[rk]*mesh->dt;
+    dfloat currentTime = time + (lserkEmbedded ? mesh->rkc[rk] : cns->rkC[rk])*mesh->dt;
 
     dfloat fx, fy, fz, intfx, intfy, intfz;
     cnsBodyForce(currentTime , &fx, &fy, &fz, &intfx, &intfy, &intfz);
 
     //compute RK stage 
     // rkq = q + dt sum_{i=0}^{rk-1} a_{rk,i}*rhsq_i
-    cns->rkStageKernel(mesh->Nelements,
-                       rk,
-                       mesh->dt,
-                       cns->o_rkA,
-                       cns->o_q,
-                       cns->o_rkrhsq,
-                       cns->o_rkq);
+    if(!lserkEmbedded)
+      cns->rkStageKernel(mesh->Nelements,
+                         rk,
+                         mesh->dt,
+                         cns->o_rkA,
+                         cns->o_q,
+                         cns->o_rkrhsq,
+                         cns->o_rkq);
     
     //compute RHS
     // rhsq = F(currentTIme, rkq)
@@ -269,6 +276,22 @@ void cnsDopriStep(cns_t *cns, setupAide &newOptions, const dfloat time){
     if(cns->elementType==QUADRILATERALS && mesh->dim==3){
       cns->constrainKernel(mesh->Nelements, mesh->o_x, mesh->o_y, mesh->o_z, cns->o_rhsq);
     }
+    if(lserkEmbedded){
+      // resq = rka_rk*resq + dt*rhsq, rkq += rkb_rk*resq
+      // rkerr = dt*sum_{i=0}^{rk} rkE_i*rhsq_i
+      cns->rkEmbeddedUpdateKernel(mesh->Nelements,
+                                  rk,
+                                  mesh->dt,
+                                  mesh->rka[rk],
+                                  mesh->rkb[rk],
+                                  cns->rkE[rk],
+                                  cns->o_rhsq,
+                                  cns->o_resq,
+                                  cns->o_rkerr,
+                                  cns->o_rkq);
+      continue;
+    }
+
     // update solution using Runge-Kutta
     // rkrhsq_rk = rhsq
     // if rk==6 
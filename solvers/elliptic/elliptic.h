@@ -50,6 +50,7 @@ typedef struct {
   precon_t *precon;
 
   ogs_t *ogs;
+  ogsHandle_t *ogsAddHandle;  // resolved dfloat add gather-scatter on ogs
 
   setupAide options;
 
@@ -115,6 +116,18 @@ typedef struct {
   occa::kernel partialAxKernel;
   occa::kernel partialFloatAxKernel;
   occa::kernel partialCubatureAxKernel;
+
+  // assembled continuous operator ([ELLIPTIC OPERATOR] ASSEMBLED)
+  int assembled;
+  dlong NassembledGather;
+  dlong *gatherMap;
+  occa::memory o_gatherMap;
+  occa::memory o_GAq;
+  occa::kernel partialAssembledAxKernel;
+  occa::kernel assembledZeroKernel;
+  occa::kernel assembledScatterKernel;
+  occa::kernel assembledWeightedInnerProductKernel;
+  occa::kernel assembledUpdatePCGKernel;
   
   occa::kernel rhsBCKernel;
   occa::kernel addBCKernel;
@@ -168,6 +181,14 @@ dfloat ellipticCascadingWeightedInnerProduct(elliptic_t *elliptic, occa::memory
 
 void ellipticOperator(elliptic_t *elliptic, dfloat lambda, occa::memory &o_q, occa::memory &o_Aq, const char *precision);
 
+void ellipticAssembledSetup(elliptic_t *elliptic, occa::properties &kernelInfo);
+void ellipticAssembledOperator(elliptic_t *elliptic, dfloat lambda, occa::memory &o_q, occa::memory &o_Aq);
+dfloat ellipticAssembledGather(elliptic_t *elliptic, dfloat lambda, occa::memory &o_q);
+dfloat ellipticAssembledWeightedInnerProduct(elliptic_t *elliptic, dfloat shift, occa::memory &o_w, occa::memory &o_a);
+dfloat ellipticAssembledUpdatePCG(elliptic_t *elliptic, dfloat shift,
+                                  occa::memory &o_p, dfloat alpha,
+                                  occa::memory &o_x, occa::memory &o_r);
+
 dfloat ellipticWeightedNorm2(elliptic_t *elliptic, occa::memory &o_w, occa::memory &o_a);
 void ellipticBuildIpdg(elliptic_t* elliptic, int basisNp, dfloat *basis, dfloat lambda,
                         nonZero_t **A, dlong *nnzA, hlong *globalStarts);
@@ -53,6 +53,13 @@ int pcg(elliptic_t* elliptic, dfloat lambda,
   occa::memory &o_Ap = elliptic->o_Ap;
   occa::memory &o_Ax = elliptic->o_Ax;
 
+  // with the assembled operator A*p stays gathered and the scatter is folded into
+  // the p.Ap reduction and the update. Flexible PCG still needs Ap for z.Ap
+  int fusedScatter = elliptic->assembled &&
+    !(options.compareArgs("KRYLOV SOLVER", "PCG+FLEXIBLE") ||
+      options.compareArgs("KRYLOV SOLVER", "PCG,FLEXIBLE"));
+  dfloat shiftAp = 0;
+
 
   /*compute norm b, set the tolerance */
 #if 0
@@ -102,14 +109,20 @@ int pcg(elliptic_t* elliptic, dfloat lambda,
 
     // [
     // A*p
-    ellipticOperator(elliptic, lambda, o_p, o_Ap, dfloatString);
+    if(fusedScatter)
+      shiftAp = ellipticAssembledGather(elliptic, lambda, o_p);
+    else
+      ellipticOperator(elliptic, lambda, o_p, o_Ap, dfloatString);
     
     // dot(p,A*p)
     if(DEBUG_ENABLE_REDUCTIONS==1){
 #if 0
       pAp =  ellipticCascadingWeightedInnerProduct(elliptic, elliptic->o_invDegree, o_p, o_Ap);
 #else
-      pAp =  ellipticWeightedInnerProduct(elliptic, elliptic->o_invDegree, o_p, o_Ap);
+      if(fusedScatter)
+        pAp =  ellipticAssembledWeightedInnerProduct(elliptic, shiftAp, elliptic->o_invDegree, o_p);
+      else
+        pAp =  ellipticWeightedInnerProduct(elliptic, elliptic->o_invDegree, o_p, o_Ap);
 #endif
     }
     else
@@ -124,7 +137,10 @@ int pcg(elliptic_t* elliptic, dfloat lambda,
     //  r <= r - alpha*A*p
     //  dot(r,r)
     //
-    rdotr1 = ellipticUpdatePCG(elliptic, o_p, o_Ap, alpha, o_x, o_r);
+    if(fusedScatter)
+      rdotr1 = ellipticAssembledUpdatePCG(elliptic, shiftAp, o_p, alpha, o_x, o_r);
+    else
+      rdotr1 = ellipticUpdatePCG(elliptic, o_p, o_Ap, alpha, o_x, o_r);
     
     if (options.compareArgs("VERBOSE", "TRUE")&&(mesh->rank==0)) 
       printf("CG: it %d r norm %12.12f alpha = %f \n",Niter, sqrt(rdotr1), alpha);
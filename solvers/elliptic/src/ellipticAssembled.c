@@ -0,0 +1,205 @@
+/*
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Tim Warburton, Noel Chalmers, Jesse Chan, Ali Karakus
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "elliptic.h"
+
+// Assembled continuous operator: the element Ax kernel accumulates straight into
+// the gathered nodes of the ogs ordering (local gather nodes first, then halo gather
+// nodes), so the E-vector written by partialAx and re-read by the gather-scatter
+// is replaced by one scatter from the gathered vector. PCG skips that scatter too
+// and reads A*p from the gathered vector in its p.Ap reduction and update.
+void ellipticAssembledSetup(elliptic_t *elliptic, occa::properties &kernelInfo){
+
+  mesh_t *mesh = elliptic->mesh;
+  setupAide &options = elliptic->options;
+
+  elliptic->assembled = 0;
+
+  if (!options.compareArgs("ELLIPTIC OPERATOR", "ASSEMBLED")) return;
+
+  if (!options.compareArgs("DISCRETIZATION", "CONTINUOUS") ||
+      elliptic->elementType!=HEXAHEDRA ||
+      options.compareArgs("ELEMENT MAP", "TRILINEAR") ||
+      options.compareArgs("ELLIPTIC INTEGRATION", "CUBATURE")) {
+    if (mesh->rank==0)
+      printf("WARNING: ASSEMBLED elliptic operator is only available for continuous affine hexes with GLL integration, using the unassembled operator\n");
+    return;
+  }
+
+  ogs_t *ogs = elliptic->ogs;
+
+  elliptic->assembled = 1;
+  elliptic->NassembledGather = ogs->NlocalGather + ogs->NhaloGather;
+
+  // map each local node to its gathered node, masked nodes are -1
+  elliptic->gatherMap = (dlong*) malloc((ogs->N+1)*sizeof(dlong));
+  for (dlong n=0;n<ogs->N;n++) elliptic->gatherMap[n] = -1;
+
+  for (dlong g=0;g<ogs->NlocalGather;g++)
+    for (dlong j=ogs->localGatherOffsets[g];j<ogs->localGatherOffsets[g+1];j++)
+      elliptic->gatherMap[ogs->localGatherIds[j]] = g;
+
+  for (dlong g=0;g<ogs->NhaloGather;g++)
+    for (dlong j=ogs->haloGatherOffsets[g];j<ogs->haloGatherOffsets[g+1];j++)
+      elliptic->gatherMap[ogs->haloGatherIds[j]] = ogs->NlocalGather + g;
+
+  elliptic->o_gatherMap = mesh->device.malloc((ogs->N+1)*sizeof(dlong), elliptic->gatherMap);
+  elliptic->o_GAq = mesh->device.malloc((elliptic->NassembledGather+1)*sizeof(dfloat));
+
+  char fileName[BUFSIZ], kernelName[BUFSIZ];
+  sprintf(fileName,  DELLIPTIC "/okl/ellipticAxHex3D.okl");
+  sprintf(kernelName, "ellipticPartialAssembledAxHex3D");
+  elliptic->partialAssembledAxKernel = mesh->device.buildKernel(fileName,kernelName,kernelInfo);
+
+  elliptic->assembledZeroKernel =
+    mesh->device.buildKernel(DELLIPTIC "/okl/ellipticAssembled.okl", "ellipticAssembledZero", kernelInfo);
+  elliptic->assembledScatterKernel =
+    mesh->device.buildKernel(DELLIPTIC "/okl/ellipticAssembled.okl", "ellipticAssembledScatter", kernelInfo);
+}
+
+// accumulate A*q into o_GAq. Returns the constant the all-Neumann penalty adds
+// to every node of A*q (zero otherwise)
+dfloat ellipticAssembledGather(elliptic_t *elliptic, dfloat lambda, occa::memory &o_q){
+
+  mesh_t *mesh = elliptic->mesh;
+  ogs_t *ogs = elliptic->ogs;
+
+  dfloat alpha = 0., alphaG = 0.;
+  dlong Nblock = elliptic->Nblock;
+  dfloat *tmp = elliptic->tmp;
+  occa::memory &o_tmp = elliptic->o_tmp;
+
+  // halo gather nodes sit after the local gather nodes
+  occa::memory o_GAqHalo;
+  if(ogs->NhaloGather)
+    o_GAqHalo = elliptic->o_GAq + ogs->NlocalGather*sizeof(dfloat);
+
+  elliptic->assembledZeroKernel(elliptic->NassembledGather, elliptic->o_GAq);
+
+  if(mesh->NglobalGatherElements)
+    elliptic->partialAssembledAxKernel(mesh->NglobalGatherElements, mesh->o_globalGatherElementList, elliptic->o_gatherMap,
+                                       mesh->o_ggeo, mesh->o_Dmatrices, mesh->o_Smatrices, mesh->o_MM, lambda, o_q, elliptic->o_GAq);
+
+  // the halo gather nodes are complete once the global gather elements are done
+  if(ogs->NhaloGather)
+    ogsHaloExchangeStart(o_GAqHalo, elliptic->ogsAddHandle);
+
+  if(mesh->NlocalGatherElements)
+    elliptic->partialAssembledAxKernel(mesh->NlocalGatherElements, mesh->o_localGatherElementList, elliptic->o_gatherMap,
+                                       mesh->o_ggeo, mesh->o_Dmatrices, mesh->o_Smatrices, mesh->o_MM, lambda, o_q, elliptic->o_GAq);
+
+  if(ogs->NhaloGather)
+    ogsHaloExchangeFinish(o_GAqHalo, elliptic->ogsAddHandle);
+
+  if(elliptic->allNeumann) {
+    elliptic->innerProductKernel(mesh->Nelements*mesh->Np, elliptic->o_invDegree, o_q, o_tmp);
+    o_tmp.copyTo(tmp);
+
+    for(dlong n=0;n<Nblock;++n)
+      alpha += tmp[n];
+
+    MPI_Allreduce(&alpha, &alphaG, 1, MPI_DFLOAT, MPI_SUM, mesh->comm);
+    alphaG *= elliptic->allNeumannPenalty*elliptic->allNeumannScale*elliptic->allNeumannScale;
+  }
+
+  return alphaG;
+}
+
+void ellipticAssembledOperator(elliptic_t *elliptic, dfloat lambda, occa::memory &o_q, occa::memory &o_Aq){
+
+  mesh_t *mesh = elliptic->mesh;
+  ogs_t *ogs = elliptic->ogs;
+
+  dfloat shift = ellipticAssembledGather(elliptic, lambda, o_q);
+
+  // scatter back to local nodes, masked nodes are zeroed here
+  elliptic->assembledScatterKernel(ogs->N, elliptic->o_gatherMap, elliptic->o_GAq, o_Aq);
+
+  if(elliptic->allNeumann)
+    mesh->addScalarKernel(mesh->Nelements*mesh->Np, shift, o_Aq);
+}
+
+// w.(a.*Aq) with Aq = o_GAq + shift read through the gather map
+dfloat ellipticAssembledWeightedInnerProduct(elliptic_t *elliptic, dfloat shift, occa::memory &o_w, occa::memory &o_a){
+
+  mesh_t *mesh = elliptic->mesh;
+  dfloat *tmp = elliptic->tmp;
+  dlong Nblock = elliptic->Nblock;
+  dlong Nblock2 = elliptic->Nblock2;
+  dlong Ntotal = mesh->Nelements*mesh->Np;
+
+  occa::memory &o_tmp = elliptic->o_tmp;
+  occa::memory &o_tmp2 = elliptic->o_tmp2;
+
+  elliptic->assembledWeightedInnerProductKernel(Ntotal, elliptic->o_gatherMap, shift, o_w, o_a, elliptic->o_GAq, o_tmp);
+
+  /* add a second sweep if Nblock>Ncutoff */
+  dlong Ncutoff = 100;
+  dlong Nfinal;
+  if(Nblock>Ncutoff){
+    mesh->sumKernel(Nblock, o_tmp, o_tmp2);
+    o_tmp2.copyTo(tmp);
+    Nfinal = Nblock2;
+  }
+  else{
+    o_tmp.copyTo(tmp);
+    Nfinal = Nblock;
+  }
+
+  dfloat wab = 0;
+  for(dlong n=0;n<Nfinal;++n){
+    wab += tmp[n];
+  }
+
+  dfloat globalwab = 0;
+  MPI_Allreduce(&wab, &globalwab, 1, MPI_DFLOAT, MPI_SUM, mesh->comm);
+
+  return globalwab;
+}
+
+// x <= x + alpha*p, r <= r - alpha*A*p and dot(r,r), with A*p read from o_GAq
+dfloat ellipticAssembledUpdatePCG(elliptic_t *elliptic, dfloat shift,
+                                  occa::memory &o_p, dfloat alpha,
+                                  occa::memory &o_x, occa::memory &o_r){
+
+  mesh_t *mesh = elliptic->mesh;
+
+  elliptic->assembledUpdatePCGKernel(mesh->Nelements*mesh->Np, elliptic->NblocksUpdatePCG,
+                                     elliptic->o_invDegree, elliptic->o_gatherMap, shift, elliptic->o_GAq,
+                                     o_p, alpha, o_x, o_r, elliptic->o_tmpNormr);
+
+  elliptic->o_tmpNormr.copyTo(elliptic->tmpNormr);
+
+  dfloat rdotr1 = 0;
+  for(int n=0;n<elliptic->NblocksUpdatePCG;++n){
+    rdotr1 += elliptic->tmpNormr[n];
+  }
+
+  dfloat globalrdotr1 = 0;
+  MPI_Allreduce(&rdotr1, &globalrdotr1, 1, MPI_DFLOAT, MPI_SUM, mesh->comm);
+
+  return globalrdotr1;
+}
@@ -741,6 +741,7 @@ elliptic_t *ellipticBuildMultigridLevel(elliptic_t *baseElliptic, int Nc, int Nf
 
   //use the masked ids to make another gs handle
   elliptic->ogs = ogsSetup(Ntotal, mesh->maskedGlobalIds, mesh->comm, verbose, mesh->device);
+  elliptic->ogsAddHandle = ogsHandleSetup(ogsDfloat, ogsAdd, elliptic->ogs);
   elliptic->o_invDegree = elliptic->ogs->o_invDegree;
 
 
@@ -928,6 +929,9 @@ elliptic_t *ellipticBuildMultigridLevel(elliptic_t *baseElliptic, int Nc, int Nf
 
       elliptic->partialFloatAxKernel = mesh->device.buildKernel(fileName,kernelName,floatKernelInfo);
 
+      // optional assembled continuous operator
+      ellipticAssembledSetup(elliptic, dfloatKernelInfo);
+
       // only for Hex3D - cubature Ax
       if(elliptic->elementType==HEXAHEDRA){
 	printf("BUILDING partialCubatureAxKernel\n");
@@ -46,7 +46,7 @@ void MGLevel::coarsen(occa::memory o_x, occa::memory o_Rx) {
   elliptic->precon->coarsenKernel(mesh->Nelements, o_R, o_x, o_Rx);
 
   if (options.compareArgs("DISCRETIZATION","CONTINUOUS")) {
-    ogsGatherScatter(o_Rx, ogsDfloat, ogsAdd, elliptic->ogs);
+    ogsGatherScatter(o_Rx, elliptic->ogsAddHandle);
     if (elliptic->Nmasked) mesh->maskKernel(elliptic->Nmasked, elliptic->o_maskIds, o_Rx);
   }
 }
@@ -45,8 +45,11 @@ void ellipticOperator(elliptic_t *elliptic, dfloat lambda, occa::memory &o_q, oc
   options.getArgs("DEBUG ENABLE OGS", DEBUG_ENABLE_OGS);
 
 
-  if(options.compareArgs("DISCRETIZATION", "CONTINUOUS")){
-    ogs_t *ogs = elliptic->ogs;
+  if(options.compareArgs("DISCRETIZATION", "CONTINUOUS") &&
+     elliptic->assembled && !strcmp(precision, dfloatString)){
+    ellipticAssembledOperator(elliptic, lambda, o_q, o_Aq);
+
+  } else if(options.compareArgs("DISCRETIZATION", "CONTINUOUS")){
 
 #if 1
     int mapType = (elliptic->elementType==HEXAHEDRA &&
@@ -81,7 +84,7 @@ void ellipticOperator(elliptic_t *elliptic, dfloat lambda, occa::memory &o_q, oc
     elliptic->AxKernel(mesh->Nelements, mesh->o_ggeo, mesh->o_Dmatrices, mesh->o_Smatrices, mesh->o_MM, lambda, o_q, o_Aq);
 #endif
     if(DEBUG_ENABLE_OGS==1)
-      ogsGatherScatterStart(o_Aq, ogsDfloat, ogsAdd, ogs);
+      ogsGatherScatterStart(o_Aq, elliptic->ogsAddHandle);
 
 #if 1
     if(mesh->NlocalGatherElements){
@@ -109,7 +112,7 @@ void ellipticOperator(elliptic_t *elliptic, dfloat lambda, occa::memory &o_q, oc
 
     // finalize gather using local and global contributions
     if(DEBUG_ENABLE_OGS==1)
-      ogsGatherScatterFinish(o_Aq, ogsDfloat, ogsAdd, ogs);
+      ogsGatherScatterFinish(o_Aq, elliptic->ogsAddHandle);
 
     if(elliptic->allNeumann) {
       // mesh->sumKernel(mesh->Nelements*mesh->Np, o_q, o_tmp);
@@ -66,14 +66,14 @@ void ellipticPreconditioner(elliptic_t *elliptic, dfloat lambda,
                                 mesh->o_globalGatherElementList,
                                 invLambda, mesh->o_vgeo, precon->o_invMM, elliptic->o_rtmp, o_z);
 
-      ogsGatherScatterStart(o_z, ogsDfloat, ogsAdd, ogs);
+      ogsGatherScatterStart(o_z, elliptic->ogsAddHandle);
 
       if(mesh->NlocalGatherElements)
         precon->partialblockJacobiKernel(mesh->NlocalGatherElements,
                                 mesh->o_localGatherElementList,
                                 invLambda, mesh->o_vgeo, precon->o_invMM, elliptic->o_rtmp, o_z);
 
-      ogsGatherScatterFinish(o_z, ogsDfloat, ogsAdd, ogs);
+      ogsGatherScatterFinish(o_z, elliptic->ogsAddHandle);
 
       elliptic->dotMultiplyKernel(mesh->Nelements*mesh->Np, ogs->o_invDegree, o_z, o_z);
 
@@ -74,13 +74,22 @@ void ellipticSolveSetup(elliptic_t *elliptic, dfloat lambda, occa::properties &k
   else
     elliptic->tau = 2.0*(mesh->N+1)*(mesh->N+3);
 
-  elliptic->p   = (dfloat*) calloc(Nall,   sizeof(dfloat));
-  elliptic->z   = (dfloat*) calloc(Nall,   sizeof(dfloat));
-  elliptic->Ax  = (dfloat*) calloc(Nall,   sizeof(dfloat));
-  elliptic->Ap  = (dfloat*) calloc(Nall,   sizeof(dfloat));
   elliptic->tmp = (dfloat*) calloc(Nblock, sizeof(dfloat));
 
-  elliptic->grad = (dfloat*) calloc(Nall*4, sizeof(dfloat));
+  // the Krylov vectors are never read on the host; with HOST SHADOWS = NONE
+  // they are zeroed from one scratch buffer that is released after setup
+  dfloat *zeros = NULL;
+  if(options.compareArgs("HOST SHADOWS", "NONE")){
+    zeros = (dfloat*) calloc(Nall*4, sizeof(dfloat));
+    elliptic->p  = elliptic->z = elliptic->Ax = elliptic->Ap = zeros;
+    elliptic->grad = zeros;
+  }else{
+    elliptic->p   = (dfloat*) calloc(Nall,   sizeof(dfloat));
+    elliptic->z   = (dfloat*) calloc(Nall,   sizeof(dfloat));
+    elliptic->Ax  = (dfloat*) calloc(Nall,   sizeof(dfloat));
+    elliptic->Ap  = (dfloat*) calloc(Nall,   sizeof(dfloat));
+    elliptic->grad = (dfloat*) calloc(Nall*4, sizeof(dfloat));
+  }
 
   elliptic->o_p   = mesh->device.malloc(Nall*sizeof(dfloat), elliptic->p);
   elliptic->o_rtmp= mesh->device.malloc(Nall*sizeof(dfloat), elliptic->p);
@@ -99,6 +108,16 @@ void ellipticSolveSetup(elliptic_t *elliptic, dfloat lambda, occa::properties &k
   
   elliptic->o_grad  = mesh->device.malloc(Nall*4*sizeof(dfloat), elliptic->grad);
 
+  if(zeros){
+    free(zeros);
+    elliptic->p  = elliptic->z = elliptic->Ax = elliptic->Ap = NULL;
+    elliptic->grad = NULL;
+
+    dfloat savedL = 8.*Nall*sizeof(dfloat)/(1024.*1024.), saved = 0;
+    MPI_Allreduce(&savedL, &saved, 1, MPI_DFLOAT, MPI_SUM, mesh->comm);
+    if(mesh->rank==0) printf("HOST SHADOWS = NONE: %g MB of elliptic host vectors not allocated\n", saved);
+  }
+
   //setup async halo stream
   elliptic->defaultStream = mesh->defaultStream;
   elliptic->dataStream = mesh->dataStream;
@@ -274,6 +293,7 @@ void ellipticSolveSetup(elliptic_t *elliptic, dfloat lambda, occa::properties &k
 
   //use the masked ids to make another gs handle
   elliptic->ogs = ogsSetup(Ntotal, mesh->maskedGlobalIds, mesh->comm, verbose, mesh->device);
+  elliptic->ogsAddHandle = ogsHandleSetup(ogsDfloat, ogsAdd, elliptic->ogs);
   elliptic->o_invDegree = elliptic->ogs->o_invDegree;
 
   /*preconditioner setup */
@@ -460,6 +480,9 @@ void ellipticSolveSetup(elliptic_t *elliptic, dfloat lambda, occa::properties &k
 
       elliptic->partialAxKernel = mesh->device.buildKernel(fileName,kernelName,dfloatKernelInfo);
       elliptic->partialFloatAxKernel = mesh->device.buildKernel(fileName,kernelName,floatKernelInfo);
+
+      // optional assembled continuous operator
+      ellipticAssembledSetup(elliptic, dfloatKernelInfo);
       
       // only for Hex3D - cubature Ax
       if(elliptic->elementType==HEXAHEDRA){
@@ -476,6 +499,16 @@ void ellipticSolveSetup(elliptic_t *elliptic, dfloat lambda, occa::properties &k
 	mesh->device.buildKernel(DELLIPTIC "/okl/ellipticUpdatePCG.okl",
 				 "ellipticUpdatePCG", dfloatKernelInfo);
 
+      // PCG consumers that read A*p straight from the assembled vector
+      if(elliptic->assembled){
+        elliptic->assembledWeightedInnerProductKernel =
+          mesh->device.buildKernel(DELLIPTIC "/okl/ellipticAssembled.okl",
+                                   "ellipticAssembledWeightedInnerProduct", dfloatKernelInfo);
+        elliptic->assembledUpdatePCGKernel =
+          mesh->device.buildKernel(DELLIPTIC "/okl/ellipticUpdatePCG.okl",
+                                   "ellipticAssembledUpdatePCG", dfloatKernelInfo);
+      }
+
       
       // Not implemented for Quad3D !!!!!
       if (options.compareArgs("BASIS","BERN")) {
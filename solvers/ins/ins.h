@@ -56,6 +56,8 @@ typedef struct {
   int Nblock;
 
   dfloat dt, cfl, dti;          // time step
+  int NcflBlock;                // element blocks in the device CFL reduction
+  dfloat *cflBlockMax;
   dfloat dtMIN;         
   dfloat time;
   int tstep, frame;
@@ -69,6 +71,25 @@ typedef struct {
   int   Nstages;     
   int   outputStep;
   int   outputForceStep; 
+
+  // boundary force integration over the FORCE BOUNDARY TAG faces
+  int forceTag;
+  dlong NforceNodes;
+  int NforceBlock;
+  dfloat *forceBlock;
+  int forceBufferSize, NforceBuffered;
+  dfloat *forceBuffer;
+  occa::memory o_forceIds, o_forceGeo, o_forceBlock;
+
+  // point probes of velocity and pressure, sampled every step
+  int probeFlag;
+
+  // running means and second moments of U, P and vorticity (Welford)
+  int statSteps, statMoments;
+  int NstatFields, NstatUU;
+  dlong statCount;
+  dfloat statStartTime;
+  dfloat *statMean, *statM2, *statUU;
   int   dtAdaptStep; 
 
 
@@ -104,9 +125,18 @@ typedef struct {
   dfloat *erkE, *irkE, *prkE;
   int embeddedRKFlag;
 
+  // embedded error control for ARK
+  dfloat ATOL, RTOL;
+  dfloat *errtmp;
+  int atstep, rtstep; // attempted and rejected steps
+
   //EXTBDF data
   dfloat *extbdfA, *extbdfB, *extbdfC;
   dfloat *extC;
+  int historyHead; // slot of the newest level in the U, P, NU and GP history
+
+  int hostShadows;        // 0 when HOST SHADOWS = NONE: no host copies of device fields
+  size_t hostBytesSaved;
 
   int *VmapB, *PmapB;
   occa::memory o_VmapB, o_PmapB;
@@ -131,25 +161,26 @@ typedef struct {
   dfloat *cU, *cUd;
   occa::memory o_cU, o_cUd;
 
-  // Some Iso-surfacing variables
-  int isoField, isoColorField, isoNfields, isoNlevels, isoMaxNtris, *isoNtris; 
-  dfloat isoMinVal, isoMaxVal, *isoLevels, *isoq; 
-  size_t isoMax; 
-  
-  int *isoGNlevels, isoGNgroups;
-  dfloat **isoGLvalues;
-  // NBN: add storage for compacted isosurf data for gmsh write
-  std::vector<dfloat> iso_nodes;
-  std::vector<int> iso_tris;
+  // Some Iso-surfacing variables, extracted on the welded plot mesh
+  int isoField, isoColorField, isoNlevels, isoMaxNtris, isoMaxNverts;
+  dfloat isoMinVal, isoMaxVal, *isoLevels;
+  dlong NplotEdges;
+
+  // staging and pending write of the shared binary output file
+  char *isoStage;
+  size_t isoStageBytes;
+  int isoPending;
+  MPI_File isoFile;
+  MPI_Request isoRequest;
 
 
   int readRestartFile,writeRestartFile, restartedFromFile;
 
 
 
-  occa::memory *o_isoGLvalues; 
-  occa::memory o_isoLevels, o_isoq, o_isoNtris; 
   occa::memory o_plotInterp, o_plotEToV; 
+  occa::memory o_plotNodeRep, o_plotEdges, o_plotEdgeNodes, o_isoPlotq;
+  occa::memory o_isoCounts, o_isoEdgeVert, o_isoPoints, o_isoColor, o_isoTris;
 
 
 
@@ -161,8 +192,15 @@ typedef struct {
   occa::kernel subCycleExtKernel;
 
   occa::kernel constrainKernel;
+  occa::kernel setValueKernel;
+  occa::kernel cflKernel;
+  occa::kernel forcesKernel;
+  occa::kernel errorEstimateKernel;
+  occa::kernel statisticsKernel;
   
   occa::memory o_U, o_P;
+  occa::memory o_hmin, o_cflBlockMax;
+  occa::memory o_errtmp;
   occa::memory o_rhsU, o_rhsV, o_rhsW, o_rhsP; 
 
   occa::memory o_NU, o_LU, o_GP;
@@ -174,6 +212,8 @@ typedef struct {
 
   occa::memory o_Vort, o_Div;
 
+  occa::memory o_statMean, o_statM2, o_statUU;
+
   occa::memory o_vHaloBuffer, o_pHaloBuffer; 
   occa::memory o_velocityHaloGatherTmp;
 
@@ -185,6 +225,7 @@ typedef struct {
 
   //EXTBDF data
   occa::memory o_extbdfA, o_extbdfB, o_extbdfC;
+  occa::memory o_extbdfSlotA, o_extbdfSlotB, o_extbdfSlotC; // ordered by history slot
   occa::memory o_extC;
 
   occa::kernel velocityHaloExtractKernel;
@@ -220,11 +261,15 @@ typedef struct {
   occa::kernel velocityRhsKernel;
   occa::kernel velocityRhsIpdgBCKernel;
   occa::kernel velocityRhsBCKernel;
+  occa::kernel velocityRhsBCExtbdfKernel; // EXTBDF rhs and continuous BC lifting in one pass
+  int velocityRhsFused;
   occa::kernel velocityAddBCKernel;
   occa::kernel velocityUpdateKernel;  
   
   occa::kernel vorticityKernel;
-  occa::kernel isoSurfaceKernel;
+  occa::kernel isoPlotKernel;
+  occa::kernel isoEdgesKernel;
+  occa::kernel isoTrisKernel;
 
 
 }ins_t;
@@ -233,13 +278,29 @@ ins_t *insSetup(mesh_t *mesh, setupAide options);
 
 void insRunARK(ins_t *ins);
 void insRunEXTBDF(ins_t *ins);
+int  insHistorySlot(ins_t *ins, int age);
+void insHistoryRotate(ins_t *ins);
 
 void insPlotVTU(ins_t *ins, char *fileNameBase);
 void insReport(ins_t *ins, dfloat time,  int tstep);
 void insError(ins_t *ins, dfloat time);
+void insForcesSetup(ins_t *ins);
 void insForces(ins_t *ins, dfloat time);
+void insForcesFlush(ins_t *ins);
+void insProbesSetup(ins_t *ins, occa::properties &kernelInfo);
+void insProbes(ins_t *ins, dfloat time);
+void insStatisticsSetup(ins_t *ins);
+void insStatistics(ins_t *ins, dfloat time);
+void insStatisticsCopyToHost(ins_t *ins);
+void insStatisticsPlotVTU(ins_t *ins, FILE *fp);
+void insStatisticsWrite(ins_t *ins, FILE *fp);
+void insStatisticsRead(ins_t *ins, FILE *fp);
 void insComputeDt(ins_t *ins, dfloat time); 
 
+dfloat *insHostShadow(ins_t *ins, size_t N);
+occa::memory insDeviceField(ins_t *ins, size_t N, dfloat *shadow);
+void insHostStage(ins_t *ins, int restart);
+
 void insAdvection(ins_t *ins, dfloat time, occa::memory o_U, occa::memory o_NU);
 void insDiffusion(ins_t *ins, dfloat time, occa::memory o_U, occa::memory o_LU);
 void insGradient (ins_t *ins, dfloat time, occa::memory o_P, occa::memory o_GP);
@@ -254,9 +315,10 @@ void insPressureRhs  (ins_t *ins, dfloat time, int stage);
 void insPressureSolve(ins_t *ins, dfloat time, int stage);
 void insPressureUpdate(ins_t *ins, dfloat time, int stage, occa::memory o_rkP);
 
-// Welding  to Tris, needs to be moved seperate library
-int insWeldTriVerts(ins_t *ins, int isoNtris, dfloat *isoq);
-void insIsoPlotVTU(ins_t *ins, char *fileName);
+// device isosurfaces written as binary VTP, one shared file per frame
+void insIsoSurfaceSetup(ins_t *ins);
+void insIsoSurface(ins_t *ins, char *fileName);
+void insIsoSurfaceClose(ins_t *ins);
 
 // Restarting from file
 void insRestartWrite(ins_t *ins, setupAide &options, dfloat time); 
@@ -0,0 +1,44 @@
+/*
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Tim Warburton, Noel Chalmers, Jesse Chan, Ali Karakus
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+// EXTBDF history part of the velocity rhs at node id of field fld, before
+// the mass matrix: (\sum b_s U^s/dt - a_s NU^s - c_s GP^s)/nu
+#define insVelocityHistory(id, fld, h)                                      \
+{                                                                           \
+  if (p_SUBCYCLING) {                                                       \
+    /* NU holds \hat{U} after subcycling */                                 \
+    h = idt*NU[id+fld*fieldOffset];                                         \
+    for (int s=0;s<p_Nstages;s++)                                           \
+      h -= extbdfC[s]*GP[id+fld*fieldOffset+s*p_NVfields*fieldOffset];      \
+  } else {                                                                  \
+    h = 0.f;                                                                \
+    for (int s=0;s<p_Nstages;s++) {                                         \
+      const dlong sid = id+fld*fieldOffset+s*p_NVfields*fieldOffset;        \
+      h += idt*extbdfB[s]*U[sid] - extbdfA[s]*NU[sid] - extbdfC[s]*GP[sid]; \
+    }                                                                       \
+  }                                                                         \
+  h *= inu;                                                                 \
+}
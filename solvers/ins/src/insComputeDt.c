@@ -29,66 +29,24 @@ SOFTWARE.
 void insComputeDt(ins_t *ins, dfloat time){
 
   mesh_t *mesh = ins->mesh; 
-  // copy data to host
-  ins->o_U.copyTo(ins->U);
-
-  dfloat hminL = 0.0, umaxL = 0.0, dt = 1e9;
-  for(dlong e=0;e<mesh->Nelements;++e){
-    hminL = 1e9; 
-    umaxL = 0.0; 
-
-    if(ins->elementType == TRIANGLES || ins->elementType == TETRAHEDRA){
-    for(int f=0;f<mesh->Nfaces;++f){
-      dlong sid = mesh->Nsgeo*(mesh->Nfaces*e + f);
-      dfloat sJ   = mesh->sgeo[sid + SJID];
-      dfloat invJ = mesh->sgeo[sid + IJID];
-
-      dfloat hest = 2./(sJ*invJ);
-      hminL = mymin(hminL, hest);
-    }
-   }else{
-    for(int f=0; f<mesh->Nfaces; f++){
-      for(int n=0; n<mesh->Nfp; n++){
-        dlong sid = mesh->Nsgeo*(mesh->Nfaces*mesh->Nfp*e + f*mesh->Nfp + n);
-        dfloat sJ   = mesh->sgeo[sid + SJID];
-        dfloat invJ = mesh->sgeo[sid + IJID];
-
-        dfloat hest = 2./(sJ*invJ);
-        hminL = mymin(hminL, hest);
-      }
-    }
-  }
-
-    for(int n=0;n<mesh->Np;++n){
-      const dlong id = n + mesh->Np*e;
-      dfloat t = 0;
-      dfloat uxn = ins->U[id+0*ins->fieldOffset];
-      dfloat uyn = ins->U[id+1*ins->fieldOffset];
-      dfloat uzn = 0.0;
-      if (ins->dim==3) 
-        uzn = ins->U[id+2*ins->fieldOffset];
-
-      //Squared maximum velocity
-      dfloat numax;
-      if (ins->dim==2)
-        numax = uxn*uxn + uyn*uyn;
-      else 
-        numax = uxn*uxn + uyn*uyn + uzn*uzn;
-
-      umaxL = mymax(umaxL, numax);
-    }
-    umaxL = sqrt(umaxL);
-    
-    //Guard for around zero velocity
-    umaxL = (umaxL<1.E-12) ? 1.E-3 : umaxL;
-
-    dfloat dtL = ins->cfl*hminL/((mesh->N+1)*(mesh->N+1)*umaxL);
-    dt = mymin(dt, dtL); 
-  }
-
-
-  // Save the time step size
-  // ins->dto = ins->dt; 
+
+  // block-wise max of |u|/h on the newest velocity
+  const dlong offset = insHistorySlot(ins, 0)*ins->NVfields*ins->fieldOffset;
+  ins->cflKernel(mesh->Nelements,
+                 ins->o_hmin,
+                 ins->fieldOffset,
+                 ins->o_U + offset*sizeof(dfloat),
+                 ins->o_cflBlockMax);
+
+  // only the block maxima come back to the host
+  ins->o_cflBlockMax.copyTo(ins->cflBlockMax, ins->NcflBlock*sizeof(dfloat));
+
+  dfloat ratio = 0.0; 
+  for(int b=0;b<ins->NcflBlock;++b)
+    ratio = mymax(ratio, ins->cflBlockMax[b]);
+
+  dfloat dt = (ratio>0.0) ? ins->cfl/((mesh->N+1)*(mesh->N+1)*ratio) : 1e9;
+
   // MPI_Allreduce to get global minimum dt
   MPI_Allreduce(&dt, &(ins->dt), 1, MPI_DFLOAT, MPI_MIN, mesh->comm);
 
@@ -27,134 +27,153 @@ SOFTWARE.
 #include "ins.h"
 
 
-void insForces(ins_t *ins, dfloat time){
-
-
-  mesh_t *mesh = ins->mesh; 
-  // Hard coded weights i.e. sum(MM1D,1), MM1D = inv(V1)'*V1
-  dfloat W[mesh->Nfp];
-  if(mesh->N==1){
-    W[0] = 1.000000000000000; W[1] = 1.000000000000000; 
+// collect the face nodes carrying the FORCE BOUNDARY TAG together with
+// their weighted surface Jacobian and outward normal
+void insForcesSetup(ins_t *ins){
+
+  mesh_t *mesh = ins->mesh;
+  const int Ngeo = ins->NVfields+1;
+  const int simplex = (ins->elementType==TRIANGLES || ins->elementType==TETRAHEDRA);
+
+  ins->forceTag = 1;
+  ins->options.getArgs("FORCE BOUNDARY TAG", ins->forceTag);
+
+  ins->NforceNodes = 0;
+  if(ins->elementType==QUADRILATERALS && ins->dim==3){
+    if(ins->outputForceStep && mesh->rank==0)
+      printf("WARNING: boundary forces are not available for surface quadrilaterals\n");
+  }else{
+    for(dlong e=0;e<mesh->Nelements;++e)
+      for(int f=0;f<mesh->Nfaces;++f)
+        if(mesh->EToB[e*mesh->Nfaces+f]==ins->forceTag)
+          ins->NforceNodes += mesh->Nfp;
   }
 
- if(mesh->N==2){
-    W[0] = 0.333333333333333; W[1] = 1.333333333333333;
-    W[2] = 0.333333333333333; 
+  // face quadrature weights of simplices are the column sums of MM*LIFT
+  dfloat *faceW = NULL;
+  if(simplex){
+    faceW = (dfloat*) calloc(mesh->Nfaces*mesh->Nfp, sizeof(dfloat));
+    for(int m=0;m<mesh->Nfaces*mesh->Nfp;++m)
+      for(int i=0;i<mesh->Np;++i)
+        for(int j=0;j<mesh->Np;++j)
+          faceW[m] += mesh->MM[i*mesh->Np+j]*mesh->LIFT[j*mesh->Nfaces*mesh->Nfp+m];
   }
 
-  if(mesh->N==3){
-    W[0] = 0.166666666666666; W[1] = 0.833333333333334;
-    W[2] = 0.833333333333334; W[3] = 0.166666666666666;
-  }
-  if(mesh->N==4){
-    W[0] = 0.100000000000000; W[1] = 0.544444444444444;
-    W[2] = 0.711111111111111; W[3] = 0.544444444444444;
-    W[4] = 0.100000000000000; 
-  }
-  if(mesh->N==5){
-    W[0] = 0.066666666666666; W[1] = 0.378474956297847;
-    W[2] = 0.554858377035487; W[3] = 0.554858377035486;
-    W[4] = 0.378474956297847; W[5] = 0.066666666666667;
-  }
+  dlong  *forceIds = (dlong*)  calloc(ins->NforceNodes+1, sizeof(dlong));
+  dfloat *forceGeo = (dfloat*) calloc((ins->NforceNodes+1)*Ngeo, sizeof(dfloat));
 
-  if(mesh->N==6){
-    W[0] = 0.047619047619047; W[1] = 0.276826047361566;
-    W[2] = 0.431745381209863; W[3] = 0.487619047619048;
-    W[4] = 0.431745381209863; W[5] = 0.276826047361566;
-    W[6] = 0.047619047619047;
+  dlong cnt = 0;
+  for(dlong e=0;e<mesh->Nelements && cnt<ins->NforceNodes;++e){
+    for(int f=0;f<mesh->Nfaces;++f){
+      if(mesh->EToB[e*mesh->Nfaces+f]!=ins->forceTag) continue;
+
+      for(int n=0;n<mesh->Nfp;++n){
+        const dlong vid = e*mesh->Nfp*mesh->Nfaces + f*mesh->Nfp + n;
+        const dlong sid = simplex ? mesh->Nsgeo*(e*mesh->Nfaces+f) : mesh->Nsgeo*vid;
+
+        forceIds[cnt] = mesh->vmapM[vid];
+        forceGeo[cnt*Ngeo+0] = simplex ? faceW[f*mesh->Nfp+n]*mesh->sgeo[sid+SJID]
+                                       : mesh->sgeo[sid+WSJID];
+        forceGeo[cnt*Ngeo+1] = mesh->sgeo[sid+NXID];
+        forceGeo[cnt*Ngeo+2] = mesh->sgeo[sid+NYID];
+        if(ins->dim==3)
+          forceGeo[cnt*Ngeo+3] = mesh->sgeo[sid+NZID];
+        ++cnt;
+      }
+    }
   }
 
-   
+  ins->NforceBlock = (ins->NforceNodes+blockSize-1)/blockSize;
+  ins->forceBlock  = (dfloat*) calloc((ins->NforceBlock+1)*ins->NVfields, sizeof(dfloat));
 
-  dfloat Fx =0. , Fy = 0. ;
-  dfloat *dUdx = (dfloat*) calloc(mesh->Np,sizeof(dfloat));
-  dfloat *dUdy = (dfloat*) calloc(mesh->Np,sizeof(dfloat));
-  dfloat *dVdx = (dfloat*) calloc(mesh->Np,sizeof(dfloat));
-  dfloat *dVdy = (dfloat*) calloc(mesh->Np,sizeof(dfloat));
-  dlong offset = mesh->Np*(mesh->Nelements+mesh->totalHaloPairs);
+  ins->o_forceIds   = mesh->device.malloc((ins->NforceNodes+1)*sizeof(dlong), forceIds);
+  ins->o_forceGeo   = mesh->device.malloc((ins->NforceNodes+1)*Ngeo*sizeof(dfloat), forceGeo);
+  ins->o_forceBlock = mesh->device.malloc((ins->NforceBlock+1)*ins->NVfields*sizeof(dfloat), ins->forceBlock);
 
-  //
-   for(int e=0;e<mesh->Nelements;++e){
-     int flag = 0; 
-    for(int f=0;f<mesh->Nfaces;++f){
-      int bc = mesh->EToB[e*mesh->Nfaces+f];
-      if(bc == 1){ flag = 1; }
-    }
+  // rows of (time, F) are written out in batches
+  ins->forceBufferSize = 100;
+  ins->options.getArgs("FORCE OUTPUT BUFFER", ins->forceBufferSize);
+  ins->forceBufferSize = mymax(ins->forceBufferSize, 1);
+  ins->NforceBuffered  = 0;
+  ins->forceBuffer = (dfloat*) calloc(ins->forceBufferSize*Ngeo, sizeof(dfloat));
 
-    if(flag){
-
-      dfloat drdx = mesh->vgeo[e*mesh->Nvgeo + RXID];
-      dfloat drdy = mesh->vgeo[e*mesh->Nvgeo + RYID];
-      dfloat dsdx = mesh->vgeo[e*mesh->Nvgeo + SXID];
-      dfloat dsdy = mesh->vgeo[e*mesh->Nvgeo + SYID];
-      for(int n=0;n<mesh->Np;++n){
-        dfloat dudr = 0, duds = 0, dvdr = 0, dvds = 0;     
-        for(int i=0;i<mesh->Np;++i){
-          // load data at node i of element e (note Nfields==4)
-          int id = e*mesh->Np + i;
-          dfloat u = ins->U[id+0*offset];
-          dfloat v = ins->U[id+1*offset];
-          //  
-          dfloat Drni = mesh->Dr[n*mesh->Np+i];
-          dfloat Dsni = mesh->Ds[n*mesh->Np+i];
-          // differentiate (u,v,p) with respect to 'r' and 's'
-          dudr += Drni*u;
-          duds += Dsni*u;
-          dvdr += Drni*v;
-          dvds += Dsni*v;   
-        }
-        dUdx[n] = drdx*dudr + dsdx*duds;
-        dUdy[n] = drdy*dudr + dsdy*duds;
-        dVdx[n] = drdx*dvdr + dsdx*dvds;
-        dVdy[n] = drdy*dvdr + dsdy*dvds;
-      }
+  free(forceIds);
+  free(forceGeo);
+  if(faceW) free(faceW);
+}
 
-   
-      for(int f=0;f<mesh->Nfaces;++f){
-        int bc = mesh->EToB[e*mesh->Nfaces+f];
-        if(bc==1){
-          for(int n=0;n<mesh->Nfp; n++){
-            int sid = mesh->Nsgeo*(e*mesh->Nfaces+f);
-            dfloat nx = mesh->sgeo[sid+NXID];
-            dfloat ny = mesh->sgeo[sid+NYID];
-            dfloat sJ = mesh->sgeo[sid+SJID];
-
-            int vid  = e*mesh->Nfp*mesh->Nfaces + f*mesh->Nfp + n;
-            int idM  = mesh->vmapM[vid];
-            //
-            dfloat dudx = dUdx[idM-e*mesh->Np]; 
-            dfloat dudy = dUdy[idM-e*mesh->Np]; 
-            dfloat dvdx = dVdx[idM-e*mesh->Np]; 
-            dfloat dvdy = dVdy[idM-e*mesh->Np];
-            //
-            dfloat p = ins->P[idM];
-
-            Fx += W[n]*(sJ*(-p*nx + ins->nu*(nx*2.0*dudx + ny*(dvdx + dudy))));
-            Fy += W[n]*(sJ*(-p*ny + ins->nu*(nx*(dvdx + dudy) + ny*2.0*dvdy)));
-          }
-        }
-      }
-    }
-  }
+// integrate the traction over the tagged boundary on the device
+void insForces(ins_t *ins, dfloat time){
 
+  mesh_t *mesh = ins->mesh;
+  if(ins->elementType==QUADRILATERALS && ins->dim==3) return;
+
+  // newest level of the velocity and pressure history
+  occa::memory o_Un = ins->o_U + insHistorySlot(ins, 0)*ins->NVfields*ins->fieldOffset*sizeof(dfloat);
+  occa::memory o_Pn = ins->o_P + insHistorySlot(ins, 0)*ins->fieldOffset*sizeof(dfloat);
+
+  // velocity gradient, component by component, into GU
+  for(int i=0;i<ins->NVfields;++i)
+    ins->gradientVolumeKernel(mesh->Nelements,
+                              mesh->o_vgeo,
+                              mesh->o_Dmatrices,
+                              ins->fieldOffset,
+                              o_Un + i*ins->fieldOffset*sizeof(dfloat),
+                              ins->o_GU + i*ins->NVfields*ins->fieldOffset*sizeof(dfloat));
+
+  dfloat F[3] = {0.,0.,0.}, gF[3] = {0.,0.,0.};
+
+  if(ins->NforceNodes){
+    ins->forcesKernel(ins->NforceNodes,
+                      ins->o_forceIds,
+                      ins->o_forceGeo,
+                      ins->fieldOffset,
+                      o_Pn,
+                      ins->o_GU,
+                      ins->o_forceBlock);
+
+    ins->o_forceBlock.copyTo(ins->forceBlock, ins->NforceBlock*ins->NVfields*sizeof(dfloat));
+
+    for(int b=0;b<ins->NforceBlock;++b)
+      for(int i=0;i<ins->NVfields;++i)
+        F[i] += ins->forceBlock[b*ins->NVfields+i];
+  }
 
-  dfloat gFx = 0., gFy = 0.; 
-  // Add all processors force, 
-  MPI_Allreduce(&Fx, &gFx, 1, MPI_DFLOAT, MPI_SUM, mesh->comm);
-  MPI_Allreduce(&Fy, &gFy, 1, MPI_DFLOAT, MPI_SUM, mesh->comm);
+  // Add all processors force
+  MPI_Allreduce(F, gF, ins->NVfields, MPI_DFLOAT, MPI_SUM, mesh->comm);
 
-  //
   if(mesh->rank==0){
+    dfloat *row = ins->forceBuffer + ins->NforceBuffered*(ins->NVfields+1);
+    row[0] = time;
+    for(int i=0;i<ins->NVfields;++i) row[1+i] = gF[i];
+    ++ins->NforceBuffered;
+  }
+
+  if(ins->NforceBuffered==ins->forceBufferSize)
+    insForcesFlush(ins);
+}
+
+// append the buffered force rows to the time-series file
+void insForcesFlush(ins_t *ins){
+
+  mesh_t *mesh = ins->mesh;
+
+  if(mesh->rank==0 && ins->NforceBuffered){
     char fname[BUFSIZ];
     sprintf(fname, "INSForceData_N%d.dat", mesh->N);
 
     FILE *fp; 
     fp = fopen(fname, "a");  
 
-    fprintf(fp, "%.4e %.8e %.8e \n", time, gFx, gFy); 
+    for(int r=0;r<ins->NforceBuffered;++r){
+      dfloat *row = ins->forceBuffer + r*(ins->NVfields+1);
+      fprintf(fp, "%.4e", row[0]);
+      for(int i=0;i<ins->NVfields;++i) fprintf(fp, " %.8e", row[1+i]);
+      fprintf(fp, " \n");
+    }
 
     fclose(fp);
   }
 
-
+  ins->NforceBuffered = 0;
 }
@@ -0,0 +1,66 @@
+/*
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Tim Warburton, Noel Chalmers, Jesse Chan, Ali Karakus
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "ins.h"
+
+// host copy of a solver field, or NULL when HOST SHADOWS = NONE
+dfloat *insHostShadow(ins_t *ins, size_t N){
+
+  if(ins->hostShadows)
+    return (dfloat*) calloc(N, sizeof(dfloat));
+
+  ins->hostBytesSaved += N*sizeof(dfloat);
+  return NULL;
+}
+
+// device field initialised from its host shadow, or set to zero on the device
+occa::memory insDeviceField(ins_t *ins, size_t N, dfloat *shadow){
+
+  if(shadow)
+    return ins->mesh->device.malloc(N*sizeof(dfloat), shadow);
+
+  occa::memory o_q = ins->mesh->device.malloc(N*sizeof(dfloat));
+  ins->setValueKernel((dlong) N, (dfloat) 0.0, o_q);
+  return o_q;
+}
+
+// allocate the host staging used by output and restart on first use
+void insHostStage(ins_t *ins, int restart){
+
+  mesh_t *mesh = ins->mesh;
+  const dlong Nlocal = mesh->Np*mesh->Nelements;
+  const dlong Ntotal = ins->Ntotal;
+
+  if(!ins->U)    ins->U    = (dfloat*) calloc(ins->NVfields*ins->Nstages*Ntotal, sizeof(dfloat));
+  if(!ins->P)    ins->P    = (dfloat*) calloc(              ins->Nstages*Ntotal, sizeof(dfloat));
+  if(!ins->Vort) ins->Vort = (dfloat*) calloc(ins->NVfields*Ntotal, sizeof(dfloat));
+  if(!ins->Div)  ins->Div  = (dfloat*) calloc(Nlocal, sizeof(dfloat));
+
+  if(restart){
+    if(!ins->NU) ins->NU = (dfloat*) calloc(ins->NVfields*(ins->Nstages+1)*Ntotal, sizeof(dfloat));
+    if(!ins->GP) ins->GP = (dfloat*) calloc(ins->NVfields*(ins->Nstages+1)*Ntotal, sizeof(dfloat));
+  }
+}
@@ -0,0 +1,403 @@
+/*
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Tim Warburton, Noel Chalmers, Jesse Chan, Ali Karakus
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include <stdint.h>
+#include "ins.h"
+
+typedef struct {
+  hlong q[3];   // quantized plot node coordinates
+  dlong id;     // flat plot node index e*plotNp+n
+} isoPlotNode_t;
+
+typedef struct {
+  dlong a, b;   // representative plot nodes, a<b
+  dlong slot;   // (e*plotNelements+t)*6+k
+} isoPlotEdge_t;
+
+static int insIsoComparePlotNodes(const void *a, const void *b){
+  const isoPlotNode_t *na = (const isoPlotNode_t*) a;
+  const isoPlotNode_t *nb = (const isoPlotNode_t*) b;
+
+  for(int d=0;d<3;++d){
+    if(na->q[d] < nb->q[d]) return -1;
+    if(na->q[d] > nb->q[d]) return +1;
+  }
+  return (na->id < nb->id) ? -1 : (na->id > nb->id);
+}
+
+static int insIsoComparePlotEdges(const void *a, const void *b){
+  const isoPlotEdge_t *ea = (const isoPlotEdge_t*) a;
+  const isoPlotEdge_t *eb = (const isoPlotEdge_t*) b;
+
+  if(ea->a < eb->a) return -1;
+  if(ea->a > eb->a) return +1;
+  if(ea->b < eb->b) return -1;
+  if(ea->b > eb->b) return +1;
+  return 0;
+}
+
+// read the ISOSURFACE options, weld the plot nodes shared between elements
+// and number the edges of the plot tets once, since the mesh does not move
+void insIsoSurfaceSetup(ins_t *ins){
+
+  mesh_t *mesh = ins->mesh;
+  setupAide &options = ins->options;
+
+  if(ins->dim!=3 || !options.compareArgs("OUTPUT TYPE", "ISO")) return;
+
+  if(ins->elementType==QUADRILATERALS){
+    if(mesh->rank==0) printf("WARNING: isosurfaces are not available for surface quadrilaterals\n");
+    return;
+  }
+
+  // 0 pr (1,2,3) (u,v,w) 4 mag(u) (5,6,7) vort(x,y,z) 8 mag(vort) 9 Q-criterion
+  ins->isoField      = 4;
+  ins->isoColorField = 4;
+  ins->isoNlevels    = 1;
+  ins->isoMaxNtris   = 1.E7;
+  ins->isoMinVal     = 0.;
+  ins->isoMaxVal     = 0.;
+  options.getArgs("ISOSURFACE FIELD ID", ins->isoField);
+  options.getArgs("ISOSURFACE COLOR ID", ins->isoColorField);
+  options.getArgs("ISOSURFACE LEVEL NUMBER", ins->isoNlevels);
+  options.getArgs("ISOSURFACE CONTOUR MAX", ins->isoMaxVal);
+  options.getArgs("ISOSURFACE CONTOUR MIN", ins->isoMinVal);
+  options.getArgs("ISOSURFACE MAX TRIANGLES", ins->isoMaxNtris);
+  ins->isoMaxNverts = ins->isoMaxNtris;
+
+  ins->isoNlevels = mymax(ins->isoNlevels, 1);
+  ins->isoLevels  = (dfloat*) calloc(ins->isoNlevels, sizeof(dfloat));
+  for(int l=0;l<ins->isoNlevels;++l)
+    ins->isoLevels[l] = (ins->isoNlevels==1) ? ins->isoMinVal :
+      ins->isoMinVal + (ins->isoMaxVal-ins->isoMinVal)*l/(dfloat)(ins->isoNlevels-1);
+
+  const int plotNp = mesh->plotNp;
+  const int plotNelements = mesh->plotNelements;
+  const dlong Nplot = mesh->Nelements*plotNp;
+
+  // Interpolation operators form Np to PlotNp (equisapaced nodes of order >N generally)
+  dfloat *plotInterp = (dfloat*) calloc(plotNp*mesh->Np, sizeof(dfloat));
+  for(int n=0;n<plotNp;++n)
+    for(int m=0;m<mesh->Np;++m)
+      plotInterp[n+m*plotNp] = mesh->plotInterp[n*mesh->Np+m];
+
+  ins->o_plotInterp = mesh->device.malloc(plotNp*mesh->Np*sizeof(dfloat), plotInterp);
+
+  // EToV for local triangulation
+  int *plotEToV = (int*) calloc(plotNelements*mesh->plotNverts, sizeof(int));
+  for(int n=0;n<plotNelements;++n)
+    for(int m=0;m<mesh->plotNverts;++m)
+      plotEToV[n+m*plotNelements] = mesh->plotEToV[n*mesh->plotNverts+m];
+
+  ins->o_plotEToV = mesh->device.malloc(plotNelements*mesh->plotNverts*sizeof(int), plotEToV);
+
+  // plot node coordinates, quantized relative to the size of the partition
+  dfloat *plotx = (dfloat*) calloc(3*(Nplot+1), sizeof(dfloat));
+  dfloat xmin[3] = {0.,0.,0.}, xmax[3] = {0.,0.,0.};
+
+  for(dlong e=0;e<mesh->Nelements;++e){
+    for(int n=0;n<plotNp;++n){
+      const dlong id = e*plotNp+n;
+      for(int m=0;m<mesh->Np;++m){
+        const dfloat Inm = mesh->plotInterp[n*mesh->Np+m];
+        plotx[3*id+0] += Inm*mesh->x[m+e*mesh->Np];
+        plotx[3*id+1] += Inm*mesh->y[m+e*mesh->Np];
+        plotx[3*id+2] += Inm*mesh->z[m+e*mesh->Np];
+      }
+      for(int d=0;d<3;++d){
+        xmin[d] = (id==0) ? plotx[3*id+d] : mymin(xmin[d], plotx[3*id+d]);
+        xmax[d] = (id==0) ? plotx[3*id+d] : mymax(xmax[d], plotx[3*id+d]);
+      }
+    }
+  }
+
+  const dfloat extent = mymax(xmax[0]-xmin[0], mymax(xmax[1]-xmin[1], xmax[2]-xmin[2]));
+  const dfloat tol    = 1.e-9*mymax(extent, (dfloat) 1.e-12);
+
+  isoPlotNode_t *nodes = (isoPlotNode_t*) calloc(Nplot+1, sizeof(isoPlotNode_t));
+  for(dlong id=0;id<Nplot;++id){
+    for(int d=0;d<3;++d)
+      nodes[id].q[d] = (hlong) llround((plotx[3*id+d]-xmin[d])/tol);
+    nodes[id].id = id;
+  }
+  qsort(nodes, Nplot, sizeof(isoPlotNode_t), insIsoComparePlotNodes);
+
+  // every plot node is represented by the first node at its position
+  dlong *plotNodeRep = (dlong*) calloc(Nplot+1, sizeof(dlong));
+  for(dlong i=0, rep=0;i<Nplot;++i){
+    if(i==0 || nodes[i-1].q[0]!=nodes[i].q[0] || nodes[i-1].q[1]!=nodes[i].q[1] || nodes[i-1].q[2]!=nodes[i].q[2])
+      rep = nodes[i].id;
+    plotNodeRep[nodes[i].id] = rep;
+  }
+  free(nodes);
+  free(plotx);
+
+  // number the edges of the plot tets between representatives
+  const int edgeVerts[6][2] = {{0,1},{0,2},{0,3},{1,2},{1,3},{2,3}};
+  const dlong Nslots = mesh->Nelements*plotNelements*6;
+
+  isoPlotEdge_t *edges = (isoPlotEdge_t*) calloc(Nslots+1, sizeof(isoPlotEdge_t));
+  for(dlong e=0;e<mesh->Nelements;++e){
+    for(int t=0;t<plotNelements;++t){
+      for(int k=0;k<6;++k){
+        const dlong slot = (e*plotNelements+t)*6+k;
+        const dlong ra = plotNodeRep[e*plotNp+plotEToV[t+edgeVerts[k][0]*plotNelements]];
+        const dlong rb = plotNodeRep[e*plotNp+plotEToV[t+edgeVerts[k][1]*plotNelements]];
+        edges[slot].a    = mymin(ra, rb);
+        edges[slot].b    = mymax(ra, rb);
+        edges[slot].slot = slot;
+      }
+    }
+  }
+  qsort(edges, Nslots, sizeof(isoPlotEdge_t), insIsoComparePlotEdges);
+
+  dlong *plotEdges = (dlong*) calloc(Nslots+1, sizeof(dlong));
+  dlong *edgeNodes = (dlong*) calloc(2*(Nslots+1), sizeof(dlong));
+  ins->NplotEdges = 0;
+  for(dlong i=0;i<Nslots;++i){
+    if(i==0 || insIsoComparePlotEdges(edges+i-1, edges+i)){
+      edgeNodes[2*ins->NplotEdges+0] = edges[i].a;
+      edgeNodes[2*ins->NplotEdges+1] = edges[i].b;
+      ++ins->NplotEdges;
+    }
+    plotEdges[edges[i].slot] = ins->NplotEdges-1;
+  }
+  free(edges);
+
+  ins->o_plotNodeRep   = mesh->device.malloc((Nplot+1)*sizeof(dlong), plotNodeRep);
+  ins->o_plotEdges     = mesh->device.malloc((Nslots+1)*sizeof(dlong), plotEdges);
+  ins->o_plotEdgeNodes = mesh->device.malloc(2*(ins->NplotEdges+1)*sizeof(dlong), edgeNodes);
+  ins->o_isoPlotq      = mesh->device.malloc((Nplot+1)*5*sizeof(dfloat));
+  ins->o_isoEdgeVert   = mesh->device.malloc((ins->NplotEdges+1)*sizeof(int));
+
+  ins->o_isoCounts = mesh->device.malloc(2*sizeof(int));
+  ins->o_isoPoints = mesh->device.malloc(3*(size_t)ins->isoMaxNverts*sizeof(float));
+  ins->o_isoColor  = mesh->device.malloc(  (size_t)ins->isoMaxNverts*sizeof(float));
+  ins->o_isoTris   = mesh->device.malloc(3*(size_t)ins->isoMaxNtris*sizeof(int));
+
+  ins->isoStage      = NULL;
+  ins->isoStageBytes = 0;
+  ins->isoPending    = 0;
+
+  free(plotInterp);
+  free(plotEToV);
+  free(plotNodeRep);
+  free(plotEdges);
+  free(edgeNodes);
+}
+
+// complete the write of the previous frame and release its staging
+void insIsoSurfaceClose(ins_t *ins){
+
+  if(!ins->isoPending) return;
+
+  MPI_Wait(&ins->isoRequest, MPI_STATUS_IGNORE);
+  MPI_File_close(&ins->isoFile);
+  ins->isoPending = 0;
+}
+
+// piece of the shared VTP file for rank r with Nv points and Nt triangles
+static int insIsoPieceHeader(char *buf, int Nv, int Nt, size_t offset){
+
+  const size_t pointBytes = 3*(size_t)Nv*sizeof(float);
+  const size_t colorBytes =   (size_t)Nv*sizeof(float);
+  const size_t triBytes   = 3*(size_t)Nt*sizeof(int);
+
+  size_t o0 = offset;
+  size_t o1 = o0 + sizeof(uint64_t) + pointBytes;
+  size_t o2 = o1 + sizeof(uint64_t) + colorBytes;
+  size_t o3 = o2 + sizeof(uint64_t) + triBytes;
+
+  return sprintf(buf,
+    "    <Piece NumberOfPoints=\"%d\" NumberOfPolys=\"%d\">\n"
+    "      <Points>\n"
+    "        <DataArray type=\"Float32\" NumberOfComponents=\"3\" format=\"appended\" offset=\"%zu\"/>\n"
+    "      </Points>\n"
+    "      <PointData Scalars=\"Color\">\n"
+    "        <DataArray type=\"Float32\" Name=\"Color\" format=\"appended\" offset=\"%zu\"/>\n"
+    "      </PointData>\n"
+    "      <Polys>\n"
+    "        <DataArray type=\"Int32\" Name=\"connectivity\" format=\"appended\" offset=\"%zu\"/>\n"
+    "        <DataArray type=\"Int32\" Name=\"offsets\" format=\"appended\" offset=\"%zu\"/>\n"
+    "      </Polys>\n"
+    "    </Piece>\n", Nv, Nt, o0, o1, o2, o3);
+}
+
+static size_t insIsoPieceBytes(int Nv, int Nt){
+  return 4*sizeof(uint64_t) + 4*(size_t)Nv*sizeof(float) + 4*(size_t)Nt*sizeof(int);
+}
+
+// extract all contour levels of the newest solution on the device and start
+// a non-blocking write of one binary VTP file shared by all ranks
+void insIsoSurface(ins_t *ins, char *fileName){
+
+  mesh_t *mesh = ins->mesh;
+
+  occa::memory o_Un = ins->o_U + insHistorySlot(ins, 0)*ins->NVfields*ins->fieldOffset*sizeof(dfloat);
+  occa::memory o_Pn = ins->o_P + insHistorySlot(ins, 0)*ins->fieldOffset*sizeof(dfloat);
+
+  // velocity gradient, component by component, for the Q-criterion
+  if(ins->isoField==9 || ins->isoColorField==9)
+    for(int i=0;i<ins->NVfields;++i)
+      ins->gradientVolumeKernel(mesh->Nelements,
+                                mesh->o_vgeo,
+                                mesh->o_Dmatrices,
+                                ins->fieldOffset,
+                                o_Un + i*ins->fieldOffset*sizeof(dfloat),
+                                ins->o_GU + i*ins->NVfields*ins->fieldOffset*sizeof(dfloat));
+
+  ins->isoPlotKernel(mesh->Nelements,
+                     ins->fieldOffset,
+                     ins->isoField,
+                     ins->isoColorField,
+                     mesh->o_x,
+                     mesh->o_y,
+                     mesh->o_z,
+                     o_Pn,
+                     o_Un,
+                     ins->o_Vort,
+                     ins->o_GU,
+                     ins->o_plotInterp,
+                     ins->o_isoPlotq);
+
+  int zero[2] = {0, 0};
+  ins->o_isoCounts.copyFrom(zero);
+
+  // vertices and triangles of all levels are appended to the same buffers
+  for(int l=0;l<ins->isoNlevels;++l){
+    ins->isoEdgesKernel(ins->NplotEdges,
+                        ins->isoLevels[l],
+                        ins->o_plotEdgeNodes,
+                        ins->o_isoPlotq,
+                        ins->isoMaxNverts,
+                        ins->o_isoCounts,
+                        ins->o_isoEdgeVert,
+                        ins->o_isoPoints,
+                        ins->o_isoColor);
+
+    ins->isoTrisKernel(mesh->Nelements,
+                       ins->isoLevels[l],
+                       ins->o_plotNodeRep,
+                       ins->o_plotEToV,
+                       ins->o_plotEdges,
+                       ins->o_isoPlotq,
+                       ins->o_isoEdgeVert,
+                       ins->isoMaxNtris,
+                       ins->o_isoCounts,
+                       ins->o_isoTris);
+  }
+
+  int counts[2];
+  ins->o_isoCounts.copyTo(counts);
+
+  if(counts[0]>ins->isoMaxNverts || counts[1]>ins->isoMaxNtris)
+    printf("WARNING: rank %d isosurface truncated to %d triangles, increase ISOSURFACE MAX TRIANGLES\n",
+           mesh->rank, ins->isoMaxNtris);
+
+  int Nv = mymin(counts[0], ins->isoMaxNverts);
+  int Nt = mymin(counts[1], ins->isoMaxNtris);
+
+  // the staging of the previous frame is still owned by its write
+  insIsoSurfaceClose(ins);
+
+  const size_t pieceBytes = insIsoPieceBytes(Nv, Nt);
+  if(pieceBytes>ins->isoStageBytes){
+    ins->isoStage      = (char*) realloc(ins->isoStage, pieceBytes);
+    ins->isoStageBytes = pieceBytes;
+  }
+
+  // stage the piece as [bytes][points][bytes][color][bytes][connectivity][bytes][offsets]
+  char *stage = ins->isoStage;
+  uint64_t nbytes;
+
+  nbytes = 3*(size_t)Nv*sizeof(float);
+  memcpy(stage, &nbytes, sizeof(uint64_t)); stage += sizeof(uint64_t);
+  if(Nv) ins->o_isoPoints.copyTo(stage, nbytes);
+  stage += nbytes;
+
+  nbytes = (size_t)Nv*sizeof(float);
+  memcpy(stage, &nbytes, sizeof(uint64_t)); stage += sizeof(uint64_t);
+  if(Nv) ins->o_isoColor.copyTo(stage, nbytes);
+  stage += nbytes;
+
+  nbytes = 3*(size_t)Nt*sizeof(int);
+  memcpy(stage, &nbytes, sizeof(uint64_t)); stage += sizeof(uint64_t);
+  int *tris = (int*) stage;
+  if(Nt) ins->o_isoTris.copyTo(stage, nbytes);
+  stage += nbytes;
+
+  // triangles whose vertices were dropped by a truncation are collapsed
+  for(int t=0;t<Nt;++t)
+    if(tris[3*t+0]<0 || tris[3*t+1]<0 || tris[3*t+2]<0 || tris[3*t+0]>=Nv || tris[3*t+1]>=Nv || tris[3*t+2]>=Nv)
+      tris[3*t+0] = tris[3*t+1] = tris[3*t+2] = 0;
+
+  nbytes = (size_t)Nt*sizeof(int);
+  memcpy(stage, &nbytes, sizeof(uint64_t)); stage += sizeof(uint64_t);
+  int *offsets = (int*) stage;
+  for(int t=0;t<Nt;++t) offsets[t] = 3*(t+1);
+
+  // every rank builds the same header from the gathered piece sizes
+  int *allCounts = (int*) calloc(2*mesh->size, sizeof(int));
+  int myCounts[2] = {Nv, Nt};
+  MPI_Allgather(myCounts, 2, MPI_INT, allCounts, 2, MPI_INT, mesh->comm);
+
+  const char *head =
+    "<?xml version=\"1.0\"?>\n"
+    "<VTKFile type=\"PolyData\" version=\"1.0\" byte_order=\"LittleEndian\" header_type=\"UInt64\">\n"
+    "  <PolyData>\n";
+  const char *tail =
+    "  </PolyData>\n"
+    "  <AppendedData encoding=\"raw\">\n   _";
+  const char *end =
+    "\n  </AppendedData>\n</VTKFile>\n";
+
+  char *header = (char*) calloc(strlen(head)+strlen(tail)+(size_t)mesh->size*1024, sizeof(char));
+  size_t headerBytes = sprintf(header, "%s", head);
+  size_t dataOffset = 0, myOffset = 0;
+  for(int r=0;r<mesh->size;++r){
+    if(r==mesh->rank) myOffset = dataOffset;
+    headerBytes += insIsoPieceHeader(header+headerBytes, allCounts[2*r+0], allCounts[2*r+1], dataOffset);
+    dataOffset  += insIsoPieceBytes(allCounts[2*r+0], allCounts[2*r+1]);
+  }
+  headerBytes += sprintf(header+headerBytes, "%s", tail);
+
+  MPI_File_open(mesh->comm, fileName, MPI_MODE_CREATE|MPI_MODE_WRONLY, MPI_INFO_NULL, &ins->isoFile);
+  MPI_File_set_size(ins->isoFile, 0);
+
+  if(mesh->rank==0){
+    MPI_File_write_at(ins->isoFile, 0, header, headerBytes, MPI_CHAR, MPI_STATUS_IGNORE);
+    MPI_File_write_at(ins->isoFile, headerBytes+dataOffset, (void*) end, strlen(end), MPI_CHAR, MPI_STATUS_IGNORE);
+  }
+
+  // the piece is completed in the background, at the next frame or at the end of the run
+  MPI_File_iwrite_at(ins->isoFile, headerBytes+myOffset, ins->isoStage, pieceBytes, MPI_BYTE, &ins->isoRequest);
+  ins->isoPending = 1;
+
+  if(mesh->rank==0) printf("Isosurface %s: %d levels\n", fileName, ins->isoNlevels);
+
+  free(header);
+  free(allCounts);
+}
@@ -159,7 +159,6 @@ void insPlotVTU(ins_t *ins, char *fileName){
       }
     }
     fprintf(fp, "       </DataArray>\n");
-    fprintf(fp, "     </PointData>\n");
   } else {
     fprintf(fp, "        <DataArray type=\"Float32\" Name=\"Velocity\" NumberOfComponents=\"3\" Format=\"ascii\">\n");
     for(dlong e=0;e<mesh->Nelements;++e){
@@ -181,8 +180,10 @@ void insPlotVTU(ins_t *ins, char *fileName){
       }
     }
     fprintf(fp, "       </DataArray>\n");
-    fprintf(fp, "     </PointData>\n");
   }
+
+  if(ins->statSteps) insStatisticsPlotVTU(ins, fp);
+  fprintf(fp, "     </PointData>\n");
   
   fprintf(fp, "    <Cells>\n");
   fprintf(fp, "      <DataArray type=\"Int32\" Name=\"connectivity\" Format=\"ascii\">\n");
@@ -34,7 +34,7 @@ void insPressureUpdate(ins_t *ins, dfloat time, int stage, occa::memory o_rkP){
   occaTimerTic(mesh->device,"PressureUpdate");
   ins->pressureUpdateKernel(mesh->Nelements,
                             stage,
-		                        ins->o_prkB,
+		                        ins->ARKswitch ? ins->o_prkB : ins->o_extbdfSlotC,
                             ins->fieldOffset,
                             ins->o_PI,
                             ins->o_P,
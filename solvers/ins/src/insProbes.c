@@ -0,0 +1,62 @@
+/*
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Tim Warburton, Noel Chalmers, Jesse Chan, Ali Karakus
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "ins.h"
+
+// locate the points of the PROBE FILE and set up the device sampling ring
+void insProbesSetup(ins_t *ins, occa::properties &kernelInfo){
+
+  mesh_t *mesh = ins->mesh;
+
+  string probeFile;
+  ins->probeFlag = ins->options.getArgs("PROBE FILE", probeFile);
+  if(!ins->probeFlag) return;
+
+  int Nslots = 64;
+  ins->options.getArgs("PROBE RING SLOTS", Nslots);
+
+  string probeName = "INSProbeData";
+  ins->options.getArgs("PROBE OUTPUT NAME", probeName);
+
+  meshProbeSetupFile(mesh, ins->elementType, probeFile.c_str());
+
+  // velocity components followed by pressure
+  meshProbeDeviceSetup(mesh, ins->NVfields+1, Nslots, probeName.c_str(), kernelInfo);
+}
+
+// sample the newest velocity and pressure into the probe ring
+void insProbes(ins_t *ins, dfloat time){
+
+  mesh_t *mesh = ins->mesh;
+
+  occa::memory o_Un = ins->o_U + insHistorySlot(ins, 0)*ins->NVfields*ins->fieldOffset*sizeof(dfloat);
+  occa::memory o_Pn = ins->o_P + insHistorySlot(ins, 0)*ins->fieldOffset*sizeof(dfloat);
+
+  meshProbeSample(mesh, 0,            ins->NVfields, mesh->Np, ins->fieldOffset, o_Un);
+  meshProbeSample(mesh, ins->NVfields, 1,            mesh->Np, ins->fieldOffset, o_Pn);
+
+  meshProbeAdvance(mesh, time);
+}
@@ -31,6 +31,7 @@ void insRestartWrite(ins_t *ins, setupAide &options, dfloat t){
 
   // Copy Field To Host
   // copy data back to host
+  insHostStage(ins, 1);
   ins->o_U.copyTo(ins->U);
   ins->o_P.copyTo(ins->P);
   
@@ -63,8 +64,9 @@ void insRestartWrite(ins_t *ins, setupAide &options, dfloat t){
   // 
  if(options.compareArgs("TIME INTEGRATOR", "EXTBDF") ){
 
-  // Write U and P 
-  for(int s =0; s<ins->Nstages; s++){
+  // Write U and P, newest level first whatever the history rotation
+  for(int age =0; age<ins->Nstages; age++){
+    const int s = insHistorySlot(ins, age);
     for(dlong e = 0;e<mesh->Nelements; e++){
       for(int n=0; n<mesh->Np; n++ ){
         const dlong idv = e*mesh->Np + n + s*ins->fieldOffset*ins->NVfields; 
@@ -78,7 +80,8 @@ void insRestartWrite(ins_t *ins, setupAide &options, dfloat t){
     } 
   }
   // Write nonlinear History 
-  for(int s =0; s<ins->Nstages; s++){
+  for(int age =0; age<ins->Nstages; age++){
+    const int s = insHistorySlot(ins, age);
     for(dlong e = 0;e<mesh->Nelements; e++){
       for(int n=0; n<mesh->Np; n++ ){
         const dlong idv = e*mesh->Np + n + s*ins->fieldOffset*ins->NVfields; 
@@ -95,6 +98,9 @@ void insRestartWrite(ins_t *ins, setupAide &options, dfloat t){
   }
 }
 
+// running statistics follow the solution history
+if(ins->statSteps) insStatisticsWrite(ins, fp);
+
 fclose(fp); 
 
 }
@@ -105,6 +111,7 @@ fclose(fp);
 void insRestartRead(ins_t *ins, setupAide &options){
 
   mesh_t *mesh = ins->mesh;
+  insHostStage(ins, 1);
   
   // Create Binary File Name
   char fname[BUFSIZ];
@@ -170,9 +177,13 @@ void insRestartRead(ins_t *ins, setupAide &options){
       if(mesh->rank==0) printf("restart for ARK has not tested yet\n");
     }
 
+  if(ins->statSteps) insStatisticsRead(ins, fp);
+
   fclose(fp);
 
   ins->restartedFromFile = 1;  
+  // the file holds the history newest level first
+  ins->historyHead = 0;
   // Just Update start time
   ins->startTime = startTime; 
   ins->dt        = ins->dti; // set time-step to initial time-step estimate
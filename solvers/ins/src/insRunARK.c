@@ -26,6 +26,9 @@ SOFTWARE.
 
 #include "ins.h"
 
+static void insARKSetDt(ins_t *ins, dfloat dt);
+static dfloat insErrorEstimate(ins_t *ins);
+
 void insRunARK(ins_t *ins){
 
   mesh_t *mesh = ins->mesh;
@@ -101,7 +104,9 @@ void insRunARK(ins_t *ins){
   insReport(ins, 0.0, 0);
 #endif
 
-  ins->tstep = 0;
+  ins->tstep  = 0;
+  ins->atstep = 0;
+  ins->rtstep = 0;
   int done = 0;
   ins->time = ins->startTime;
 
@@ -109,9 +114,14 @@ void insRunARK(ins_t *ins){
   if(ins->dtAdaptStep) insComputeDt(ins, ins->time); 
   // Write Initial Data
   if(ins->outputStep) insReport(ins, 0.0, 0);
-  // Write Initial Force Data (assumes U = o_U )
+  // Write Initial Force Data
   if(ins->outputForceStep) insForces(ins, ins->time); 
 
+  // the stage Helmholtz operators share the ESDIRK diagonal, so the
+  // solvers set up for lambda = g0/(dt nu) serve every stage
+  if(mesh->rank==0)
+    printf("ARK: one Helmholtz setup for %d implicit stages (lambda = %g)\n", ins->Nstages, ins->lambda);
+
   while (!done) {
 
     if (ins->dt<ins->dtMIN){
@@ -123,12 +133,13 @@ void insRunARK(ins_t *ins){
       exit (-1);
     }
 
-
     //check for final timestep
+    dfloat dtStep = ins->dt;
     if (ins->time+ins->dt > ins->finalTime){
       ins->dt = ins->finalTime-ins->time;
       done = 1;
     }
+    insARKSetDt(ins, ins->dt);
 
     insAdvection(ins, ins->time, ins->o_U, ins->o_NU);
     insDiffusion(ins, ins->time, ins->o_U, ins->o_LU);
@@ -164,7 +175,36 @@ void insRunARK(ins_t *ins){
       ins->o_GP.copyFrom(ins->o_rkGP, ins->Ntotal*ins->NVfields*sizeof(dfloat), stage*ins->Ntotal*ins->NVfields*sizeof(dfloat), 0);
     } 
 
-    if (ins->embeddedRKFlag==0) {//check if an embedded rk method is being used
+    ins->atstep++;
+
+    int accept = 1;
+    dfloat dtnew = ins->dt;
+
+    if (ins->embeddedRKFlag) {
+      // PI controller on the embedded error, HAIRER, NORSETT AND WANNER
+      dfloat err = insErrorEstimate(ins);
+
+      dfloat fac1 = pow(err,exp1);
+      dfloat fac  = fac1/pow(facold,beta);
+
+      fac   = mymax(invfactor2, mymin(invfactor1,fac/safe));
+      dtnew = ins->dt/fac;
+
+      if(err<1.0){
+        facold = mymax(err,1E-4);
+      }else{
+        accept = 0;
+        done   = 0;
+        ins->rtstep++;
+        dtnew = ins->dt/(mymax(invfactor1,fac1/safe));
+        if(mesh->rank==0) printf("\rtime = %g, dt = %g rejected (error %g), trying %g\n", ins->time, ins->dt, err, dtnew);
+      }
+    } else if (done) {
+      // keep the nominal step, the final one was only shortened to land on finalTime
+      dtnew = dtStep;
+    }
+
+    if (accept) {
       //accept the step and proceed
       ins->o_U.copyFrom(ins->o_rkU, ins->Ntotal*ins->NVfields*sizeof(dfloat), 0);
       ins->o_P.copyFrom(ins->o_rkP, ins->Ntotal*sizeof(dfloat), 0);
@@ -182,87 +222,83 @@ void insRunARK(ins_t *ins){
       
       if(ins->outputForceStep){
         if(((ins->tstep)%(ins->outputForceStep))==0){
-          ins->o_U.copyTo(ins->U);
-          ins->o_P.copyTo(ins->P);
           insForces(ins, ins->time);
         }
       }
 
-      // Update Time-Step Size
-      if(ins->dtAdaptStep){
+      if(ins->probeFlag) insProbes(ins, ins->time);
+
+      if(ins->statSteps){
+        if(((ins->tstep)%(ins->statSteps))==0)
+          insStatistics(ins, ins->time);
+      }
+
+      // Update Time-Step Size, the embedded controller owns dt when present
+      if(ins->dtAdaptStep && !ins->embeddedRKFlag){
         if(((ins->tstep)%(ins->dtAdaptStep))==0){
           if(mesh->rank==0) printf("\n Adapting time Step Size to ");
           insComputeDt(ins, ins->time);
           if(mesh->rank==0) printf("%.4e\n", ins->dt);
+          dtnew = ins->dt;
         }
       }
+      occaTimerToc(mesh->device,"Report");
     }
 
+    ins->dt = dtnew;
 
-
-      
-    
     if (ins->dim==2 && mesh->rank==0) printf("\rtstep = %d, solver iterations: U - %3d, V - %3d, P - %3d", ins->tstep+1, ins->NiterU, ins->NiterV, ins->NiterP); fflush(stdout);
     if (ins->dim==3 && mesh->rank==0) printf("\rtstep = %d, solver iterations: U - %3d, V - %3d, W - %3d, P - %3d", ins->tstep+1, ins->NiterU, ins->NiterV, ins->NiterW, ins->NiterP); fflush(stdout);
-    occaTimerToc(mesh->device,"Report");
-
-
-/*
-    dlong Nlocal = mesh->Nelements*mesh->Np*ins->NVfields;
-    ins->errorEstimateKernel(Nlocal, 
-                            ins->ATOL,
-                            ins->RTOL,
-                            ins->o_U,
-                            ins->o_rkU,
-                            ins->o_NU,
-                            ins->o_LU,
-                            ins->o_erkerr,
-                            ins->o_irkerr,
-                            ins->o_errtmp);
-
-    ins->o_errtmp.copyTo(ins->errtmp);
-    dfloat localerr = 0;
-    dfloat err = 0;
-    for(int n=0;n<ins->Nblock;++n){
-      localerr += ins->errtmp[n];
-    }
-    MPI_Allreduce(&localerr, &err, 1, MPI_DFLOAT, MPI_SUM, mesh->comm);
-
-    err = sqrt(err/(ins->totalElements*mesh->Np*ins->NVfields));
-
-    dfloat fac1 = pow(err,exp1);
-    dfloat fac  = fac1/pow(facold,beta);
+  }
+  occaTimerToc(mesh->device,"INS");
 
-    fac = mymax(invfactor2, mymin(invfactor1,fac/safe));
-    dfloat dtnew = ins->dt/fac;
+  if(ins->outputForceStep) insForcesFlush(ins);
+  if(ins->probeFlag) meshProbeClose(mesh);
 
-    if(err<1.0){
-      ins->o_q.copyFrom(ins->o_rkq);
-      ins->o_pmlqx.copyFrom(ins->o_rkqx);
-      ins->o_pmlqy.copyFrom(ins->o_rkqy);
+  if(ins->embeddedRKFlag && mesh->rank==0)
+    printf("\nARK: %d accepted and %d rejected steps, average dt = %.4e", ins->tstep, ins->rtstep, (ins->time-ins->startTime)/ins->tstep);
 
-      facold = mymax(err,1E-4);
-      ins->time += ins->dt;
+  printf("\n");
+  insReport(ins, ins->time, ins->tstep);
 
-      ins->ins->tstep++;
-    }else{
-      ins->rtstep++; 
-      dtnew = ins->dt/(mymax(invfactor1,fac1/safe));
-      done =0;
-    }
+  insIsoSurfaceClose(ins);
+  
+  if(mesh->rank==0) occa::printTimer();
+}
 
-    ins->dt = dtnew;
-    ins->atstep++;
+// dt and the quantities derived from it
+static void insARKSetDt(ins_t *ins, dfloat dt){
+  ins->dt     = dt;
+  ins->idt    = 1.0/dt;
+  ins->lambda = ins->g0/(dt*ins->nu);
+}
 
-    printf("\rTime = %.4e (%d). Average Dt = %.4e, Rejection rate = %.2g   ", time, ins->tstep, time/(dfloat)ins->tstep, Nregect/(dfloat) ins->tstep); fflush(stdout);
-  */
-  }
-  occaTimerToc(mesh->device,"INS");
+// RMS of the embedded error over all velocity nodes, scaled by ATOL + RTOL|U|
+static dfloat insErrorEstimate(ins_t *ins){
 
+  mesh_t *mesh = ins->mesh;
 
-  dfloat finalTime = ins->NtimeSteps*ins->dt;
-  printf("\n");
-  insReport(ins, finalTime, ins->NtimeSteps);
-  
-  if(mesh->rank==0) occa::printTimer();
+  const dlong Nlocal = mesh->Nelements*mesh->Np;
+  ins->errorEstimateKernel(Nlocal,
+                           ins->ATOL,
+                           ins->RTOL,
+                           ins->dt,
+                           ins->fieldOffset,
+                           ins->o_erkE,
+                           ins->o_irkE,
+                           ins->o_U,
+                           ins->o_rkU,
+                           ins->o_NU,
+                           ins->o_LU,
+                           ins->o_errtmp);
+
+  ins->o_errtmp.copyTo(ins->errtmp, ins->Nblock*sizeof(dfloat));
+
+  // the error and the number of nodes it covers in one reduction
+  dfloat localerr[2] = {0, (dfloat) Nlocal*ins->NVfields}, err[2];
+  for(dlong n=0;n<ins->Nblock;++n)
+    localerr[0] += ins->errtmp[n];
+  MPI_Allreduce(localerr, err, 2, MPI_DFLOAT, MPI_SUM, mesh->comm);
+
+  return sqrt(err[0]/err[1]);
 }
@@ -27,6 +27,7 @@ SOFTWARE.
 #include "ins.h"
 
 void extbdfCoefficents(ins_t *ins, int order);
+static void extbdfSlotCoefficents(ins_t *ins);
 
 void insRunEXTBDF(ins_t *ins){
 
@@ -35,6 +36,10 @@ void insRunEXTBDF(ins_t *ins){
   occa::initTimer(mesh->device);
   occaTimerTic(mesh->device,"INS");
 
+  // byte offsets of the newest slot in the velocity and pressure history
+  size_t Uoffset = insHistorySlot(ins, 0)*ins->NVfields*ins->fieldOffset*sizeof(dfloat);
+  size_t Poffset = insHistorySlot(ins, 0)*ins->fieldOffset*sizeof(dfloat);
+
   int NstokesSteps = 0;
   dfloat oldDt = ins->dt;
   ins->dt *= 100;
@@ -48,7 +53,7 @@ void insRunEXTBDF(ins_t *ins){
     else if(tstep<3 && ins->temporalOrder>=3) 
       extbdfCoefficents(ins,tstep+1);
 
-    insGradient (ins, 0, ins->o_P, ins->o_GP);
+    insGradient (ins, 0, ins->o_P+Poffset, ins->o_GP+Uoffset);
 
     insVelocityRhs  (ins, 0, ins->Nstages, ins->o_rhsU, ins->o_rhsV, ins->o_rhsW);
     insVelocitySolve(ins, 0, ins->Nstages, ins->o_rhsU, ins->o_rhsV, ins->o_rhsW, ins->o_rkU);
@@ -59,31 +64,17 @@ void insRunEXTBDF(ins_t *ins){
     insPressureUpdate(ins, 0, ins->Nstages, ins->o_rkP);
     insGradient(ins, 0, ins->o_rkP, ins->o_rkGP);
 
-    //cycle history
-    for (int s=ins->Nstages;s>1;s--) {
-      ins->o_U.copyFrom(ins->o_U, ins->Ntotal*ins->NVfields*sizeof(dfloat), 
-                                  (s-1)*ins->Ntotal*ins->NVfields*sizeof(dfloat), 
-                                  (s-2)*ins->Ntotal*ins->NVfields*sizeof(dfloat));
-      ins->o_P.copyFrom(ins->o_P, ins->Ntotal*sizeof(dfloat), 
-                                  (s-1)*ins->Ntotal*sizeof(dfloat), 
-                                  (s-2)*ins->Ntotal*sizeof(dfloat));
-    }
-
-    //copy updated pressure
-    ins->o_P.copyFrom(ins->o_rkP, ins->Ntotal*sizeof(dfloat)); 
-
     //update velocity
     insVelocityUpdate(ins, 0, ins->Nstages, ins->o_rkGP, ins->o_rkU);
 
-    //copy updated pressure
-    ins->o_U.copyFrom(ins->o_rkU, ins->NVfields*ins->Ntotal*sizeof(dfloat)); 
+    //cycle history, the oldest slot becomes the newest
+    insHistoryRotate(ins);
+    Uoffset = insHistorySlot(ins, 0)*ins->NVfields*ins->fieldOffset*sizeof(dfloat);
+    Poffset = insHistorySlot(ins, 0)*ins->fieldOffset*sizeof(dfloat);
 
-    //cycle rhs history
-    for (int s=ins->Nstages;s>1;s--) {
-      ins->o_GP.copyFrom(ins->o_GP, ins->Ntotal*ins->NVfields*sizeof(dfloat), 
-                                  (s-1)*ins->Ntotal*ins->NVfields*sizeof(dfloat), 
-                                  (s-2)*ins->Ntotal*ins->NVfields*sizeof(dfloat));
-    }
+    //copy updated pressure and velocity
+    ins->o_P.copyFrom(ins->o_rkP, ins->Ntotal*sizeof(dfloat), Poffset, 0); 
+    ins->o_U.copyFrom(ins->o_rkU, ins->NVfields*ins->Ntotal*sizeof(dfloat), Uoffset, 0); 
 
     if (mesh->rank==0) printf("\rSstep = %d, solver iterations: U - %3d, V - %3d, P - %3d", tstep+1, ins->NiterU, ins->NiterV, ins->NiterP); fflush(stdout);
   }
@@ -124,12 +115,13 @@ void insRunEXTBDF(ins_t *ins){
 #endif
     
     if(ins->Nsubsteps) {
+      // \hat{U} always lands in the first NU slot, the NU history is unused when subcycling
       insSubCycle(ins, time, ins->Nstages, ins->o_U, ins->o_NU);
     } else {
-      insAdvection(ins, time, ins->o_U, ins->o_NU);
+      insAdvection(ins, time, ins->o_U+Uoffset, ins->o_NU+Uoffset);
     }
 
-    insGradient (ins, time, ins->o_P, ins->o_GP);
+    insGradient (ins, time, ins->o_P+Poffset, ins->o_GP+Uoffset);
 
 #if 0
     ins->constrainKernel(mesh->Nelements,
@@ -168,19 +160,6 @@ void insRunEXTBDF(ins_t *ins){
 			 ins->o_rkGP);
 #endif
     
-    //cycle history
-    for (int s=ins->Nstages;s>1;s--) {
-      ins->o_U.copyFrom(ins->o_U, ins->Ntotal*ins->NVfields*sizeof(dfloat), 
-                                  (s-1)*ins->Ntotal*ins->NVfields*sizeof(dfloat), 
-                                  (s-2)*ins->Ntotal*ins->NVfields*sizeof(dfloat));
-      ins->o_P.copyFrom(ins->o_P, ins->Ntotal*sizeof(dfloat), 
-                                  (s-1)*ins->Ntotal*sizeof(dfloat), 
-                                  (s-2)*ins->Ntotal*sizeof(dfloat));
-    }
-
-    //copy updated pressure
-    ins->o_P.copyFrom(ins->o_rkP, ins->Ntotal*sizeof(dfloat)); 
-
     //update velocity
     insVelocityUpdate(ins, time+ins->dt, ins->Nstages, ins->o_rkGP, ins->o_rkU);
 
@@ -195,22 +174,15 @@ void insRunEXTBDF(ins_t *ins){
 			     ins->o_rkU);
       }
     }
-      
-    
 
-    
-    //copy updated pressure
-    ins->o_U.copyFrom(ins->o_rkU, ins->NVfields*ins->Ntotal*sizeof(dfloat)); 
-
-    //cycle rhs history
-    for (int s=ins->Nstages;s>1;s--) {
-      ins->o_NU.copyFrom(ins->o_NU, ins->Ntotal*ins->NVfields*sizeof(dfloat), 
-			 (s-1)*ins->Ntotal*ins->NVfields*sizeof(dfloat), 
-			 (s-2)*ins->Ntotal*ins->NVfields*sizeof(dfloat));
-      ins->o_GP.copyFrom(ins->o_GP, ins->Ntotal*ins->NVfields*sizeof(dfloat), 
-			 (s-1)*ins->Ntotal*ins->NVfields*sizeof(dfloat), 
-			 (s-2)*ins->Ntotal*ins->NVfields*sizeof(dfloat));
-    }
+    //cycle history, the oldest slot becomes the newest
+    insHistoryRotate(ins);
+    Uoffset = insHistorySlot(ins, 0)*ins->NVfields*ins->fieldOffset*sizeof(dfloat);
+    Poffset = insHistorySlot(ins, 0)*ins->fieldOffset*sizeof(dfloat);
+
+    //copy updated pressure and velocity
+    ins->o_P.copyFrom(ins->o_rkP, ins->Ntotal*sizeof(dfloat), Poffset, 0); 
+    ins->o_U.copyFrom(ins->o_rkU, ins->NVfields*ins->Ntotal*sizeof(dfloat), Uoffset, 0); 
 
 
 
@@ -258,6 +230,18 @@ void insRunEXTBDF(ins_t *ins){
       }
     }
 
+    if(ins->outputForceStep){
+      if(((tstep+1)%(ins->outputForceStep))==0)
+        insForces(ins, time+ins->dt);
+    }
+
+    if(ins->probeFlag) insProbes(ins, time+ins->dt);
+
+    if(ins->statSteps){
+      if(((tstep+1)%(ins->statSteps))==0)
+        insStatistics(ins, time+ins->dt);
+    }
+
     if (ins->dim==2 && mesh->rank==0) printf("\rtstep = %d, solver iterations: U - %3d, V - %3d, P - %3d", tstep+1, ins->NiterU, ins->NiterV, ins->NiterP); fflush(stdout);
     if (ins->dim==3 && mesh->rank==0) printf("\rtstep = %d, solver iterations: U - %3d, V - %3d, W - %3d, P - %3d", tstep+1, ins->NiterU, ins->NiterV, ins->NiterW, ins->NiterP); fflush(stdout);
     
@@ -266,10 +250,15 @@ void insRunEXTBDF(ins_t *ins){
   occaTimerToc(mesh->device,"INS");
 
 
+  if(ins->outputForceStep) insForcesFlush(ins);
+  if(ins->probeFlag) meshProbeClose(mesh);
+
   dfloat finalTime = ins->NtimeSteps*ins->dt;
   printf("\n");
 
   if(ins->outputStep) insReport(ins, finalTime,ins->NtimeSteps);
+
+  insIsoSurfaceClose(ins);
   
   if(mesh->rank==0) occa::printTimer();
 }
@@ -335,4 +324,38 @@ void extbdfCoefficents(ins_t *ins, int order) {
     ins->lambda = ins->g0 / (ins->dt * ins->nu);
     ins->ig0 = 1.0/ins->g0; 
   }
+
+  extbdfSlotCoefficents(ins);
+}
+
+// The U, P, NU and GP histories are rings: level age (0 newest) is stored in
+//  slot (historyHead+age)%Nstages, so advancing a step only moves historyHead.
+int insHistorySlot(ins_t *ins, int age){
+  return (ins->historyHead+age)%ins->Nstages;
+}
+
+// make the oldest slot the newest
+void insHistoryRotate(ins_t *ins){
+  ins->historyHead = (ins->historyHead+ins->Nstages-1)%ins->Nstages;
+
+  extbdfSlotCoefficents(ins);
+}
+
+// kernels summing over the history slots take the coefficients in slot order
+static void extbdfSlotCoefficents(ins_t *ins){
+
+  dfloat extbdfA[3] = {0.0f, 0.0f, 0.0f};
+  dfloat extbdfB[3] = {0.0f, 0.0f, 0.0f};
+  dfloat extbdfC[3] = {0.0f, 0.0f, 0.0f};
+
+  for (int age=0;age<ins->Nstages;age++) {
+    const int slot = insHistorySlot(ins, age);
+    extbdfA[slot] = ins->extbdfA[age];
+    extbdfB[slot] = ins->extbdfB[age];
+    extbdfC[slot] = ins->extbdfC[age];
+  }
+
+  ins->o_extbdfSlotA.copyFrom(extbdfA);
+  ins->o_extbdfSlotB.copyFrom(extbdfB);
+  ins->o_extbdfSlotC.copyFrom(extbdfC);
 }
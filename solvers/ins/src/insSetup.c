@@ -115,7 +115,8 @@ ins_t *insSetup(mesh_t *mesh, setupAide options){
     ins->g0 =  1.0/gamma;
     ins->embeddedRKFlag = 0; //no embedded method
   } else if (options.compareArgs("TIME INTEGRATOR", "ARK3")) {
-    ins->Nstages = 4;
+    // explicit first stage plus three implicit stages, tables are Nrk x Nrk
+    ins->Nstages = 3;
     int Nrk = 4;
 
     dfloat erkA[4*4] ={                              0.0,                              0.0,                               0.0, 0.0,\
@@ -149,13 +150,16 @@ ins_t *insSetup(mesh_t *mesh, setupAide options){
                     3.0/5.0, \
                     1.0};
 
+    // pressure increments on P^n as in ARK2: c_s on the diagonal, trapezoidal last stage
     dfloat prkA[4*4] ={  0.0,                             0.0,       0.0,   0.0,\
                          0.0, 1767732205903.0/2027836641118.0,       0.0,   0.0,\
-                         0.5,                             0.0,       0.5,   0.5};
+                         0.0,                             0.0, 3.0/5.0,   0.0,\
+                         0.5,                             0.0,       0.0,   0.5};
 
     dfloat prkB[4*4] ={  0.0,                             0.0,       0.0,   0.0,\
-                         0.0, 1767732205903.0/2027836641118.0,       0.0,   0.0,\
-                         0.5,                             0.0,       0.5,   0.5};
+                         1.0,                             0.0,       0.0,   0.0,\
+                         1.0,                             0.0,       0.0,   0.0,\
+                         1.0,                             0.0,       0.0,   0.0};
 
     ins->Nrk = Nrk;
     ins->erkA = (dfloat*) calloc(ins->Nrk*ins->Nrk, sizeof(dfloat));
@@ -188,8 +192,6 @@ ins_t *insSetup(mesh_t *mesh, setupAide options){
     ins->extbdfA = (dfloat*) calloc(3, sizeof(dfloat));
     ins->extbdfB = (dfloat*) calloc(3, sizeof(dfloat));
     ins->extbdfC = (dfloat*) calloc(3, sizeof(dfloat));
-
-    ins->extC = (dfloat*) calloc(3, sizeof(dfloat));
   }
 
   if (options.compareArgs("TIME INTEGRATOR", "EXTBDF1")) {
@@ -214,6 +216,10 @@ ins_t *insSetup(mesh_t *mesh, setupAide options){
 
 
 
+  // keep host copies of the solver fields unless HOST SHADOWS = NONE
+  ins->hostShadows = options.compareArgs("HOST SHADOWS", "NONE") ? 0 : 1;
+  ins->hostBytesSaved = 0;
+
   dlong Nlocal = mesh->Np*mesh->Nelements;
   dlong Ntotal = mesh->Np*(mesh->Nelements+mesh->totalHaloPairs);
   
@@ -222,37 +228,37 @@ ins_t *insSetup(mesh_t *mesh, setupAide options){
   ins->Nblock = (Nlocal+blockSize-1)/blockSize;
 
   // compute samples of q at interpolation nodes
-  ins->U     = (dfloat*) calloc(ins->NVfields*ins->Nstages*Ntotal,sizeof(dfloat));
-  ins->P     = (dfloat*) calloc(              ins->Nstages*Ntotal,sizeof(dfloat));
+  ins->U     = insHostShadow(ins, ins->NVfields*ins->Nstages*Ntotal);
+  ins->P     = insHostShadow(ins, ins->Nstages*Ntotal);
 
   //rhs storage
-  ins->rhsU  = (dfloat*) calloc(Ntotal,sizeof(dfloat));
-  ins->rhsV  = (dfloat*) calloc(Ntotal,sizeof(dfloat));
-  ins->rhsW  = (dfloat*) calloc(Ntotal,sizeof(dfloat));
-  ins->rhsP  = (dfloat*) calloc(Ntotal,sizeof(dfloat));
+  ins->rhsU  = insHostShadow(ins, Ntotal);
+  ins->rhsV  = insHostShadow(ins, Ntotal);
+  ins->rhsW  = insHostShadow(ins, Ntotal);
+  ins->rhsP  = insHostShadow(ins, Ntotal);
 
   //additional field storage
-  ins->NU   = (dfloat*) calloc(ins->NVfields*(ins->Nstages+1)*Ntotal,sizeof(dfloat));
-  ins->LU   = (dfloat*) calloc(ins->NVfields*(ins->Nstages+1)*Ntotal,sizeof(dfloat));
-  ins->GP   = (dfloat*) calloc(ins->NVfields*(ins->Nstages+1)*Ntotal,sizeof(dfloat));
+  ins->NU   = insHostShadow(ins, ins->NVfields*(ins->Nstages+1)*Ntotal);
+  ins->LU   = insHostShadow(ins, ins->NVfields*(ins->Nstages+1)*Ntotal);
+  ins->GP   = insHostShadow(ins, ins->NVfields*(ins->Nstages+1)*Ntotal);
 
-  ins->GU   = (dfloat*) calloc(ins->NVfields*Ntotal*4,sizeof(dfloat));
+  ins->GU   = insHostShadow(ins, ins->NVfields*Ntotal*4);
   
-  ins->rkU  = (dfloat*) calloc(ins->NVfields*Ntotal,sizeof(dfloat));
-  ins->rkP  = (dfloat*) calloc(              Ntotal,sizeof(dfloat));
-  ins->PI   = (dfloat*) calloc(              Ntotal,sizeof(dfloat));
+  ins->rkU  = insHostShadow(ins, ins->NVfields*Ntotal);
+  ins->rkP  = insHostShadow(ins, Ntotal);
+  ins->PI   = insHostShadow(ins, Ntotal);
   
-  ins->rkNU = (dfloat*) calloc(ins->NVfields*Ntotal,sizeof(dfloat));
-  ins->rkLU = (dfloat*) calloc(ins->NVfields*Ntotal,sizeof(dfloat));
-  ins->rkGP = (dfloat*) calloc(ins->NVfields*Ntotal,sizeof(dfloat));
+  ins->rkNU = insHostShadow(ins, ins->NVfields*Ntotal);
+  ins->rkLU = insHostShadow(ins, ins->NVfields*Ntotal);
+  ins->rkGP = insHostShadow(ins, ins->NVfields*Ntotal);
 
   //plotting fields
-  ins->Vort = (dfloat*) calloc(ins->NVfields*Ntotal,sizeof(dfloat));
-  ins->Div  = (dfloat*) calloc(              Nlocal,sizeof(dfloat));
+  ins->Vort = insHostShadow(ins, ins->NVfields*Ntotal);
+  ins->Div  = insHostShadow(ins, Nlocal);
 
   //extra storage for interpolated fields
   if(ins->elementType==HEXAHEDRA)
-    ins->cU = (dfloat *) calloc(ins->NVfields*mesh->Nelements*mesh->cubNp,sizeof(dfloat));
+    ins->cU = insHostShadow(ins, ins->NVfields*mesh->Nelements*mesh->cubNp);
   else 
     ins->cU = ins->U;
 
@@ -261,13 +267,13 @@ ins_t *insSetup(mesh_t *mesh, setupAide options){
     options.getArgs("SUBCYCLING STEPS",ins->Nsubsteps);
 
   if(ins->Nsubsteps){
-    ins->Ud    = (dfloat*) calloc(ins->NVfields*Ntotal,sizeof(dfloat));
-    ins->Ue    = (dfloat*) calloc(ins->NVfields*Ntotal,sizeof(dfloat));
-    ins->resU  = (dfloat*) calloc(ins->NVfields*Ntotal,sizeof(dfloat));
-    ins->rhsUd = (dfloat*) calloc(ins->NVfields*Ntotal,sizeof(dfloat));
+    ins->Ud    = insHostShadow(ins, ins->NVfields*Ntotal);
+    ins->Ue    = insHostShadow(ins, ins->NVfields*Ntotal);
+    ins->resU  = insHostShadow(ins, ins->NVfields*Ntotal);
+    ins->rhsUd = insHostShadow(ins, ins->NVfields*Ntotal);
 
     if(ins->elementType==HEXAHEDRA)
-      ins->cUd = (dfloat *) calloc(ins->NVfields*mesh->Nelements*mesh->cubNp,sizeof(dfloat));
+      ins->cUd = insHostShadow(ins, ins->NVfields*mesh->Nelements*mesh->cubNp);
     else 
       ins->cUd = ins->U;
 
@@ -376,8 +382,18 @@ ins_t *insSetup(mesh_t *mesh, setupAide options){
   options.getArgs("DATA FILE", boundaryHeaderFileName);
   kernelInfo["includes"] += (char*)boundaryHeaderFileName.c_str();
 
-  ins->o_U = mesh->device.malloc(ins->NVfields*ins->Nstages*Ntotal*sizeof(dfloat), ins->U);
-  ins->o_P = mesh->device.malloc(              ins->Nstages*Ntotal*sizeof(dfloat), ins->P);
+  // EXTBDF history terms shared by the velocity rhs kernels
+  kernelInfo["includes"] += DINS "/okl/insVelocityHistory.h";
+
+  // fields without a host shadow are zeroed on the device
+  for (int r=0;r<mesh->size;r++) {
+    if (r==mesh->rank)
+      ins->setValueKernel = mesh->device.buildKernel(DHOLMES "/okl/setValue.okl", "setValue", kernelInfo);
+    MPI_Barrier(mesh->comm);
+  }
+
+  ins->o_U = insDeviceField(ins, ins->NVfields*ins->Nstages*Ntotal, ins->U);
+  ins->o_P = insDeviceField(ins, ins->Nstages*Ntotal, ins->P);
 
 #if 0
   if (mesh->rank==0 && options.compareArgs("VERBOSE","TRUE")) 
@@ -390,6 +406,7 @@ ins_t *insSetup(mesh_t *mesh, setupAide options){
 if(options.compareArgs("INITIAL CONDITION", "BROWN-MINION") &&
   (ins->elementType == QUADRILATERALS && ins->dim==3)){
   printf("Setting up initial condition for BROWN-MINION test case...");
+  insHostStage(ins, 0);
   insBrownMinionQuad3D(ins);
   ins->o_U.copyFrom(ins->U);
   ins->o_P.copyFrom(ins->P);
@@ -422,50 +439,38 @@ if(options.compareArgs("INITIAL CONDITION", "BROWN-MINION") &&
                           ins->fieldOffset,
                           ins->o_U,
                           ins->o_P);
-  ins->o_U.copyTo(ins->U);
 
 }
 
-  // set time step
-  dfloat hmin = 1e9, hmax = 0;
-  dfloat umax = 0;
-  for(dlong e=0;e<mesh->Nelements;++e){
-
-    if(ins->elementType==TRIANGLES || ins->elementType == TETRAHEDRA){
-      for(int f=0;f<mesh->Nfaces;++f){
-        dlong sid = mesh->Nsgeo*(mesh->Nfaces*e + f);
-        dfloat sJ   = mesh->sgeo[sid + SJID];
-        dfloat invJ = mesh->sgeo[sid + IJID];
+  // stage the initial velocity on the host for the time step estimate
+  dfloat *U0 = ins->U ? ins->U : (dfloat*) calloc(ins->NVfields*Ntotal, sizeof(dfloat));
+  ins->o_U.copyTo(U0, ins->NVfields*Ntotal*sizeof(dfloat));
 
-        dfloat hest = 2./(sJ*invJ);
+  // set time step from the per-element length scales the device CFL reduction uses
+  dfloat *elementHmin = meshElementHmin(mesh, ins->elementType);
 
-        hmin = mymin(hmin, hest);
-        hmax = mymax(hmax, hest);
-      }
-    }else{
-      for(int f=0;f<mesh->Nfaces;++f){
-        for(int n=0; n<mesh->Nfp; n++){
-        dlong sid = mesh->Nsgeo*(mesh->Nfaces*mesh->Nfp*e + f*mesh->Nfp + n);
-        dfloat sJ   = mesh->sgeo[sid + SJID];
-        dfloat invJ = mesh->sgeo[sid + IJID];
+  dfloat localHmin = 1e9, localHmax = 0;
+  for(dlong e=0;e<mesh->Nelements;++e){
+    localHmin = mymin(localHmin, elementHmin[e]);
+    localHmax = mymax(localHmax, elementHmin[e]);
+  }
 
-        dfloat hest = 2./(sJ*invJ);
+  dfloat hmin, hmax;
+  MPI_Allreduce(&localHmin, &hmin, 1, MPI_DFLOAT, MPI_MIN, mesh->comm);
+  MPI_Allreduce(&localHmax, &hmax, 1, MPI_DFLOAT, MPI_MAX, mesh->comm);
 
-        hmin = mymin(hmin, hest);
-        hmax = mymax(hmax, hest);
-      }
-    }
-  }
+  dfloat umax = 0;
+  for(dlong e=0;e<mesh->Nelements;++e){
 
      // dfloat maxMagVecLoc = 0;
 
     for(int n=0;n<mesh->Np;++n){
       const dlong id = n + mesh->Np*e;
       dfloat t = 0;
-      dfloat uxn = ins->U[id+0*ins->fieldOffset];
-      dfloat uyn = ins->U[id+1*ins->fieldOffset];
+      dfloat uxn = U0[id+0*ins->fieldOffset];
+      dfloat uyn = U0[id+1*ins->fieldOffset];
       dfloat uzn = 0.0;
-      if (ins->dim==3) uzn = ins->U[id+2*ins->fieldOffset];
+      if (ins->dim==3) uzn = U0[id+2*ins->fieldOffset];
 
 
       //Squared maximum velocity
@@ -479,6 +484,8 @@ if(options.compareArgs("INITIAL CONDITION", "BROWN-MINION") &&
     }
   }
 
+  if(U0!=ins->U) free(U0);
+
   // Maximum Velocity
   umax = sqrt(umax);
   dfloat magVel = mymax(umax,1.0); // Correction for initial zero velocity
@@ -535,103 +542,9 @@ if(options.compareArgs("INITIAL CONDITION", "BROWN-MINION") &&
   ins->outputForceStep = 0;
   options.getArgs("TSTEPS FOR FORCE OUTPUT", ins->outputForceStep);
 
+  ins->statSteps = 0;
+  options.getArgs("TSTEPS FOR STATISTICS", ins->statSteps);
 
-  //!!!!! Isosurface Setup !! remove those to seoperate library later !!!!
-  if(ins->dim==3 && options.compareArgs("OUTPUT TYPE", "ISO"))
-  {
-    
-    // Only one field is exported for iso-surface to reduce the file size
-    ins->isoNfields  = 1;   //1 + (ins->dim) + (1 + ins->dim) ; // p, u.v,w, vort_x, vort_y, vort_z, wort_mag 
-    ins->isoMaxNtris = 1.E7; 
-    //
-    options.getArgs("ISOSURFACE FIELD ID", ins->isoField); 
-    options.getArgs("ISOSURFACE COLOR ID", ins->isoColorField); 
-    options.getArgs("ISOSURFACE LEVEL NUMBER", ins->isoNlevels);
-    options.getArgs("ISOSURFACE CONTOUR MAX", ins->isoMaxVal); 
-    options.getArgs("ISOSURFACE CONTOUR MIN", ins->isoMinVal);
-
-    ins->isoMax    = (ins->dim + ins->isoNfields)*3*ins->isoMaxNtris;
-    ins->isoNtris  = (int*) calloc(1, sizeof(int));
-    ins->isoq      = (dfloat*) calloc(ins->isoMax, sizeof(dfloat)); 
-
-    ins->o_isoq      = mesh->device.malloc(ins->isoMax*sizeof(dfloat), ins->isoq);
-    ins->o_isoNtris  = mesh->device.malloc(1*sizeof(int), ins->isoNtris);
-
-    // Create all contour levels
-    dfloat *isoLevels = (dfloat*) calloc(ins->isoNlevels, sizeof(dfloat));
-    for(int l=0;l<ins->isoNlevels;++l)
-      isoLevels[l] = ins->isoMinVal + (ins->isoMaxVal-ins->isoMinVal)*l/(dfloat)(ins->isoNlevels-1);
-
-
-
-    // GROUP LEVELS of ISOCONTOURS
-
-    int levelsInGroup = 0; 
-    options.getArgs("ISOSURFACE GROUP NUMBER", levelsInGroup);
-
-    if(levelsInGroup==0) {printf("Number of levels in each group can not be zero!!!\n");  exit(EXIT_FAILURE);} 
-    if(levelsInGroup){
-
-      // Number of groups for isosurfaces
-      ins->isoGNgroups        = ins->isoNlevels/(levelsInGroup);  
-      if(ins->isoNlevels%(levelsInGroup))
-        ins->isoGNgroups++; 
-
-      ins->isoGNlevels        = (int *) calloc(ins->isoGNgroups,sizeof(int));
-      ins->isoGLvalues        = (dfloat **) calloc(ins->isoGNgroups,sizeof(dfloat*));
-
-      for(int gr =0; gr<ins->isoGNgroups; gr++)
-      {
-        int nlevels = (gr+1)*levelsInGroup > ins->isoNlevels ? (ins->isoNlevels%levelsInGroup) : levelsInGroup;  
-        ins->isoGNlevels[gr] = nlevels;  
-        printf("Isosurface Group %d has %d levels\n", gr, ins->isoGNlevels[gr]);
-      }
-
-      // Allocate memory for levels in each group
-      for (int gr =0;gr<ins->isoGNgroups;gr++)
-        ins->isoGLvalues[gr] = (dfloat *) calloc(ins->isoGNlevels[gr],sizeof(dfloat));
-
-      int sk = 0; 
-      for (int gr =0;gr<ins->isoGNgroups;gr++){
-        printf("Isosurface Group %d Values\n", gr);        
-        for (int l=0;l<ins->isoGNlevels[gr];l++){
-          ins->isoGLvalues[gr][l] = isoLevels[sk + l];
-          printf("%.4f\t", ins->isoGLvalues[gr][l]);
-        }
-        printf("\n");
-      sk += ins->isoGNlevels[gr]; 
-      }
-
-      // Create levels for each group
-      ins->o_isoGLvalues     = (occa::memory *) malloc(ins->isoGNgroups*sizeof(occa::memory));
-      for (int gr =0;gr<ins->isoGNgroups;gr++)
-        ins->o_isoGLvalues[gr] = mesh->device.malloc(ins->isoGNlevels[gr]*sizeof(dfloat),ins->isoGLvalues[gr]);
-    
-    }
-
-    // Interpolation operators form Np to PlotNp (equisapaced nodes of order >N generally)
-    dfloat *plotInterp = (dfloat*) calloc(mesh->plotNp*mesh->Np, sizeof(dfloat));
-    for(int n=0;n<mesh->plotNp;++n){
-      for(int m=0;m<mesh->Np;++m){
-        plotInterp[n+m*mesh->plotNp] = mesh->plotInterp[n*mesh->Np+m];
-      }
-    }
-    ins->o_plotInterp = mesh->device.malloc(mesh->plotNp*mesh->Np*sizeof(dfloat), plotInterp);
-
-    // EToV for local triangulation
-    int *plotEToV = (int*) calloc(mesh->plotNp*mesh->Np, sizeof(int));
-    for(int n=0;n<mesh->plotNelements;++n){
-      for(int m=0;m<mesh->plotNverts;++m){
-        plotEToV[n+m*mesh->plotNelements] = mesh->plotEToV[n*mesh->plotNverts+m];
-      }
-    }
-    ins->o_plotEToV = mesh->device.malloc(mesh->plotNp*mesh->Np*sizeof(int), plotEToV);
-
-
-  }
-
-  
-  
 
   //make option objects for elliptc solvers
   ins->vOptions = options;
@@ -778,10 +691,6 @@ if(options.compareArgs("INITIAL CONDITION", "BROWN-MINION") &&
   
   // IsoSurface related
   if(ins->dim==3 && ins->elementType != QUADRILATERALS ){
-    kernelInfo["defines/" "p_isoNfields"]= ins->isoNfields;
-    // Define Isosurface Area Tolerance
-    kernelInfo["defines/" "p_triAreaTol"]= (dfloat) 1.0E-16;
-
     kernelInfo["defines/" "p_dim"]= ins->dim;
     kernelInfo["defines/" "p_plotNp"]= mesh->plotNp;
     kernelInfo["defines/" "p_plotNelements"]= mesh->plotNelements;
@@ -807,6 +716,17 @@ if(options.compareArgs("INITIAL CONDITION", "BROWN-MINION") &&
     ins->o_irkA = mesh->device.malloc(ins->Nrk*ins->Nrk*sizeof(dfloat),ins->irkA);
     ins->o_prkA = mesh->device.malloc(ins->Nrk*ins->Nrk*sizeof(dfloat),ins->prkA);
     ins->o_prkB = mesh->device.malloc(ins->Nrk*ins->Nrk*sizeof(dfloat),ins->prkB);
+
+    if(ins->embeddedRKFlag){
+      ins->o_erkE = mesh->device.malloc(ins->Nrk*sizeof(dfloat),ins->erkE);
+      ins->o_irkE = mesh->device.malloc(ins->Nrk*sizeof(dfloat),ins->irkE);
+
+      ins->ATOL = 1.0; options.getArgs("ABSOLUTE TOLERANCE", ins->ATOL);
+      ins->RTOL = 1.0; options.getArgs("RELATIVE TOLERANCE", ins->RTOL);
+
+      ins->errtmp   = (dfloat*) calloc(ins->Nblock, sizeof(dfloat));
+      ins->o_errtmp = mesh->device.malloc(ins->Nblock*sizeof(dfloat), ins->errtmp);
+    }
   }
 
   if (options.compareArgs("TIME INTEGRATOR", "EXTBDF")) {
@@ -817,43 +737,61 @@ if(options.compareArgs("INITIAL CONDITION", "BROWN-MINION") &&
     ins->o_extbdfB = mesh->device.malloc(3*sizeof(dfloat));
     ins->o_extbdfC = mesh->device.malloc(3*sizeof(dfloat)); 
 
-    ins->o_extC = mesh->device.malloc(3*sizeof(dfloat)); 
+    ins->o_extbdfSlotA = mesh->device.malloc(3*sizeof(dfloat));
+    ins->o_extbdfSlotB = mesh->device.malloc(3*sizeof(dfloat));
+    ins->o_extbdfSlotC = mesh->device.malloc(3*sizeof(dfloat));
+    ins->historyHead = 0;
+
+    // subcycling extrapolation weights for all stages of a step
+    dlong NextC = ins->Nsubsteps ? 3*3*ins->Nsubsteps*ins->SNrk : 3;
+    ins->extC   = (dfloat*) calloc(NextC, sizeof(dfloat));
+    ins->o_extC = mesh->device.malloc(NextC*sizeof(dfloat), ins->extC); 
 
     ins->o_prkA = ins->o_extbdfC;
     ins->o_prkB = ins->o_extbdfC;
   }
 
   // MEMORY ALLOCATION
-  ins->o_rhsU  = mesh->device.malloc(Ntotal*sizeof(dfloat), ins->rhsU);
-  ins->o_rhsV  = mesh->device.malloc(Ntotal*sizeof(dfloat), ins->rhsV);
-  ins->o_rhsW  = mesh->device.malloc(Ntotal*sizeof(dfloat), ins->rhsW);
-  ins->o_rhsP  = mesh->device.malloc(Ntotal*sizeof(dfloat), ins->rhsP);
-
-  ins->o_NU    = mesh->device.malloc(ins->NVfields*(ins->Nstages+1)*Ntotal*sizeof(dfloat), ins->NU);
-  ins->o_LU    = mesh->device.malloc(ins->NVfields*(ins->Nstages+1)*Ntotal*sizeof(dfloat), ins->LU);
-  ins->o_GP    = mesh->device.malloc(ins->NVfields*(ins->Nstages+1)*Ntotal*sizeof(dfloat), ins->GP);
+  ins->o_rhsU  = insDeviceField(ins, Ntotal, ins->rhsU);
+  ins->o_rhsV  = insDeviceField(ins, Ntotal, ins->rhsV);
+  ins->o_rhsW  = insDeviceField(ins, Ntotal, ins->rhsW);
+  ins->o_rhsP  = insDeviceField(ins, Ntotal, ins->rhsP);
+
+  ins->o_NU    = insDeviceField(ins, ins->NVfields*(ins->Nstages+1)*Ntotal, ins->NU);
+  ins->o_LU    = insDeviceField(ins, ins->NVfields*(ins->Nstages+1)*Ntotal, ins->LU);
+  ins->o_GP    = insDeviceField(ins, ins->NVfields*(ins->Nstages+1)*Ntotal, ins->GP);
   
-  ins->o_GU    = mesh->device.malloc(ins->NVfields*Ntotal*4*sizeof(dfloat), ins->GU);
+  ins->o_GU    = insDeviceField(ins, ins->NVfields*Ntotal*4, ins->GU);
   
-  ins->o_rkU   = mesh->device.malloc(ins->NVfields*Ntotal*sizeof(dfloat), ins->rkU);
-  ins->o_rkP   = mesh->device.malloc(              Ntotal*sizeof(dfloat), ins->rkP);
-  ins->o_PI    = mesh->device.malloc(              Ntotal*sizeof(dfloat), ins->PI);
+  ins->o_rkU   = insDeviceField(ins, ins->NVfields*Ntotal, ins->rkU);
+  ins->o_rkP   = insDeviceField(ins, Ntotal, ins->rkP);
+  ins->o_PI    = insDeviceField(ins, Ntotal, ins->PI);
   
-  ins->o_rkNU  = mesh->device.malloc(ins->NVfields*Ntotal*sizeof(dfloat), ins->rkNU);
-  ins->o_rkLU  = mesh->device.malloc(ins->NVfields*Ntotal*sizeof(dfloat), ins->rkLU);
-  ins->o_rkGP  = mesh->device.malloc(ins->NVfields*Ntotal*sizeof(dfloat), ins->rkGP);
+  ins->o_rkNU  = insDeviceField(ins, ins->NVfields*Ntotal, ins->rkNU);
+  ins->o_rkLU  = insDeviceField(ins, ins->NVfields*Ntotal, ins->rkLU);
+  ins->o_rkGP  = insDeviceField(ins, ins->NVfields*Ntotal, ins->rkGP);
 
   //storage for helmholtz solves
   ins->o_UH = mesh->device.malloc(Ntotal*sizeof(dfloat));
   ins->o_VH = mesh->device.malloc(Ntotal*sizeof(dfloat));
   ins->o_WH = mesh->device.malloc(Ntotal*sizeof(dfloat));
 
+  // per-element length scale and block maxima for the device CFL reduction
+  ins->NcflBlock   = (mesh->Nelements+blockSize-1)/blockSize;
+  ins->cflBlockMax = (dfloat*) calloc(ins->NcflBlock+1, sizeof(dfloat));
+  ins->o_hmin        = mesh->device.malloc((mesh->Nelements+1)*sizeof(dfloat), elementHmin);
+  ins->o_cflBlockMax = mesh->device.malloc((ins->NcflBlock+1)*sizeof(dfloat), ins->cflBlockMax);
+  free(elementHmin);
+
+  // boundary faces and weights for the device force integration
+  insForcesSetup(ins);
+
   //plotting fields
-  ins->o_Vort = mesh->device.malloc(ins->NVfields*Ntotal*sizeof(dfloat), ins->Vort);
-  ins->o_Div  = mesh->device.malloc(              Nlocal*sizeof(dfloat), ins->Div);
+  ins->o_Vort = insDeviceField(ins, ins->NVfields*Ntotal, ins->Vort);
+  ins->o_Div  = insDeviceField(ins, Nlocal, ins->Div);
 
   if(ins->elementType==HEXAHEDRA) // !!!! check that
-    ins->o_cU = mesh->device.malloc(ins->NVfields*mesh->Nelements*mesh->cubNp*sizeof(dfloat), ins->cU);
+    ins->o_cU = insDeviceField(ins, ins->NVfields*mesh->Nelements*mesh->cubNp, ins->cU);
   else 
     ins->o_cU = ins->o_U;
 
@@ -908,6 +846,11 @@ if(options.compareArgs("INITIAL CONDITION", "BROWN-MINION") &&
 
   char fileName[BUFSIZ], kernelName[BUFSIZ];
 
+  // continuous EXTBDF builds its whole velocity rhs in one kernel
+  ins->velocityRhsFused = options.compareArgs("TIME INTEGRATOR", "EXTBDF")
+                       && ins->vOptions.compareArgs("DISCRETIZATION", "CONTINUOUS")
+                       && !(ins->dim==3 && ins->elementType==QUADRILATERALS);
+
   for (int r=0;r<mesh->size;r++) {
     if (r==mesh->rank) {
 
@@ -1001,6 +944,11 @@ if(options.compareArgs("INITIAL CONDITION", "BROWN-MINION") &&
 
         sprintf(kernelName, "insVelocityAddBC%s", suffix);
         ins->velocityAddBCKernel =  mesh->device.buildKernel(fileName, kernelName, kernelInfo);
+
+        if (ins->velocityRhsFused) {
+          sprintf(kernelName, "insVelocityRhsBCEXTBDF%s", suffix);
+          ins->velocityRhsBCExtbdfKernel =  mesh->device.buildKernel(fileName, kernelName, kernelInfo);
+        }
       }
 
       // ===========================================================================
@@ -1030,7 +978,31 @@ if(options.compareArgs("INITIAL CONDITION", "BROWN-MINION") &&
 
       sprintf(fileName, DINS "/okl/insVelocityUpdate.okl");
       sprintf(kernelName, "insVelocityUpdate");
-      ins->velocityUpdateKernel =  mesh->device.buildKernel(fileName, kernelName, kernelInfo);      
+      ins->velocityUpdateKernel =  mesh->device.buildKernel(fileName, kernelName, kernelInfo);
+
+      sprintf(fileName, DINS "/okl/insCfl.okl");
+      sprintf(kernelName, "insCfl");
+      ins->cflKernel =  mesh->device.buildKernel(fileName, kernelName, kernelInfo);
+
+      sprintf(fileName, DINS "/okl/insForces.okl");
+      sprintf(kernelName, "insForces");
+      ins->forcesKernel =  mesh->device.buildKernel(fileName, kernelName, kernelInfo);      
+
+      if(ins->statSteps){
+        // 2D vorticity has a single (z) component
+        occa::properties kernelInfoS = kernelInfo;
+        kernelInfoS["defines/" "p_NVort"]= (ins->dim==2) ? 1 : ins->NVfields;
+
+        sprintf(fileName, DINS "/okl/insStatistics.okl");
+        sprintf(kernelName, "insStatistics");
+        ins->statisticsKernel =  mesh->device.buildKernel(fileName, kernelName, kernelInfoS);
+      }
+
+      if(ins->embeddedRKFlag){
+        sprintf(fileName, DINS "/okl/insErrorEstimate.okl");
+        sprintf(kernelName, "insErrorEstimate");
+        ins->errorEstimateKernel =  mesh->device.buildKernel(fileName, kernelName, kernelInfo);
+      }
 
       // ===========================================================================
 
@@ -1039,24 +1011,29 @@ if(options.compareArgs("INITIAL CONDITION", "BROWN-MINION") &&
       ins->vorticityKernel =  mesh->device.buildKernel(fileName, kernelName, kernelInfo);
     
       // ===========================================================================
-      if(ins->dim==3 && ins->options.compareArgs("OUTPUT TYPE","ISO")){
+      if(ins->dim==3 && ins->elementType!=QUADRILATERALS && ins->options.compareArgs("OUTPUT TYPE","ISO")){
         sprintf(fileName, DINS "/okl/insIsoSurface3D.okl");
-        sprintf(kernelName, "insIsoSurface3D");
+        sprintf(kernelName, "insIsoSurfacePlot3D");
+        ins->isoPlotKernel = mesh->device.buildKernel(fileName, kernelName, kernelInfo);  
 
-        ins->isoSurfaceKernel = mesh->device.buildKernel(fileName, kernelName, kernelInfo);  
+        sprintf(kernelName, "insIsoSurfaceEdges3D");
+        ins->isoEdgesKernel = mesh->device.buildKernel(fileName, kernelName, kernelInfo);  
+
+        sprintf(kernelName, "insIsoSurfaceTris3D");
+        ins->isoTrisKernel = mesh->device.buildKernel(fileName, kernelName, kernelInfo);  
       }
       
 
       // Not implemented for Quad 3D yet !!!!!!!!!!
       if(ins->Nsubsteps){
         // Note that resU and resV can be replaced with already introduced buffer
-        ins->o_Ue    = mesh->device.malloc(ins->NVfields*Ntotal*sizeof(dfloat), ins->Ue);
-        ins->o_Ud    = mesh->device.malloc(ins->NVfields*Ntotal*sizeof(dfloat), ins->Ud);
-        ins->o_resU  = mesh->device.malloc(ins->NVfields*Ntotal*sizeof(dfloat), ins->resU);
-        ins->o_rhsUd = mesh->device.malloc(ins->NVfields*Ntotal*sizeof(dfloat), ins->rhsUd);
+        ins->o_Ue    = insDeviceField(ins, ins->NVfields*Ntotal, ins->Ue);
+        ins->o_Ud    = insDeviceField(ins, ins->NVfields*Ntotal, ins->Ud);
+        ins->o_resU  = insDeviceField(ins, ins->NVfields*Ntotal, ins->resU);
+        ins->o_rhsUd = insDeviceField(ins, ins->NVfields*Ntotal, ins->rhsUd);
 
         if(ins->elementType==HEXAHEDRA)
-          ins->o_cUd = mesh->device.malloc(ins->NVfields*mesh->Nelements*mesh->cubNp*sizeof(dfloat), ins->cUd);
+          ins->o_cUd = insDeviceField(ins, ins->NVfields*mesh->Nelements*mesh->cubNp, ins->cUd);
         else 
           ins->o_cUd = ins->o_Ud;
 
@@ -1088,6 +1065,18 @@ if(options.compareArgs("INITIAL CONDITION", "BROWN-MINION") &&
     MPI_Barrier(mesh->comm);
   }
 
+  insProbesSetup(ins, kernelInfo);
+
+  insStatisticsSetup(ins);
+
+  insIsoSurfaceSetup(ins);
+
+  if(!ins->hostShadows){
+    dfloat savedL = ins->hostBytesSaved/(1024.*1024.), saved = 0;
+    MPI_Allreduce(&savedL, &saved, 1, MPI_DFLOAT, MPI_SUM, mesh->comm);
+    if(mesh->rank==0) printf("HOST SHADOWS = NONE: %g MB of host field copies not allocated\n", saved);
+  }
+
   return ins;
 }
 
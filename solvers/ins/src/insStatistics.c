@@ -0,0 +1,238 @@
+/*
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Tim Warburton, Noel Chalmers, Jesse Chan, Ali Karakus
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "ins.h"
+
+// device buffers of the running statistics, zero until the first sample
+void insStatisticsSetup(ins_t *ins){
+
+  mesh_t *mesh = ins->mesh;
+  if(!ins->statSteps) return;
+
+  ins->statMoments = 2;
+  ins->options.getArgs("STATISTICS MOMENTS", ins->statMoments);
+
+  ins->statStartTime = ins->startTime;
+  ins->options.getArgs("STATISTICS START TIME", ins->statStartTime);
+
+  // velocity, pressure and vorticity (one component in 2D); co-moments uv[, uw, vw]
+  const int NVort  = (ins->dim==2) ? 1 : ins->NVfields;
+  ins->NstatFields = ins->NVfields+1+NVort;
+  ins->NstatUU     = ins->NVfields*(ins->NVfields-1)/2;
+  ins->statCount   = 0;
+
+  ins->o_statMean = insDeviceField(ins, ins->NstatFields*ins->fieldOffset, NULL);
+  if(ins->statMoments>1){
+    ins->o_statM2 = insDeviceField(ins, ins->NstatFields*ins->fieldOffset, NULL);
+    ins->o_statUU = insDeviceField(ins, ins->NstatUU*ins->fieldOffset, NULL);
+  }else{
+    ins->o_statM2 = ins->o_statMean;
+    ins->o_statUU = ins->o_statMean;
+  }
+
+  if(mesh->rank==0)
+    printf("Statistics: moments up to order %d every %d steps from t = %g\n",
+           ins->statMoments, ins->statSteps, ins->statStartTime);
+}
+
+// add the newest velocity, pressure and vorticity to the running statistics
+void insStatistics(ins_t *ins, dfloat time){
+
+  mesh_t *mesh = ins->mesh;
+  if(time<ins->statStartTime) return;
+
+  occa::memory o_Un = ins->o_U + insHistorySlot(ins, 0)*ins->NVfields*ins->fieldOffset*sizeof(dfloat);
+  occa::memory o_Pn = ins->o_P + insHistorySlot(ins, 0)*ins->fieldOffset*sizeof(dfloat);
+
+  ins->vorticityKernel(mesh->Nelements,
+                       mesh->o_vgeo,
+                       mesh->o_Dmatrices,
+                       ins->fieldOffset,
+                       o_Un,
+                       ins->o_Vort);
+
+  ins->statCount++;
+
+  ins->statisticsKernel(mesh->Nelements,
+                        ins->fieldOffset,
+                        1.0/ins->statCount,
+                        (int) (ins->statMoments>1),
+                        o_Un,
+                        o_Pn,
+                        ins->o_Vort,
+                        ins->o_statMean,
+                        ins->o_statM2,
+                        ins->o_statUU);
+}
+
+// stage the raw statistics on the host for output and restart
+void insStatisticsCopyToHost(ins_t *ins){
+
+  if(!ins->statMean) ins->statMean = (dfloat*) calloc(ins->NstatFields*ins->fieldOffset, sizeof(dfloat));
+  ins->o_statMean.copyTo(ins->statMean, ins->NstatFields*ins->fieldOffset*sizeof(dfloat));
+
+  if(ins->statMoments>1){
+    if(!ins->statM2) ins->statM2 = (dfloat*) calloc(ins->NstatFields*ins->fieldOffset, sizeof(dfloat));
+    if(!ins->statUU) ins->statUU = (dfloat*) calloc(ins->NstatUU*ins->fieldOffset+1, sizeof(dfloat));
+    ins->o_statM2.copyTo(ins->statM2, ins->NstatFields*ins->fieldOffset*sizeof(dfloat));
+    ins->o_statUU.copyTo(ins->statUU, ins->NstatUU*ins->fieldOffset*sizeof(dfloat));
+  }
+}
+
+// write Ncomp fields starting at q to the plot nodes, scaled by scale and
+// optionally square rooted per node before interpolation
+static void insStatisticsPlotField(ins_t *ins, FILE *fp, const char *name, int Ncomp,
+                                   dfloat *q, dfloat scale, int root){
+
+  mesh_t *mesh = ins->mesh;
+
+  if(Ncomp==1)
+    fprintf(fp, "        <DataArray type=\"Float32\" Name=\"%s\" Format=\"ascii\">\n", name);
+  else
+    fprintf(fp, "        <DataArray type=\"Float32\" Name=\"%s\" NumberOfComponents=\"%d\" Format=\"ascii\">\n", name, Ncomp);
+
+  for(dlong e=0;e<mesh->Nelements;++e){
+    for(int n=0;n<mesh->plotNp;++n){
+      fprintf(fp, "       ");
+      for(int c=0;c<Ncomp;++c){
+        dfloat plotq = 0;
+        for(int m=0;m<mesh->Np;++m){
+          dfloat qm = scale*q[m+e*mesh->Np+c*ins->fieldOffset];
+          if(root) qm = sqrt(mymax(qm, 0.));
+          plotq += mesh->plotInterp[n*mesh->Np+m]*qm;
+        }
+        fprintf(fp, "%g ", plotq);
+      }
+      fprintf(fp, "\n");
+    }
+  }
+  fprintf(fp, "       </DataArray>\n");
+}
+
+// append the statistics to the point data of an open VTU piece
+void insStatisticsPlotVTU(ins_t *ins, FILE *fp){
+
+  if(!ins->statCount) return;
+
+  const dfloat invCount = 1.0/ins->statCount;
+  const int NVort = (ins->dim==2) ? 1 : ins->NVfields;
+
+  dfloat *U    = ins->statMean;
+  dfloat *P    = ins->statMean + ins->NVfields*ins->fieldOffset;
+  dfloat *Vort = ins->statMean + (ins->NVfields+1)*ins->fieldOffset;
+
+  insStatisticsPlotField(ins, fp, "MeanVelocity",  ins->NVfields, U,    1.0, 0);
+  insStatisticsPlotField(ins, fp, "MeanPressure",  1,             P,    1.0, 0);
+  insStatisticsPlotField(ins, fp, "MeanVorticity", NVort,         Vort, 1.0, 0);
+
+  if(ins->statMoments>1){
+    U    = ins->statM2;
+    P    = ins->statM2 + ins->NVfields*ins->fieldOffset;
+    Vort = ins->statM2 + (ins->NVfields+1)*ins->fieldOffset;
+
+    insStatisticsPlotField(ins, fp, "RMSVelocity",    ins->NVfields, U,           invCount, 1);
+    insStatisticsPlotField(ins, fp, "RMSPressure",    1,             P,           invCount, 1);
+    insStatisticsPlotField(ins, fp, "RMSVorticity",   NVort,         Vort,        invCount, 1);
+    insStatisticsPlotField(ins, fp, "ReynoldsStress", ins->NstatUU,  ins->statUU, invCount, 0);
+  }
+}
+
+// append the statistics to a restart file, node by node like the history
+void insStatisticsWrite(ins_t *ins, FILE *fp){
+
+  mesh_t *mesh = ins->mesh;
+
+  insStatisticsCopyToHost(ins);
+
+  // the layout below depends on the moment order and field count
+  fwrite(&ins->statCount,   sizeof(dlong), 1, fp);
+  fwrite(&ins->statMoments, sizeof(int),   1, fp);
+  fwrite(&ins->NstatFields, sizeof(int),   1, fp);
+
+  for(dlong e=0;e<mesh->Nelements;++e){
+    for(int n=0;n<mesh->Np;++n){
+      const dlong id = e*mesh->Np+n;
+      for(int fld=0;fld<ins->NstatFields;++fld)
+        fwrite(ins->statMean+id+fld*ins->fieldOffset, sizeof(dfloat), 1, fp);
+      if(ins->statMoments>1){
+        for(int fld=0;fld<ins->NstatFields;++fld)
+          fwrite(ins->statM2+id+fld*ins->fieldOffset, sizeof(dfloat), 1, fp);
+        for(int fld=0;fld<ins->NstatUU;++fld)
+          fwrite(ins->statUU+id+fld*ins->fieldOffset, sizeof(dfloat), 1, fp);
+      }
+    }
+  }
+}
+
+// resume the statistics from a restart file, if it carries them
+void insStatisticsRead(ins_t *ins, FILE *fp){
+
+  mesh_t *mesh = ins->mesh;
+
+  dlong count = 0;
+  int moments = 0, NstatFields = 0;
+  if(fread(&count,       sizeof(dlong), 1, fp)!=1 ||
+     fread(&moments,     sizeof(int),   1, fp)!=1 ||
+     fread(&NstatFields, sizeof(int),   1, fp)!=1){
+    if(mesh->rank==0) printf("WARNING: restart file has no statistics, starting them from zero\n");
+    return;
+  }
+
+  if(moments!=ins->statMoments || NstatFields!=ins->NstatFields){
+    if(mesh->rank==0)
+      printf("WARNING: restart statistics have moments %d and %d fields, not %d and %d, starting them from zero\n",
+             moments, NstatFields, ins->statMoments, ins->NstatFields);
+
+    // step over the saved block so anything after it still lines up
+    long Nnode = NstatFields + ((moments>1) ? NstatFields+ins->NstatUU : 0);
+    fseek(fp, (long) mesh->Nelements*mesh->Np*Nnode*sizeof(dfloat), SEEK_CUR);
+    return;
+  }
+
+  // allocate the host staging
+  insStatisticsCopyToHost(ins);
+
+  for(dlong e=0;e<mesh->Nelements;++e){
+    for(int n=0;n<mesh->Np;++n){
+      const dlong id = e*mesh->Np+n;
+      for(int fld=0;fld<ins->NstatFields;++fld)
+        fread(ins->statMean+id+fld*ins->fieldOffset, sizeof(dfloat), 1, fp);
+      if(ins->statMoments>1){
+        for(int fld=0;fld<ins->NstatFields;++fld)
+          fread(ins->statM2+id+fld*ins->fieldOffset, sizeof(dfloat), 1, fp);
+        for(int fld=0;fld<ins->NstatUU;++fld)
+          fread(ins->statUU+id+fld*ins->fieldOffset, sizeof(dfloat), 1, fp);
+      }
+    }
+  }
+
+  ins->statCount = count;
+  ins->o_statMean.copyFrom(ins->statMean, ins->NstatFields*ins->fieldOffset*sizeof(dfloat));
+  if(ins->statMoments>1){
+    ins->o_statM2.copyFrom(ins->statM2, ins->NstatFields*ins->fieldOffset*sizeof(dfloat));
+    ins->o_statUU.copyFrom(ins->statUU, ins->NstatUU*ins->fieldOffset*sizeof(dfloat));
+  }
+}
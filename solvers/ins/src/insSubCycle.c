@@ -34,13 +34,16 @@ void insSubCycle(ins_t *ins, dfloat time, int Nstages, occa::memory o_U, occa::m
 
   const dlong NtotalElements = (mesh->Nelements+mesh->totalHaloPairs);  
 
+  // newest level of the velocity history
+  occa::memory o_Un = o_U + insHistorySlot(ins, 0)*ins->NVfields*ins->fieldOffset*sizeof(dfloat);
+
   //Exctract Halo On Device, all fields
   if(mesh->totalHaloPairs>0){
     ins->velocityHaloExtractKernel(mesh->Nelements,
                                  mesh->totalHaloPairs,
                                  mesh->o_haloElementList,
                                  ins->fieldOffset,
-                                 o_U,
+                                 o_Un,
                                  ins->o_vHaloBuffer);
 
     // copy extracted halo to HOST 
@@ -59,7 +62,7 @@ void insSubCycle(ins_t *ins, dfloat time, int Nstages, occa::memory o_U, occa::m
     ins->velocityHaloScatterKernel(mesh->Nelements,
                                   mesh->totalHaloPairs,
                                   ins->fieldOffset,
-                                  o_U,
+                                  o_Un,
                                   ins->o_vHaloBuffer);
   }
 
@@ -68,6 +71,40 @@ void insSubCycle(ins_t *ins, dfloat time, int Nstages, occa::memory o_U, occa::m
   const dfloat tn1 = time - 1*ins->dt;
   const dfloat tn2 = time - 2*ins->dt;
 
+  // extrapolation weights of every subproblem stage, in slot order, so the
+  // whole batch is uploaded with a single copy
+  for (int torder=ins->ExplicitOrder-1; torder>=0; torder--){
+    const dfloat tsub = time - torder*ins->dt;
+    for(int ststep = 0; ststep<ins->Nsubsteps;++ststep){
+      const dfloat tstage = tsub + ststep*ins->sdt;
+      for(int rk=0;rk<ins->SNrk;++rk){
+        dfloat t = tstage +  ins->sdt*ins->Srkc[rk];
+        dfloat c[3] = {0.f, 0.f, 0.f};
+
+        switch(ins->ExplicitOrder){
+          case 1:
+            c[0] = 1.f;
+            break;
+          case 2:
+            c[0] = (t-tn1)/(tn0-tn1);
+            c[1] = (t-tn0)/(tn1-tn0);
+            break;
+          case 3:
+            c[0] = (t-tn1)*(t-tn2)/((tn0-tn1)*(tn0-tn2)); 
+            c[1] = (t-tn0)*(t-tn2)/((tn1-tn0)*(tn1-tn2));
+            c[2] = (t-tn0)*(t-tn1)/((tn2-tn0)*(tn2-tn1));
+            break;
+        }
+
+        dfloat *extC = ins->extC + 3*((torder*ins->Nsubsteps + ststep)*ins->SNrk + rk);
+        extC[0] = 0.f; extC[1] = 0.f; extC[2] = 0.f;
+        for (int age=0;age<Nstages;age++)
+          extC[insHistorySlot(ins, age)] = c[age];
+      }
+    }
+  }
+  ins->o_extC.copyFrom(ins->extC, 3*ins->ExplicitOrder*ins->Nsubsteps*ins->SNrk*sizeof(dfloat));
+
   dfloat zero = 0.0, one = 1.0;
   int izero = 0;
 
@@ -80,7 +117,7 @@ void insSubCycle(ins_t *ins, dfloat time, int Nstages, occa::memory o_U, occa::m
     bScale += b;
 
     // Initialize SubProblem Velocity i.e. Ud = U^(t-torder*dt)
-    dlong toffset = torder*ins->NVfields*ins->Ntotal;
+    dlong toffset = insHistorySlot(ins, torder)*ins->NVfields*ins->Ntotal;
 
     if (torder==ins->ExplicitOrder-1) { //first substep
       ins->scaledAddKernel(ins->NVfields*ins->Ntotal, b, toffset, o_U, zero, izero, o_Ud);
@@ -97,38 +134,20 @@ void insSubCycle(ins_t *ins, dfloat time, int Nstages, occa::memory o_U, occa::m
         // Extrapolate velocity to subProblem stage time
         dfloat t = tstage +  ins->sdt*ins->Srkc[rk]; 
 
-        switch(ins->ExplicitOrder){
-          case 1:
-            ins->extC[0] = 1.f; ins->extC[1] = 0.f; ins->extC[2] = 0.f;
-            break;
-          case 2:
-            ins->extC[0] = (t-tn1)/(tn0-tn1);
-            ins->extC[1] = (t-tn0)/(tn1-tn0);
-            ins->extC[2] = 0.f; 
-            break;
-          case 3:
-            ins->extC[0] = (t-tn1)*(t-tn2)/((tn0-tn1)*(tn0-tn2)); 
-            ins->extC[1] = (t-tn0)*(t-tn2)/((tn1-tn0)*(tn1-tn2));
-            ins->extC[2] = (t-tn0)*(t-tn1)/((tn2-tn0)*(tn2-tn1));
-            break;
-        }
-        ins->o_extC.copyFrom(ins->extC);
+        const dlong stage = (torder*ins->Nsubsteps + ststep)*ins->SNrk + rk;
 
         //compute advective velocity fields at time t
         ins->subCycleExtKernel(NtotalElements,
                                Nstages,
                                ins->fieldOffset,
-                               ins->o_extC,
+                               ins->o_extC + 3*stage*sizeof(dfloat),
                                o_U,
                                ins->o_Ue);
 
+        occa::streamTag haloTag;
         if(mesh->totalHaloPairs>0){
-          // make sure compute device is ready to perform halo extract
-          mesh->device.finish();
-
-          // switch to data stream
-          mesh->device.setStream(mesh->dataStream);
-
+          // extract on the compute stream so it is ordered after the last
+          // update, then tag it instead of draining the device
           ins->velocityHaloExtractKernel(mesh->Nelements,
                                    mesh->totalHaloPairs,
                                    mesh->o_haloElementList,
@@ -136,9 +155,7 @@ void insSubCycle(ins_t *ins, dfloat time, int Nstages, occa::memory o_U, occa::m
                                    o_Ud,
                                    ins->o_vHaloBuffer);
 
-          // copy extracted halo to HOST 
-          ins->o_vHaloBuffer.copyTo(ins->vSendBuffer,"async: true");            
-          mesh->device.setStream(mesh->defaultStream);
+          haloTag = mesh->device.tagStream();
         }
 
         // Compute Volume Contribution
@@ -169,8 +186,13 @@ void insSubCycle(ins_t *ins, dfloat time, int Nstages, occa::memory o_U, occa::m
         occaTimerToc(mesh->device,"AdvectionVolume");
 
         if(mesh->totalHaloPairs>0){
-          // make sure compute device is ready to perform halo extract
+          // volume kernel is queued, wait only for the extracted halo
+          mesh->device.waitFor(haloTag);
+
           mesh->device.setStream(mesh->dataStream);
+
+          // copy extracted halo to HOST 
+          ins->o_vHaloBuffer.copyTo(ins->vSendBuffer,"async: true");
           mesh->device.finish();
 
           // start halo exchange
@@ -192,7 +214,6 @@ void insSubCycle(ins_t *ins, dfloat time, int Nstages, occa::memory o_U, occa::m
           mesh->device.finish();
           
           mesh->device.setStream(mesh->defaultStream);
-          mesh->device.finish();
         }
 
         //Surface Kernel
@@ -50,6 +50,35 @@ void insVelocityRhs(ins_t *ins, dfloat time, int stage, occa::memory o_rhsU, occ
                            o_rhsU,
                            o_rhsV,
                            o_rhsW);
+  } else if (ins->velocityRhsFused) {
+    // history, mass matrix and boundary lifting in one pass, the solve only gathers
+    ins->velocityRhsBCExtbdfKernel(mesh->Nelements,
+                                   mesh->o_ggeo,
+                                   mesh->o_sgeo,
+                                   mesh->o_Dmatrices,
+                                   mesh->o_Smatrices,
+                                   mesh->o_MM,
+                                   mesh->o_vmapM,
+                                   mesh->o_EToB,
+                                   mesh->o_sMT,
+                                   ins->lambda,
+                                   time,
+                                   mesh->o_x,
+                                   mesh->o_y,
+                                   mesh->o_z,
+                                   ins->o_VmapB,
+                                   ins->idt,
+                                   ins->inu,
+                                   ins->o_extbdfSlotA,
+                                   ins->o_extbdfSlotB,
+                                   ins->o_extbdfSlotC,
+                                   ins->fieldOffset,
+                                   ins->o_U,
+                                   ins->o_NU,
+                                   ins->o_GP,
+                                   o_rhsU,
+                                   o_rhsV,
+                                   o_rhsW);
   } else if (ins->options.compareArgs("TIME INTEGRATOR", "EXTBDF")) {
     // rhsU^s = MM*(\sum^s b_i U^n-i - \sum^s-1 a_i N(U^n-i) + \sum^s-1 c_i GP^n-i)/nu dt
     ins->velocityRhsKernel(mesh->Nelements,
@@ -57,9 +86,9 @@ void insVelocityRhs(ins_t *ins, dfloat time, int stage, occa::memory o_rhsU, occ
                            mesh->o_MM,
                            ins->idt,
                            ins->inu,
-                           ins->o_extbdfA,
-                           ins->o_extbdfB,
-                           ins->o_extbdfC,
+                           ins->o_extbdfSlotA,
+                           ins->o_extbdfSlotB,
+                           ins->o_extbdfSlotC,
                            ins->fieldOffset,
                            ins->o_U,
                            ins->o_NU,
@@ -41,7 +41,8 @@ void insVelocitySolve(ins_t *ins, dfloat time, int stage,  occa::memory o_rhsU,
   
   if (ins->vOptions.compareArgs("DISCRETIZATION","CONTINUOUS")){
 
-    if(!quad3D) 
+    // the fused EXTBDF rhs kernel has already lifted the boundary data
+    if(!quad3D && !ins->velocityRhsFused) 
       ins->velocityRhsBCKernel(mesh->Nelements,
                                 mesh->o_ggeo,
                                 mesh->o_sgeo,
@@ -61,12 +62,11 @@ void insVelocitySolve(ins_t *ins, dfloat time, int stage,  occa::memory o_rhsU,
                                 o_rhsV,
                                 o_rhsW);
 
-    // gather-scatter
-    ogsGatherScatter(o_rhsU, ogsDfloat, ogsAdd, mesh->ogs);
-    ogsGatherScatter(o_rhsV, ogsDfloat, ogsAdd, mesh->ogs);
-
-    if (ins->dim==3)
-      ogsGatherScatter(o_rhsW, ogsDfloat, ogsAdd, mesh->ogs);
+    // gather-scatter, all velocity components share one halo exchange
+    ogsField_t fields[3] = {{o_rhsU, ogsDfloat, ogsAdd},
+                            {o_rhsV, ogsDfloat, ogsAdd},
+                            {o_rhsW, ogsDfloat, ogsAdd}};
+    ogsGatherScatterFields(ins->dim, fields, mesh->ogs);
 
     if (usolver->Nmasked) mesh->maskKernel(usolver->Nmasked, usolver->o_maskIds, o_rhsU);
     if (vsolver->Nmasked) mesh->maskKernel(vsolver->Nmasked, vsolver->o_maskIds, o_rhsV);
@@ -95,12 +95,14 @@ void insVelocitySolve(ins_t *ins, dfloat time, int stage,  occa::memory o_rhsU,
     occaTimerToc(mesh->device,"velocityRhsIpdg");   
   }
 
-  //copy current velocity fields as initial guess? (could use Uhat or beter guess)
+  // initial guess: the newest velocity, or for ARK the previous stage solution
   dlong Ntotal = (mesh->Nelements+mesh->totalHaloPairs)*mesh->Np;
-  ins->o_UH.copyFrom(ins->o_U,Ntotal*sizeof(dfloat),0,0*ins->fieldOffset*sizeof(dfloat));
-  ins->o_VH.copyFrom(ins->o_U,Ntotal*sizeof(dfloat),0,1*ins->fieldOffset*sizeof(dfloat));
+  const int guessSlot = ins->ARKswitch ? stage-1 : insHistorySlot(ins, 0);
+  dlong Uoffset = guessSlot*ins->NVfields*ins->fieldOffset;
+  ins->o_UH.copyFrom(ins->o_U,Ntotal*sizeof(dfloat),0,(Uoffset+0*ins->fieldOffset)*sizeof(dfloat));
+  ins->o_VH.copyFrom(ins->o_U,Ntotal*sizeof(dfloat),0,(Uoffset+1*ins->fieldOffset)*sizeof(dfloat));
   if (ins->dim==3)
-    ins->o_WH.copyFrom(ins->o_U,Ntotal*sizeof(dfloat),0,2*ins->fieldOffset*sizeof(dfloat));
+    ins->o_WH.copyFrom(ins->o_U,Ntotal*sizeof(dfloat),0,(Uoffset+2*ins->fieldOffset)*sizeof(dfloat));
 
   if (ins->vOptions.compareArgs("DISCRETIZATION","CONTINUOUS") && !quad3D) {
     if (usolver->Nmasked) mesh->maskKernel(usolver->Nmasked, usolver->o_maskIds, ins->o_UH);
@@ -39,7 +39,7 @@ void insVelocityUpdate(ins_t *ins, dfloat time, int stage,
                               ins->ARKswitch,
                               ins->dt,
                               ins->fieldOffset,
-                              ins->o_prkA,
+                              ins->ARKswitch ? ins->o_prkA : ins->o_extbdfSlotC,
                               ins->o_prkB,
                               o_rkGP,
                               ins->o_GP,
@@ -0,0 +1,54 @@
+/*
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Tim Warburton, Noel Chalmers, Jesse Chan, Ali Karakus
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "mesh.h"
+#include "mesh3D.h"
+
+// per-element length scale h = min over the faces of 2/(sJ*invJ).
+// Simplices carry one surface factor per face, tensor-product
+// elements carry one per face node.
+dfloat *meshElementHmin(mesh_t *mesh, int elementType){
+
+  dfloat *hmin = (dfloat*) calloc(mesh->Nelements+1, sizeof(dfloat));
+
+  const int Nsurf = (elementType==TRIANGLES || elementType==TETRAHEDRA) ? 1 : mesh->Nfp;
+
+  for(dlong e=0;e<mesh->Nelements;++e){
+    dfloat h = 1e9;
+    for(int f=0;f<mesh->Nfaces;++f){
+      for(int n=0;n<Nsurf;++n){
+        dlong sid = mesh->Nsgeo*(mesh->Nfaces*Nsurf*e + f*Nsurf + n);
+        dfloat sJ   = mesh->sgeo[sid + SJID];
+        dfloat invJ = mesh->sgeo[sid + IJID];
+
+        h = mymin(h, 2./(sJ*invJ));
+      }
+    }
+    hmin[e] = h;
+  }
+
+  return hmin;
+}
@@ -0,0 +1,154 @@
+/*
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Tim Warburton, Noel Chalmers, Jesse Chan, Ali Karakus
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include <string.h>
+#include "mesh.h"
+
+// device copies of the probe weights, a ring of Nslots samples of Nfields
+// per probe, and the per-rank time-series file the ring is flushed to
+void meshProbeDeviceSetup(mesh_t *mesh, int Nfields, int Nslots,
+                          const char *fileBase, occa::properties &kernelInfo){
+
+  const dlong Nprobes = mesh->probeN;
+
+  mesh->probeNfields  = Nfields;
+  mesh->probeNslots   = mymax(Nslots, 1);
+  mesh->probeSlot     = 0;
+  mesh->probeNpending = 0;
+
+  // weights are stored node-major on the device for coalesced reads
+  dfloat *probeIT = (dfloat*) calloc((Nprobes+1)*mesh->Np, sizeof(dfloat));
+  for(dlong p=0;p<Nprobes;++p)
+    for(int n=0;n<mesh->Np;++n)
+      probeIT[n*Nprobes+p] = mesh->probeI[p*mesh->Np+n];
+
+  mesh->o_probeElementIds = mesh->device.malloc((Nprobes+1)*sizeof(dlong), mesh->probeElementIds);
+  mesh->o_probeI          = mesh->device.malloc((Nprobes+1)*mesh->Np*sizeof(dfloat), probeIT);
+  free(probeIT);
+
+  const size_t ringBytes = (mesh->probeNslots*Nprobes*Nfields+1)*sizeof(dfloat);
+  mesh->o_probeRing = mesh->device.malloc(ringBytes);
+  mesh->probeRing   = (dfloat*) occaHostMallocPinned(mesh->device, ringBytes, NULL, mesh->h_probeRing);
+
+  mesh->probeTimes        = (dfloat*) calloc(mesh->probeNslots, sizeof(dfloat));
+  mesh->probePendingTimes = (dfloat*) calloc(mesh->probeNslots, sizeof(dfloat));
+
+  for (int r=0;r<mesh->size;r++) {
+    if (r==mesh->rank)
+      mesh->probeKernel = mesh->device.buildKernel(DHOLMES "/okl/meshProbe.okl", "meshProbeInterpolate", kernelInfo);
+    MPI_Barrier(mesh->comm);
+  }
+
+  mesh->probeFile = NULL;
+  if(Nprobes){
+    char fname[BUFSIZ];
+    sprintf(fname, "%s_%04d.dat", fileBase, mesh->rank);
+    mesh->probeFile = fopen(fname, "w");
+
+    fprintf(mesh->probeFile, "# time, then %d fields for each of the probes", Nfields);
+    for(dlong p=0;p<Nprobes;++p) fprintf(mesh->probeFile, " %d", mesh->probeIds[p]);
+    fprintf(mesh->probeFile, "\n");
+  }
+}
+
+// interpolate Nfields of o_q into the current ring slot, starting at fieldStart
+void meshProbeSample(mesh_t *mesh, int fieldStart, int Nfields,
+                     dlong elementStride, dlong fieldStride, occa::memory &o_q){
+
+  if(!mesh->probeN) return;
+
+  const dlong slotOffset = mesh->probeSlot*mesh->probeN*mesh->probeNfields;
+
+  mesh->probeKernel(mesh->probeN,
+                    Nfields,
+                    fieldStart,
+                    mesh->probeNfields,
+                    elementStride,
+                    fieldStride,
+                    mesh->o_probeElementIds,
+                    mesh->o_probeI,
+                    o_q,
+                    mesh->o_probeRing + slotOffset*sizeof(dfloat));
+}
+
+// close the current slot; a full ring is flushed
+void meshProbeAdvance(mesh_t *mesh, dfloat time){
+
+  if(!mesh->probeN) return;
+
+  mesh->probeTimes[mesh->probeSlot++] = time;
+
+  if(mesh->probeSlot==mesh->probeNslots)
+    meshProbeFlush(mesh);
+}
+
+static void meshProbeWritePending(mesh_t *mesh){
+
+  if(!mesh->probeNpending) return;
+
+  mesh->device.waitFor(mesh->probeTag);
+
+  const int Nrow = mesh->probeN*mesh->probeNfields;
+  for(int s=0;s<mesh->probeNpending;++s){
+    fprintf(mesh->probeFile, "%.8e", mesh->probePendingTimes[s]);
+    for(int n=0;n<Nrow;++n)
+      fprintf(mesh->probeFile, " %.8e", mesh->probeRing[s*Nrow+n]);
+    fprintf(mesh->probeFile, "\n");
+  }
+
+  mesh->probeNpending = 0;
+}
+
+// write the batch copied by the previous flush, then start copying the
+// filled slots to the host without waiting for them
+void meshProbeFlush(mesh_t *mesh){
+
+  if(!mesh->probeN) return;
+
+  meshProbeWritePending(mesh);
+
+  if(mesh->probeSlot){
+    const size_t bytes = mesh->probeSlot*mesh->probeN*mesh->probeNfields*sizeof(dfloat);
+    mesh->o_probeRing.copyTo(mesh->probeRing, bytes, 0, "async: true");
+    mesh->probeTag = mesh->device.tagStream();
+
+    memcpy(mesh->probePendingTimes, mesh->probeTimes, mesh->probeSlot*sizeof(dfloat));
+    mesh->probeNpending = mesh->probeSlot;
+    mesh->probeSlot = 0;
+  }
+}
+
+// write everything still in flight and close the probe file
+void meshProbeClose(mesh_t *mesh){
+
+  if(!mesh->probeN) return;
+
+  meshProbeFlush(mesh);
+  meshProbeWritePending(mesh);
+
+  fclose(mesh->probeFile);
+  mesh->probeFile = NULL;
+}
@@ -0,0 +1,372 @@
+/*
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Tim Warburton, Noel Chalmers, Jesse Chan, Ali Karakus
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "mesh.h"
+#include "mesh3D.h"
+
+// orthonormal Jacobi polynomial P_N^{alpha,beta}(x)
+static dfloat probeJacobiP(dfloat x, dfloat alpha, dfloat beta, int N){
+
+  dfloat gamma0 = pow(2.,alpha+beta+1)/(alpha+beta+1)*tgamma(alpha+1)*tgamma(beta+1)/tgamma(alpha+beta+1);
+  dfloat Pm = 1.0/sqrt(gamma0);
+  if(N==0) return Pm;
+
+  dfloat gamma1 = (alpha+1)*(beta+1)/(alpha+beta+3)*gamma0;
+  dfloat P = ((alpha+beta+2)*x/2 + (alpha-beta)/2)/sqrt(gamma1);
+  if(N==1) return P;
+
+  dfloat aold = 2/(2+alpha+beta)*sqrt((alpha+1.)*(beta+1.)/(alpha+beta+3.));
+  for(int i=1;i<=N-1;++i){
+    dfloat h1 = 2.*i+alpha+beta;
+    dfloat anew = 2./(h1+2.)*sqrt((i+1.)*(i+1.+alpha+beta)*(i+1+alpha)*(i+1+beta)/(h1+1)/(h1+3));
+    dfloat bnew = -(alpha*alpha-beta*beta)/h1/(h1+2);
+    dfloat Pp = 1./anew*(-aold*Pm + (x-bnew)*P);
+    Pm = P;
+    P = Pp;
+    aold = anew;
+  }
+  return P;
+}
+
+// modal basis spanning the element's polynomial space, evaluated at (r,s,t)
+static void probeModalBasis(mesh_t *mesh, int elementType, dfloat *rst, dfloat *phi){
+
+  const int N = mesh->N;
+  const dfloat r = rst[0], s = rst[1], t = rst[2];
+  int sk = 0;
+
+  if(elementType==TRIANGLES){
+    dfloat a = (fabs(1-s)>1e-12) ? 2*(1+r)/(1-s)-1 : -1;
+    for(int i=0;i<=N;++i)
+      for(int j=0;j<=N-i;++j)
+        phi[sk++] = probeJacobiP(a,0,0,i)*probeJacobiP(s,2*i+1,0,j)*pow(1-s,i);
+  }
+  if(elementType==TETRAHEDRA){
+    dfloat a = (fabs(s+t)>1e-12) ? 2*(1+r)/(-s-t)-1 : -1;
+    dfloat b = (fabs(1-t)>1e-12) ? 2*(1+s)/(1-t)-1 : -1;
+    for(int i=0;i<=N;++i)
+      for(int j=0;j<=N-i;++j)
+        for(int k=0;k<=N-i-j;++k)
+          phi[sk++] = probeJacobiP(a,0,0,i)*probeJacobiP(b,2*i+1,0,j)*pow(1-b,i)
+                     *probeJacobiP(t,2*i+2*j+2,0,k)*pow(1-t,i+j);
+  }
+  if(elementType==QUADRILATERALS){
+    for(int j=0;j<=N;++j)
+      for(int i=0;i<=N;++i)
+        phi[sk++] = probeJacobiP(r,0,0,i)*probeJacobiP(s,0,0,j);
+  }
+  if(elementType==HEXAHEDRA){
+    for(int k=0;k<=N;++k)
+      for(int j=0;j<=N;++j)
+        for(int i=0;i<=N;++i)
+          phi[sk++] = probeJacobiP(r,0,0,i)*probeJacobiP(s,0,0,j)*probeJacobiP(t,0,0,k);
+  }
+}
+
+// nodal interpolation weights at (r,s,t) and the physical point they map to
+static void probeMap(mesh_t *mesh, int elementType, dfloat *invV, dlong e,
+                     dfloat *rst, dfloat *phi, dfloat *I, dfloat *X){
+
+  probeModalBasis(mesh, elementType, rst, phi);
+
+  X[0] = X[1] = X[2] = 0;
+  for(int n=0;n<mesh->Np;++n){
+    dfloat In = 0;
+    for(int m=0;m<mesh->Np;++m)
+      In += phi[m]*invV[m*mesh->Np+n];
+    I[n] = In;
+
+    const dlong id = e*mesh->Np+n;
+    X[0] += In*mesh->x[id];
+    X[1] += In*mesh->y[id];
+    if(mesh->dim==3) X[2] += In*mesh->z[id];
+  }
+}
+
+// Newton iteration for the reference coordinates of xp in element e, with a
+// finite difference Jacobian so curved elements are handled as well
+static int probeLocate(mesh_t *mesh, int elementType, dfloat *invV, dlong e, dfloat h,
+                       dfloat *xp, dfloat *rst, dfloat *phi, dfloat *I){
+
+  const int dim = mesh->dim;
+  const dfloat eps = 1e-7;
+  const dfloat tol = 1e-8;
+
+  dfloat X[3], Xd[3], J[3][3], res[3];
+
+  rst[0] = rst[1] = rst[2] = 0;
+  if(elementType==TRIANGLES)  rst[0] = rst[1] = -1./3.;
+  if(elementType==TETRAHEDRA) rst[0] = rst[1] = rst[2] = -0.5;
+
+  for(int it=0;it<20;++it){
+    probeMap(mesh, elementType, invV, e, rst, phi, I, X);
+    for(int d=0;d<dim;++d) res[d] = xp[d]-X[d];
+
+    for(int d=0;d<dim;++d){
+      rst[d] += eps;
+      probeMap(mesh, elementType, invV, e, rst, phi, I, Xd);
+      rst[d] -= eps;
+      for(int c=0;c<dim;++c) J[c][d] = (Xd[c]-X[c])/eps;
+    }
+
+    dfloat dr[3] = {0,0,0};
+    if(dim==2){
+      dfloat det = J[0][0]*J[1][1]-J[0][1]*J[1][0];
+      dr[0] = ( J[1][1]*res[0]-J[0][1]*res[1])/det;
+      dr[1] = (-J[1][0]*res[0]+J[0][0]*res[1])/det;
+    }else{
+      dfloat det = J[0][0]*(J[1][1]*J[2][2]-J[1][2]*J[2][1])
+                  -J[0][1]*(J[1][0]*J[2][2]-J[1][2]*J[2][0])
+                  +J[0][2]*(J[1][0]*J[2][1]-J[1][1]*J[2][0]);
+      for(int d=0;d<3;++d){
+        dfloat Jd[3][3];
+        for(int a=0;a<3;++a)
+          for(int b=0;b<3;++b)
+            Jd[a][b] = (b==d) ? res[a] : J[a][b];
+        dr[d] = (Jd[0][0]*(Jd[1][1]*Jd[2][2]-Jd[1][2]*Jd[2][1])
+                -Jd[0][1]*(Jd[1][0]*Jd[2][2]-Jd[1][2]*Jd[2][0])
+                +Jd[0][2]*(Jd[1][0]*Jd[2][1]-Jd[1][1]*Jd[2][0]))/det;
+      }
+    }
+
+    dfloat nrm = 0;
+    for(int d=0;d<dim;++d){
+      // keep the iterate near the reference element
+      rst[d] = mymin(mymax(rst[d]+dr[d], -2.), 2.);
+      nrm += dr[d]*dr[d];
+    }
+    if(nrm<1e-24) break;
+  }
+
+  probeMap(mesh, elementType, invV, e, rst, phi, I, X);
+  dfloat err = 0;
+  for(int d=0;d<dim;++d) err += (xp[d]-X[d])*(xp[d]-X[d]);
+  if(sqrt(err)>tol*h) return 0;
+
+  const dfloat r = rst[0], s = rst[1], t = rst[2];
+  if(elementType==TRIANGLES)
+    return (r>=-1-tol && s>=-1-tol && r+s<=tol);
+  if(elementType==TETRAHEDRA)
+    return (r>=-1-tol && s>=-1-tol && t>=-1-tol && r+s+t<=-1+tol);
+  if(elementType==QUADRILATERALS)
+    return (fabs(r)<=1+tol && fabs(s)<=1+tol);
+  return (fabs(r)<=1+tol && fabs(s)<=1+tol && fabs(t)<=1+tol);
+}
+
+// locate NprobeTotal points (replicated on every rank) and precompute their
+// interpolation weights. Candidate elements come from a uniform grid over the
+// element bounding boxes; a point found on several ranks goes to the lowest.
+void meshProbeSetup(mesh_t *mesh, int elementType, dlong NprobeTotal,
+                    dfloat *pX, dfloat *pY, dfloat *pZ){
+
+  const int dim = mesh->dim;
+  const int Np  = mesh->Np;
+
+  mesh->probeNTotal = NprobeTotal;
+  mesh->probeN = 0;
+
+  if(elementType==QUADRILATERALS && dim==3){
+    if(mesh->rank==0) printf("WARNING: probes are not available for surface quadrilaterals\n");
+    NprobeTotal = 0;
+  }
+
+  // element bounding boxes from the nodal coordinates
+  dfloat *bb = (dfloat*) calloc(6*(mesh->Nelements+1), sizeof(dfloat));
+  dfloat lo[3] = { 1e300, 1e300, 1e300}, hi[3] = {-1e300,-1e300,-1e300};
+  for(dlong e=0;e<mesh->Nelements;++e){
+    for(int d=0;d<3;++d){ bb[6*e+2*d] = 1e300; bb[6*e+2*d+1] = -1e300; }
+    for(int n=0;n<Np;++n){
+      const dlong id = e*Np+n;
+      dfloat xn[3] = {mesh->x[id], mesh->y[id], (dim==3) ? mesh->z[id] : 0};
+      for(int d=0;d<3;++d){
+        bb[6*e+2*d]   = mymin(bb[6*e+2*d],   xn[d]);
+        bb[6*e+2*d+1] = mymax(bb[6*e+2*d+1], xn[d]);
+      }
+    }
+    for(int d=0;d<3;++d){
+      lo[d] = mymin(lo[d], bb[6*e+2*d]);
+      hi[d] = mymax(hi[d], bb[6*e+2*d+1]);
+    }
+  }
+
+  // uniform grid with about one element per cell
+  int Nc[3] = {1,1,1};
+  dfloat dx[3] = {1,1,1};
+  for(int d=0;d<dim;++d){
+    Nc[d] = mymax(1, (int) ceil(pow((dfloat) mesh->Nelements, 1./dim)));
+    dx[d] = (hi[d]>lo[d]) ? (hi[d]-lo[d])/Nc[d] : 1;
+  }
+  const dlong Ncells = (dlong) Nc[0]*Nc[1]*Nc[2];
+
+  dlong *cellStarts = (dlong*) calloc(Ncells+1, sizeof(dlong));
+  for(int pass=0;pass<2;++pass){
+    dlong *cellFill = (dlong*) calloc(Ncells, sizeof(dlong));
+    for(dlong e=0;e<mesh->Nelements;++e){
+      int c0[3] = {0,0,0}, c1[3] = {0,0,0};
+      for(int d=0;d<dim;++d){
+        c0[d] = mymax(0,       (int) floor((bb[6*e+2*d]  -lo[d])/dx[d]));
+        c1[d] = mymin(Nc[d]-1, (int) floor((bb[6*e+2*d+1]-lo[d])/dx[d]));
+      }
+      for(int k=c0[2];k<=c1[2];++k)
+        for(int j=c0[1];j<=c1[1];++j)
+          for(int i=c0[0];i<=c1[0];++i){
+            const dlong c = i + Nc[0]*(j + Nc[1]*k);
+            if(pass==0) cellStarts[c+1]++;
+            else mesh->probeElementIds[cellStarts[c]+cellFill[c]] = e;
+            cellFill[c]++;
+          }
+    }
+    free(cellFill);
+
+    if(pass==0){
+      for(dlong c=0;c<Ncells;++c) cellStarts[c+1] += cellStarts[c];
+      // the cell element lists borrow probeElementIds until the search is done
+      mesh->probeElementIds = (dlong*) calloc(cellStarts[Ncells]+1, sizeof(dlong));
+    }
+  }
+  dlong *cellElements = mesh->probeElementIds;
+
+  // reference Vandermonde matrix at the element nodes
+  dfloat *invV = (dfloat*) calloc(Np*Np, sizeof(dfloat));
+  dfloat *phi  = (dfloat*) calloc(Np, sizeof(dfloat));
+  for(int n=0;n<Np;++n){
+    dfloat rst[3] = {mesh->r[n], mesh->s[n], (dim==3) ? mesh->t[n] : 0};
+    probeModalBasis(mesh, elementType, rst, phi);
+    for(int m=0;m<Np;++m) invV[m*Np+n] = phi[m];
+  }
+  matrixInverse(Np, invV);
+
+  int    *owner   = (int*)    calloc(NprobeTotal+1, sizeof(int));
+  dlong  *foundE  = (dlong*)  calloc(NprobeTotal+1, sizeof(dlong));
+  dfloat *foundR  = (dfloat*) calloc(3*(NprobeTotal+1), sizeof(dfloat));
+  dfloat *I       = (dfloat*) calloc(Np, sizeof(dfloat));
+
+  for(dlong p=0;p<NprobeTotal;++p){
+    dfloat xp[3] = {pX[p], pY[p], (dim==3) ? pZ[p] : 0};
+    owner[p] = mesh->size;
+
+    int inside = 1, ci[3] = {0,0,0};
+    for(int d=0;d<dim;++d){
+      const dfloat slack = 1e-8*(hi[d]-lo[d]+1);
+      if(xp[d]<lo[d]-slack || xp[d]>hi[d]+slack) inside = 0;
+      ci[d] = mymin(Nc[d]-1, mymax(0, (int) floor((xp[d]-lo[d])/dx[d])));
+    }
+    if(!inside) continue;
+
+    const dlong c = ci[0] + Nc[0]*(ci[1] + Nc[1]*ci[2]);
+    for(dlong k=cellStarts[c];k<cellStarts[c+1];++k){
+      const dlong e = cellElements[k];
+
+      int inBox = 1;
+      dfloat h = 0;
+      for(int d=0;d<dim;++d){
+        const dfloat w = bb[6*e+2*d+1]-bb[6*e+2*d];
+        if(xp[d]<bb[6*e+2*d]-1e-8*w || xp[d]>bb[6*e+2*d+1]+1e-8*w) inBox = 0;
+        h = mymax(h, w);
+      }
+      if(!inBox) continue;
+
+      if(probeLocate(mesh, elementType, invV, e, h, xp, foundR+3*p, phi, I)){
+        owner[p]  = mesh->rank;
+        foundE[p] = e;
+        break;
+      }
+    }
+  }
+
+  int *gowner = (int*) calloc(NprobeTotal+1, sizeof(int));
+  MPI_Allreduce(owner, gowner, NprobeTotal, MPI_INT, MPI_MIN, mesh->comm);
+
+  dlong Nmissing = 0;
+  for(dlong p=0;p<NprobeTotal;++p){
+    if(gowner[p]==mesh->rank) mesh->probeN++;
+    if(gowner[p]==mesh->size) Nmissing++;
+  }
+  if(Nmissing && mesh->rank==0)
+    printf("WARNING: %d of %d probes are outside the mesh and ignored\n", Nmissing, NprobeTotal);
+
+  free(mesh->probeElementIds);
+  mesh->probeIds        = (dlong*)  calloc(mesh->probeN+1, sizeof(dlong));
+  mesh->probeElementIds = (dlong*)  calloc(mesh->probeN+1, sizeof(dlong));
+  mesh->probeR          = (dfloat*) calloc(mesh->probeN+1, sizeof(dfloat));
+  mesh->probeS          = (dfloat*) calloc(mesh->probeN+1, sizeof(dfloat));
+  mesh->probeT          = (dfloat*) calloc(mesh->probeN+1, sizeof(dfloat));
+  mesh->probeI          = (dfloat*) calloc((mesh->probeN+1)*Np, sizeof(dfloat));
+
+  dlong cnt = 0;
+  for(dlong p=0;p<NprobeTotal;++p){
+    if(gowner[p]!=mesh->rank) continue;
+
+    dfloat X[3];
+    probeMap(mesh, elementType, invV, foundE[p], foundR+3*p, phi, mesh->probeI+cnt*Np, X);
+
+    mesh->probeIds[cnt]        = p;
+    mesh->probeElementIds[cnt] = foundE[p];
+    mesh->probeR[cnt] = foundR[3*p+0];
+    mesh->probeS[cnt] = foundR[3*p+1];
+    mesh->probeT[cnt] = foundR[3*p+2];
+    ++cnt;
+  }
+
+  free(bb); free(cellStarts);
+  free(invV); free(phi); free(I);
+  free(owner); free(gowner); free(foundE); free(foundR);
+}
+
+// probe file: number of probes on the first line, then one "x y [z]" per line
+void meshProbeSetupFile(mesh_t *mesh, int elementType, const char *fileName){
+
+  FILE *fp = fopen(fileName, "r");
+  if(!fp){
+    printf("ERROR: cannot open probe file %s\n", fileName);
+    exit(-1);
+  }
+
+  dlong NprobeTotal = 0;
+  if(fscanf(fp, "%d", &NprobeTotal)!=1 || NprobeTotal<0){
+    printf("ERROR: probe file %s does not start with the number of probes\n", fileName);
+    exit(-1);
+  }
+
+  dfloat *pX = (dfloat*) calloc(NprobeTotal+1, sizeof(dfloat));
+  dfloat *pY = (dfloat*) calloc(NprobeTotal+1, sizeof(dfloat));
+  dfloat *pZ = (dfloat*) calloc(NprobeTotal+1, sizeof(dfloat));
+  for(dlong p=0;p<NprobeTotal;++p){
+    double x = 0, y = 0, z = 0;
+    int Nread = (mesh->dim==3) ? fscanf(fp, "%lf %lf %lf", &x, &y, &z)
+                               : fscanf(fp, "%lf %lf", &x, &y);
+    if(Nread!=mesh->dim){
+      printf("ERROR: probe file %s lists fewer than %d probes\n", fileName, NprobeTotal);
+      exit(-1);
+    }
+    pX[p] = x; pY[p] = y; pZ[p] = z;
+  }
+  fclose(fp);
+
+  meshProbeSetup(mesh, elementType, NprobeTotal, pX, pY, pZ);
+
+  free(pX); free(pY); free(pZ);
+}
@@ -0,0 +1,144 @@
+/*
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Tim Warburton, Noel Chalmers, Jesse Chan, Ali Karakus
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+// ogs setup benchmark
+//  builds the continuous node ids of a structured hex mesh of degree N,
+//  Ex x Ey x Ez elements per rank stacked in z, and times ogsSetup, repeated
+//  setups with the same ids (which share the gslib handles), and the first
+//  host gather-scatter (which builds the gslib handle).
+//
+//  usage: mpirun -np P ./ogsSetupBenchmark N Ex Ey Ez [Nrepeat]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "mpi.h"
+#include "ogs.hpp"
+
+int main(int argc, char **argv){
+
+  MPI_Init(&argc, &argv);
+
+  MPI_Comm comm = MPI_COMM_WORLD;
+  int rank, size;
+  MPI_Comm_rank(comm, &rank);
+  MPI_Comm_size(comm, &size);
+
+  if (argc<5) {
+    if (rank==0) printf("usage: %s N Ex Ey Ez [Nrepeat]\n", argv[0]);
+    MPI_Finalize();
+    exit(-1);
+  }
+
+  int N  = atoi(argv[1]);
+  int Ex = atoi(argv[2]);
+  int Ey = atoi(argv[3]);
+  int Ez = atoi(argv[4]);
+  int Nrepeat = (argc>5) ? atoi(argv[5]) : 4;
+
+  int Nq = N+1;
+  int Np = Nq*Nq*Nq;
+  dlong Nelements = Ex*Ey*Ez;
+  dlong Ntotal = Nelements*Np;
+
+  hlong Nx = Ex*N+1;
+  hlong Ny = Ey*N+1;
+
+  // global node ids, 1-indexed
+  hlong *ids = (hlong*) calloc(Ntotal, sizeof(hlong));
+  for (int ez=0;ez<Ez;ez++) {
+    for (int ey=0;ey<Ey;ey++) {
+      for (int ex=0;ex<Ex;ex++) {
+        dlong e = ex + ey*Ex + ez*Ex*Ey;
+        for (int k=0;k<Nq;k++) {
+          for (int j=0;j<Nq;j++) {
+            for (int i=0;i<Nq;i++) {
+              hlong x = ex*N+i;
+              hlong y = ey*N+j;
+              hlong z = ((hlong)rank*Ez+ez)*N+k;
+              ids[e*Np + i + j*Nq + k*Nq*Nq] = 1 + x + y*Nx + z*Nx*Ny;
+            }
+          }
+        }
+      }
+    }
+  }
+
+  occa::device device;
+  device.setup("mode: 'Serial'");
+
+  dfloat *q = (dfloat*) calloc(Ntotal, sizeof(dfloat));
+
+  //first setup, also builds the ogs kernels
+  MPI_Barrier(comm);
+  double tic = MPI_Wtime();
+  ogs_t *ogs = ogsSetup(Ntotal, ids, comm, 0, device);
+  MPI_Barrier(comm);
+  double tSetup = MPI_Wtime()-tic;
+
+  //repeated setups with the same ids share the gslib handles
+  ogs_t **ogsRepeat = (ogs_t**) calloc(Nrepeat, sizeof(ogs_t*));
+  MPI_Barrier(comm);
+  tic = MPI_Wtime();
+  for (int r=0;r<Nrepeat;r++)
+    ogsRepeat[r] = ogsSetup(Ntotal, ids, comm, 0, device);
+  MPI_Barrier(comm);
+  double tRepeat = (MPI_Wtime()-tic)/Nrepeat;
+
+  //the first host gather-scatter builds the gslib handle
+  for (dlong n=0;n<Ntotal;n++) q[n] = 1;
+  MPI_Barrier(comm);
+  tic = MPI_Wtime();
+  ogsGatherScatter(q, ogsDfloat, ogsAdd, ogs);
+  MPI_Barrier(comm);
+  double tFirst = MPI_Wtime()-tic;
+
+  //later ones, on any of the sharing ogs objects, reuse it
+  MPI_Barrier(comm);
+  tic = MPI_Wtime();
+  for (int r=0;r<Nrepeat;r++)
+    ogsGatherScatter(q, ogsDfloat, ogsAdd, ogsRepeat[r]);
+  MPI_Barrier(comm);
+  double tLater = (MPI_Wtime()-tic)/Nrepeat;
+
+  hlong NglobalNodes = Nx*Ny*((hlong)size*Ez*N+1);
+  if (rank==0) {
+    printf("ogs setup benchmark: N=%d, %d ranks, %d elements/rank, " hlongFormat " global nodes\n",
+           N, size, Nelements, NglobalNodes);
+    printf("  first ogsSetup             %g s\n", tSetup);
+    printf("  repeated ogsSetup          %g s\n", tRepeat);
+    printf("  first host gather-scatter  %g s\n", tFirst);
+    printf("  later host gather-scatter  %g s\n", tLater);
+  }
+
+  for (int r=0;r<Nrepeat;r++) ogsFree(ogsRepeat[r]);
+  ogsFree(ogs);
+
+  free(ogsRepeat);
+  free(ids); free(q);
+
+  MPI_Finalize();
+  return 0;
+}